@@ -10,6 +10,7 @@ foreach(
   DISABLE_STREAMING_MUSIC
   DISABLE_STREAMING_SOUNDS
   BUILD_TESTING
+  BUILD_DRLG_FARM
   GPERF
   GPERF_HEAP_MAIN
   GPERF_HEAP_FIRST_GAME_ITERATION
@@ -7,7 +7,9 @@ if(EMSCRIPTEN)
   emscripten_system_library("zlib" ZLIB::ZLIB USE_ZLIB=1)
 else()
   dependency_options("zlib" DEVILUTIONX_SYSTEM_ZLIB ON DEVILUTIONX_STATIC_ZLIB)
-  if(NOT DEVILUTIONX_SYSTEM_ZLIB)
+  if(DEVILUTIONX_SYSTEM_ZLIB)
+    find_package(ZLIB REQUIRED)
+  else()
     add_subdirectory(3rdParty/zlib)
   endif()
 endif()
@@ -215,6 +217,9 @@ if(BUILD_TESTING)
   else()
     add_subdirectory(3rdParty/googletest)
   endif()
+
+  # Benchmarks are only built if Google Benchmark is available.
+  find_package(benchmark QUIET)
 endif()
 
 if(GPERF)
@@ -5,10 +5,16 @@
  */
 #include "automap.h"
 
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <vector>
+
 #include <fmt/format.h>
 
 #include "control.h"
 #include "engine/load_file.hpp"
+#include "engine/render/automap_layer.hpp"
 #include "engine/render/automap_render.hpp"
 #include "levels/gendung.h"
 #include "levels/setmaps.h"
@@ -556,6 +562,141 @@ std::unique_ptr<AutomapTile[]> LoadAutomapData(size_t &tileCount)
 	}
 }
 
+/** @brief Layers larger than this are not kept, zoomed in the automap shows few enough tiles to draw them directly. */
+constexpr size_t MaxAutomapLayerSize = 8 * 1024 * 1024;
+/** @brief Above this many changed tiles, drawing the whole layer again is faster than redrawing them one by one. */
+constexpr size_t MaxAutomapDirtyTiles = 64;
+
+bool AutomapCacheEnabled = true;
+
+/** @brief The automap tiles at the current zoom level, along with the state of the level they show. */
+struct AutomapCacheLayer {
+	std::optional<AutomapLayer> layer;
+	uint8_t automapView[DMAXX][DMAXY];
+	uint8_t dungeon[DMAXX][DMAXY];
+};
+
+/** @brief One layer per row parity, the second one is only used by zoom levels that space the rows unevenly. */
+std::array<AutomapCacheLayer, 2> AutomapCache;
+
+void ClearAutomapCache()
+{
+	for (AutomapCacheLayer &cache : AutomapCache)
+		cache.layer = std::nullopt;
+}
+
+void AddDirtyAutomapTile(std::vector<Point> &dirtyTiles, Point map)
+{
+	if (map.x < -1 || map.x >= DMAXX || map.y < -1 || map.y >= DMAXY)
+		return;
+	dirtyTiles.push_back(map);
+}
+
+/**
+ * @brief Lists the automap tiles whose shape or color changed since they were drawn in the layer.
+ *
+ * A tile depends on its exploration state and dungeon piece, the pieces to its north west and north east turn corners
+ * into diamonds, and the tiles beyond the top edges show dirt from the pieces along that edge.
+ */
+std::vector<Point> GetDirtyAutomapTiles(const AutomapCacheLayer &cache)
+{
+	std::vector<Point> dirtyTiles;
+	if (memcmp(cache.automapView, AutomapView, sizeof(AutomapView)) == 0 && memcmp(cache.dungeon, dungeon, sizeof(dungeon)) == 0)
+		return dirtyTiles;
+
+	for (int x = 0; x < DMAXX; x++) {
+		for (int y = 0; y < DMAXY; y++) {
+			const bool viewChanged = cache.automapView[x][y] != AutomapView[x][y];
+			const bool dungeonChanged = cache.dungeon[x][y] != dungeon[x][y];
+			if (!viewChanged && !dungeonChanged)
+				continue;
+			AddDirtyAutomapTile(dirtyTiles, { x, y });
+			if (x == 0)
+				AddDirtyAutomapTile(dirtyTiles, { -1, y });
+			if (y == 0)
+				AddDirtyAutomapTile(dirtyTiles, { x, -1 });
+			if (!dungeonChanged)
+				continue;
+			AddDirtyAutomapTile(dirtyTiles, { x + 1, y });
+			AddDirtyAutomapTile(dirtyTiles, { x, y + 1 });
+			if (x == 0) {
+				AddDirtyAutomapTile(dirtyTiles, { -1, y - 1 });
+				AddDirtyAutomapTile(dirtyTiles, { -1, y + 1 });
+			}
+			if (y == 0) {
+				AddDirtyAutomapTile(dirtyTiles, { x - 1, -1 });
+				AddDirtyAutomapTile(dirtyTiles, { x + 1, -1 });
+			}
+		}
+	}
+
+	std::sort(dirtyTiles.begin(), dirtyTiles.end(), [](Point a, Point b) { return a.x != b.x ? a.x < b.x : a.y < b.y; });
+	dirtyTiles.erase(std::unique(dirtyTiles.begin(), dirtyTiles.end()), dirtyTiles.end());
+	return dirtyTiles;
+}
+
+/**
+ * @brief Brings the cached automap up to date with the zoom level and the explored tiles.
+ * @param rowParity Parity of the rows that are not shifted by half a tile on screen
+ * @return The layer to composite, or nullptr to draw the tiles directly
+ */
+const AutomapLayer *UpdateAutomapCache(int rowParity)
+{
+	if (!AutomapCacheEnabled)
+		return nullptr;
+
+	AutomapCacheLayer &cache = AutomapCache[rowParity];
+	if (!cache.layer || !cache.layer->HasMetrics(AmLine64, AmLine32, AmLine16, rowParity)) {
+		// Only the current zoom level is kept.
+		for (int parity : { 0, 1 }) {
+			if (AutomapCache[parity].layer && !AutomapCache[parity].layer->HasMetrics(AmLine64, AmLine32, AmLine16, parity))
+				AutomapCache[parity].layer = std::nullopt;
+		}
+		const Size layerSize = AutomapLayer::GetLayerSize({ DMAXX, DMAXY }, AmLine64, AmLine32, AmLine16, AmLine64);
+		if (static_cast<size_t>(layerSize.width) * layerSize.height > MaxAutomapLayerSize)
+			return nullptr;
+		memcpy(cache.automapView, AutomapView, sizeof(AutomapView));
+		memcpy(cache.dungeon, dungeon, sizeof(dungeon));
+		cache.layer.emplace(Size { DMAXX, DMAXY }, AmLine64, AmLine32, AmLine16, AmLine64, rowParity, &DrawAutomapTile);
+		return &*cache.layer;
+	}
+
+	const std::vector<Point> dirtyTiles = GetDirtyAutomapTiles(cache);
+	if (dirtyTiles.size() > MaxAutomapDirtyTiles) {
+		cache.layer->Redraw();
+	} else {
+		for (Point map : dirtyTiles)
+			cache.layer->RedrawTile(map);
+	}
+	memcpy(cache.automapView, AutomapView, sizeof(AutomapView));
+	memcpy(cache.dungeon, dungeon, sizeof(dungeon));
+	return &*cache.layer;
+}
+
+/**
+ * @brief Draws the automap tiles on screen one by one.
+ * @param screen Position of the center of the tile at `map`, the top left tile in view
+ */
+void DrawAutomapTiles(const Surface &out, Point screen, Point map, int cells)
+{
+	for (int i = 0; i <= cells + 1; i++) {
+		Point tile1 = screen;
+		for (int j = 0; j < cells; j++) {
+			DrawAutomapTile(out, tile1, { map.x + j, map.y - j });
+			tile1.x += AmLine64;
+		}
+		map.y++;
+
+		Point tile2 { screen.x - AmLine32, screen.y + AmLine16 };
+		for (int j = 0; j <= cells; j++) {
+			DrawAutomapTile(out, tile2, { map.x + j, map.y - j });
+			tile2.x += AmLine64;
+		}
+		map.x++;
+		screen.y += AmLine32;
+	}
+}
+
 } // namespace
 
 bool AutomapActive;
@@ -588,6 +729,7 @@ void InitAutomap()
 	}
 
 	memset(AutomapView, 0, sizeof(AutomapView));
+	ClearAutomapCache();
 
 	for (auto &column : dFlags)
 		for (auto &dFlag : column)
@@ -716,23 +858,12 @@ void DrawAutomap(const Surface &out)
 		}
 	}
 
-	Point map = { Automap.x - cells, Automap.y - 1 };
-
-	for (int i = 0; i <= cells + 1; i++) {
-		Point tile1 = screen;
-		for (int j = 0; j < cells; j++) {
-			DrawAutomapTile(out, tile1, { map.x + j, map.y - j });
-			tile1.x += AmLine64;
-		}
-		map.y++;
-
-		Point tile2 { screen.x - AmLine32, screen.y + AmLine16 };
-		for (int j = 0; j <= cells; j++) {
-			DrawAutomapTile(out, tile2, { map.x + j, map.y - j });
-			tile2.x += AmLine64;
-		}
-		map.x++;
-		screen.y += AmLine32;
+	const Point map = { Automap.x - cells, Automap.y - 1 };
+	const int rowParity = AutomapLayer::IsEvenlySpaced(AmLine64, AmLine32, AmLine16) ? 0 : (map.x + map.y) & 1;
+	if (const AutomapLayer *layer = UpdateAutomapCache(rowParity); layer != nullptr) {
+		layer->Composite(out, screen - layer->GetTileCenter(map));
+	} else {
+		DrawAutomapTiles(out, screen, map, cells);
 	}
 
 	for (int playerId = 0; playerId < MAX_PLRS; playerId++) {
@@ -830,6 +961,13 @@ void SetAutomapView(Point position, MapExplorationType explorer)
 	}
 }
 
+void SetAutomapCacheEnabled(bool enabled)
+{
+	AutomapCacheEnabled = enabled;
+	if (!enabled)
+		ClearAutomapCache();
+}
+
 void AutomapZoomReset()
 {
 	AutomapOffset = { 0, 0 };
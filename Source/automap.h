@@ -31,7 +31,7 @@ enum MapExplorationType : uint8_t {
 /** Specifies whether the automap is enabled. */
 extern DVL_API_FOR_TEST bool AutomapActive;
 /** Tracks the explored areas of the map. */
-extern uint8_t AutomapView[DMAXX][DMAXY];
+extern DVL_API_FOR_TEST uint8_t AutomapView[DMAXX][DMAXY];
 /** Specifies the scale of the automap. */
 extern DVL_API_FOR_TEST int AutoMapScale;
 extern DVL_API_FOR_TEST Displacement AutomapOffset;
@@ -101,6 +101,11 @@ void UpdateAutomapExplorer(Point map, MapExplorationType explorer);
  */
 void SetAutomapView(Point tile, MapExplorationType explorer);
 
+/**
+ * @brief Enables keeping the automap tiles of the current zoom level in an offscreen layer instead of drawing them each frame.
+ */
+void SetAutomapCacheEnabled(bool enabled);
+
 /**
  * @brief Resets the zoom level of the automap.
  */
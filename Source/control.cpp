@@ -21,6 +21,7 @@
 #include "engine/cel_sprite.hpp"
 #include "engine/load_cel.hpp"
 #include "engine/render/cel_render.hpp"
+#include "engine/render/scrollrt.h"
 #include "engine/render/text_render.hpp"
 #include "engine/trn.hpp"
 #include "error.h"
@@ -55,18 +56,10 @@
 
 namespace devilution {
 
-/**
- * @brief Set if the life flask needs to be redrawn during next frame
- */
-bool drawhpflag;
 bool dropGoldFlag;
 bool chrbtn[4];
 bool lvlbtndown;
 int dropGoldValue;
-/**
- * @brief Set if the mana flask needs to be redrawn during the next frame
- */
-bool drawmanaflag;
 bool chrbtnactive;
 int pnumlines;
 UiFlags InfoColor;
@@ -75,7 +68,6 @@ int8_t initialDropGoldIndex;
 bool talkflag;
 bool sbookflag;
 bool chrflag;
-bool drawbtnflag;
 StringOrView InfoString;
 bool panelflag;
 int initialDropGoldValue;
@@ -150,6 +142,11 @@ bool TalkButtonsDown[3];
 int sgbPlrTalkTbl;
 bool WhisperList[MAX_PLRS];
 char panelstr[4][64];
+/** @brief Life and mana of the player when the flasks were last updated. */
+int FlaskHitPoints;
+int FlaskMaxHitPoints;
+int FlaskMana;
+int FlaskMaxMana;
 
 enum panel_button_id {
 	PanelButtonCharinfo,
@@ -251,7 +248,7 @@ void DrawFlaskLower(const Surface &out, const Surface &sourceBuffer, int offset,
 void SetButtonStateDown(int btnId)
 {
 	PanelButtons[btnId] = true;
-	drawbtnflag = true;
+	RedrawComponent(PanelDrawComponent::ControlButtons);
 	panbtndown = true;
 }
 
@@ -536,8 +533,20 @@ void DrawFlaskValues(const Surface &out, Point pos, int currValue, int maxValue)
 
 void control_update_life_mana()
 {
-	MyPlayer->UpdateManaPercentage();
-	MyPlayer->UpdateHitPointPercentage();
+	Player &myPlayer = *MyPlayer;
+	myPlayer.UpdateManaPercentage();
+	myPlayer.UpdateHitPointPercentage();
+
+	if (myPlayer._pHitPoints != FlaskHitPoints || myPlayer._pMaxHP != FlaskMaxHitPoints) {
+		FlaskHitPoints = myPlayer._pHitPoints;
+		FlaskMaxHitPoints = myPlayer._pMaxHP;
+		RedrawComponent(PanelDrawComponent::Health);
+	}
+	if (myPlayer._pMana != FlaskMana || myPlayer._pMaxMana != FlaskMaxMana) {
+		FlaskMana = myPlayer._pMana;
+		FlaskMaxMana = myPlayer._pMaxMana;
+		RedrawComponent(PanelDrawComponent::Mana);
+	}
 }
 
 void InitControlPan()
@@ -589,8 +598,8 @@ void InitControlPan()
 	pDurIcons = LoadCel("Items\\DurIcons.CEL", 32);
 	InfoString = {};
 	ClearPanel();
-	drawhpflag = true;
-	drawmanaflag = true;
+	RedrawComponent(PanelDrawComponent::Health);
+	RedrawComponent(PanelDrawComponent::Mana);
 	chrflag = false;
 	spselflag = false;
 	sbooktab = 0;
@@ -641,7 +650,7 @@ void ClearPanBtn()
 {
 	for (bool &panelButton : PanelButtons)
 		panelButton = false;
-	drawbtnflag = true;
+	RedrawComponent(PanelDrawComponent::ControlButtons);
 	panbtndown = false;
 }
 
@@ -655,7 +664,7 @@ void DoPanBtn()
 		if (MousePosition.x >= PanBtnPos[i].x + mainPanelPosition.x && MousePosition.x <= x) {
 			if (MousePosition.y >= PanBtnPos[i].y + mainPanelPosition.y && MousePosition.y <= y) {
 				PanelButtons[i] = true;
-				drawbtnflag = true;
+				RedrawComponent(PanelDrawComponent::ControlButtons);
 				panbtndown = true;
 			}
 		}
@@ -777,7 +786,7 @@ void CheckBtnUp()
 	bool gamemenuOff = true;
 	const Point mainPanelPosition = GetMainPanel().position;
 
-	drawbtnflag = true;
+	RedrawComponent(PanelDrawComponent::ControlButtons);
 	panbtndown = false;
 
 	for (int i = 0; i < 8; i++) {
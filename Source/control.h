@@ -26,12 +26,10 @@ namespace devilution {
 
 constexpr Size SidePanelSize { 320, 352 };
 
-extern bool drawhpflag;
 extern bool dropGoldFlag;
 extern bool chrbtn[4];
 extern bool lvlbtndown;
 extern int dropGoldValue;
-extern bool drawmanaflag;
 extern bool chrbtnactive;
 extern DVL_API_FOR_TEST int pnumlines;
 extern UiFlags InfoColor;
@@ -40,7 +38,6 @@ extern int8_t initialDropGoldIndex;
 extern bool talkflag;
 extern bool sbookflag;
 extern bool chrflag;
-extern bool drawbtnflag;
 extern StringOrView InfoString;
 extern bool panelflag;
 extern int initialDropGoldValue;
@@ -110,6 +107,7 @@ void DrawFlaskValues(const Surface &out, Point pos, int currValue, int maxValue)
  * @brief calls on the active player object to update HP/Mana percentage variables
  *
  * This is used to ensure that DrawFlask routines display an accurate representation of the players health/mana
+ * and marks the flasks for redraw when either changed.
  *
  * @see Player::UpdateHitPointPercentage() and Player::UpdateManaPercentage()
  */
@@ -16,6 +16,7 @@
 #include "engine/load_cel.hpp"
 #include "engine/point.hpp"
 #include "engine/render/cel_render.hpp"
+#include "engine/render/scrollrt.h"
 #include "hwcursor.hpp"
 #include "inv.h"
 #include "levels/trigs.h"
@@ -363,7 +364,7 @@ void CheckCursMove()
 	pcursobj = -1;
 	pcursitem = -1;
 	if (pcursinvitem != -1) {
-		drawsbarflag = true;
+		RedrawComponent(PanelDrawComponent::Belt);
 	}
 	pcursinvitem = -1;
 	pcursstashitem = uint16_t(-1);
@@ -18,6 +18,7 @@
 #include "cursor.h"
 #include "engine/load_cel.hpp"
 #include "engine/point.hpp"
+#include "engine/render/scrollrt.h"
 #include "error.h"
 #include "inv.h"
 #include "levels/setmaps.h"
@@ -39,6 +40,7 @@ bool DebugToggle = false;
 bool DebugGodMode = false;
 bool DebugVision = false;
 bool DebugGrid = false;
+bool DebugDamagedAreas = false;
 std::unordered_map<int, Point> DebugCoordsMap;
 bool DebugScrollViewEnabled = false;
 
@@ -554,8 +556,8 @@ std::string DebugCmdRefillHealthMana(const string_view parameter)
 	Player &myPlayer = *MyPlayer;
 	myPlayer.RestoreFullLife();
 	myPlayer.RestoreFullMana();
-	drawhpflag = true;
-	drawmanaflag = true;
+	RedrawComponent(PanelDrawComponent::Health);
+	RedrawComponent(PanelDrawComponent::Mana);
 
 	return "Ready for more.";
 }
@@ -593,7 +595,7 @@ std::string DebugCmdChangeMana(const string_view parameter)
 	int newMana = myPlayer._pMana + (change * 64);
 	myPlayer._pMana = newMana;
 	myPlayer._pManaBase = myPlayer._pMana + myPlayer._pMaxManaBase - myPlayer._pMaxMana;
-	drawmanaflag = true;
+	RedrawComponent(PanelDrawComponent::Mana);
 
 	return fmt::format("Mana has changed.");
 }
@@ -654,6 +656,16 @@ std::string DebugCmdShowGrid(const string_view parameter)
 	return "Back to boring.";
 }
 
+std::string DebugCmdShowDamagedAreas(const string_view parameter)
+{
+	DebugDamagedAreas = !DebugDamagedAreas;
+	force_redraw = 255;
+	if (DebugDamagedAreas)
+		return "Redrawn areas are outlined.";
+
+	return "Outlines removed.";
+}
+
 std::string DebugCmdLevelSeed(const string_view parameter)
 {
 	return fmt::format("Seedinfo for level {}\nseed: {}\nMid1: {}\nMid2: {}\nMid3: {}\nEnd: {}", currlevel, glSeedTbl[currlevel], glMid1Seed[currlevel], glMid2Seed[currlevel], glMid3Seed[currlevel], glEndSeed[currlevel]);
@@ -980,11 +992,12 @@ std::vector<DebugCmdItem> DebugCmdList = {
 	{ "changehp", "Changes health by {value} (Use a negative value to remove health).", "{value}", &DebugCmdChangeHealth },
 	{ "changemp", "Changes mana by {value} (Use a negative value to remove mana).", "{value}", &DebugCmdChangeMana },
 	{ "dropu", "Attempts to generate unique item {name}.", "{name}", &DebugCmdGenerateUniqueItem },
-	{ "drop", "Attempts to generate item {name}.", "{name}", &DebugCmdGenerateItem },
+	{ "drop", "Attempts to generate item {name}, with minimum stats like str:20 and type:sword.", "{name} ({stat}:{value})", &DebugCmdGenerateItem },
 	{ "talkto", "Interacts with a NPC whose name contains {name}.", "{name}", &DebugCmdTalkToTowner },
 	{ "exit", "Exits the game.", "", &DebugCmdExit },
 	{ "arrow", "Changes arrow effect (normal, fire, lightning, explosion).", "{effect}", &DebugCmdArrow },
 	{ "grid", "Toggles showing grid.", "", &DebugCmdShowGrid },
+	{ "r_damage", "Toggles outlining the redrawn screen areas.", "", &DebugCmdShowDamagedAreas },
 	{ "seedinfo", "Show seed infos for current level.", "", &DebugCmdLevelSeed },
 	{ "spawnu", "Spawns unique monster {name}.", "{name} ({count})", &DebugCmdSpawnUniqueMonster },
 	{ "spawn", "Spawns monster {name}.", "{name} ({count})", &DebugCmdSpawnMonster },
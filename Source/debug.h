@@ -21,6 +21,8 @@ extern bool DebugToggle;
 extern bool DebugGodMode;
 extern bool DebugVision;
 extern bool DebugGrid;
+/** @brief Outline the parts of the screen that are presented each frame. */
+extern bool DebugDamagedAreas;
 extern std::unordered_map<int, Point> DebugCoordsMap;
 extern bool DebugScrollViewEnabled;
 
@@ -31,6 +31,7 @@
 #include "engine/load_cel.hpp"
 #include "engine/load_file.hpp"
 #include "engine/random.hpp"
+#include "engine/render/sprite_outline.hpp"
 #include "engine/sound.h"
 #include "error.h"
 #include "gamemenu.h"
@@ -1168,6 +1169,7 @@ void LoadAllGFX()
  */
 void CreateLevel(lvl_entry entry)
 {
+	ClearLevelOccupants();
 	CreateDungeon(glSeedTbl[currlevel], entry);
 
 	switch (leveltype) {
@@ -1705,6 +1707,7 @@ void FreeGameMem()
 	pMegaTiles = nullptr;
 	pSpecialCels = std::nullopt;
 
+	ClearOutlineCache();
 	FreeMonsters();
 	FreeMissileGFX();
 	FreeObjectGFX();
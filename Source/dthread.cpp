@@ -4,12 +4,14 @@
  * Implementation of functions for updating game state from network commands.
  */
 
-#include <list>
+#include <array>
+#include <atomic>
 #include <mutex>
 
 #include "nthread.h"
 #include "utils/sdl_cond.h"
 #include "utils/sdl_thread.h"
+#include "utils/spsc_queue.hpp"
 
 namespace devilution {
 
@@ -18,44 +20,65 @@ struct DThreadPkt {
 	_cmd_id cmd;
 	std::unique_ptr<byte[]> data;
 	uint32_t len;
+	/** @brief Value of the player's generation when the packet was queued, see `dthread_remove_player`. */
+	uint32_t generation;
 
-	DThreadPkt(int pnum, _cmd_id(cmd), std::unique_ptr<byte[]> data, uint32_t len)
+	DThreadPkt() = default;
+
+	DThreadPkt(int pnum, _cmd_id(cmd), std::unique_ptr<byte[]> data, uint32_t len, uint32_t generation)
 	    : pnum(pnum)
 	    , cmd(cmd)
 	    , data(std::move(data))
 	    , len(len)
+	    , generation(generation)
 	{
 	}
 };
 
 namespace {
 
+/** A join sends one packet per visited level plus two, so this fits several players joining at once. */
+constexpr size_t InfoQueueCapacity = 256;
+
+/** Packets are queued by the main thread and sent by the delta thread. */
+SpscQueue<DThreadPkt, InfoQueueCapacity> InfoQueue;
+/** Incremented when a player leaves, so that packets queued for them are dropped without touching the queue. */
+std::array<std::atomic<uint32_t>, MAX_PLRS> PlayerGenerations;
+std::atomic<bool> DthreadRunning;
+/** Only guards sleeping on `WorkToDo` and `RoomToPush`, the queue itself is lock-free. */
 std::optional<SdlMutex> DthreadMutex;
-std::list<DThreadPkt> InfoList;
-bool DthreadRunning;
 std::optional<SdlCond> WorkToDo;
+/** Signaled by the delta thread each time it has emptied the queue, for `dthread_send_delta` to wait on when it is full. */
+std::optional<SdlCond> RoomToPush;
 
 /* rdata */
 SdlThread Thread;
 
 void DthreadHandler()
 {
-	std::lock_guard<SdlMutex> lock(*DthreadMutex);
+	DThreadPkt pkt;
 	while (true) {
-		while (!InfoList.empty()) {
-			DThreadPkt pkt = std::move(InfoList.front());
-			InfoList.pop_front();
-
-			DthreadMutex->unlock();
-			multi_send_zero_packet(pkt.pnum, pkt.cmd, pkt.data.get(), pkt.len);
-			DthreadMutex->lock();
+		while (DthreadRunning && InfoQueue.TryPop(pkt)) {
+			if (pkt.generation == PlayerGenerations[pkt.pnum].load(std::memory_order_relaxed))
+				multi_send_zero_packet(pkt.pnum, pkt.cmd, pkt.data.get(), pkt.len);
+			pkt.data = nullptr;
 		}
+
+		std::lock_guard<SdlMutex> lock(*DthreadMutex);
+		RoomToPush->signal();
 		if (!DthreadRunning)
 			return;
-		WorkToDo->wait(*DthreadMutex);
+		if (InfoQueue.Empty())
+			WorkToDo->wait(*DthreadMutex);
 	}
 }
 
+void WakeDthread()
+{
+	std::lock_guard<SdlMutex> lock(*DthreadMutex);
+	WorkToDo->signal();
+}
+
 } // namespace
 
 void dthread_remove_player(uint8_t pnum)
@@ -63,10 +86,7 @@ void dthread_remove_player(uint8_t pnum)
 	if (!DthreadRunning)
 		return;
 
-	std::lock_guard<SdlMutex> lock(*DthreadMutex);
-	InfoList.remove_if([&](auto &pkt) {
-		return pkt.pnum == pnum;
-	});
+	PlayerGenerations[pnum].fetch_add(1, std::memory_order_relaxed);
 }
 
 void dthread_send_delta(int pnum, _cmd_id cmd, std::unique_ptr<byte[]> data, uint32_t len)
@@ -74,11 +94,16 @@ void dthread_send_delta(int pnum, _cmd_id cmd, std::unique_ptr<byte[]> data, uin
 	if (!gbIsMultiplayer || !DthreadRunning)
 		return;
 
-	DThreadPkt pkt { pnum, cmd, std::move(data), len };
-
-	std::lock_guard<SdlMutex> lock(*DthreadMutex);
-	InfoList.push_back(std::move(pkt));
-	WorkToDo->signal();
+	DThreadPkt pkt { pnum, cmd, std::move(data), len, PlayerGenerations[pnum].load(std::memory_order_relaxed) };
+	if (!InfoQueue.TryPush(std::move(pkt))) {
+		// The delta thread is behind, wait until it has caught up. It signals `RoomToPush` with the mutex held after
+		// emptying the queue, so checking the queue with the mutex held can't miss it.
+		std::lock_guard<SdlMutex> lock(*DthreadMutex);
+		WorkToDo->signal();
+		while (!InfoQueue.TryPush(std::move(pkt)))
+			RoomToPush->wait(*DthreadMutex);
+	}
+	WakeDthread();
 }
 
 void dthread_start()
@@ -89,6 +114,7 @@ void dthread_start()
 	DthreadRunning = true;
 	DthreadMutex.emplace();
 	WorkToDo.emplace();
+	RoomToPush.emplace();
 	Thread = SdlThread { DthreadHandler };
 }
 
@@ -100,13 +126,15 @@ void DThreadCleanup()
 	{
 		std::lock_guard<SdlMutex> lock(*DthreadMutex);
 		DthreadRunning = false;
-		InfoList.clear();
 		WorkToDo->signal();
 	}
 
 	Thread.join();
+	// The delta thread has exited, so it is safe to consume the remaining packets here.
+	InfoQueue.Clear();
 	DthreadMutex = std::nullopt;
 	WorkToDo = std::nullopt;
+	RoomToPush = std::nullopt;
 }
 
 } // namespace devilution
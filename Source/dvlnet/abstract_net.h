@@ -36,6 +36,16 @@ public:
 	virtual bool SNetDropPlayer(int playerid, uint32_t flags) = 0;
 	virtual bool SNetGetOwnerTurnsWaiting(uint32_t *turns) = 0;
 	virtual bool SNetGetTurnsInTransit(uint32_t *turns) = 0;
+
+	/**
+	 * @brief Retrieves the worst smoothed round trip time and jitter to the other players, in milliseconds.
+	 * @return false if no measurement is available.
+	 */
+	virtual bool SNetGetLatency(uint32_t *roundTripLatency, uint32_t *jitter)
+	{
+		return false;
+	}
+
 	virtual void setup_gameinfo(buffer_t info) = 0;
 	virtual ~abstract_net() = default;
 
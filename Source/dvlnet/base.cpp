@@ -7,9 +7,25 @@
 namespace devilution {
 namespace net {
 
+namespace {
+
+/** How often the round trip time to the other players is measured. */
+constexpr timestamp_t EchoRequestInterval = 1000;
+
+} // namespace
+
 void base::setup_gameinfo(buffer_t info)
 {
 	game_init_info = std::move(info);
+	ReadAdaptiveTurns();
+}
+
+void base::ReadAdaptiveTurns()
+{
+	GameData gameData {};
+	if (game_init_info.size() == sizeof(gameData))
+		memcpy(&gameData, game_init_info.data(), sizeof(gameData));
+	adaptiveTurns_ = gameData.bAdaptiveTurns != 0;
 }
 
 void base::setup_password(std::string pw)
@@ -36,6 +52,9 @@ void base::DisconnectNet(plr_t plr)
 
 void base::SendEchoRequest(plr_t player)
 {
+	// Only adaptive turns need the round trip time.
+	if (!adaptiveTurns_)
+		return;
 	if (plr_self == PLR_BROADCAST)
 		return;
 	if (player == plr_self)
@@ -46,6 +65,22 @@ void base::SendEchoRequest(plr_t player)
 	send(*echo);
 }
 
+void base::SendEchoRequestsIfDue()
+{
+	if (!adaptiveTurns_)
+		return;
+
+	timestamp_t now = SDL_GetTicks();
+	if (lastEchoRequestTime_ && now - *lastEchoRequestTime_ < EchoRequestInterval)
+		return;
+
+	lastEchoRequestTime_ = now;
+	for (plr_t i = 0; i < MAX_PLRS; ++i) {
+		if (IsConnected(i))
+			SendEchoRequest(i);
+	}
+}
+
 void base::HandleAccept(packet &pkt)
 {
 	if (plr_self != PLR_BROADCAST) {
@@ -61,6 +96,7 @@ void base::HandleAccept(packet &pkt)
 		}
 		// we joined and did not create
 		game_init_info = pkt.Info();
+		ReadAdaptiveTurns();
 		_SNETEVENT ev;
 		ev.eventid = EVENT_TYPE_PLAYER_CREATE_GAME;
 		ev.playerid = plr_self;
@@ -103,6 +139,7 @@ void base::HandleDisconnect(packet &pkt)
 			PlayerState &playerState = playerStateTable_[newPlayer];
 			playerState.isConnected = false;
 			playerState.turnQueue.clear();
+			playerState.hasLatencySample = false;
 		}
 	} else {
 		ABORT(); // we were dropped by the owner?!?
@@ -120,7 +157,18 @@ void base::HandleEchoReply(packet &pkt)
 	uint32_t now = SDL_GetTicks();
 	plr_t src = pkt.Source();
 	PlayerState &playerState = playerStateTable_[src];
-	playerState.roundTripLatency = now - pkt.Time();
+	uint32_t sample = now - pkt.Time();
+	if (!playerState.hasLatencySample) {
+		playerState.roundTripLatency = sample;
+		playerState.roundTripJitter = sample / 2;
+		playerState.hasLatencySample = true;
+		return;
+	}
+
+	// Exponentially weighted moving averages, as used for TCP retransmission timers (RFC 6298).
+	uint32_t deviation = sample > playerState.roundTripLatency ? sample - playerState.roundTripLatency : playerState.roundTripLatency - sample;
+	playerState.roundTripJitter = (3 * playerState.roundTripJitter + deviation) / 4;
+	playerState.roundTripLatency = (7 * playerState.roundTripLatency + sample) / 8;
 }
 
 void base::ClearMsg(plr_t plr)
@@ -236,6 +284,7 @@ bool base::AllTurnsArrived()
 bool base::SNetReceiveTurns(char **data, size_t *size, uint32_t *status)
 {
 	poll();
+	SendEchoRequestsIfDue();
 
 	for (auto i = 0; i < MAX_PLRS; ++i) {
 		status[i] = 0;
@@ -304,12 +353,16 @@ bool base::SNetSendTurn(char *data, unsigned int size)
 	if (size != sizeof(int32_t))
 		ABORT();
 
+	PlayerState &playerState = playerStateTable_[plr_self];
+	std::deque<turn_t> &turnQueue = playerState.turnQueue;
+
 	turn_t turn;
 	turn.SequenceNumber = next_turn;
+	// Turns still in transit are for the upcoming sequence numbers, so this one comes after them.
+	if (adaptiveTurns_)
+		turn.SequenceNumber += static_cast<seq_t>(turnQueue.size());
 	std::memcpy(&turn.Value, data, size);
 
-	PlayerState &playerState = playerStateTable_[plr_self];
-	std::deque<turn_t> &turnQueue = playerState.turnQueue;
 	turnQueue.push_back(turn);
 	SendTurnIfReady(turn);
 	return true;
@@ -336,9 +389,16 @@ void base::SendFirstTurnIfReady(plr_t player)
 	if (turnQueue.empty())
 		return;
 
-	turn_t turn = turnQueue.back();
-	auto pkt = pktfty->make_packet<PT_TURN>(plr_self, player, turn);
-	send(*pkt);
+	if (!adaptiveTurns_) {
+		auto pkt = pktfty->make_packet<PT_TURN>(plr_self, player, turnQueue.back());
+		send(*pkt);
+		return;
+	}
+
+	for (const turn_t &turn : turnQueue) {
+		auto pkt = pktfty->make_packet<PT_TURN>(plr_self, player, turn);
+		send(*pkt);
+	}
 }
 
 void base::MakeReady(seq_t sequenceNumber)
@@ -351,10 +411,20 @@ void base::MakeReady(seq_t sequenceNumber)
 
 	PlayerState &playerState = playerStateTable_[plr_self];
 	std::deque<turn_t> &turnQueue = playerState.turnQueue;
-	if (!turnQueue.empty()) {
+	if (turnQueue.empty())
+		return;
+
+	if (!adaptiveTurns_) {
 		turn_t &turn = turnQueue.front();
 		turn.SequenceNumber = next_turn;
 		SendTurnIfReady(turn);
+		return;
+	}
+
+	seq_t sequenceNumberInTransit = next_turn;
+	for (turn_t &turn : turnQueue) {
+		turn.SequenceNumber = sequenceNumberInTransit++;
+		SendTurnIfReady(turn);
 	}
 }
 
@@ -368,8 +438,9 @@ void base::SNetGetProviderCaps(struct _SNETCAPS *caps)
 	caps->bytessec = 1000000;        // ?
 	caps->latencyms = 0;             // unused
 	caps->defaultturnssec = 10;      // ?
-	caps->defaultturnsintransit = 1; // maximum acceptable number
-	                                 // of turns in queue?
+	caps->defaultturnsintransit = 1; // initial number of turns in queue,
+	                                 // adaptive turns can raise it up to
+	                                 // TurnScheduler::MaxTurnsInTransit
 }
 
 bool base::SNetUnregisterEventHandler(event_type evtype)
@@ -442,5 +513,22 @@ bool base::SNetGetTurnsInTransit(uint32_t *turns)
 	return true;
 }
 
+bool base::SNetGetLatency(uint32_t *roundTripLatency, uint32_t *jitter)
+{
+	bool hasLatencySample = false;
+	*roundTripLatency = 0;
+	*jitter = 0;
+	for (plr_t i = 0; i < MAX_PLRS; ++i) {
+		const PlayerState &playerState = playerStateTable_[i];
+		if (i == plr_self || !playerState.isConnected || !playerState.hasLatencySample)
+			continue;
+
+		hasLatencySample = true;
+		*roundTripLatency = std::max(*roundTripLatency, playerState.roundTripLatency);
+		*jitter = std::max(*jitter, playerState.roundTripJitter);
+	}
+	return hasLatencySample;
+}
+
 } // namespace net
 } // namespace devilution
@@ -10,6 +10,7 @@
 #include "dvlnet/packet.h"
 #include "multi.h"
 #include "storm/storm_net.hpp"
+#include "utils/stdcompat/optional.hpp"
 
 namespace devilution {
 namespace net {
@@ -31,6 +32,7 @@ public:
 	virtual bool SNetDropPlayer(int playerid, uint32_t flags);
 	virtual bool SNetGetOwnerTurnsWaiting(uint32_t *turns);
 	virtual bool SNetGetTurnsInTransit(uint32_t *turns);
+	virtual bool SNetGetLatency(uint32_t *roundTripLatency, uint32_t *jitter);
 
 	virtual void poll() = 0;
 	virtual void send(packet &pkt) = 0;
@@ -66,7 +68,11 @@ protected:
 		bool isConnected = {};
 		std::deque<turn_t> turnQueue;
 		int32_t lastTurnValue = {};
+		/** @brief Smoothed round trip time in milliseconds. */
 		uint32_t roundTripLatency = {};
+		/** @brief Smoothed mean deviation of the round trip time in milliseconds. */
+		uint32_t roundTripJitter = {};
+		bool hasLatencySample = {};
 	};
 
 	seq_t next_turn = 0;
@@ -82,6 +88,7 @@ protected:
 	void RecvLocal(packet &pkt);
 	void RunEventHandler(_SNETEVENT &ev);
 	void SendEchoRequest(plr_t player);
+	void SendEchoRequestsIfDue();
 
 	[[nodiscard]] bool IsConnected(plr_t player) const;
 	virtual bool IsGameHost() = 0;
@@ -89,7 +96,11 @@ protected:
 private:
 	std::array<PlayerState, MAX_PLRS> playerStateTable_;
 	bool awaitingSequenceNumber_ = true;
+	/** @brief Whether the game info of the host enables adaptive turns, see `GameData::bAdaptiveTurns`. */
+	bool adaptiveTurns_ = false;
+	std::optional<timestamp_t> lastEchoRequestTime_;
 
+	void ReadAdaptiveTurns();
 	plr_t GetOwner();
 	bool AllTurnsArrived();
 	void MakeReady(seq_t sequenceNumber);
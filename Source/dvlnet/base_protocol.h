@@ -283,7 +283,7 @@ void base_protocol<P>::handle_join_request(packet &pkt, endpoint_t sender)
 	// not resume game logic until after having been notified of all existing players
 	auto reply = pktfty->make_packet<PT_JOIN_ACCEPT>(plr_self, PLR_BROADCAST,
 	    pkt.Cookie(), i,
-	    game_init_info);
+	    game_init_info, false);
 	proto.send(sender, reply->Data());
 	DrainSendQueue(i);
 }
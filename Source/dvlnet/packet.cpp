@@ -170,6 +170,13 @@ plr_t packet::NewPlayer()
 	return m_newplr;
 }
 
+bool packet::IsGameHost()
+{
+	assert(have_decrypted);
+	CheckPacketTypeOneOf({ PT_JOIN_ACCEPT }, m_type);
+	return m_gamehost != 0;
+}
+
 timestamp_t packet::Time()
 {
 	assert(have_decrypted);
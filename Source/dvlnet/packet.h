@@ -86,6 +86,7 @@ protected:
 	turn_t m_turn;
 	cookie_t m_cookie;
 	plr_t m_newplr;
+	uint8_t m_gamehost;
 	timestamp_t m_time;
 	buffer_t m_info;
 	leaveinfo_t m_leaveinfo;
@@ -109,6 +110,7 @@ public:
 	turn_t Turn();
 	cookie_t Cookie();
 	plr_t NewPlayer();
+	bool IsGameHost();
 	timestamp_t Time();
 	const buffer_t &Info();
 	leaveinfo_t LeaveInfo();
@@ -171,6 +173,7 @@ void packet_proc<P>::process_data()
 	case PT_JOIN_ACCEPT:
 		self.process_element(m_cookie);
 		self.process_element(m_newplr);
+		self.process_element(m_gamehost);
 		self.process_element(m_info);
 		break;
 	case PT_CONNECT:
@@ -276,7 +279,7 @@ inline void packet_out::create<PT_JOIN_REQUEST>(plr_t s, plr_t d,
 
 template <>
 inline void packet_out::create<PT_JOIN_ACCEPT>(plr_t s, plr_t d, cookie_t c,
-    plr_t n, buffer_t i)
+    plr_t n, buffer_t i, bool h)
 {
 	if (have_encrypted || have_decrypted)
 		ABORT();
@@ -287,6 +290,7 @@ inline void packet_out::create<PT_JOIN_ACCEPT>(plr_t s, plr_t d, cookie_t c,
 	m_cookie = c;
 	m_newplr = n;
 	m_info = i;
+	m_gamehost = h ? 1 : 0;
 }
 
 template <>
@@ -17,6 +17,9 @@ namespace net {
 
 int tcp_client::create(std::string addrstr)
 {
+	if (*sgOptions.Network.szRelayServer != '\0')
+		return join(sgOptions.Network.szRelayServer);
+
 	try {
 		auto port = *sgOptions.Network.port;
 		local_server = std::make_unique<tcp_server>(ioc, addrstr, port, *pktfty);
@@ -71,7 +74,7 @@ int tcp_client::join(std::string addrstr)
 
 bool tcp_client::IsGameHost()
 {
-	return local_server != nullptr;
+	return local_server != nullptr || relay_game_host;
 }
 
 void tcp_client::poll()
@@ -95,6 +98,8 @@ void tcp_client::HandleReceive(const asio::error_code &error, size_t bytesRead)
 	recv_buffer.resize(frame_queue::max_frame_size);
 	while (recv_queue.PacketReady()) {
 		auto pkt = pktfty->make_packet(recv_queue.ReadPacket());
+		if (pkt->Type() == PT_JOIN_ACCEPT && pkt->Cookie() == cookie_self && plr_self == PLR_BROADCAST)
+			relay_game_host = pkt->IsGameHost();
 		RecvLocal(*pkt);
 	}
 	StartReceive();
@@ -41,6 +41,8 @@ private:
 	asio::ip::tcp::resolver resolver = asio::ip::tcp::resolver(ioc);
 	asio::ip::tcp::socket sock = asio::ip::tcp::socket(ioc);
 	std::unique_ptr<tcp_server> local_server; // must be declared *after* ioc
+	// Set when a relay accepted us into an empty room, so that we created the game on it.
+	bool relay_game_host = false;
 
 	void HandleReceive(const asio::error_code &error, size_t bytesRead);
 	void StartReceive();
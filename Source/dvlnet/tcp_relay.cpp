@@ -0,0 +1,50 @@
+#include "dvlnet/tcp_relay.h"
+
+#include <fmt/format.h>
+
+namespace devilution {
+namespace net {
+
+tcp_relay::tcp_relay(asio::io_context &ioc, const std::string &bindaddr,
+    unsigned short firstPort, unsigned short roomCount, packet_factory &pktfty)
+{
+	rooms.reserve(roomCount);
+	for (unsigned short i = 0; i < roomCount; ++i) {
+		auto port = static_cast<unsigned short>(firstPort + i);
+		rooms.push_back(std::make_unique<tcp_server>(ioc, bindaddr, port, pktfty));
+	}
+}
+
+size_t tcp_relay::RoomCount() const
+{
+	return rooms.size();
+}
+
+const tcp_server &tcp_relay::Room(size_t room) const
+{
+	return *rooms[room];
+}
+
+std::vector<std::string> tcp_relay::FormatStats() const
+{
+	std::vector<std::string> lines;
+	for (const auto &room : rooms) {
+		size_t players = room->PlayerCount();
+		if (players == 0)
+			continue;
+		const server_stats &stats = room->Stats();
+		lines.push_back(fmt::format("Room {}: {} players ({} joined, {} dropped), received {} packets ({} bytes), sent {} packets ({} bytes)",
+		    room->Port(), players, stats.playersJoined, stats.playersDropped,
+		    stats.packetsReceived, stats.bytesReceived, stats.packetsSent, stats.bytesSent));
+	}
+	return lines;
+}
+
+void tcp_relay::Close()
+{
+	for (auto &room : rooms)
+		room->Close();
+}
+
+} // namespace net
+} // namespace devilution
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <asio/ts/io_context.hpp>
+
+#include "dvlnet/packet.h"
+#include "dvlnet/tcp_server.h"
+
+namespace devilution {
+namespace net {
+
+/**
+ * @brief Hosts many independent games without taking part in any of them.
+ *
+ * Each room is a `tcp_server` listening on its own port, starting at `firstPort`, so that
+ * clients pick a game simply by connecting to its port. The first player to join an empty
+ * room provides the game settings and becomes its host.
+ */
+class tcp_relay {
+public:
+	tcp_relay(asio::io_context &ioc, const std::string &bindaddr,
+	    unsigned short firstPort, unsigned short roomCount, packet_factory &pktfty);
+
+	size_t RoomCount() const;
+	const tcp_server &Room(size_t room) const;
+	/** @brief One line per room with players, for logging. */
+	std::vector<std::string> FormatStats() const;
+	void Close();
+
+private:
+	std::vector<std::unique_ptr<tcp_server>> rooms;
+};
+
+} // namespace net
+} // namespace devilution
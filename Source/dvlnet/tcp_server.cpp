@@ -37,6 +37,26 @@ std::string tcp_server::LocalhostSelf()
 	return addr.to_string();
 }
 
+unsigned short tcp_server::Port() const
+{
+	return acceptor->local_endpoint().port();
+}
+
+size_t tcp_server::PlayerCount() const
+{
+	size_t count = 0;
+	for (const scc &con : connections) {
+		if (con)
+			count++;
+	}
+	return count;
+}
+
+const server_stats &tcp_server::Stats() const
+{
+	return stats;
+}
+
 tcp_server::scc tcp_server::MakeConnection()
 {
 	return std::make_shared<client_connection>(ioc);
@@ -72,12 +92,14 @@ void tcp_server::HandleReceive(const scc &con, const asio::error_code &ec,
 		DropConnection(con);
 		return;
 	}
+	stats.bytesReceived += bytesRead;
 	con->recv_buffer.resize(bytesRead);
 	con->recv_queue.Write(std::move(con->recv_buffer));
 	con->recv_buffer.resize(frame_queue::max_frame_size);
 	try {
 		while (con->recv_queue.PacketReady()) {
 			try {
+				stats.packetsReceived++;
 				auto pkt = pktfty.make_packet(con->recv_queue.ReadPacket());
 				if (con->plr == PLR_BROADCAST) {
 					HandleReceiveNewPlayer(con, *pkt);
@@ -105,7 +127,9 @@ void tcp_server::HandleReceiveNewPlayer(const scc &con, packet &pkt)
 	if (newplr == PLR_BROADCAST)
 		throw server_exception();
 
-	if (Empty())
+	// The player who opens an empty server creates the game and hosts it until they leave.
+	const bool gameHost = Empty();
+	if (gameHost)
 		game_init_info = pkt.Info();
 
 	for (plr_t player = 0; player < MAX_PLRS; player++) {
@@ -120,11 +144,12 @@ void tcp_server::HandleReceiveNewPlayer(const scc &con, packet &pkt)
 
 	auto reply = pktfty.make_packet<PT_JOIN_ACCEPT>(PLR_MASTER, PLR_BROADCAST,
 	    pkt.Cookie(), newplr,
-	    game_init_info);
+	    game_init_info, gameHost);
 	StartSend(con, *reply);
 	con->plr = newplr;
 	connections[newplr] = con;
 	con->timeout = timeout_active;
+	stats.playersJoined++;
 }
 
 void tcp_server::HandleReceivePacket(packet &pkt)
@@ -149,6 +174,8 @@ void tcp_server::SendPacket(packet &pkt)
 void tcp_server::StartSend(const scc &con, packet &pkt)
 {
 	auto frame = std::make_unique<buffer_t>(frame_queue::MakeFrame(pkt.Data()));
+	stats.packetsSent++;
+	stats.bytesSent += frame->size();
 	auto buf = asio::buffer(*frame);
 	asio::async_write(con->socket, buf,
 	    [this, con, frame = std::move(frame)](const asio::error_code &ec, size_t bytesSent) {
@@ -211,10 +238,12 @@ void tcp_server::HandleTimeout(const scc &con, const asio::error_code &ec)
 
 void tcp_server::DropConnection(const scc &con)
 {
-	if (con->plr != PLR_BROADCAST) {
+	// A connection can be dropped by both a failed receive and its timeout, and its slot may have been reused since.
+	if (con->plr != PLR_BROADCAST && connections[con->plr] == con) {
 		auto pkt = pktfty.make_packet<PT_DISCONNECT>(PLR_MASTER, PLR_BROADCAST,
 		    con->plr, LEAVE_DROP);
 		connections[con->plr] = nullptr;
+		stats.playersDropped++;
 		SendPacket(*pkt);
 		// TODO: investigate if it is really ok for the server to
 		//       drop a client directly.
@@ -25,11 +25,24 @@ public:
 	}
 };
 
+/** @brief Traffic counters of a single game hosted by a `tcp_server`. */
+struct server_stats {
+	uint64_t packetsReceived = 0;
+	uint64_t packetsSent = 0;
+	uint64_t bytesReceived = 0;
+	uint64_t bytesSent = 0;
+	uint32_t playersJoined = 0;
+	uint32_t playersDropped = 0;
+};
+
 class tcp_server {
 public:
 	tcp_server(asio::io_context &ioc, const std::string &bindaddr,
 	    unsigned short port, packet_factory &pktfty);
 	std::string LocalhostSelf();
+	unsigned short Port() const;
+	size_t PlayerCount() const;
+	const server_stats &Stats() const;
 	void Close();
 	virtual ~tcp_server();
 
@@ -58,6 +71,7 @@ private:
 	std::unique_ptr<asio::ip::tcp::acceptor> acceptor;
 	std::array<scc, MAX_PLRS> connections;
 	buffer_t game_init_info;
+	server_stats stats;
 
 	scc MakeConnection();
 	plr_t NextFree();
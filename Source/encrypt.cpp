@@ -10,8 +10,10 @@
 
 #include <SDL.h>
 #include <pkware.h>
+#include <zlib.h>
 
 #include "encrypt.h"
+#include "utils/lz4.hpp"
 
 namespace devilution {
 
@@ -130,7 +132,7 @@ uint32_t PkwareCompress(byte *srcData, uint32_t size)
 	return size;
 }
 
-void PkwareDecompress(byte *inBuff, int recvSize, int maxBytes)
+uint32_t PkwareDecompress(byte *inBuff, int recvSize, int maxBytes)
 {
 	std::unique_ptr<char[]> ptr = std::make_unique<char[]>(CMP_BUFFER_SIZE);
 	std::unique_ptr<byte[]> outBuff { new byte[maxBytes] };
@@ -144,6 +146,71 @@ void PkwareDecompress(byte *inBuff, int recvSize, int maxBytes)
 
 	explode(PkwareBufferRead, PkwareBufferWrite, ptr.get(), &info);
 	memcpy(inBuff, outBuff.get(), info.destOffset);
+
+	return info.destOffset;
+}
+
+uint32_t ZlibCompress(byte *srcData, uint32_t size, uint32_t limit)
+{
+	uLongf destSize = compressBound(size);
+	std::unique_ptr<byte[]> destData { new byte[destSize] };
+
+	const int result = compress2(reinterpret_cast<Bytef *>(destData.get()), &destSize, reinterpret_cast<const Bytef *>(srcData), size, Z_BEST_SPEED);
+	if (result != Z_OK || destSize >= limit)
+		return size;
+
+	memcpy(srcData, destData.get(), destSize);
+	return destSize;
+}
+
+uint32_t CompressBuffer(CompressionType type, byte *data, uint32_t size)
+{
+	switch (type) {
+	case CompressionType::None:
+		return size;
+	case CompressionType::Implode:
+		return PkwareCompress(data, size);
+	case CompressionType::Lz4: {
+		std::unique_ptr<byte[]> destData { new byte[size] };
+		const size_t destSize = Lz4Compress(data, size, destData.get(), size);
+		if (destSize == 0 || destSize >= size)
+			return size;
+		memcpy(data, destData.get(), destSize);
+		return static_cast<uint32_t>(destSize);
+	}
+	case CompressionType::Zlib:
+		return ZlibCompress(data, size, size);
+	}
+	return size;
+}
+
+std::optional<uint32_t> DecompressBuffer(CompressionType type, byte *data, uint32_t size, uint32_t maxBytes)
+{
+	switch (type) {
+	case CompressionType::None:
+		if (size > maxBytes)
+			return std::nullopt;
+		return size;
+	case CompressionType::Implode:
+		return PkwareDecompress(data, size, maxBytes);
+	case CompressionType::Lz4: {
+		std::unique_ptr<byte[]> outBuff { new byte[maxBytes] };
+		const std::optional<size_t> outSize = Lz4Decompress(data, size, outBuff.get(), maxBytes);
+		if (!outSize)
+			return std::nullopt;
+		memcpy(data, outBuff.get(), *outSize);
+		return static_cast<uint32_t>(*outSize);
+	}
+	case CompressionType::Zlib: {
+		std::unique_ptr<byte[]> outBuff { new byte[maxBytes] };
+		uLongf outSize = maxBytes;
+		if (uncompress(reinterpret_cast<Bytef *>(outBuff.get()), &outSize, reinterpret_cast<const Bytef *>(data), size) != Z_OK)
+			return std::nullopt;
+		memcpy(data, outBuff.get(), outSize);
+		return static_cast<uint32_t>(outSize);
+	}
+	}
+	return std::nullopt;
 }
 
 } // namespace devilution
@@ -8,9 +8,25 @@
 #include <cstdint>
 
 #include "utils/stdcompat/cstddef.hpp"
+#include "utils/stdcompat/optional.hpp"
 
 namespace devilution {
 
+/**
+ * @brief Compression formats supported by `CompressBuffer` and `DecompressBuffer`.
+ *
+ * The values are sent over the network, do not reorder.
+ */
+enum class CompressionType : uint8_t {
+	None = 0,
+	/** @brief PKWare DCL implode, the only format vanilla Diablo understands. */
+	Implode = 1,
+	/** @brief LZ4 block format, several times faster than implode. */
+	Lz4 = 2,
+	/** @brief zlib (deflate), readable as an MPQ multi-compressed sector. */
+	Zlib = 3,
+};
+
 struct TDataInfo {
 	byte *srcData;
 	uint32_t srcOffset;
@@ -23,6 +39,24 @@ void Decrypt(uint32_t *castBlock, uint32_t size, uint32_t key);
 void Encrypt(uint32_t *castBlock, uint32_t size, uint32_t key);
 uint32_t Hash(const char *s, int type);
 uint32_t PkwareCompress(byte *srcData, uint32_t size);
-void PkwareDecompress(byte *inBuff, int recvSize, int maxBytes);
+uint32_t PkwareDecompress(byte *inBuff, int recvSize, int maxBytes);
+/**
+ * @brief Deflates a buffer in place.
+ * @return The compressed size if it is below `limit`, otherwise `size` with the data left untouched.
+ */
+uint32_t ZlibCompress(byte *srcData, uint32_t size, uint32_t limit);
+
+/**
+ * @brief Compresses a buffer in place.
+ * @return The compressed size, or `size` with the data left untouched if compression did not shrink it.
+ */
+uint32_t CompressBuffer(CompressionType type, byte *data, uint32_t size);
+
+/**
+ * @brief Decompresses a buffer in place.
+ * @param data Buffer holding `size` bytes of compressed data, with room for `maxBytes` bytes.
+ * @return The decompressed size, or nullopt if the data is corrupt or does not fit.
+ */
+std::optional<uint32_t> DecompressBuffer(CompressionType type, byte *data, uint32_t size, uint32_t maxBytes);
 
 } // namespace devilution
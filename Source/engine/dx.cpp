@@ -5,6 +5,14 @@
  */
 #include "engine/dx.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
 #include <SDL.h>
 
 #include "controls/plrctrls.h"
@@ -13,7 +21,13 @@
 #include "options.h"
 #include "utils/display.h"
 #include "utils/log.hpp"
+#include "utils/palette_expand.hpp"
+#include "utils/sdl_cond.h"
+#include "utils/sdl_mutex.h"
+#include "utils/sdl_thread.h"
 #include "utils/sdl_wrap.h"
+#include "utils/stdcompat/optional.hpp"
+#include "utils/upscale.hpp"
 
 #ifdef __3DS__
 #include <3ds.h>
@@ -78,6 +92,360 @@ void LimitFrameRate()
 	frameDeadline = tc + v + refreshDelay;
 }
 
+/** When `RenderPresent` was called the last time, for `PresentStats::frameTime` */
+std::chrono::steady_clock::time_point LastPresentTime;
+/** Sums of the durations since the last call to `GetPresentStats`, in microseconds */
+int64_t FrameTimeSum;
+int64_t PresentLatencySum;
+uint32_t FrameTimeCount;
+uint32_t PresentLatencyCount;
+
+void RecordFrameTime(std::chrono::steady_clock::time_point now)
+{
+	if (LastPresentTime != std::chrono::steady_clock::time_point {}) {
+		FrameTimeSum += std::chrono::duration_cast<std::chrono::microseconds>(now - LastPresentTime).count();
+		FrameTimeCount++;
+	}
+	LastPresentTime = now;
+}
+
+/** @param renderedAt When the game finished drawing the frame that has just been presented */
+void RecordPresentLatency(std::chrono::steady_clock::time_point renderedAt)
+{
+	PresentLatencySum += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - renderedAt).count();
+	PresentLatencyCount++;
+}
+
+#ifndef USE_SDL1
+/** Output pixels for each palette index of `PalSurface` */
+PaletteLut OutputPaletteLut;
+const SDL_Palette *OutputPaletteLutPalette;
+Uint32 OutputPaletteLutVersion;
+Uint32 OutputPaletteLutFormat = SDL_PIXELFORMAT_UNKNOWN;
+
+/** Above this many dirty rectangles the whole surface is considered dirty */
+constexpr size_t MaxDirtyRects = 32;
+
+/** Regions of the output surface written since the last `RenderPresent`, empty if unknown */
+std::vector<SDL_Rect> OutputDirtyRects;
+
+/** The texture or window surface that the last `RenderPresent` updated */
+const void *LastPresentTarget;
+
+/**
+ * @brief A frame handed over to the present thread.
+ *
+ * The present thread converts it to the output surface while the game renders the next frame,
+ * and the next `RenderPresent` uploads and presents it.
+ */
+struct PresentJob {
+	/** Copy of the regions of `PalSurface` to convert, with the same pitch */
+	std::unique_ptr<uint8_t[]> indices;
+	size_t size = 0;
+	int pitch = 0;
+	std::vector<SDL_Rect> rects;
+	PaletteLut lut;
+	SDL_Surface *output = nullptr;
+	/** When the game finished drawing the frame */
+	std::chrono::steady_clock::time_point renderedAt;
+};
+
+PresentJob Job;
+/** Regions of `PalSurface` blitted since the last `RenderPresent`, not yet converted */
+std::vector<SDL_Rect> PendingPresentRects;
+/** Whether `Job` was submitted and not yet uploaded, only used by the game thread */
+bool PresentJobInFlight;
+
+std::optional<SdlMutex> PresentMutex;
+std::optional<SdlCond> PresentJobQueued;
+std::optional<SdlCond> PresentJobDone;
+/** Whether `Job` still has to be converted, guarded by `PresentMutex` */
+bool PresentJobPending;
+/** Guarded by `PresentMutex` */
+bool PresentThreadRunning;
+SdlThread PresentThread;
+
+void AddDirtyRect(std::vector<SDL_Rect> &rects, const SDL_Rect &rect, const SDL_Rect &bounds)
+{
+	if (rects.size() == MaxDirtyRects) {
+		rects.assign(1, bounds);
+		return;
+	}
+	rects.push_back(rect);
+}
+
+/**
+ * @brief Output pixels for the palette of `PalSurface`, converted again whenever the palette changes.
+ *
+ * Palette cycling changes a few colors each tick, but the whole table is converted: the game view is converted
+ * in full on each of those frames anyway, which costs far more than the 256 `SDL_MapRGB` calls.
+ */
+const PaletteLut &GetOutputPaletteLut(const SDL_PixelFormat *format)
+{
+	const SDL_Palette *palette = PalSurface->format->palette;
+	if (palette != OutputPaletteLutPalette || palette->version != OutputPaletteLutVersion || format->format != OutputPaletteLutFormat) {
+		for (int i = 0; i < palette->ncolors && i < 256; i++) {
+			const SDL_Color &color = palette->colors[i];
+			OutputPaletteLut.SetEntry(static_cast<uint8_t>(i), SDL_MapRGB(format, color.r, color.g, color.b));
+		}
+		OutputPaletteLutPalette = palette;
+		OutputPaletteLutVersion = palette->version;
+		OutputPaletteLutFormat = format->format;
+	}
+	return OutputPaletteLut;
+}
+
+SDL_Rect GetOutputBounds()
+{
+	const SDL_Surface *dst = GetOutputSurface();
+	return SDL_Rect { 0, 0, std::min(PalSurface->w, dst->w), std::min(PalSurface->h, dst->h) };
+}
+
+/**
+ * @brief Clips a `BltFast` region of `PalSurface` to the output surface.
+ * @return false if the surfaces or the rectangles are not supported by `ExpandToOutputSurface`.
+ */
+bool ClipToOutputSurface(const SDL_Rect *srcRect, const SDL_Rect *dstRect, SDL_Rect &rect)
+{
+	const SDL_Surface *dst = GetOutputSurface();
+	if (PalSurface->format->BytesPerPixel != 1 || PalSurface->format->palette == nullptr || dst->format->BytesPerPixel != 4)
+		return false;
+
+	rect = srcRect != nullptr ? *srcRect : SDL_Rect { 0, 0, PalSurface->w, PalSurface->h };
+	if (dstRect != nullptr && (dstRect->x != rect.x || dstRect->y != rect.y))
+		return false;
+	const SDL_Rect bounds = GetOutputBounds();
+	if (SDL_IntersectRect(&rect, &bounds, &rect) == SDL_FALSE)
+		rect.w = rect.h = 0;
+	return true;
+}
+
+/**
+ * @brief Converts a region of `PalSurface` to the 32-bit output surface without going through `SDL_BlitSurface`.
+ */
+void ExpandToOutputSurface(const SDL_Rect &rect)
+{
+	SDL_Surface *dst = GetOutputSurface();
+	if (SDL_MUSTLOCK(dst) && SDL_LockSurface(dst) < 0)
+		ErrSdl();
+	const auto *src = static_cast<const uint8_t *>(PalSurface->pixels) + rect.y * PalSurface->pitch + rect.x;
+	auto *out = reinterpret_cast<uint32_t *>(static_cast<uint8_t *>(dst->pixels) + rect.y * dst->pitch) + rect.x;
+	ExpandPalette(src, PalSurface->pitch, out, dst->pitch / sizeof(uint32_t), rect.w, rect.h, GetOutputPaletteLut(dst->format));
+	if (SDL_MUSTLOCK(dst))
+		SDL_UnlockSurface(dst);
+
+	AddDirtyRect(OutputDirtyRects, rect, GetOutputBounds());
+}
+
+/**
+ * @brief Whether frames are converted on the present thread.
+ *
+ * Only the renderer texture surface is owned by us, the window surface may be replaced by SDL at any time.
+ */
+bool IsPresentPipelined()
+{
+	return renderer != nullptr && *sgOptions.Graphics.pipelinedPresent && !SDL_MUSTLOCK(GetOutputSurface());
+}
+
+void ConvertPresentJob(const PresentJob &job)
+{
+	const size_t dstPitch = job.output->pitch / sizeof(uint32_t);
+	for (const SDL_Rect &rect : job.rects) {
+		const uint8_t *src = &job.indices[rect.y * job.pitch + rect.x];
+		uint32_t *dst = static_cast<uint32_t *>(job.output->pixels) + rect.y * dstPitch + rect.x;
+		ExpandPalette(src, job.pitch, dst, dstPitch, rect.w, rect.h, job.lut);
+	}
+}
+
+void PresentThreadHandler()
+{
+	std::unique_lock<SdlMutex> lock(*PresentMutex);
+	while (true) {
+		while (PresentThreadRunning && !PresentJobPending)
+			PresentJobQueued->wait(*PresentMutex);
+		if (!PresentThreadRunning)
+			return;
+
+		lock.unlock();
+		ConvertPresentJob(Job);
+		lock.lock();
+
+		PresentJobPending = false;
+		PresentJobDone->signal();
+	}
+}
+
+/**
+ * @brief Waits for the present thread to convert the submitted frame, so that it can be uploaded.
+ * @return false if no frame was submitted.
+ */
+bool FinishPresentJob()
+{
+	if (!PresentJobInFlight)
+		return false;
+
+	{
+		std::lock_guard<SdlMutex> lock(*PresentMutex);
+		while (PresentJobPending)
+			PresentJobDone->wait(*PresentMutex);
+	}
+	for (const SDL_Rect &rect : Job.rects)
+		AddDirtyRect(OutputDirtyRects, rect, GetOutputBounds());
+	PresentJobInFlight = false;
+	return true;
+}
+
+/** @brief Converts the blitted regions on the game thread, when they cannot be handed to the present thread. */
+void FlushPendingPresentRects()
+{
+	for (const SDL_Rect &rect : PendingPresentRects)
+		ExpandToOutputSurface(rect);
+	PendingPresentRects.clear();
+}
+
+/**
+ * @brief Hands the regions blitted since the last `RenderPresent` over to the present thread.
+ *
+ * `PalSurface` is copied, so the game can start drawing the next frame right away.
+ * The palette is captured as well, so that fades apply to the right frames.
+ */
+void SubmitPresentJob(SDL_Surface *output, std::chrono::steady_clock::time_point renderedAt)
+{
+	if (!PresentThreadRunning) {
+		PresentMutex.emplace();
+		PresentJobQueued.emplace();
+		PresentJobDone.emplace();
+		PresentThreadRunning = true;
+		PresentThread = SdlThread { PresentThreadHandler };
+	}
+
+	const size_t size = static_cast<size_t>(PalSurface->pitch) * PalSurface->h;
+	if (Job.size != size) {
+		Job.indices = std::unique_ptr<uint8_t[]> { new uint8_t[size] };
+		Job.size = size;
+	}
+	Job.pitch = PalSurface->pitch;
+	for (const SDL_Rect &rect : PendingPresentRects) {
+		for (int y = rect.y; y < rect.y + rect.h; y++) {
+			const size_t offset = y * Job.pitch + rect.x;
+			memcpy(&Job.indices[offset], static_cast<const uint8_t *>(PalSurface->pixels) + offset, rect.w);
+		}
+	}
+	Job.rects.swap(PendingPresentRects);
+	PendingPresentRects.clear();
+	Job.lut = GetOutputPaletteLut(output->format);
+	Job.output = output;
+	Job.renderedAt = renderedAt;
+
+	std::lock_guard<SdlMutex> lock(*PresentMutex);
+	PresentJobPending = true;
+	PresentJobInFlight = true;
+	PresentJobQueued->signal();
+}
+
+void StopPresentThread()
+{
+	if (!PresentThreadRunning)
+		return;
+
+	FinishPresentJob();
+	{
+		std::lock_guard<SdlMutex> lock(*PresentMutex);
+		PresentThreadRunning = false;
+		PresentJobQueued->signal();
+	}
+	PresentThread.join();
+	PresentMutex = std::nullopt;
+	PresentJobQueued = std::nullopt;
+	PresentJobDone = std::nullopt;
+}
+
+/**
+ * @brief Whether only the dirty rectangles of `target` need to be presented.
+ *
+ * Uploading a few large rectangles is slower than a single upload of the whole surface.
+ */
+bool CanPresentDirtyRects(const void *target, const SDL_Surface *surface)
+{
+	if (target != LastPresentTarget || OutputDirtyRects.empty())
+		return false;
+	int64_t area = 0;
+	for (const SDL_Rect &rect : OutputDirtyRects)
+		area += static_cast<int64_t>(rect.w) * rect.h;
+	return area < static_cast<int64_t>(surface->w) * surface->h / 2;
+}
+
+void UpdateOutputTexture(SDL_Surface *surface)
+{
+	if (CanPresentDirtyRects(texture.get(), surface)) {
+		for (const SDL_Rect &rect : OutputDirtyRects) {
+			const auto *pixels = static_cast<const uint8_t *>(surface->pixels) + rect.y * surface->pitch + rect.x * surface->format->BytesPerPixel;
+			if (SDL_UpdateTexture(texture.get(), &rect, pixels, surface->pitch) <= -1)
+				ErrSdl();
+		}
+	} else if (SDL_UpdateTexture(texture.get(), nullptr, surface->pixels, surface->pitch) <= -1) { // pitch is 2560
+		ErrSdl();
+	}
+	LastPresentTarget = texture.get();
+	OutputDirtyRects.clear();
+}
+
+void UpdateOutputWindowSurface(SDL_Surface *surface)
+{
+	// The virtual gamepad is drawn on top of the whole surface.
+	if (ControlMode != ControlTypes::VirtualGamepad && CanPresentDirtyRects(surface, surface)) {
+		if (SDL_UpdateWindowSurfaceRects(ghMainWnd, OutputDirtyRects.data(), static_cast<int>(OutputDirtyRects.size())) <= -1)
+			ErrSdl();
+	} else if (SDL_UpdateWindowSurface(ghMainWnd) <= -1) {
+		ErrSdl();
+	}
+	LastPresentTarget = surface;
+	OutputDirtyRects.clear();
+}
+#endif
+
+#ifdef USE_SDL1
+/**
+ * @brief Scales by a whole number without going through `SDL_SoftStretch`.
+ * @return false if the output is not a whole multiple of the screen with the same format, or the rectangles differ.
+ */
+bool UpscaleToOutputSurface(SDL_Surface *src, const SDL_Rect *srcRect, const SDL_Rect *dstRect, SDL_Surface *dst)
+{
+	const int srcX = srcRect != NULL ? srcRect->x : 0;
+	const int srcY = srcRect != NULL ? srcRect->y : 0;
+	if (dstRect != NULL && (dstRect->x != srcX || dstRect->y != srcY))
+		return false;
+	if (dst->w % gnScreenWidth != 0 || dst->w / gnScreenWidth != dst->h / gnScreenHeight || dst->h % gnScreenHeight != 0)
+		return false;
+	const int bytesPerPixel = src->format->BytesPerPixel;
+	if ((bytesPerPixel != 1 && bytesPerPixel != 4) || !SDLBackport_PixelFormatFormatEq(src->format, dst->format) || SDL_HasColorKey(src))
+		return false;
+
+	const int factor = dst->w / gnScreenWidth;
+	int x = 0;
+	int y = 0;
+	int right = std::min<int>(src->w, gnScreenWidth);
+	int bottom = std::min<int>(src->h, gnScreenHeight);
+	if (srcRect != NULL) {
+		x = std::max<int>(srcRect->x, 0);
+		y = std::max<int>(srcRect->y, 0);
+		right = std::min<int>(srcRect->x + srcRect->w, right);
+		bottom = std::min<int>(srcRect->y + srcRect->h, bottom);
+	}
+	if (right <= x || bottom <= y)
+		return true;
+
+	if (SDL_MUSTLOCK(dst) && SDL_LockSurface(dst) < 0)
+		ErrSdl();
+	const auto *srcPixels = static_cast<const uint8_t *>(src->pixels) + y * src->pitch + x * bytesPerPixel;
+	auto *dstPixels = static_cast<uint8_t *>(dst->pixels) + y * factor * dst->pitch + x * factor * bytesPerPixel;
+	UpscaleNearest(srcPixels, src->pitch, dstPixels, dst->pitch, right - x, bottom - y, bytesPerPixel, factor);
+	if (SDL_MUSTLOCK(dst))
+		SDL_UnlockSurface(dst);
+	return true;
+}
+#endif
+
 } // namespace
 
 void dx_init()
@@ -104,6 +472,9 @@ void dx_cleanup()
 		SDL_HideWindow(ghMainWnd);
 #endif
 
+#ifndef USE_SDL1
+	StopPresentThread();
+#endif
 	PalSurface = nullptr;
 	PinnedPalSurface = nullptr;
 	Palette = nullptr;
@@ -152,6 +523,22 @@ void BltFast(SDL_Rect *srcRect, SDL_Rect *dstRect)
 {
 	if (RenderDirectlyToOutputSurface)
 		return;
+#ifndef USE_SDL1
+	SDL_Rect rect;
+	if (ClipToOutputSurface(srcRect, dstRect, rect)) {
+		if (rect.w <= 0 || rect.h <= 0)
+			return;
+		if (IsPresentPipelined())
+			AddDirtyRect(PendingPresentRects, rect, GetOutputBounds());
+		else
+			ExpandToOutputSurface(rect);
+		return;
+	}
+	FlushPresentPipeline();
+	// Whatever SDL writes is not tracked, so the whole surface has to be presented.
+	OutputDirtyRects.clear();
+	LastPresentTarget = nullptr;
+#endif
 	Blit(PalSurface, srcRect, dstRect);
 }
 
@@ -168,6 +555,9 @@ void Blit(SDL_Surface *src, SDL_Rect *srcRect, SDL_Rect *dstRect)
 		return;
 	}
 
+	if (UpscaleToOutputSurface(src, srcRect, dstRect, dst))
+		return;
+
 	SDL_Rect scaledDstRect;
 	if (dstRect != NULL) {
 		scaledDstRect = *dstRect;
@@ -205,6 +595,28 @@ void Blit(SDL_Surface *src, SDL_Rect *srcRect, SDL_Rect *dstRect)
 #endif
 }
 
+void FlushPresentPipeline()
+{
+#ifndef USE_SDL1
+	FinishPresentJob();
+	FlushPendingPresentRects();
+#endif
+}
+
+PresentStats GetPresentStats()
+{
+	PresentStats stats {};
+	if (FrameTimeCount != 0)
+		stats.frameTime = static_cast<float>(FrameTimeSum) / FrameTimeCount / 1000;
+	if (PresentLatencyCount != 0)
+		stats.presentLatency = static_cast<float>(PresentLatencySum) / PresentLatencyCount / 1000;
+	FrameTimeSum = 0;
+	FrameTimeCount = 0;
+	PresentLatencySum = 0;
+	PresentLatencyCount = 0;
+	return stats;
+}
+
 void RenderPresent()
 {
 	SDL_Surface *surface = GetOutputSurface();
@@ -214,11 +626,22 @@ void RenderPresent()
 		return;
 	}
 
+	const auto now = std::chrono::steady_clock::now();
+	RecordFrameTime(now);
+	auto renderedAt = now;
+
 #ifndef USE_SDL1
 	if (renderer != nullptr) {
-		if (SDL_UpdateTexture(texture.get(), nullptr, surface->pixels, surface->pitch) <= -1) { // pitch is 2560
-			ErrSdl();
-		}
+		// With a pipelined present, the frame converted during the last call is shown now,
+		// while the present thread converts the one that has just been drawn.
+		const bool pipelined = IsPresentPipelined();
+		if (FinishPresentJob())
+			renderedAt = Job.renderedAt;
+		if (!pipelined)
+			FlushPendingPresentRects();
+		UpdateOutputTexture(surface);
+		if (pipelined && !PendingPresentRects.empty())
+			SubmitPresentJob(surface, now);
 
 		// Clear buffer to avoid artifacts in case the window was resized
 		if (SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255) <= -1) { // TODO only do this if window was resized
@@ -235,23 +658,25 @@ void RenderPresent()
 			RenderVirtualGamepad(renderer);
 		}
 		SDL_RenderPresent(renderer);
+		RecordPresentLatency(renderedAt);
 
 		if (!*sgOptions.Graphics.vSync) {
 			LimitFrameRate();
 		}
 	} else {
+		FlushPresentPipeline();
 		if (ControlMode == ControlTypes::VirtualGamepad) {
 			RenderVirtualGamepad(surface);
 		}
-		if (SDL_UpdateWindowSurface(ghMainWnd) <= -1) {
-			ErrSdl();
-		}
+		UpdateOutputWindowSurface(surface);
+		RecordPresentLatency(renderedAt);
 		LimitFrameRate();
 	}
 #else
 	if (SDL_Flip(surface) <= -1) {
 		ErrSdl();
 	}
+	RecordPresentLatency(renderedAt);
 	if (RenderDirectlyToOutputSurface)
 		PalSurface = GetOutputSurface();
 	LimitFrameRate();
@@ -21,6 +21,23 @@ void InitPalette();
 void BltFast(SDL_Rect *srcRect, SDL_Rect *dstRect);
 void Blit(SDL_Surface *src, SDL_Rect *srcRect, SDL_Rect *dstRect);
 void RenderPresent();
+
+/**
+ * @brief Finishes converting the frames drawn so far to the output surface.
+ *
+ * Has to be called before the output surface is written or replaced by anything else than `BltFast`.
+ */
+void FlushPresentPipeline();
+
+/** @brief Timing of the frames presented since the previous call. */
+struct PresentStats {
+	/** Average time between two frames, in milliseconds */
+	float frameTime;
+	/** Average time from the end of drawing a frame until it was presented, in milliseconds */
+	float presentLatency;
+};
+
+PresentStats GetPresentStats();
 void PaletteGetEntries(int dwNumEntries, SDL_Color *lpEntries);
 
 } // namespace devilution
@@ -1,54 +1,55 @@
 #include "engine/random.hpp"
 
-#include <limits>
-
-#include "utils/stdcompat/abs.hpp"
-
 namespace devilution {
 
-/** Current game seed */
-uint32_t sglGameSeed;
+namespace {
 
-/**
- * Specifies the increment used in the Borland C/C++ pseudo-random number generator algorithm.
- */
-const uint32_t RndInc = 1;
+/** Context of the game, used by every thread until a RandomContextScope gives it another one. */
+RandomContext GlobalRandomContext;
 
 /**
- * Specifies the multiplier used in the Borland C/C++ pseudo-random number generator algorithm.
+ * Context the vanilla functions use on each thread.
+ *
+ * It is constant-initialized, so reading it is a single thread-local access without any initialization check.
  */
-const uint32_t RndMult = 0x015A4E35;
+thread_local RandomContext *CurrentRandomContext = &GlobalRandomContext;
 
-void SetRndSeed(uint32_t seed)
+} // namespace
+
+RandomContext &GetCurrentRandomContext()
 {
-	sglGameSeed = seed;
+	return *CurrentRandomContext;
 }
 
-uint32_t GetLCGEngineState()
+RandomContextScope::RandomContextScope(RandomContext &context)
+    : previous_(CurrentRandomContext)
 {
-	return sglGameSeed;
+	CurrentRandomContext = &context;
 }
 
-int32_t GetRndSeed()
+RandomContextScope::~RandomContextScope()
+{
+	CurrentRandomContext = previous_;
+}
+
+void SetRndSeed(uint32_t seed)
+{
+	CurrentRandomContext->SetSeed(seed);
+}
+
+uint32_t GetLCGEngineState()
 {
-	const int32_t seed = static_cast<int32_t>(sglGameSeed);
-	// since abs(INT_MIN) is undefined behavior, handle this value specially
-	return seed == std::numeric_limits<int32_t>::min() ? std::numeric_limits<int32_t>::min() : abs(seed);
+	return CurrentRandomContext->GetState();
 }
 
 int32_t AdvanceRndSeed()
 {
-	sglGameSeed = (RndMult * sglGameSeed) + RndInc;
-	return GetRndSeed();
+	return CurrentRandomContext->Advance();
 }
 
 int32_t GenerateRnd(int32_t v)
 {
-	if (v <= 0)
-		return 0;
-	if (v <= 0x7FFF) // use the high bits to correct for LCG bias
-		return (AdvanceRndSeed() >> 16) % v;
-	return AdvanceRndSeed() % v;
+	return CurrentRandomContext->Generate(v);
 }
 
 } // namespace devilution
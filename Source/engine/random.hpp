@@ -9,12 +9,89 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <cstdlib>
 #include <initializer_list>
+#include <limits>
 
 namespace devilution {
 
+/**
+ * @brief State of the vanilla RNG, an LCG with the Borland constants
+ *
+ * The vanilla functions below use the current context of the calling thread, which is the game's global context unless
+ * a RandomContextScope replaced it. Code that generates on another thread, or that mustn't disturb the game's sequence,
+ * gives them a context of its own with a RandomContextScope.
+ */
+class RandomContext {
+public:
+	constexpr explicit RandomContext(uint32_t seed = 0)
+	    : state_(seed)
+	{
+	}
+
+	void SetSeed(uint32_t seed)
+	{
+		state_ = seed;
+	}
+
+	[[nodiscard]] uint32_t GetState() const
+	{
+		return state_;
+	}
+
+	/** @see AdvanceRndSeed() */
+	int32_t Advance()
+	{
+		state_ = (Multiplier * state_) + Increment;
+		const int32_t seed = static_cast<int32_t>(state_);
+		// since abs(INT_MIN) is undefined behavior, handle this value specially
+		return seed == std::numeric_limits<int32_t>::min() ? std::numeric_limits<int32_t>::min() : std::abs(seed);
+	}
+
+	/** @see GenerateRnd() */
+	int32_t Generate(int32_t v)
+	{
+		if (v <= 0)
+			return 0;
+		if (v <= 0x7FFF) // use the high bits to correct for LCG bias
+			return (Advance() >> 16) % v;
+		return Advance() % v;
+	}
+
+private:
+	static constexpr uint32_t Increment = 1;
+	static constexpr uint32_t Multiplier = 0x015A4E35;
+
+	uint32_t state_;
+};
+
+/**
+ * @brief Returns the context the vanilla RNG functions use on the calling thread
+ *
+ * Threads start with the game's global context, which is seeded with 0 at startup.
+ */
+RandomContext &GetCurrentRandomContext();
+
+/**
+ * @brief Makes a context the current one of the calling thread for its lifetime, restoring the previous one after
+ */
+class RandomContextScope {
+public:
+	explicit RandomContextScope(RandomContext &context);
+	~RandomContextScope();
+
+	RandomContextScope(const RandomContextScope &) = delete;
+	RandomContextScope &operator=(const RandomContextScope &) = delete;
+
+private:
+	RandomContext *previous_;
+};
+
 /**
  * @brief Set the state of the RandomNumberEngine used by the base game to the specific seed
+ *
+ * This sets the current context of the calling thread, see GetCurrentRandomContext().
+ *
  * @param seed New engine state
  */
 void SetRndSeed(uint32_t seed);
@@ -0,0 +1,154 @@
+#include "engine/render/automap_layer.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace devilution {
+
+namespace {
+
+Point GetRelativeTileCenter(Point map, int tileWidth, int rowHeight, int halfRowHeight, int rowParity)
+{
+	// Odd rows are shifted by half a tile, like the second row of each pair in `DrawAutomap`.
+	const int row = map.x + map.y + rowParity;
+	const int odd = row & 1;
+	const int column = map.x - map.y + odd + rowParity;
+	return {
+		column / 2 * tileWidth - odd * rowHeight,
+		(row - odd) / 2 * rowHeight + odd * halfRowHeight
+	};
+}
+
+/**
+ * @brief The area covered by the centers of the tiles from -1 to `mapSize - 1`.
+ */
+Rectangle GetTileCenterBounds(Size mapSize, int tileWidth, int rowHeight, int halfRowHeight, int rowParity)
+{
+	Point min { std::numeric_limits<int>::max(), std::numeric_limits<int>::max() };
+	Point max { std::numeric_limits<int>::min(), std::numeric_limits<int>::min() };
+	for (int y = -1; y < mapSize.height; y++) {
+		for (int x = -1; x < mapSize.width; x++) {
+			const Point center = GetRelativeTileCenter({ x, y }, tileWidth, rowHeight, halfRowHeight, rowParity);
+			min = { std::min(min.x, center.x), std::min(min.y, center.y) };
+			max = { std::max(max.x, center.x), std::max(max.y, center.y) };
+		}
+	}
+	return { min, Size { max.x - min.x + 1, max.y - min.y + 1 } };
+}
+
+} // namespace
+
+AutomapLayer::AutomapLayer(Size mapSize, int tileWidth, int rowHeight, int halfRowHeight, int tileExtent, int rowParity, DrawTileFn drawTile)
+    : mapSize_(mapSize)
+    , tileWidth_(tileWidth)
+    , rowHeight_(rowHeight)
+    , halfRowHeight_(halfRowHeight)
+    , tileExtent_(tileExtent)
+    , rowParity_(rowParity)
+    , drawTile_(drawTile)
+    , surface_(GetLayerSize(mapSize, tileWidth, rowHeight, halfRowHeight, tileExtent))
+{
+	const Rectangle bounds = GetTileCenterBounds(mapSize, tileWidth, rowHeight, halfRowHeight, rowParity);
+	origin_ = { tileExtent - bounds.position.x, tileExtent - bounds.position.y };
+	Redraw();
+}
+
+Size AutomapLayer::GetLayerSize(Size mapSize, int tileWidth, int rowHeight, int halfRowHeight, int tileExtent)
+{
+	// Unevenly spaced rows make the layouts of both parities differ by a pixel, use the same size for both.
+	const Rectangle even = GetTileCenterBounds(mapSize, tileWidth, rowHeight, halfRowHeight, 0);
+	const Rectangle odd = GetTileCenterBounds(mapSize, tileWidth, rowHeight, halfRowHeight, 1);
+	return {
+		std::max(even.size.width, odd.size.width) + 2 * tileExtent,
+		std::max(even.size.height, odd.size.height) + 2 * tileExtent
+	};
+}
+
+Point AutomapLayer::GetRelativeTileCenter(Point map) const
+{
+	return devilution::GetRelativeTileCenter(map, tileWidth_, rowHeight_, halfRowHeight_, rowParity_);
+}
+
+Point AutomapLayer::GetTileCenter(Point map) const
+{
+	return GetRelativeTileCenter(map) + origin_;
+}
+
+void AutomapLayer::Redraw()
+{
+	RedrawArea({ { 0, 0 }, Size { surface_.w(), surface_.h() } });
+}
+
+void AutomapLayer::RedrawTile(Point map)
+{
+	const Point center = GetTileCenter(map);
+	RedrawArea({ { center.x - tileExtent_, center.y - tileExtent_ }, Size { 2 * tileExtent_ + 1, 2 * tileExtent_ + 1 } });
+}
+
+void AutomapLayer::RedrawArea(Rectangle area)
+{
+	const int left = std::max(area.position.x, 0);
+	const int top = std::max(area.position.y, 0);
+	const int right = std::min(area.position.x + area.size.width, surface_.w());
+	const int bottom = std::min(area.position.y + area.size.height, surface_.h());
+	if (left >= right || top >= bottom)
+		return;
+
+	const Surface out = surface_.subregion(left, top, right - left, bottom - top);
+	for (int y = 0; y < out.h(); y++)
+		memset(out.at(0, y), TransparentColor, out.w());
+
+	// Same order as `DrawAutomap`: by row from the top, then from the left.
+	for (int row = -2; row <= mapSize_.width + mapSize_.height - 2; row++) {
+		for (int x = std::max(-1, row - mapSize_.height + 1); x <= std::min(mapSize_.width - 1, row + 1); x++) {
+			const Point map { x, row - x };
+			const Point center = GetTileCenter(map);
+			if (center.x + tileExtent_ < left || center.x - tileExtent_ >= right)
+				continue;
+			if (center.y + tileExtent_ < top || center.y - tileExtent_ >= bottom)
+				continue;
+			drawTile_(out, { center.x - left, center.y - top }, map);
+		}
+	}
+}
+
+void AutomapLayer::Composite(const Surface &out, Displacement offset) const
+{
+	const int left = std::max(offset.deltaX, 0);
+	const int top = std::max(offset.deltaY, 0);
+	const int right = std::min(offset.deltaX + surface_.w(), out.w());
+	const int bottom = std::min(offset.deltaY + surface_.h(), out.h());
+	if (left >= right || top >= bottom)
+		return;
+
+	constexpr uint64_t TransparentWord = ~uint64_t { 0 } / 0xFF * TransparentColor;
+	const int width = right - left;
+	for (int y = top; y < bottom; y++) {
+		const uint8_t *src = surface_.at(left - offset.deltaX, y - offset.deltaY);
+		uint8_t *dst = out.at(left, y);
+		int x = 0;
+		// The automap is mostly empty, skip it 8 pixels at a time.
+		for (; x + 8 <= width; x += 8) {
+			uint64_t word;
+			memcpy(&word, &src[x], sizeof(word));
+			if (word == TransparentWord)
+				continue;
+			for (int i = x; i < x + 8; i++) {
+				if (src[i] != TransparentColor)
+					dst[i] = src[i];
+			}
+		}
+		for (; x < width; x++) {
+			if (src[x] != TransparentColor)
+				dst[x] = src[x];
+		}
+	}
+}
+
+size_t AutomapLayer::MemoryUsage() const
+{
+	return static_cast<size_t>(surface_.pitch()) * surface_.h();
+}
+
+} // namespace devilution
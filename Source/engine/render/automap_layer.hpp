@@ -0,0 +1,111 @@
+/**
+ * @file automap_layer.hpp
+ *
+ * The automap rasterized once for a zoom level, so that it can be composited instead of being drawn line by line each frame.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "engine/point.hpp"
+#include "engine/rectangle.hpp"
+#include "engine/size.hpp"
+#include "engine/surface.hpp"
+
+namespace devilution {
+
+/**
+ * @brief An 8-bit layer with every automap tile drawn at one zoom level.
+ *
+ * Tiles are drawn in the same order as `DrawAutomap` draws them on screen, row by row from the top and from the left
+ * within a row, so that overlapping lines match. The layer covers the map tiles from -1 to `mapSize - 1` on both
+ * axes, pixels that no tile drew are `TransparentColor`.
+ */
+class AutomapLayer {
+public:
+	/** @brief Marks pixels that no tile drew, tiles must not use this color. */
+	static constexpr uint8_t TransparentColor = 255;
+
+	/**
+	 * @brief Draws the tile at `map` centered on `center`.
+	 *
+	 * The tile must stay within `tileExtent` pixels of its center.
+	 */
+	using DrawTileFn = void (*)(const Surface &out, Point center, Point map);
+
+	/**
+	 * @param mapSize Number of tiles on each axis
+	 * @param tileWidth Distance between two tiles of a row, `AmLine64`
+	 * @param rowHeight Distance between every other row, `AmLine32`
+	 * @param halfRowHeight Vertical offset of the rows in between, `AmLine16`
+	 * @param tileExtent How far tiles draw from their center, in both directions
+	 * @param rowParity Parity of `x + y` of the rows that are not shifted, the screen rows start from one of those
+	 */
+	AutomapLayer(Size mapSize, int tileWidth, int rowHeight, int halfRowHeight, int tileExtent, int rowParity, DrawTileFn drawTile);
+
+	/**
+	 * @brief Size of the surface of a layer, without allocating it.
+	 */
+	static Size GetLayerSize(Size mapSize, int tileWidth, int rowHeight, int halfRowHeight, int tileExtent);
+
+	/**
+	 * @brief Whether the rows are spaced evenly, in which case the layout is the same for both row parities.
+	 */
+	static bool IsEvenlySpaced(int tileWidth, int rowHeight, int halfRowHeight)
+	{
+		return tileWidth == 2 * rowHeight && rowHeight == 2 * halfRowHeight;
+	}
+
+	[[nodiscard]] bool HasMetrics(int tileWidth, int rowHeight, int halfRowHeight, int rowParity) const
+	{
+		return tileWidth_ == tileWidth && rowHeight_ == rowHeight && halfRowHeight_ == halfRowHeight && rowParity_ == rowParity;
+	}
+
+	/**
+	 * @brief Position of the center of a tile in the layer.
+	 */
+	[[nodiscard]] Point GetTileCenter(Point map) const;
+
+	/**
+	 * @brief Draws every tile again.
+	 */
+	void Redraw();
+
+	/**
+	 * @brief Draws the area of a tile again, along with the parts of the tiles overlapping it.
+	 */
+	void RedrawTile(Point map);
+
+	/**
+	 * @brief Copies the drawn pixels to `out`.
+	 * @param offset Position in `out` of the top left pixel of the layer
+	 */
+	void Composite(const Surface &out, Displacement offset) const;
+
+	[[nodiscard]] const Surface &GetSurface() const
+	{
+		return surface_;
+	}
+
+	[[nodiscard]] size_t MemoryUsage() const;
+
+private:
+	/** @brief Position of the center of a tile, relative to the center of tile 0, 0. */
+	[[nodiscard]] Point GetRelativeTileCenter(Point map) const;
+
+	void RedrawArea(Rectangle area);
+
+	Size mapSize_;
+	int tileWidth_;
+	int rowHeight_;
+	int halfRowHeight_;
+	int tileExtent_;
+	int rowParity_;
+	DrawTileFn drawTile_;
+	/** @brief Position of the center of tile 0, 0 in the layer. */
+	Displacement origin_;
+	OwnedSurface surface_;
+};
+
+} // namespace devilution
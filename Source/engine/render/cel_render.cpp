@@ -7,10 +7,12 @@
 
 #include <cstdint>
 #include <cstring>
+#include <vector>
 
 #include "engine/cel_header.hpp"
 #include "engine/render/common_impl.h"
 #include "engine/render/scrollrt.h"
+#include "engine/render/sprite_outline.hpp"
 #include "engine/trn.hpp"
 #include "options.h"
 #include "palette.h"
@@ -540,6 +542,26 @@ void RenderCelOutline(const Surface &out, Point position, const byte *src, std::
 	}
 }
 
+/**
+ * @brief Returns whether each pixel of a CEL frame casts an outline, starting from the bottom row.
+ */
+std::vector<bool> GetCelOutlineMask(const byte *src, int srcSize, int width, bool skipColorIndexZero)
+{
+	std::vector<bool> opaque;
+	const byte *srcEnd = src + srcSize;
+	while (src < srcEnd) {
+		auto v = static_cast<std::uint8_t>(*src++);
+		if (IsCelTransparent(v)) {
+			opaque.insert(opaque.end(), GetCelTransparentWidth(v), false);
+			continue;
+		}
+		for (const byte *end = src + v; src != end; src++)
+			opaque.push_back(!skipColorIndexZero || *src != byte { 0 });
+	}
+	opaque.resize((opaque.size() + width - 1) / width * width);
+	return opaque;
+}
+
 /**
  * @brief Blit CEL sprite to the given buffer, checks for drawing outside the buffer.
  * @param out Target buffer
@@ -673,6 +695,16 @@ void CelBlitOutlineTo(const Surface &out, uint8_t col, Point position, CelSprite
 {
 	int nDataSize;
 	const byte *src = CelGetFrameClipped(cel.Data(), frame, &nDataSize);
+	if (IsOutlineCacheEnabled()) {
+		const OutlineSource source = skipColorIndexZero ? OutlineSource::CelSkipColorIndexZero : OutlineSource::Cel;
+		const SpriteOutline *outline = FindCachedOutline(cel.Data(), frame, source);
+		if (outline == nullptr) {
+			const int width = cel.Width(frame);
+			outline = &CacheOutline(cel.Data(), frame, source, SpriteOutline(GetCelOutlineMask(src, nDataSize, width, skipColorIndexZero), width));
+		}
+		outline->Draw(out, position, col);
+		return;
+	}
 	if (skipColorIndexZero)
 		RenderCelOutline<true>(out, position, src, nDataSize, cel.Width(frame), col);
 	else
@@ -0,0 +1,120 @@
+/**
+ * @file cl2_atlas.cpp
+ *
+ * CL2 sprites decoded at load time into a format that is faster to draw.
+ */
+#include "engine/render/cl2_atlas.hpp"
+
+#include <unordered_map>
+
+#include "engine/cel_header.hpp"
+#include "engine/render/cl2_format.hpp"
+#include "utils/endian.hpp"
+
+namespace devilution {
+
+namespace {
+
+std::unordered_map<const byte *, Cl2Atlas> Atlases;
+
+} // namespace
+
+Cl2Atlas::Cl2Atlas(CelSprite sprite)
+{
+	const byte *data = sprite.Data();
+	const auto numFrames = static_cast<int>(LoadLE32(data));
+	sourceSize_ = LoadLE32(&data[(numFrames + 1) * sizeof(uint32_t)]);
+
+	frames_.reserve(numFrames);
+	for (int frame = 0; frame < numFrames; frame++) {
+		int frameSize;
+		const byte *frameData = CelGetFrameClipped(data, frame, &frameSize);
+		AddFrame(frameData, frameSize, sprite.Width(frame));
+	}
+
+	rows_.shrink_to_fit();
+	runs_.shrink_to_fit();
+	pixels_.shrink_to_fit();
+}
+
+void Cl2Atlas::AddFrame(const byte *src, size_t srcSize, uint16_t width)
+{
+	// The palette index of each pixel, or -1 where the frame is transparent.
+	std::vector<int16_t> decoded;
+	const byte *srcEnd = src + srcSize;
+	while (src < srcEnd) {
+		auto v = static_cast<std::uint8_t>(*src++);
+		if (!IsCl2Opaque(v)) {
+			decoded.insert(decoded.end(), v, -1);
+		} else if (IsCl2OpaqueFill(v)) {
+			decoded.insert(decoded.end(), GetCl2OpaqueFillWidth(v), static_cast<std::uint8_t>(*src++));
+		} else {
+			v = GetCl2OpaquePixelsWidth(v);
+			for (const byte *end = src + v; src != end; src++)
+				decoded.push_back(static_cast<std::uint8_t>(*src));
+		}
+	}
+
+	const size_t height = (decoded.size() + width - 1) / width;
+	decoded.resize(height * width, -1);
+	frames_.push_back(Frame { width, static_cast<uint16_t>(height), static_cast<uint32_t>(rows_.size()) });
+
+	for (size_t row = 0; row < height; row++) {
+		rows_.push_back(static_cast<uint32_t>(runs_.size()));
+		const int16_t *line = &decoded[row * width];
+		unsigned x = 0;
+		while (x < width) {
+			if (line[x] < 0) {
+				x++;
+				continue;
+			}
+			unsigned end = x + 1;
+			bool singleColor = true;
+			for (; end < width && line[end] >= 0; end++)
+				singleColor = singleColor && line[end] == line[x];
+
+			Run run { static_cast<uint16_t>(x), static_cast<uint16_t>(end - x), 0 };
+			if (singleColor) {
+				run.data = FillFlag | static_cast<uint32_t>(line[x]);
+			} else {
+				run.data = static_cast<uint32_t>(pixels_.size());
+				for (unsigned i = x; i < end; i++)
+					pixels_.push_back(static_cast<uint8_t>(line[i]));
+			}
+			runs_.push_back(run);
+			x = end;
+		}
+	}
+	rows_.push_back(static_cast<uint32_t>(runs_.size()));
+}
+
+size_t Cl2Atlas::MemoryUsage() const
+{
+	return sizeof(*this)
+	    + frames_.capacity() * sizeof(Frame)
+	    + rows_.capacity() * sizeof(uint32_t)
+	    + runs_.capacity() * sizeof(Run)
+	    + pixels_.capacity();
+}
+
+const Cl2Atlas &RegisterCl2Atlas(CelSprite sprite)
+{
+	return Atlases.try_emplace(sprite.Data(), sprite).first->second;
+}
+
+void UnregisterCl2Atlas(const byte *data)
+{
+	Atlases.erase(data);
+}
+
+const Cl2Atlas *FindCl2Atlas(const byte *data)
+{
+	if (Atlases.empty())
+		return nullptr;
+	const auto it = Atlases.find(data);
+	if (it == Atlases.end())
+		return nullptr;
+	return &it->second;
+}
+
+} // namespace devilution
@@ -0,0 +1,124 @@
+/**
+ * @file cl2_atlas.hpp
+ *
+ * CL2 sprites decoded at load time into a format that is faster to draw.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "engine/cel_sprite.hpp"
+
+namespace devilution {
+
+/**
+ * @brief The frames of a CL2 sprite, decoded into rows of opaque runs.
+ *
+ * Unlike CL2, every row can be found directly, so clipped rows are skipped without walking
+ * their data, and every uninterrupted span of opaque pixels is a single copy or fill.
+ * Like in CL2, the rows are stored from the bottom to the top.
+ */
+class Cl2Atlas {
+public:
+	/** @brief Marks runs of a single color in `Run::data`. */
+	static constexpr uint32_t FillFlag = 1U << 31;
+
+	struct Run {
+		/** @brief Horizontal position of the first pixel of the run. */
+		uint16_t x;
+		uint16_t width;
+		/** @brief Offset of the pixels in `Pixels()`, or the color with `FillFlag` set. */
+		uint32_t data;
+
+		[[nodiscard]] bool IsFill() const
+		{
+			return (data & FillFlag) != 0;
+		}
+
+		[[nodiscard]] uint8_t FillColor() const
+		{
+			return static_cast<uint8_t>(data);
+		}
+	};
+
+	struct Frame {
+		uint16_t width;
+		uint16_t height;
+		/** @brief Index of the first row of the frame in the row table. */
+		uint32_t firstRow;
+	};
+
+	/**
+	 * @brief Decodes every frame of a CL2 sprite.
+	 * @param sprite CL2 sprite for a single direction
+	 */
+	explicit Cl2Atlas(CelSprite sprite);
+
+	[[nodiscard]] int NumFrames() const
+	{
+		return static_cast<int>(frames_.size());
+	}
+
+	[[nodiscard]] const Frame &GetFrame(int frame) const
+	{
+		return frames_[frame];
+	}
+
+	/** @brief First run of `row`, counted from the bottom of `frame`. */
+	[[nodiscard]] const Run *RowBegin(const Frame &frame, int row) const
+	{
+		return &runs_[rows_[frame.firstRow + row]];
+	}
+
+	[[nodiscard]] const Run *RowEnd(const Frame &frame, int row) const
+	{
+		return &runs_[rows_[frame.firstRow + row + 1]];
+	}
+
+	[[nodiscard]] const uint8_t *Pixels() const
+	{
+		return pixels_.data();
+	}
+
+	/** @brief Size of the CL2 frames that were decoded, in bytes. */
+	[[nodiscard]] size_t SourceSize() const
+	{
+		return sourceSize_;
+	}
+
+	/** @brief Memory used by the decoded frames, in bytes. */
+	[[nodiscard]] size_t MemoryUsage() const;
+
+private:
+	void AddFrame(const byte *src, size_t srcSize, uint16_t width);
+
+	std::vector<Frame> frames_;
+	/** @brief For every frame, the index of the first run of each row, followed by the end of the last row. */
+	std::vector<uint32_t> rows_;
+	std::vector<Run> runs_;
+	std::vector<uint8_t> pixels_;
+	size_t sourceSize_ = 0;
+};
+
+/**
+ * @brief Decodes `sprite`, which is then drawn from the decoded frames until it is unregistered.
+ *
+ * Registering a sprite that is already registered returns the existing atlas.
+ * @param sprite CL2 sprite for a single direction
+ */
+const Cl2Atlas &RegisterCl2Atlas(CelSprite sprite);
+
+/**
+ * @brief Releases the decoded frames of a sprite, has to be called before its data is freed.
+ * @param data Data of a sprite, does nothing if it isn't registered
+ */
+void UnregisterCl2Atlas(const byte *data);
+
+/**
+ * @brief Returns the decoded frames of the sprite at `data` or nullptr if it isn't registered.
+ */
+const Cl2Atlas *FindCl2Atlas(const byte *data);
+
+} // namespace devilution
@@ -0,0 +1,43 @@
+/**
+ * @file cl2_format.hpp
+ *
+ * CL2 control bytes.
+ */
+#pragma once
+
+#include <cstdint>
+
+namespace devilution {
+
+/**
+ * CL2 is similar to CEL, with the following differences:
+ *
+ * 1. Transparent runs can cross line boundaries.
+ * 2. Control bytes are different, and the [0x80, 0xBE] control byte range
+ *    indicates a fill-N command.
+ */
+
+constexpr bool IsCl2Opaque(std::uint8_t control)
+{
+	constexpr std::uint8_t Cl2OpaqueMin = 0x80;
+	return control >= Cl2OpaqueMin;
+}
+
+constexpr std::uint8_t GetCl2OpaquePixelsWidth(std::uint8_t control)
+{
+	return -static_cast<std::int8_t>(control);
+}
+
+constexpr bool IsCl2OpaqueFill(std::uint8_t control)
+{
+	constexpr std::uint8_t Cl2FillMax = 0xBE;
+	return control <= Cl2FillMax;
+}
+
+constexpr std::uint8_t GetCl2OpaqueFillWidth(std::uint8_t control)
+{
+	constexpr std::uint8_t Cl2FillEnd = 0xBF;
+	return static_cast<std::int_fast16_t>(Cl2FillEnd - control);
+}
+
+} // namespace devilution
@@ -6,46 +6,19 @@
 #include "cl2_render.hpp"
 
 #include <algorithm>
+#include <vector>
 
 #include "engine/cel_header.hpp"
+#include "engine/render/cl2_atlas.hpp"
+#include "engine/render/cl2_format.hpp"
 #include "engine/render/common_impl.h"
 #include "engine/render/scrollrt.h"
+#include "engine/render/sprite_outline.hpp"
 #include "utils/attributes.h"
 
 namespace devilution {
 namespace {
 
-/**
- * CL2 is similar to CEL, with the following differences:
- *
- * 1. Transparent runs can cross line boundaries.
- * 2. Control bytes are different, and the [0x80, 0xBE] control byte range
- *    indicates a fill-N command.
- */
-
-constexpr bool IsCl2Opaque(std::uint8_t control)
-{
-	constexpr std::uint8_t Cl2OpaqueMin = 0x80;
-	return control >= Cl2OpaqueMin;
-}
-
-constexpr std::uint8_t GetCl2OpaquePixelsWidth(std::uint8_t control)
-{
-	return -static_cast<std::int8_t>(control);
-}
-
-constexpr bool IsCl2OpaqueFill(std::uint8_t control)
-{
-	constexpr std::uint8_t Cl2FillMax = 0xBE;
-	return control <= Cl2FillMax;
-}
-
-constexpr std::uint8_t GetCl2OpaqueFillWidth(std::uint8_t control)
-{
-	constexpr std::uint8_t Cl2FillEnd = 0xBF;
-	return static_cast<std::int_fast16_t>(Cl2FillEnd - control);
-}
-
 struct SkipSize {
 	std::int_fast16_t wholeLines;
 	std::int_fast16_t xOffset;
@@ -262,19 +235,67 @@ DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void RenderCl2(
 	}
 }
 
+/** Renders a frame decoded by a `Cl2Atlas` to the output buffer. */
+template <typename RenderPixels, typename RenderFill>
+DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void RenderCl2Atlas(
+    const Surface &out, Point position, const Cl2Atlas &atlas, const Cl2Atlas::Frame &frame,
+    const RenderPixels &renderPixels, const RenderFill &renderFill)
+{
+	const ClipX clipX = CalculateClipX(position.x, frame.width, out);
+	if (clipX.width <= 0)
+		return;
+	const int clipLeft = static_cast<int>(clipX.left);
+	const int clipRight = clipLeft + static_cast<int>(clipX.width);
+
+	// Rows are stored from the bottom, `position` is the bottom left corner.
+	const int firstRow = std::max(position.y - out.h() + 1, 0);
+	const int endRow = std::min(position.y + 1, static_cast<int>(frame.height));
+	const std::uint8_t *pixels = atlas.Pixels();
+	for (int row = firstRow; row < endRow; row++) {
+		std::uint8_t *dst = &out[{ position.x + clipLeft, position.y - row }];
+		const Cl2Atlas::Run *rowEnd = atlas.RowEnd(frame, row);
+		for (const Cl2Atlas::Run *run = atlas.RowBegin(frame, row); run != rowEnd; ++run) {
+			const int begin = std::max(static_cast<int>(run->x), clipLeft);
+			const int end = std::min(run->x + run->width, clipRight);
+			if (begin >= end)
+				continue;
+			if (run->IsFill())
+				renderFill(dst + (begin - clipLeft), run->FillColor(), end - begin);
+			else
+				renderPixels(dst + (begin - clipLeft), pixels + run->data + (begin - run->x), end - begin);
+		}
+	}
+}
+
+/** Renders a CL2 frame, using the decoded frame when the sprite has a registered `Cl2Atlas`. */
+template <typename RenderPixels, typename RenderFill>
+DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void RenderCl2Frame(
+    const Surface &out, Point position, CelSprite cel, int frame,
+    const RenderPixels &renderPixels, const RenderFill &renderFill)
+{
+	const Cl2Atlas *atlas = FindCl2Atlas(cel.Data());
+	if (atlas != nullptr) {
+		RenderCl2Atlas(out, position, *atlas, atlas->GetFrame(frame), renderPixels, renderFill);
+		return;
+	}
+
+	int nDataSize;
+	const byte *pRLEBytes = CelGetFrameClipped(cel.Data(), frame, &nDataSize);
+	RenderCl2(out, position, pRLEBytes, nDataSize, cel.Width(frame), renderPixels, renderFill);
+}
+
 /**
  * @brief Blit CL2 sprite to the given buffer
  * @param out Target buffer
  * @param sx Target buffer coordinate
  * @param sy Target buffer coordinate
- * @param pRLEBytes CL2 pixel stream (run-length encoded)
- * @param nDataSize Size of CL2 in bytes
- * @param nWidth Width of sprite
+ * @param cel CL2 sprite
+ * @param frame Frame number
  */
-void Cl2BlitSafe(const Surface &out, int sx, int sy, const byte *pRLEBytes, int nDataSize, int nWidth)
+void Cl2BlitSafe(const Surface &out, int sx, int sy, CelSprite cel, int frame)
 {
-	RenderCl2(
-	    out, { sx, sy }, pRLEBytes, nDataSize, nWidth,
+	RenderCl2Frame(
+	    out, { sx, sy }, cel, frame,
 #ifndef DEBUG_RENDER_COLOR
 	    [](std::uint8_t *dst, const std::uint8_t *src, std::size_t w) {
 		    std::memcpy(dst, src, w);
@@ -298,15 +319,14 @@ void Cl2BlitSafe(const Surface &out, int sx, int sy, const byte *pRLEBytes, int
  * @param out Target buffer
  * @param sx Target buffer coordinate
  * @param sy Target buffer coordinate
- * @param pRLEBytes CL2 pixel stream (run-length encoded)
- * @param nDataSize Size of CL2 in bytes
- * @param nWidth With of CL2 sprite
+ * @param cel CL2 sprite
+ * @param frame Frame number
  * @param pTable Light color table
  */
-void Cl2BlitLightSafe(const Surface &out, int sx, int sy, const byte *pRLEBytes, int nDataSize, int nWidth, uint8_t *pTable)
+void Cl2BlitLightSafe(const Surface &out, int sx, int sy, CelSprite cel, int frame, uint8_t *pTable)
 {
-	RenderCl2(
-	    out, { sx, sy }, pRLEBytes, nDataSize, nWidth,
+	RenderCl2Frame(
+	    out, { sx, sy }, cel, frame,
 #ifndef DEBUG_RENDER_COLOR
 	    [pTable](std::uint8_t *dst, const std::uint8_t *src, std::size_t w) {
 		    while (w-- > 0)
@@ -743,6 +763,29 @@ void RenderCl2Outline(const Surface &out, Point position, const byte *src, std::
 	}
 }
 
+/**
+ * @brief Returns whether each pixel of a CL2 frame casts an outline, starting from the bottom row.
+ */
+std::vector<bool> GetCl2OutlineMask(const byte *src, int srcSize, int width)
+{
+	std::vector<bool> opaque;
+	const byte *srcEnd = src + srcSize;
+	while (src < srcEnd) {
+		auto v = static_cast<std::uint8_t>(*src++);
+		if (!IsCl2Opaque(v)) {
+			opaque.insert(opaque.end(), v, false);
+		} else if (IsCl2OpaqueFill(v)) {
+			opaque.insert(opaque.end(), GetCl2OpaqueFillWidth(v), *src++ != byte { 0 });
+		} else {
+			v = GetCl2OpaquePixelsWidth(v);
+			for (const byte *end = src + v; src != end; src++)
+				opaque.push_back(*src != byte { 0 });
+		}
+	}
+	opaque.resize((opaque.size() + width - 1) / width * width);
+	return opaque;
+}
+
 } // namespace
 
 void Cl2ApplyTrans(byte *p, const std::array<uint8_t, 256> &ttbl, int numFrames)
@@ -782,10 +825,7 @@ void Cl2Draw(const Surface &out, int sx, int sy, CelSprite cel, int frame)
 {
 	assert(frame >= 0);
 
-	int nDataSize;
-	const byte *pRLEBytes = CelGetFrameClipped(cel.Data(), frame, &nDataSize);
-
-	Cl2BlitSafe(out, sx, sy, pRLEBytes, nDataSize, cel.Width(frame));
+	Cl2BlitSafe(out, sx, sy, cel, frame);
 }
 
 void Cl2DrawOutline(const Surface &out, uint8_t col, int sx, int sy, CelSprite cel, int frame)
@@ -795,6 +835,16 @@ void Cl2DrawOutline(const Surface &out, uint8_t col, int sx, int sy, CelSprite c
 	int nDataSize;
 	const byte *pRLEBytes = CelGetFrameClipped(cel.Data(), frame, &nDataSize);
 
+	if (IsOutlineCacheEnabled()) {
+		const SpriteOutline *outline = FindCachedOutline(cel.Data(), frame, OutlineSource::Cl2);
+		if (outline == nullptr) {
+			const int width = cel.Width(frame);
+			outline = &CacheOutline(cel.Data(), frame, OutlineSource::Cl2, SpriteOutline(GetCl2OutlineMask(pRLEBytes, nDataSize, width), width));
+		}
+		outline->Draw(out, { sx, sy }, col);
+		return;
+	}
+
 	RenderCl2Outline(out, { sx, sy }, pRLEBytes, nDataSize, cel.Width(frame), col);
 }
 
@@ -802,22 +852,17 @@ void Cl2DrawTRN(const Surface &out, int sx, int sy, CelSprite cel, int frame, ui
 {
 	assert(frame >= 0);
 
-	int nDataSize;
-	const byte *pRLEBytes = CelGetFrameClipped(cel.Data(), frame, &nDataSize);
-	Cl2BlitLightSafe(out, sx, sy, pRLEBytes, nDataSize, cel.Width(frame), trn);
+	Cl2BlitLightSafe(out, sx, sy, cel, frame, trn);
 }
 
 void Cl2DrawLight(const Surface &out, int sx, int sy, CelSprite cel, int frame)
 {
 	assert(frame >= 0);
 
-	int nDataSize;
-	const byte *pRLEBytes = CelGetFrameClipped(cel.Data(), frame, &nDataSize);
-
 	if (LightTableIndex != 0)
-		Cl2BlitLightSafe(out, sx, sy, pRLEBytes, nDataSize, cel.Width(frame), &LightTables[LightTableIndex * 256]);
+		Cl2BlitLightSafe(out, sx, sy, cel, frame, &LightTables[LightTableIndex * 256]);
 	else
-		Cl2BlitSafe(out, sx, sy, pRLEBytes, nDataSize, cel.Width(frame));
+		Cl2BlitSafe(out, sx, sy, cel, frame);
 }
 
 } // namespace devilution
@@ -3,9 +3,11 @@
  *
  * Implementation of functionality for rendering the dungeons, monsters and calling other render routines.
  */
+#include "engine/render/scrollrt.h"
 
 #include "DiabloUI/ui_flags.hpp"
 #include "automap.h"
+#include "control.h"
 #include "controls/plrctrls.h"
 #include "controls/touch/renderers.h"
 #include "cursor.h"
@@ -16,6 +18,7 @@
 #include "engine/render/cl2_render.hpp"
 #include "engine/render/dun_render.hpp"
 #include "engine/render/text_render.hpp"
+#include "engine/surface.hpp"
 #include "engine/trn.hpp"
 #include "error.h"
 #include "gmenu.h"
@@ -40,6 +43,9 @@
 #include "utils/display.h"
 #include "utils/endian.hpp"
 #include "utils/log.hpp"
+#include "utils/sdl_geometry.h"
+#include "utils/stdcompat/optional.hpp"
+#include "utils/upscale.hpp"
 
 #ifdef _DEBUG
 #include "debug.h"
@@ -209,6 +215,8 @@ Bitset2d<MAXDUNX, MAXDUNY> dRendered;
 int frameend;
 int framerate;
 int framestart;
+/** Frame timing over the last second, see `GetPresentStats` */
+PresentStats presentStats;
 
 const char *const PlayerModeNames[] = {
 	"standing",
@@ -1034,43 +1042,28 @@ void Zoom(const Surface &out)
 		}
 	}
 
-	// We round to even for the source width and height.
-	// If the width / height was odd, we copy just one extra pixel / row later on.
-	const int srcWidth = (viewportWidth + 1) / 2;
+	// Each source pixel and row is doubled.
+	// If the width / height is odd, the first pixel / row is copied just once.
 	const int doubleableWidth = viewportWidth / 2;
-	const int srcHeight = (out.h() + 1) / 2;
-	const int doubleableHeight = out.h() / 2;
-
-	BYTE *src = out.at(srcWidth - 1, srcHeight - 1);
-	BYTE *dst = out.at(viewportOffsetX + viewportWidth - 1, out.h() - 1);
-	const bool oddViewportWidth = (viewportWidth % 2) == 1;
-
-	for (int hgt = 0; hgt < doubleableHeight; hgt++) {
-		// Double the pixels in the line.
-		for (int i = 0; i < doubleableWidth; i++) {
-			*dst-- = *src;
-			*dst-- = *src;
-			--src;
-		}
-
-		// Copy a single extra pixel if the output width is odd.
-		if (oddViewportWidth) {
-			*dst-- = *src;
-			--src;
-		}
-
-		// Skip the rest of the source line.
-		src -= (out.pitch() - srcWidth);
-
-		// Double the line.
-		memcpy(dst - out.pitch() + 1, dst + 1, viewportWidth);
+	const int oddViewportWidth = viewportWidth % 2;
+	const int oddHeight = out.h() % 2;
+
+	// The output overlaps the source, so we go from the bottom right to the top left
+	// to never overwrite a source pixel before it is read.
+	const auto zoomRow = [&](int y) {
+		const uint8_t *src = out.at(0, (y + oddHeight) / 2);
+		uint8_t *dst = out.at(viewportOffsetX, y);
+		DoublePixels(src + oddViewportWidth, dst + oddViewportWidth, doubleableWidth);
+		if (oddViewportWidth == 1)
+			dst[0] = src[0];
+	};
 
-		// Skip the rest of the destination line.
-		dst -= 2 * out.pitch() - viewportWidth;
-	}
-	if ((out.h() % 2) == 1) {
-		memcpy(dst - out.pitch() + 1, dst + 1, viewportWidth);
+	for (int y = out.h() - 1; y > oddHeight; y -= 2) {
+		zoomRow(y);
+		memcpy(out.at(viewportOffsetX, y - 1), out.at(viewportOffsetX, y), viewportWidth);
 	}
+	if (oddHeight == 1)
+		zoomRow(0);
 }
 
 Displacement tileOffset;
@@ -1326,7 +1319,7 @@ void DrawView(const Surface &out, Point startPosition)
  */
 void DrawFPS(const Surface &out)
 {
-	char string[12];
+	char string[32];
 
 	if (!frameflag || !gbActive) {
 		return;
@@ -1339,9 +1332,12 @@ void DrawFPS(const Surface &out)
 		framestart = tc;
 		framerate = 1000 * frameend / frames;
 		frameend = 0;
+		presentStats = GetPresentStats();
 	}
 	snprintf(string, 12, "%i FPS", framerate);
 	DrawString(out, string, Point { 8, 68 }, UiFlags::ColorRed);
+	snprintf(string, sizeof(string), "%.1f / %.1f ms", presentStats.frameTime, presentStats.presentLatency);
+	DrawString(out, string, Point { 8, 82 }, UiFlags::ColorRed);
 }
 
 /**
@@ -1365,16 +1361,137 @@ void DoBlitScreen(Sint16 dwX, Sint16 dwY, Uint16 dwWdt, Uint16 dwHgt)
 	BltFast(&srcRect, &dstRect);
 }
 
+/** @brief Panel components to redraw in the next frame, one bit per PanelDrawComponent. */
+uint32_t RedrawComponentBitmap;
+
+constexpr uint32_t AllPanelComponents = (1U << (static_cast<unsigned>(PanelDrawComponent::LAST) + 1)) - 1;
+
+/** @brief The info box is drawn with the viewport, so it is never restored from the panel layer. */
+constexpr Rectangle InfoBoxArea { { 177, 46 }, { 288, 63 } };
+
+/**
+ * @brief Copy of the main panel as it was last drawn, without the cursor.
+ *
+ * When the viewport is drawn under the panel, the panel is restored from it instead of being redrawn.
+ */
+std::optional<OwnedSurface> PanelLayer;
+/** @brief Where the main panel was on screen when the layer was captured. */
+Rectangle PanelLayerArea;
+
+bool IsPanelLayerValid()
+{
+	const Rectangle &mainPanel = GetMainPanel();
+	return PanelLayer && PanelLayerArea.position == mainPanel.position && PanelLayerArea.size == mainPanel.size;
+}
+
+/**
+ * @brief Calls `f` with each area of the main panel covered by a component, relative to the panel.
+ */
+template <typename F>
+void ForEachComponentArea(PanelDrawComponent component, F &&f)
+{
+	switch (component) {
+	case PanelDrawComponent::Health:
+		f(Rectangle { { 96, 0 }, { 88, 72 } });
+		break;
+	case PanelDrawComponent::Mana:
+		f(Rectangle { { 460, 0 }, { 88, 72 } });
+		f(Rectangle { { 564, 64 }, { 56, 56 } });
+		break;
+	case PanelDrawComponent::ControlButtons:
+		f(Rectangle { { 8, 5 }, { 72, 119 } });
+		f(Rectangle { { 556, 5 }, { 72, 48 } });
+		if (gbIsMultiplayer) {
+			f(Rectangle { { 84, 91 }, { 36, 32 } });
+			f(Rectangle { { 524, 91 }, { 36, 32 } });
+		}
+		break;
+	case PanelDrawComponent::Belt:
+		f(Rectangle { { 204, 5 }, { 232, 28 } });
+		break;
+	case PanelDrawComponent::ExperienceBar:
+		f(Rectangle { { GetMainPanel().size.width / 2 - 155, GetMainPanel().size.height - 11 }, { 313, 9 } });
+		break;
+	}
+}
+
+/**
+ * @brief Calls `f` with each area of the main panel covered by a component that has to be redrawn.
+ */
+template <typename F>
+void ForEachRedrawArea(uint32_t components, F &&f)
+{
+	for (unsigned i = static_cast<unsigned>(PanelDrawComponent::FIRST); i <= static_cast<unsigned>(PanelDrawComponent::LAST); i++) {
+		if ((components & (1U << i)) != 0)
+			ForEachComponentArea(static_cast<PanelDrawComponent>(i), f);
+	}
+}
+
+Point ToScreen(Point panelPosition)
+{
+	return GetMainPanel().position + Displacement { panelPosition.x, panelPosition.y };
+}
+
+void CapturePanelLayer(const Surface &out, Rectangle area)
+{
+	const Point position = ToScreen(area.position);
+	PanelLayer->BlitFrom(out, MakeSdlRect(position.x, position.y, area.size.width, area.size.height), area.position);
+}
+
+void RestorePanelLayer(const Surface &out, Rectangle area)
+{
+	out.BlitFrom(*PanelLayer, MakeSdlRect(area), ToScreen(area.position));
+}
+
+/**
+ * @brief Restores the main panel from the layer, except for the info box.
+ */
+void RestorePanel(const Surface &out)
+{
+	const Size panelSize = GetMainPanel().size;
+	const int infoBoxRight = InfoBoxArea.position.x + InfoBoxArea.size.width;
+	const int infoBoxBottom = InfoBoxArea.position.y + InfoBoxArea.size.height;
+	RestorePanelLayer(out, { { 0, 0 }, { panelSize.width, InfoBoxArea.position.y } });
+	RestorePanelLayer(out, { { 0, InfoBoxArea.position.y }, { InfoBoxArea.position.x, InfoBoxArea.size.height } });
+	RestorePanelLayer(out, { { infoBoxRight, InfoBoxArea.position.y }, { panelSize.width - infoBoxRight, InfoBoxArea.size.height } });
+	RestorePanelLayer(out, { { 0, infoBoxBottom }, { panelSize.width, panelSize.height - infoBoxBottom } });
+}
+
+#ifdef _DEBUG
+void DrawRectangleOutline(const Surface &out, Rectangle area, uint8_t color)
+{
+	const Point &position = area.position;
+	const Size &size = area.size;
+	DrawHorizontalLine(out, position, size.width, color);
+	DrawHorizontalLine(out, position + Displacement { 0, size.height - 1 }, size.width, color);
+	DrawVerticalLine(out, position, size.height, color);
+	DrawVerticalLine(out, position + Displacement { size.width - 1, 0 }, size.height, color);
+}
+
+/**
+ * @brief Outlines the parts of the screen that are presented this frame.
+ */
+void DrawDamagedAreas(const Surface &out, int dwHgt, bool drawDesc, uint32_t redrawComponents)
+{
+	if (dwHgt > 0)
+		DrawRectangleOutline(out, { { 0, 0 }, { gnScreenWidth, dwHgt } }, PAL16_YELLOW);
+	if (dwHgt >= gnScreenHeight)
+		return;
+	if (drawDesc)
+		DrawRectangleOutline(out, { ToScreen(InfoBoxArea.position), InfoBoxArea.size }, PAL16_BLUE);
+	ForEachRedrawArea(redrawComponents, [&](Rectangle area) {
+		DrawRectangleOutline(out, { ToScreen(area.position), area.size }, PAL16_RED);
+	});
+}
+#endif
+
 /**
  * @brief Check render pipeline and blit individual screen parts
  * @param dwHgt Section of screen to update from top to bottom
- * @param draw_desc Render info box
- * @param draw_hp Render health bar
- * @param draw_mana Render mana bar
- * @param draw_sbar Render belt
- * @param draw_btn Render panel buttons
+ * @param drawDesc Render info box
+ * @param redrawComponents Panel components to update, one bit per PanelDrawComponent
  */
-void DrawMain(int dwHgt, bool drawDesc, bool drawHp, bool drawMana, bool drawSbar, bool drawBtn)
+void DrawMain(int dwHgt, bool drawDesc, uint32_t redrawComponents)
 {
 	if (!gbActive || RenderDirectlyToOutputSurface) {
 		return;
@@ -1386,28 +1503,14 @@ void DrawMain(int dwHgt, bool drawDesc, bool drawHp, bool drawMana, bool drawSba
 		DoBlitScreen(0, 0, gnScreenWidth, dwHgt);
 	}
 	if (dwHgt < gnScreenHeight) {
-		const Point mainPanelPosition = GetMainPanel().position;
-		if (drawSbar) {
-			DoBlitScreen(mainPanelPosition.x + 204, mainPanelPosition.y + 5, 232, 28);
-		}
 		if (drawDesc) {
-			DoBlitScreen(mainPanelPosition.x + 176, mainPanelPosition.y + 46, 288, 63);
-		}
-		if (drawMana) {
-			DoBlitScreen(mainPanelPosition.x + 460, mainPanelPosition.y, 88, 72);
-			DoBlitScreen(mainPanelPosition.x + 564, mainPanelPosition.y + 64, 56, 56);
-		}
-		if (drawHp) {
-			DoBlitScreen(mainPanelPosition.x + 96, mainPanelPosition.y, 88, 72);
-		}
-		if (drawBtn) {
-			DoBlitScreen(mainPanelPosition.x + 8, mainPanelPosition.y + 5, 72, 119);
-			DoBlitScreen(mainPanelPosition.x + 556, mainPanelPosition.y + 5, 72, 48);
-			if (gbIsMultiplayer) {
-				DoBlitScreen(mainPanelPosition.x + 84, mainPanelPosition.y + 91, 36, 32);
-				DoBlitScreen(mainPanelPosition.x + 524, mainPanelPosition.y + 91, 36, 32);
-			}
+			const Point position = ToScreen(InfoBoxArea.position);
+			DoBlitScreen(position.x, position.y, InfoBoxArea.size.width, InfoBoxArea.size.height);
 		}
+		ForEachRedrawArea(redrawComponents, [](Rectangle area) {
+			const Point position = ToScreen(area.position);
+			DoBlitScreen(position.x, position.y, area.size.width, area.size.height);
+		});
 		if (sgdwCursWdtOld != 0) {
 			DoBlitScreen(sgdwCursXOld, sgdwCursYOld, sgdwCursWdtOld, sgdwCursHgtOld);
 		}
@@ -1675,7 +1778,7 @@ void scrollrt_draw_game_screen()
 		DrawCursor(GlobalBackBuffer());
 	}
 
-	DrawMain(hgt, false, false, false, false, false);
+	DrawMain(hgt, false, 0);
 
 	RenderPresent();
 
@@ -1684,6 +1787,16 @@ void scrollrt_draw_game_screen()
 	}
 }
 
+void RedrawComponent(PanelDrawComponent component)
+{
+	RedrawComponentBitmap |= 1U << static_cast<unsigned>(component);
+}
+
+bool IsRedrawComponent(PanelDrawComponent component)
+{
+	return (RedrawComponentBitmap & (1U << static_cast<unsigned>(component))) != 0;
+}
+
 void DrawAndBlit()
 {
 	if (!gbRunGame) {
@@ -1693,21 +1806,26 @@ void DrawAndBlit()
 	int hgt = 0;
 	bool ddsdesc = false;
 	bool ctrlPan = false;
+	bool restorePanel = false;
 
 	const Rectangle &mainPanel = GetMainPanel();
 
-	if (gnScreenWidth > mainPanel.size.width || force_redraw == 255 || IsHighlightingLabelsEnabled()) {
-		drawhpflag = true;
-		drawmanaflag = true;
-		drawbtnflag = true;
-		drawsbarflag = true;
-		ddsdesc = false;
+	if (force_redraw == 255 || talkflag || !IsPanelLayerValid()) {
+		RedrawComponentBitmap = AllPanelComponents;
 		ctrlPan = true;
 		hgt = gnScreenHeight;
-	} else if (force_redraw == 1) {
-		ddsdesc = true;
-		ctrlPan = false;
-		hgt = gnViewportHeight;
+	} else {
+		// Whatever is drawn under the panel is covered again with the last drawn panel.
+		restorePanel = gnScreenWidth > mainPanel.size.width || IsHighlightingLabelsEnabled();
+#ifdef _DEBUG
+		restorePanel = restorePanel || DebugDamagedAreas;
+#endif
+		if (restorePanel) {
+			hgt = gnScreenHeight;
+		} else if (force_redraw == 1) {
+			ddsdesc = true;
+			hgt = gnViewportHeight;
+		}
 	}
 
 	force_redraw = 0;
@@ -1718,33 +1836,61 @@ void DrawAndBlit()
 	nthread_UpdateProgressToNextGameTick();
 
 	DrawView(out, ViewPosition);
+	CheckXPBarRedraw();
+
 	if (ctrlPan) {
 		DrawCtrlPan(out);
+	} else {
+		if (restorePanel)
+			RestorePanel(out);
+		ForEachRedrawArea(RedrawComponentBitmap, [&](Rectangle area) {
+			DrawPanelBox(out, MakeSdlRect(area.position.x, area.position.y + 16, area.size.width, area.size.height), ToScreen(area.position));
+		});
 	}
-	if (drawhpflag) {
+	if (IsRedrawComponent(PanelDrawComponent::Health)) {
 		DrawLifeFlaskLower(out);
 	}
-	if (drawmanaflag) {
+	if (IsRedrawComponent(PanelDrawComponent::Mana)) {
 		DrawManaFlaskLower(out);
 
 		DrawSpell(out);
 	}
-	if (drawbtnflag) {
+	if (IsRedrawComponent(PanelDrawComponent::ControlButtons)) {
 		DrawCtrlBtns(out);
 	}
-	if (drawsbarflag) {
+	if (IsRedrawComponent(PanelDrawComponent::Belt)) {
 		DrawInvBelt(out);
 	}
 	if (talkflag) {
 		DrawTalkPan(out);
-		hgt = gnScreenHeight;
 	}
-	DrawXPBar(out);
-	if (*sgOptions.Graphics.showHealthValues)
+	if (IsRedrawComponent(PanelDrawComponent::ExperienceBar)) {
+		DrawXPBar(out);
+	}
+	if (*sgOptions.Graphics.showHealthValues && IsRedrawComponent(PanelDrawComponent::Health))
 		DrawFlaskValues(out, { mainPanel.position.x + 134, mainPanel.position.y + 28 }, MyPlayer->_pHitPoints >> 6, MyPlayer->_pMaxHP >> 6);
-	if (*sgOptions.Graphics.showManaValues)
+	if (*sgOptions.Graphics.showManaValues && IsRedrawComponent(PanelDrawComponent::Mana))
 		DrawFlaskValues(out, { mainPanel.position.x + mainPanel.size.width - 138, mainPanel.position.y + 28 }, MyPlayer->_pMana >> 6, MyPlayer->_pMaxMana >> 6);
 
+	if (ctrlPan) {
+		if (!IsPanelLayerValid()) {
+			PanelLayer.emplace(mainPanel.size);
+			PanelLayerArea = mainPanel;
+		}
+		CapturePanelLayer(out, { { 0, 0 }, mainPanel.size });
+	} else {
+		ForEachRedrawArea(RedrawComponentBitmap, [&](Rectangle area) {
+			CapturePanelLayer(out, area);
+		});
+	}
+
+#ifdef _DEBUG
+	if (DebugDamagedAreas) {
+		DrawDamagedAreas(out, hgt, ddsdesc, RedrawComponentBitmap);
+		hgt = gnScreenHeight;
+	}
+#endif
+
 	if (IsHardwareCursor()) {
 		SetHardwareCursorVisible(ShouldShowCursor());
 	} else {
@@ -1753,14 +1899,11 @@ void DrawAndBlit()
 
 	DrawFPS(out);
 
-	DrawMain(hgt, ddsdesc, drawhpflag, drawmanaflag, drawsbarflag, drawbtnflag);
+	DrawMain(hgt, ddsdesc, RedrawComponentBitmap);
 
 	RenderPresent();
 
-	drawhpflag = false;
-	drawmanaflag = false;
-	drawbtnflag = false;
-	drawsbarflag = false;
+	RedrawComponentBitmap = 0;
 }
 
 } // namespace devilution
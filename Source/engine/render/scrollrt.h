@@ -34,6 +34,31 @@ extern int level_piece_id;
 extern bool AutoMapShowItems;
 extern bool frameflag;
 
+/**
+ * @brief The parts of the main panel that are only redrawn and presented when they change.
+ */
+enum class PanelDrawComponent : uint8_t {
+	Health,
+	/** @brief The mana flask and the current spell icon. */
+	Mana,
+	ControlButtons,
+	Belt,
+	ExperienceBar,
+
+	FIRST = Health,
+	LAST = ExperienceBar
+};
+
+/**
+ * @brief Marks a panel component as changed, so it gets redrawn and presented in the next frame.
+ */
+void RedrawComponent(PanelDrawComponent component);
+
+/**
+ * @brief Returns whether a panel component is redrawn in the next frame.
+ */
+bool IsRedrawComponent(PanelDrawComponent component);
+
 /**
  * @brief Returns the offset for the walking animation
  * @param animationInfo the current active walking animation
@@ -99,6 +124,8 @@ void scrollrt_draw_game_screen();
 
 /**
  * @brief Render the game
+ *
+ * The main panel is kept in a layer that is restored each frame, only the changed components are redrawn on top of it.
  */
 void DrawAndBlit();
 
@@ -0,0 +1,164 @@
+/**
+ * @file sprite_outline.cpp
+ *
+ * Outlines of sprite frames, and a cache of the recently drawn ones.
+ */
+#include "engine/render/sprite_outline.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <list>
+#include <unordered_map>
+
+namespace devilution {
+
+namespace {
+
+struct OutlineKey {
+	const byte *data;
+	int frame;
+	OutlineSource source;
+
+	bool operator==(const OutlineKey &other) const
+	{
+		return data == other.data && frame == other.frame && source == other.source;
+	}
+};
+
+struct OutlineKeyHash {
+	size_t operator()(const OutlineKey &key) const
+	{
+		return std::hash<const byte *>()(key.data) ^ (static_cast<size_t>(key.frame) << 2) ^ static_cast<size_t>(key.source);
+	}
+};
+
+struct CachedOutline {
+	OutlineKey key;
+	SpriteOutline outline;
+};
+
+/** @brief The cached outlines, the most recently used first. */
+std::list<CachedOutline> CachedOutlines;
+std::unordered_map<OutlineKey, std::list<CachedOutline>::iterator, OutlineKeyHash> CachedOutlinesByKey;
+size_t OutlineCacheCapacity = 256;
+
+void TrimOutlineCache()
+{
+	while (CachedOutlines.size() > OutlineCacheCapacity) {
+		CachedOutlinesByKey.erase(CachedOutlines.back().key);
+		CachedOutlines.pop_back();
+	}
+}
+
+} // namespace
+
+SpriteOutline::SpriteOutline(const std::vector<bool> &opaque, int width)
+    : width_(width + 2)
+    , height_(static_cast<int>(opaque.size()) / width + 2)
+{
+	// Row 0 is the one below the frame and column 0 the one left of it.
+	std::vector<bool> outline(width_ * height_);
+	for (int row = 0; row < height_ - 2; row++) {
+		for (int x = 0; x < width; x++) {
+			if (!opaque[row * width + x])
+				continue;
+			outline[row * width_ + x + 1] = true;
+			outline[(row + 1) * width_ + x] = true;
+			outline[(row + 1) * width_ + x + 2] = true;
+			outline[(row + 2) * width_ + x + 1] = true;
+		}
+	}
+
+	rows_.reserve(height_ + 1);
+	for (int row = 0; row < height_; row++) {
+		rows_.push_back(static_cast<uint32_t>(spans_.size()));
+		int x = 0;
+		while (x < width_) {
+			if (!outline[row * width_ + x]) {
+				x++;
+				continue;
+			}
+			int end = x + 1;
+			while (end < width_ && outline[row * width_ + end])
+				end++;
+			spans_.push_back(Span { static_cast<int16_t>(x), static_cast<uint16_t>(end - x) });
+			x = end;
+		}
+	}
+	rows_.push_back(static_cast<uint32_t>(spans_.size()));
+	spans_.shrink_to_fit();
+}
+
+void SpriteOutline::Draw(const Surface &out, Point position, uint8_t color) const
+{
+	const int left = position.x - 1;
+	const int bottom = position.y + 1;
+	const int firstRow = std::max(bottom - out.h() + 1, 0);
+	const int endRow = std::min(bottom + 1, height_);
+	const int dstWidth = out.w();
+	for (int row = firstRow; row < endRow; row++) {
+		std::uint8_t *dst = &out[{ 0, bottom - row }];
+		for (uint32_t i = rows_[row]; i < rows_[row + 1]; i++) {
+			const Span &span = spans_[i];
+			const int begin = std::max(left + span.x, 0);
+			const int end = std::min(left + span.x + span.width, dstWidth);
+			if (begin < end)
+				std::memset(dst + begin, color, end - begin);
+		}
+	}
+}
+
+size_t SpriteOutline::MemoryUsage() const
+{
+	return sizeof(*this) + rows_.capacity() * sizeof(uint32_t) + spans_.capacity() * sizeof(Span);
+}
+
+void SetOutlineCacheCapacity(size_t capacity)
+{
+	OutlineCacheCapacity = capacity;
+	TrimOutlineCache();
+}
+
+bool IsOutlineCacheEnabled()
+{
+	return OutlineCacheCapacity != 0;
+}
+
+const SpriteOutline *FindCachedOutline(const byte *data, int frame, OutlineSource source)
+{
+	const auto it = CachedOutlinesByKey.find(OutlineKey { data, frame, source });
+	if (it == CachedOutlinesByKey.end())
+		return nullptr;
+	CachedOutlines.splice(CachedOutlines.begin(), CachedOutlines, it->second);
+	return &it->second->outline;
+}
+
+const SpriteOutline &CacheOutline(const byte *data, int frame, OutlineSource source, SpriteOutline &&outline)
+{
+	const OutlineKey key { data, frame, source };
+	CachedOutlines.push_front(CachedOutline { key, std::move(outline) });
+	CachedOutlinesByKey[key] = CachedOutlines.begin();
+	TrimOutlineCache();
+	return CachedOutlines.front().outline;
+}
+
+void EvictCachedOutlines(const byte *data)
+{
+	for (auto it = CachedOutlines.begin(); it != CachedOutlines.end();) {
+		if (it->key.data == data) {
+			CachedOutlinesByKey.erase(it->key);
+			it = CachedOutlines.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+void ClearOutlineCache()
+{
+	CachedOutlinesByKey.clear();
+	CachedOutlines.clear();
+}
+
+} // namespace devilution
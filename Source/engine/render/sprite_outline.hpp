@@ -0,0 +1,87 @@
+/**
+ * @file sprite_outline.hpp
+ *
+ * Outlines of sprite frames, and a cache of the recently drawn ones.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "engine/point.hpp"
+#include "engine/surface.hpp"
+#include "utils/stdcompat/cstddef.hpp"
+
+namespace devilution {
+
+/**
+ * @brief The pixels next to the opaque pixels of a sprite frame, as spans of each row.
+ */
+class SpriteOutline {
+public:
+	/**
+	 * @param opaque Whether each pixel of the frame casts an outline, starting from the bottom row
+	 * @param width Width of the frame
+	 */
+	SpriteOutline(const std::vector<bool> &opaque, int width);
+
+	/**
+	 * @brief Fills the outline, clipped to `out`.
+	 * @param position Position of the bottom left pixel of the frame
+	 */
+	void Draw(const Surface &out, Point position, uint8_t color) const;
+
+	[[nodiscard]] size_t MemoryUsage() const;
+
+private:
+	struct Span {
+		int16_t x;
+		uint16_t width;
+	};
+
+	/** @brief Size of the outline, which extends one pixel past each side of the frame. */
+	int width_;
+	int height_;
+	/** @brief Index of the first span of each row, from the bottom, followed by the end of the last row. */
+	std::vector<uint32_t> rows_;
+	std::vector<Span> spans_;
+};
+
+/** @brief The encoding of a sprite and which of its pixels cast an outline. */
+enum class OutlineSource : uint8_t {
+	Cel,
+	/** @brief CEL sprite whose pixels of color index 0 don't cast an outline. */
+	CelSkipColorIndexZero,
+	/** @brief CL2 sprite, where pixels of color index 0 never cast an outline. */
+	Cl2,
+};
+
+/** @brief Maximum number of outlines kept in the cache, 0 disables the cache. */
+void SetOutlineCacheCapacity(size_t capacity);
+
+bool IsOutlineCacheEnabled();
+
+/**
+ * @brief Returns the cached outline of a frame and marks it as recently used, or nullptr if it isn't cached.
+ */
+const SpriteOutline *FindCachedOutline(const byte *data, int frame, OutlineSource source);
+
+/**
+ * @brief Adds an outline to the cache, dropping the least recently used ones beyond the capacity.
+ *
+ * The cache must be enabled and must not contain the outline yet.
+ */
+const SpriteOutline &CacheOutline(const byte *data, int frame, OutlineSource source, SpriteOutline &&outline);
+
+/**
+ * @brief Drops the outlines of a sprite, has to be called before its data is freed.
+ */
+void EvictCachedOutlines(const byte *data);
+
+/**
+ * @brief Drops every cached outline.
+ */
+void ClearOutlineCache();
+
+} // namespace devilution
@@ -7,6 +7,7 @@
 
 #include <array>
 #include <cstddef>
+#include <list>
 #include <unordered_map>
 #include <utility>
 
@@ -38,7 +39,8 @@ constexpr char32_t ZWSP = U'\u200B'; // Zero-width space
 using Font = const OwnedPcxSpriteSheet;
 std::unordered_map<uint32_t, std::optional<OwnedPcxSpriteSheet>> Fonts;
 
-std::unordered_map<uint32_t, std::array<uint8_t, 256>> FontKerns;
+/** @brief Kerning of the loaded fonts, each thread measuring text loads its own. */
+thread_local std::unordered_map<uint32_t, std::array<uint8_t, 256>> FontKerns;
 std::array<int, 6> FontSizes = { 12, 24, 30, 42, 46, 22 };
 std::array<uint8_t, 6> CJKWidth = { 17, 24, 28, 41, 47, 16 };
 std::array<uint8_t, 6> HangulWidth = { 15, 20, 24, 35, 39, 15 };
@@ -156,7 +158,7 @@ std::array<uint8_t, 256> *LoadFontKerning(GameFontTables size, uint16_t row)
 	} else if (IsHangul(row)) {
 		kerning->fill(HangulWidth[size]);
 	} else {
-		SDL_RWops *handle = OpenAsset(path);
+		SDL_RWops *handle = OpenAsset(path, /*threadsafe=*/true);
 		if (handle != nullptr) {
 			SDL_RWread(handle, kerning, 256, 1);
 			SDL_RWclose(handle);
@@ -312,6 +314,202 @@ bool ContainsSmallFontTallCodepoints(string_view text)
 	return false;
 }
 
+/** @brief A codepoint of a string, with its kerning in the font size of the layout. */
+struct ShapedGlyph {
+	char32_t codepoint;
+	/** @brief Offset of the byte following the glyph in the string. */
+	uint32_t end;
+	/** @brief Width of the glyph, 0 for zero-width spaces. */
+	uint8_t advance;
+};
+
+/**
+ * @brief A string decoded into glyphs and kerned for one font size.
+ *
+ * The glyphs stop before the first invalid UTF-8 sequence, `end` is the offset following it.
+ */
+struct TextLayout {
+	std::string text;
+	GameFontTables size;
+	std::vector<ShapedGlyph> glyphs;
+	uint32_t end;
+	/** @brief Sum of the advances of the first line. */
+	int firstLineAdvance;
+	/** @brief Number of glyphs in the first line, without zero-width spaces. */
+	int firstLineGlyphs;
+	/** @brief Whether the string has glyphs that need the tall line height of the small font. */
+	bool smallFontTall;
+};
+
+void ShapeText(string_view text, GameFontTables size, TextLayout &layout)
+{
+	layout.size = size;
+	layout.glyphs.clear();
+	layout.firstLineAdvance = 0;
+	layout.firstLineGlyphs = 0;
+	layout.smallFontTall = false;
+
+	bool firstLine = true;
+	uint32_t currentUnicodeRow = 0;
+	std::array<uint8_t, 256> *kerning = nullptr;
+	string_view remaining = text;
+	while (!remaining.empty()) {
+		const char32_t next = ConsumeFirstUtf8CodePoint(&remaining);
+		if (next == Utf8DecodeError)
+			break;
+		const auto end = static_cast<uint32_t>(text.size() - remaining.size());
+		if (next == ZWSP) {
+			layout.glyphs.push_back({ next, end, 0 });
+			continue;
+		}
+
+		const uint32_t unicodeRow = GetUnicodeRow(next);
+		if (unicodeRow != currentUnicodeRow || kerning == nullptr) {
+			kerning = LoadFontKerning(size, unicodeRow);
+			currentUnicodeRow = unicodeRow;
+		}
+		const uint8_t advance = (*kerning)[next & 0xFF];
+		layout.glyphs.push_back({ next, end, advance });
+
+		if (next == U'\n')
+			firstLine = false;
+		if (firstLine) {
+			layout.firstLineAdvance += advance;
+			layout.firstLineGlyphs++;
+		}
+		if (IsSmallFontTallRow(unicodeRow))
+			layout.smallFontTall = true;
+	}
+	layout.end = static_cast<uint32_t>(text.size() - remaining.size());
+}
+
+/** @brief Identifies a layout by the contents of its string, which is owned by the cache entry. */
+struct TextLayoutKey {
+	string_view text;
+	GameFontTables size;
+
+	bool operator==(const TextLayoutKey &other) const
+	{
+		return size == other.size && text == other.text;
+	}
+};
+
+size_t HashText(string_view text, uint32_t seed)
+{
+	// FNV-1a
+	uint32_t hash = 2166136261U ^ seed;
+	for (char c : text) {
+		hash ^= static_cast<uint8_t>(c);
+		hash *= 16777619U;
+	}
+	return hash;
+}
+
+struct TextLayoutKeyHash {
+	size_t operator()(const TextLayoutKey &key) const
+	{
+		return HashText(key.text, key.size);
+	}
+};
+
+/** @brief A string wrapped to a width, see WordWrapString(). */
+struct WrappedText {
+	std::string text;
+	unsigned width;
+	GameFontTables size;
+	int spacing;
+	std::string wrapped;
+};
+
+struct WrappedTextKey {
+	string_view text;
+	unsigned width;
+	GameFontTables size;
+	int spacing;
+
+	bool operator==(const WrappedTextKey &other) const
+	{
+		return width == other.width && size == other.size && spacing == other.spacing && text == other.text;
+	}
+};
+
+struct WrappedTextKeyHash {
+	size_t operator()(const WrappedTextKey &key) const
+	{
+		return HashText(key.text, key.width ^ (key.size << 16) ^ (static_cast<uint32_t>(key.spacing) << 24));
+	}
+};
+
+size_t TextLayoutCacheCapacity = 512;
+thread_local TextLayoutCacheStats TextCacheStats;
+
+/** @brief The cached layouts, the most recently used first. Threads measuring text, such as the item search threads, keep their own. */
+thread_local std::list<TextLayout> CachedLayouts;
+thread_local std::unordered_map<TextLayoutKey, std::list<TextLayout>::iterator, TextLayoutKeyHash> CachedLayoutsByKey;
+
+/** @brief The cached word wrapped strings, the most recently used first. */
+thread_local std::list<WrappedText> CachedWrappedTexts;
+thread_local std::unordered_map<WrappedTextKey, std::list<WrappedText>::iterator, WrappedTextKeyHash> CachedWrappedTextsByKey;
+
+void TrimTextCaches()
+{
+	while (CachedLayouts.size() > TextLayoutCacheCapacity) {
+		const TextLayout &layout = CachedLayouts.back();
+		CachedLayoutsByKey.erase({ layout.text, layout.size });
+		CachedLayouts.pop_back();
+	}
+	while (CachedWrappedTexts.size() > TextLayoutCacheCapacity) {
+		const WrappedText &wrappedText = CachedWrappedTexts.back();
+		CachedWrappedTextsByKey.erase({ wrappedText.text, wrappedText.width, wrappedText.size, wrappedText.spacing });
+		CachedWrappedTexts.pop_back();
+	}
+}
+
+/**
+ * @brief Returns the layout of a string, from the cache if possible.
+ * @param scratch Holds the layout when the cache is disabled
+ */
+const TextLayout &GetTextLayout(string_view text, GameFontTables size, TextLayout &scratch)
+{
+	if (TextLayoutCacheCapacity == 0) {
+		ShapeText(text, size, scratch);
+		return scratch;
+	}
+
+	const auto it = CachedLayoutsByKey.find({ text, size });
+	if (it != CachedLayoutsByKey.end()) {
+		TextCacheStats.layoutHits++;
+		CachedLayouts.splice(CachedLayouts.begin(), CachedLayouts, it->second);
+		return *it->second;
+	}
+
+	TextCacheStats.layoutMisses++;
+	CachedLayouts.emplace_front();
+	TextLayout &layout = CachedLayouts.front();
+	layout.text = std::string(text);
+	ShapeText(layout.text, size, layout);
+	CachedLayoutsByKey.emplace(TextLayoutKey { layout.text, size }, CachedLayouts.begin());
+	TrimTextCaches();
+	return layout;
+}
+
+/**
+ * @brief Width of the line starting at the given glyph, as GetLineWidth() measures it.
+ */
+int GetLineWidth(const TextLayout &layout, std::size_t firstGlyph, int spacing)
+{
+	int lineWidth = 0;
+	for (std::size_t i = firstGlyph; i < layout.glyphs.size(); i++) {
+		const ShapedGlyph &glyph = layout.glyphs[i];
+		if (glyph.codepoint == ZWSP)
+			continue;
+		if (glyph.codepoint == U'\n')
+			break;
+		lineWidth += glyph.advance + spacing;
+	}
+	return lineWidth != 0 ? (lineWidth - spacing) : 0;
+}
+
 int GetLineHeight(string_view fmt, DrawStringFormatArg *args, std::size_t argsLen, GameFontTables fontIndex)
 {
 	constexpr std::array<int, 6> LineHeights = { 12, 26, 38, 42, 50, 22 };
@@ -351,22 +549,26 @@ int DoDrawString(const Surface &out, string_view text, Rectangle rect, Point &ch
     int spacing, int lineHeight, int lineWidth, int rightMargin, int bottomMargin,
     UiFlags flags, GameFontTables size, text_color color)
 {
+	TextLayout scratch;
+	const TextLayout &layout = GetTextLayout(text, size, scratch);
+
 	Font *font = nullptr;
-	std::array<uint8_t, 256> *kerning = nullptr;
 	uint32_t currentUnicodeRow = 0;
+	uint32_t consumed = layout.end;
 
-	char32_t next;
-	string_view remaining = text;
-	while (!remaining.empty() && remaining[0] != '\0') {
-		next = ConsumeFirstUtf8CodePoint(&remaining);
-		if (next == Utf8DecodeError)
+	for (std::size_t i = 0; i < layout.glyphs.size(); i++) {
+		const ShapedGlyph &glyph = layout.glyphs[i];
+		const char32_t next = glyph.codepoint;
+		if (next == U'\0') {
+			consumed = i > 0 ? layout.glyphs[i - 1].end : 0;
 			break;
+		}
+		consumed = glyph.end;
 		if (next == ZWSP)
 			continue;
 
 		const uint32_t unicodeRow = GetUnicodeRow(next);
 		if (unicodeRow != currentUnicodeRow || font == nullptr) {
-			kerning = LoadFontKerning(size, unicodeRow);
 			font = LoadFont(size, color, unicodeRow);
 			currentUnicodeRow = unicodeRow;
 		}
@@ -379,9 +581,9 @@ int DoDrawString(const Surface &out, string_view text, Rectangle rect, Point &ch
 			characterPosition.y += lineHeight;
 
 			if (HasAnyOf(flags, (UiFlags::AlignCenter | UiFlags::AlignRight))) {
-				lineWidth = (*kerning)[frame];
-				if (!remaining.empty())
-					lineWidth += spacing + GetLineWidth(remaining, size, spacing);
+				lineWidth = glyph.advance;
+				if (glyph.end < text.size())
+					lineWidth += spacing + GetLineWidth(layout, i + 1, spacing);
 			}
 
 			if (HasAnyOf(flags, UiFlags::AlignCenter))
@@ -394,8 +596,9 @@ int DoDrawString(const Surface &out, string_view text, Rectangle rect, Point &ch
 		}
 
 		DrawFont(out, characterPosition, font, color, frame);
-		characterPosition.x += (*kerning)[frame] + spacing;
+		characterPosition.x += glyph.advance + spacing;
 	}
+	const string_view remaining = text.substr(consumed);
 	return text.data() - remaining.data();
 }
 
@@ -423,38 +626,49 @@ void UnloadFonts()
 {
 	Fonts.clear();
 	FontKerns.clear();
+	ClearTextLayoutCache();
 }
 
-int GetLineWidth(string_view text, GameFontTables size, int spacing, int *charactersInLine)
+void SetTextLayoutCacheCapacity(size_t capacity)
 {
-	int lineWidth = 0;
+	TextLayoutCacheCapacity = capacity;
+	TrimTextCaches();
+}
 
-	uint32_t codepoints = 0;
-	uint32_t currentUnicodeRow = 0;
-	std::array<uint8_t, 256> *kerning = nullptr;
-	char32_t next;
-	while (!text.empty()) {
-		next = ConsumeFirstUtf8CodePoint(&text);
-		if (next == Utf8DecodeError)
-			break;
-		if (next == ZWSP)
-			continue;
+void ClearTextLayoutCache()
+{
+	CachedLayoutsByKey.clear();
+	CachedLayouts.clear();
+	CachedWrappedTextsByKey.clear();
+	CachedWrappedTexts.clear();
+}
 
-		if (next == '\n')
-			break;
+TextLayoutCacheStats GetTextLayoutCacheStats()
+{
+	TextLayoutCacheStats stats = TextCacheStats;
+	stats.layouts = CachedLayouts.size();
+	stats.wrappedTexts = CachedWrappedTexts.size();
+	stats.memoryUsage = 0;
+	for (const TextLayout &layout : CachedLayouts)
+		stats.memoryUsage += sizeof(layout) + layout.text.capacity() + layout.glyphs.capacity() * sizeof(ShapedGlyph);
+	for (const WrappedText &wrappedText : CachedWrappedTexts)
+		stats.memoryUsage += sizeof(wrappedText) + wrappedText.text.capacity() + wrappedText.wrapped.capacity();
+	return stats;
+}
 
-		uint8_t frame = next & 0xFF;
-		const uint32_t unicodeRow = GetUnicodeRow(next);
-		if (unicodeRow != currentUnicodeRow || kerning == nullptr) {
-			kerning = LoadFontKerning(size, unicodeRow);
-			currentUnicodeRow = unicodeRow;
-		}
-		lineWidth += (*kerning)[frame] + spacing;
-		codepoints++;
-	}
+void ResetTextLayoutCacheStats()
+{
+	TextCacheStats = {};
+}
+
+int GetLineWidth(string_view text, GameFontTables size, int spacing, int *charactersInLine)
+{
+	TextLayout scratch;
+	const TextLayout &layout = GetTextLayout(text, size, scratch);
 	if (charactersInLine != nullptr)
-		*charactersInLine = codepoints;
+		*charactersInLine = layout.firstLineGlyphs;
 
+	const int lineWidth = layout.firstLineAdvance + layout.firstLineGlyphs * spacing;
 	return lineWidth != 0 ? (lineWidth - spacing) : 0;
 }
 
@@ -512,8 +726,10 @@ int GetLineWidth(string_view fmt, DrawStringFormatArg *args, std::size_t argsLen
 
 int GetLineHeight(string_view text, GameFontTables fontIndex)
 {
-	if (fontIndex == GameFont12 && IsSmallFontTall() && ContainsSmallFontTallCodepoints(text)) {
-		return SmallFontTallLineHeight;
+	if (fontIndex == GameFont12 && IsSmallFontTall()) {
+		TextLayout scratch;
+		if (GetTextLayout(text, fontIndex, scratch).smallFontTall)
+			return SmallFontTallLineHeight;
 	}
 	return LineHeights[fontIndex];
 }
@@ -529,7 +745,9 @@ int AdjustSpacingToFitHorizontally(int &lineWidth, int maxSpacing, int character
 	return maxSpacing - spacingRedux;
 }
 
-std::string WordWrapString(string_view text, unsigned width, GameFontTables size, int spacing)
+namespace {
+
+std::string DoWordWrapString(string_view text, unsigned width, GameFontTables size, int spacing)
 {
 	std::string output;
 	if (text.empty() || text[0] == '\0')
@@ -611,6 +829,29 @@ std::string WordWrapString(string_view text, unsigned width, GameFontTables size
 	return output;
 }
 
+} // namespace
+
+std::string WordWrapString(string_view text, unsigned width, GameFontTables size, int spacing)
+{
+	if (TextLayoutCacheCapacity == 0)
+		return DoWordWrapString(text, width, size, spacing);
+
+	const auto it = CachedWrappedTextsByKey.find({ text, width, size, spacing });
+	if (it != CachedWrappedTextsByKey.end()) {
+		TextCacheStats.wrapHits++;
+		CachedWrappedTexts.splice(CachedWrappedTexts.begin(), CachedWrappedTexts, it->second);
+		return it->second->wrapped;
+	}
+
+	TextCacheStats.wrapMisses++;
+	CachedWrappedTexts.push_front({ std::string(text), width, size, spacing, DoWordWrapString(text, width, size, spacing) });
+	const WrappedText &wrappedText = CachedWrappedTexts.front();
+	CachedWrappedTextsByKey.emplace(WrappedTextKey { wrappedText.text, width, size, spacing }, CachedWrappedTexts.begin());
+	std::string output = wrappedText.wrapped;
+	TrimTextCaches();
+	return output;
+}
+
 /**
  * @todo replace Rectangle with cropped Surface
  */
@@ -5,6 +5,7 @@
  */
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <utility>
@@ -231,4 +232,34 @@ inline void DrawStringWithColors(const Surface &out, string_view fmt, std::vecto
 uint8_t PentSpn2Spin();
 void UnloadFonts();
 
+/**
+ * @brief Usage of the caches of text layouts and word wrapped strings of the calling thread.
+ */
+struct TextLayoutCacheStats {
+	uint32_t layoutHits;
+	uint32_t layoutMisses;
+	uint32_t wrapHits;
+	uint32_t wrapMisses;
+	/** @brief Number of cached layouts. */
+	size_t layouts;
+	/** @brief Number of cached word wrapped strings. */
+	size_t wrappedTexts;
+	/** @brief Approximate heap usage of the cached entries in bytes. */
+	size_t memoryUsage;
+};
+
+/**
+ * @brief Sets the maximum number of entries kept in each text cache, 0 disables the caches.
+ */
+void SetTextLayoutCacheCapacity(size_t capacity);
+
+/**
+ * @brief Drops every text layout and word wrapped string the calling thread cached, has to be called when fonts or kerning change.
+ */
+void ClearTextLayoutCache();
+
+TextLayoutCacheStats GetTextLayoutCacheStats();
+
+void ResetTextLayoutCacheStats();
+
 } // namespace devilution
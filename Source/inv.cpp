@@ -14,6 +14,7 @@
 #include "engine/cel_sprite.hpp"
 #include "engine/load_cel.hpp"
 #include "engine/render/cel_render.hpp"
+#include "engine/render/scrollrt.h"
 #include "engine/render/text_render.hpp"
 #include "engine/size.hpp"
 #include "hwcursor.hpp"
@@ -35,7 +36,6 @@
 namespace devilution {
 
 bool invflag;
-bool drawsbarflag;
 
 /**
  * Maps from inventory slot to screen position. The inventory slots are
@@ -552,7 +552,7 @@ void CheckInvPaste(Player &player, Point cursorPosition)
 			if (player.HoldItem._itype == ItemType::Gold)
 				player._pGold = CalculateGold(player);
 		}
-		drawsbarflag = true;
+		RedrawComponent(PanelDrawComponent::Belt);
 	} break;
 	case ILOC_NONE:
 	case ILOC_INVALID:
@@ -801,7 +801,7 @@ void CheckInvCut(int pnum, Point cursorPosition, bool automaticMove, bool dropIt
 
 			if (!automaticMove || automaticallyMoved) {
 				beltItem.clear();
-				drawsbarflag = true;
+				RedrawComponent(PanelDrawComponent::Belt);
 			}
 		}
 	}
@@ -1080,7 +1080,6 @@ void InitInv()
 	}
 
 	CloseInventory();
-	drawsbarflag = false;
 }
 
 void DrawInv(const Surface &out)
@@ -1247,7 +1246,7 @@ bool AutoPlaceItemInBelt(Player &player, const Item &item, bool persistItem)
 			if (persistItem) {
 				beltItem = item;
 				player.CalcScrolls();
-				drawsbarflag = true;
+				RedrawComponent(PanelDrawComponent::Belt);
 			}
 
 			return true;
@@ -1468,20 +1467,23 @@ void CheckInvSwap(Player &player, inv_body_loc bLoc, int idx, uint16_t wCI, int
 		item._iIdentified = true;
 	}
 
+	uint8_t changedBodySlots = BodySlotBit(bLoc);
 	if (bLoc == INVLOC_HAND_LEFT && player.GetItemLocation(item) == ILOC_TWOHAND) {
 		player.InvBody[INVLOC_HAND_RIGHT].clear();
+		changedBodySlots |= BodySlotBit(INVLOC_HAND_RIGHT);
 	} else if (bLoc == INVLOC_HAND_RIGHT && player.GetItemLocation(item) == ILOC_TWOHAND) {
 		player.InvBody[INVLOC_HAND_LEFT].clear();
+		changedBodySlots |= BodySlotBit(INVLOC_HAND_LEFT);
 	}
 
-	CalcPlrInv(player, true);
+	CalcPlrInv(player, true, changedBodySlots);
 }
 
 void inv_update_rem_item(Player &player, inv_body_loc iv)
 {
 	player.InvBody[iv].clear();
 
-	CalcPlrInv(player, player._pmode != PM_DEATH);
+	CalcPlrInv(player, player._pmode != PM_DEATH, BodySlotBit(iv));
 }
 
 void TransferItemToStash(Player &player, int location)
@@ -1879,7 +1881,7 @@ int8_t CheckInvHLight()
 		pi = &myPlayer.InvList[ii];
 	} else if (r >= SLOTXY_BELT_FIRST) {
 		r -= SLOTXY_BELT_FIRST;
-		drawsbarflag = true;
+		RedrawComponent(PanelDrawComponent::Belt);
 		pi = &myPlayer.SpdList[r];
 		if (pi->isEmpty())
 			return -1;
@@ -0,0 +1,329 @@
+/**
+ * @file item_search.cpp
+ *
+ * Implementation of the search for item seeds.
+ */
+#include "item_search.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include <SDL.h>
+
+#include "engine/random.hpp"
+#include "monstdat.h"
+#include "monster.h"
+#include "utils/sdl_thread.h"
+
+namespace devilution {
+
+namespace {
+
+/** @brief Number of candidates a search thread claims at a time. */
+constexpr uint32_t CandidatesPerChunk = 256;
+
+/** @brief Spreads the candidate numbers over the seeds, odd so that each candidate has its own seed. */
+constexpr uint32_t CandidateSeedStride = 0x9E3779B1;
+
+struct ItemStatName {
+	const char *name;
+	ItemSearchStat stat;
+};
+
+constexpr ItemStatName ItemStatNames[] = {
+	{ "str", ItemSearchStat::Strength },
+	{ "mag", ItemSearchStat::Magic },
+	{ "dex", ItemSearchStat::Dexterity },
+	{ "vit", ItemSearchStat::Vitality },
+	{ "tohit", ItemSearchStat::ToHit },
+	{ "dam", ItemSearchStat::DamagePercent },
+	{ "ac", ItemSearchStat::ArmorPercent },
+	{ "life", ItemSearchStat::Life },
+	{ "mana", ItemSearchStat::Mana },
+	{ "fire", ItemSearchStat::ResistFire },
+	{ "light", ItemSearchStat::ResistLightning },
+	{ "magic", ItemSearchStat::ResistMagic },
+	{ "armor", ItemSearchStat::Armor },
+	{ "maxdam", ItemSearchStat::MaxDamage },
+};
+
+std::string ToLower(string_view text)
+{
+	std::string lower;
+	AppendStrView(lower, text);
+	std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+	return lower;
+}
+
+int GetItemStat(const Item &item, ItemSearchStat stat)
+{
+	switch (stat) {
+	case ItemSearchStat::Strength:
+		return item._iPLStr;
+	case ItemSearchStat::Magic:
+		return item._iPLMag;
+	case ItemSearchStat::Dexterity:
+		return item._iPLDex;
+	case ItemSearchStat::Vitality:
+		return item._iPLVit;
+	case ItemSearchStat::ToHit:
+		return item._iPLToHit;
+	case ItemSearchStat::DamagePercent:
+		return item._iPLDam;
+	case ItemSearchStat::ArmorPercent:
+		return item._iPLAC;
+	case ItemSearchStat::Life:
+		return item._iPLHP >> 6;
+	case ItemSearchStat::Mana:
+		return item._iPLMana >> 6;
+	case ItemSearchStat::ResistFire:
+		return item._iPLFR;
+	case ItemSearchStat::ResistLightning:
+		return item._iPLLR;
+	case ItemSearchStat::ResistMagic:
+		return item._iPLMR;
+	case ItemSearchStat::Armor:
+		return item._iAC;
+	case ItemSearchStat::MaxDamage:
+		return item._iMaxDam;
+	}
+	return 0;
+}
+
+/**
+ * @brief Reads a `key:value` word of a query.
+ * @return Whether the word was a known key
+ */
+bool ParseQueryTerm(ItemSearchQuery &query, string_view word)
+{
+	const size_t separator = word.find(':');
+	if (separator == string_view::npos)
+		return false;
+	const std::string key = ToLower(word.substr(0, separator));
+	const std::string value = ToLower(word.substr(separator + 1));
+
+	if (key == "type") {
+		for (int8_t type = static_cast<int8_t>(ItemType::Misc); type <= static_cast<int8_t>(ItemType::Amulet); type++) {
+			if (ToLower(ItemTypeToString(static_cast<ItemType>(type))) == value) {
+				query.itemType = static_cast<ItemType>(type);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	for (const ItemStatName &statName : ItemStatNames) {
+		if (key == statName.name) {
+			query.minStats.push_back({ statName.stat, atoi(value.c_str()) });
+			return true;
+		}
+	}
+	return false;
+}
+
+uint32_t GetCandidateSeed(uint32_t firstSeed, uint32_t candidate)
+{
+	return firstSeed + candidate * CandidateSeedStride;
+}
+
+/**
+ * @brief Rolls the candidates of a query on the calling thread, with its own random context and copy of the unique item flags.
+ */
+class CandidateRoller {
+public:
+	explicit CandidateRoller(const ItemSearchQuery &query)
+	    : query_(query)
+	    , randomScope_(random_)
+	{
+		if (query.source == ItemSearchSource::Unique) {
+			// With every other unique dropped already, the base item can only become the unique searched for.
+			std::fill(std::begin(initialUniqueItemFlags_), std::end(initialUniqueItemFlags_), true);
+			initialUniqueItemFlags_[query.uniqueIndex] = false;
+			for (int j = 0; AllItemsList[j].iLoc != ILOC_INVALID; j++) {
+				if (IsItemAvailable(j) && AllItemsList[j].iItemId == UniqueItems[query.uniqueIndex].UIItemId)
+					uniqueBaseItem_ = j;
+			}
+		} else {
+			memcpy(initialUniqueItemFlags_, UniqueItemFlags, sizeof(initialUniqueItemFlags_));
+		}
+		memcpy(uniqueItemFlags_, initialUniqueItemFlags_, sizeof(uniqueItemFlags_));
+		SetThreadUniqueItemFlags(uniqueItemFlags_);
+		// Measuring the names only pays off for the queries that need them.
+		SetThreadItemNameMeasuring(!query.name.empty());
+
+		monster_.MData = &MonstersData[0];
+		monster_._uniqtype = 0;
+	}
+
+	~CandidateRoller()
+	{
+		SetThreadUniqueItemFlags(nullptr);
+		SetThreadItemNameMeasuring(true);
+	}
+
+	CandidateRoller(const CandidateRoller &) = delete;
+	CandidateRoller &operator=(const CandidateRoller &) = delete;
+
+	bool Roll(Item &item, uint32_t seed)
+	{
+		SetRndSeed(seed);
+		item = {};
+		if (query_.source == ItemSearchSource::Unique) {
+			// Quest uniques have a base item of their own, which stores the unique in the seed.
+			const int iseed = AllItemsList[uniqueBaseItem_].iMiscId == IMISC_UNIQUE ? query_.uniqueIndex : AdvanceRndSeed();
+			SetupAllItems(item, uniqueBaseItem_, iseed, UniqueItems[query_.uniqueIndex].UIMinLvl, 1, false, false, false);
+		} else {
+			monster_.mLevel = static_cast<int8_t>(query_.level != 0 ? query_.level : GenerateRnd(CF_LEVEL) + 1);
+			const int idx = RndItem(monster_);
+			if (idx <= 1)
+				return false; // No drop, gold or a quest item
+			SetupAllItems(item, idx - 1, AdvanceRndSeed(), monster_.mLevel, 1, false, false, false);
+		}
+		// Each candidate starts from the same flags, whichever candidates the thread rolled before.
+		if (item._iMagical == ITEM_QUALITY_UNIQUE)
+			uniqueItemFlags_[item._iUid] = initialUniqueItemFlags_[item._iUid];
+		return true;
+	}
+
+private:
+	const ItemSearchQuery &query_;
+	RandomContext random_;
+	RandomContextScope randomScope_;
+	bool initialUniqueItemFlags_[128];
+	bool uniqueItemFlags_[128];
+	int uniqueBaseItem_ = 0;
+	Monster monster_ {};
+};
+
+struct SearchState {
+	SearchState(const ItemSearchQuery &query, const ItemSearchOptions &options)
+	    : query(query)
+	    , options(options)
+	{
+	}
+
+	const ItemSearchQuery &query;
+	const ItemSearchOptions &options;
+	uint32_t maxCandidates = 0;
+	uint32_t begin = 0;
+	std::atomic<uint32_t> nextCandidate { 0 };
+	/** @brief Lowest matching candidate found so far, the threads stop once every lower one is rolled. */
+	std::atomic<uint32_t> firstMatch { std::numeric_limits<uint32_t>::max() };
+	std::atomic<uint32_t> rolled { 0 };
+};
+
+int SDLCALL SearchThread(void *data)
+{
+	SearchState &state = *static_cast<SearchState *>(data);
+	CandidateRoller roller(state.query);
+	Item item;
+	uint32_t rolled = 0;
+
+	while (true) {
+		if (state.options.timeLimitMs != 0 && SDL_GetTicks() - state.begin > state.options.timeLimitMs)
+			break;
+		const uint32_t first = state.nextCandidate.fetch_add(CandidatesPerChunk);
+		if (first >= state.maxCandidates || first >= state.firstMatch.load())
+			break;
+
+		const uint32_t last = std::min(first + CandidatesPerChunk, state.maxCandidates);
+		for (uint32_t candidate = first; candidate < last && candidate < state.firstMatch.load(std::memory_order_relaxed); candidate++) {
+			rolled++;
+			if (!roller.Roll(item, GetCandidateSeed(state.options.firstSeed, candidate)) || !ItemMatchesSearchQuery(item, state.query))
+				continue;
+			uint32_t firstMatch = state.firstMatch.load();
+			while (candidate < firstMatch && !state.firstMatch.compare_exchange_weak(firstMatch, candidate)) {
+			}
+			break;
+		}
+	}
+
+	state.rolled += rolled;
+	return 0;
+}
+
+} // namespace
+
+ItemSearchQuery ParseItemSearchQuery(string_view text)
+{
+	ItemSearchQuery query;
+	std::string name;
+	while (!text.empty()) {
+		const size_t end = std::min(text.find(' '), text.size());
+		const string_view word = text.substr(0, end);
+		text.remove_prefix(std::min(end + 1, text.size()));
+		if (word.empty() || ParseQueryTerm(query, word))
+			continue;
+		if (!name.empty())
+			name += ' ';
+		AppendStrView(name, word);
+	}
+	query.name = ToLower(name);
+	return query;
+}
+
+bool ItemMatchesSearchQuery(const Item &item, const ItemSearchQuery &query)
+{
+	if (item.isEmpty())
+		return false;
+	if (query.source == ItemSearchSource::Unique && (item._iMagical != ITEM_QUALITY_UNIQUE || item._iUid != query.uniqueIndex))
+		return false;
+	if (query.baseItem != -1 && item.IDidx != query.baseItem)
+		return false;
+	if (query.itemType != ItemType::None && item._itype != query.itemType)
+		return false;
+	if (item._iMagical < query.minQuality)
+		return false;
+	if (query.prefixPower != IPL_INVALID && item._iPrePower != query.prefixPower)
+		return false;
+	if (query.suffixPower != IPL_INVALID && item._iSufPower != query.suffixPower)
+		return false;
+	for (const ItemStatRequirement &requirement : query.minStats) {
+		if (GetItemStat(item, requirement.stat) < requirement.minValue)
+			return false;
+	}
+	return query.name.empty() || ToLower(item._iIName).find(query.name) != std::string::npos;
+}
+
+bool GenerateSearchCandidate(Item &item, const ItemSearchQuery &query, uint32_t seed)
+{
+	CandidateRoller roller(query);
+	SetThreadItemNameMeasuring(true);
+	return roller.Roll(item, seed);
+}
+
+ItemSearchResult SearchItem(const ItemSearchQuery &query, const ItemSearchOptions &options)
+{
+	ItemSearchResult result;
+	result.threads = options.threads != 0 ? options.threads : std::max(std::thread::hardware_concurrency(), 1U);
+
+	SearchState state { query, options };
+	// Leave room for the chunks the threads claim past the end before stopping.
+	state.maxCandidates = std::min(options.maxCandidates, std::numeric_limits<uint32_t>::max() - CandidatesPerChunk * (result.threads + 1));
+	state.begin = SDL_GetTicks();
+	{
+		std::vector<SdlThread> threads;
+		threads.reserve(result.threads);
+		for (unsigned i = 0; i < result.threads; i++)
+			threads.emplace_back(SearchThread, &state);
+		for (SdlThread &thread : threads)
+			thread.join();
+	}
+	result.elapsedMs = SDL_GetTicks() - state.begin;
+	result.candidates = state.rolled;
+
+	const uint32_t firstMatch = state.firstMatch;
+	if (firstMatch != std::numeric_limits<uint32_t>::max()) {
+		result.found = true;
+		result.seed = GetCandidateSeed(options.firstSeed, firstMatch);
+	}
+	return result;
+}
+
+} // namespace devilution
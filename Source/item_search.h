@@ -0,0 +1,121 @@
+/**
+ * @file item_search.h
+ *
+ * Interface of the search for item seeds, rolling candidates on several threads.
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "itemdat.h"
+#include "items.h"
+#include "utils/stdcompat/string_view.hpp"
+
+namespace devilution {
+
+/** @brief How the candidates of a search are rolled from their seed. */
+enum class ItemSearchSource : uint8_t {
+	/** @brief The item a monster drops, like killing a monster of the query's level. */
+	MonsterDrop,
+	/** @brief The base item of the query's unique, rolled until the unique comes out. */
+	Unique,
+};
+
+/** @brief Item stats a query can ask a minimum of. */
+enum class ItemSearchStat : uint8_t {
+	Strength,
+	Magic,
+	Dexterity,
+	Vitality,
+	ToHit,
+	DamagePercent,
+	ArmorPercent,
+	Life,
+	Mana,
+	ResistFire,
+	ResistLightning,
+	ResistMagic,
+	Armor,
+	MaxDamage,
+};
+
+struct ItemStatRequirement {
+	ItemSearchStat stat;
+	int minValue;
+};
+
+struct ItemSearchQuery {
+	ItemSearchSource source = ItemSearchSource::MonsterDrop;
+	/** @brief Level of the monster dropping the item, 0 to let each candidate pick one. */
+	int level = 0;
+	/** @brief Unique item to roll, for ItemSearchSource::Unique. */
+	int uniqueIndex = -1;
+	/** @brief Base item (_item_indexes) the item must be, -1 for any. */
+	int baseItem = -1;
+	/** @brief Type the item must be, ItemType::None for any. */
+	ItemType itemType = ItemType::None;
+	item_quality minQuality = ITEM_QUALITY_NORMAL;
+	/** @brief Effect of the prefix the item must have, IPL_INVALID for any. */
+	item_effect_type prefixPower = IPL_INVALID;
+	/** @brief Effect of the suffix the item must have, IPL_INVALID for any. */
+	item_effect_type suffixPower = IPL_INVALID;
+	std::vector<ItemStatRequirement> minStats;
+	/** @brief Lowercase text the identified name must contain, empty for any. */
+	std::string name;
+};
+
+struct ItemSearchOptions {
+	/** @brief Number of threads rolling candidates, 0 for one per CPU core. */
+	unsigned threads = 0;
+	/** @brief Seed of the first candidate, candidates are numbered from it. */
+	uint32_t firstSeed = 0;
+	uint32_t maxCandidates = 1000000;
+	/** @brief Gives up after this long, 0 to only stop after maxCandidates. */
+	uint32_t timeLimitMs = 0;
+};
+
+struct ItemSearchResult {
+	bool found = false;
+	/** @brief Seed of the matching candidate, for GenerateSearchCandidate. */
+	uint32_t seed = 0;
+	/** @brief Number of candidates rolled, by all threads. */
+	uint32_t candidates = 0;
+	uint32_t elapsedMs = 0;
+	unsigned threads = 0;
+
+	[[nodiscard]] uint32_t SeedsPerSecond() const
+	{
+		return static_cast<uint32_t>(static_cast<uint64_t>(candidates) * 1000 / (elapsedMs != 0 ? elapsedMs : 1));
+	}
+};
+
+/**
+ * @brief Parses the query of the item debug commands.
+ *
+ * Words of the form `stat:value` ask a minimum stat (str, mag, dex, vit, tohit, dam, ac, life, mana, fire, light,
+ * magic, armor, maxdam), `type:name` a type as ItemTypeToString() names it. The other words make up the name.
+ */
+ItemSearchQuery ParseItemSearchQuery(string_view text);
+
+/**
+ * @brief Whether an item rolled for a query satisfies it.
+ */
+bool ItemMatchesSearchQuery(const Item &item, const ItemSearchQuery &query);
+
+/**
+ * @brief Rolls the candidate for a seed, as the search did, without touching the game's random state or unique item flags.
+ * @return Whether the seed rolls an item at all
+ */
+bool GenerateSearchCandidate(Item &item, const ItemSearchQuery &query, uint32_t seed);
+
+/**
+ * @brief Rolls candidates on worker threads until one matches the query, returning the first matching seed.
+ *
+ * The calling thread waits for the workers, which share the text layouts used to measure item names with it.
+ * The result doesn't depend on the number of threads.
+ */
+ItemSearchResult SearchItem(const ItemSearchQuery &query, const ItemSearchOptions &options);
+
+} // namespace devilution
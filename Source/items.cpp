@@ -12,6 +12,10 @@
 #endif
 #include <climits>
 #include <cstdint>
+#include <limits>
+#include <map>
+#include <tuple>
+#include <vector>
 
 #include <fmt/format.h>
 
@@ -24,9 +28,12 @@
 #include "engine/load_cel.hpp"
 #include "engine/random.hpp"
 #include "engine/render/cel_render.hpp"
+#include "engine/render/scrollrt.h"
+#include "engine/render/sprite_outline.hpp"
 #include "engine/render/text_render.hpp"
 #include "init.h"
 #include "inv_iterators.hpp"
+#include "item_search.h"
 #include "levels/town.h"
 #include "lighting.h"
 #include "missiles.h"
@@ -50,8 +57,10 @@ uint8_t ActiveItems[MAXITEMS];
 uint8_t ActiveItemCount;
 int8_t dItem[MAXDUNX][MAXDUNY];
 bool ShowUniqueItemInfoBox;
-CornerStoneStruct CornerStone;
+DVL_LEVEL_THREAD_LOCAL CornerStoneStruct CornerStone;
 bool UniqueItemFlags[128];
+/** @brief The unique item flags that item rolls on this thread check and mark. */
+thread_local bool *CurrentUniqueItemFlags = UniqueItemFlags;
 int MaxGold = GOLD_MAX_LIMIT;
 
 /** Maps from item_cursor_graphic to in-memory item type. */
@@ -382,6 +391,119 @@ bool IsSuffixValidForItemType(int i, AffixItemType flgs)
 	return HasAnyOf(flgs, itemTypes);
 }
 
+/** @brief The pickers that roll one of a list of candidate base items or affixes. */
+enum class ItemPicker : uint8_t {
+	Drop,
+	Unique,
+	All,
+	Type,
+	Smith,
+	Premium,
+	Witch,
+	Healer,
+	Prefix,
+	Suffix,
+	StaffPrefix,
+};
+
+/** @brief Everything besides the game mode that decides the candidates of a picker. */
+using ItemCandidatesKey = std::tuple<ItemPicker, int, int, int, int>;
+
+bool ItemCandidateTablesEnabled = true;
+/** @brief Game mode the candidate tables were built for, see `GetItemCandidatesMode`. */
+thread_local int ItemCandidatesMode = -1;
+/**
+ * @brief Candidates of the item pickers, built by each picker's own loop the first time they're needed.
+ *
+ * Each thread rolling items, such as the item search threads, keeps its own tables.
+ */
+thread_local std::map<ItemCandidatesKey, std::vector<int>> ItemCandidateTables;
+
+/**
+ * @brief The game options that `IsItemAvailable`, the affix checks and the pickers depend on.
+ */
+int GetItemCandidatesMode()
+{
+	return (gbIsMultiplayer ? 1 : 0) | (gbIsHellfire ? 2 : 0) | (gbIsSpawn ? 4 : 0) | (*sgOptions.Gameplay.testBard ? 8 : 0);
+}
+
+/**
+ * @brief Looks up the candidates of a picker, the list stays valid until the next lookup.
+ * @param build Lists the candidates, used when they are not in the tables yet
+ */
+template <typename BuildFn>
+const std::vector<int> &GetItemCandidates(const ItemCandidatesKey &key, BuildFn build)
+{
+	const int mode = GetItemCandidatesMode();
+	if (!ItemCandidateTablesEnabled || mode != ItemCandidatesMode) {
+		ItemCandidateTables.clear();
+		ItemCandidatesMode = mode;
+	}
+	auto it = ItemCandidateTables.find(key);
+	if (it == ItemCandidateTables.end())
+		it = ItemCandidateTables.emplace(key, build()).first;
+	return it->second;
+}
+
+/**
+ * @brief Rolls one of the candidates of a picker with a single call to `GenerateRnd`, as the item pickers always did.
+ */
+template <typename BuildFn>
+int RndItemCandidate(const ItemCandidatesKey &key, BuildFn build)
+{
+	const std::vector<int> &candidates = GetItemCandidates(key, build);
+	const int r = GenerateRnd(static_cast<int>(candidates.size()));
+	return candidates.empty() ? 0 : candidates[r];
+}
+
+std::vector<int> GetPrefixCandidates(AffixItemType flgs, int minlvl, int maxlvl, bool onlygood)
+{
+	std::vector<int> candidates;
+	for (int j = 0; ItemPrefixes[j].power.type != IPL_INVALID; j++) {
+		if (!IsPrefixValidForItemType(j, flgs))
+			continue;
+		if (ItemPrefixes[j].PLMinLvl < minlvl || ItemPrefixes[j].PLMinLvl > maxlvl)
+			continue;
+		if (onlygood && !ItemPrefixes[j].PLOk)
+			continue;
+		if (HasAnyOf(flgs, AffixItemType::Staff) && ItemPrefixes[j].power.type == IPL_CHARGES)
+			continue;
+		candidates.push_back(j);
+		if (ItemPrefixes[j].PLDouble)
+			candidates.push_back(j);
+	}
+	return candidates;
+}
+
+std::vector<int> GetSuffixCandidates(AffixItemType flgs, int minlvl, int maxlvl, bool onlygood, goodorevil goe)
+{
+	std::vector<int> candidates;
+	for (int j = 0; ItemSuffixes[j].power.type != IPL_INVALID; j++) {
+		if (IsSuffixValidForItemType(j, flgs)
+		    && ItemSuffixes[j].PLMinLvl >= minlvl && ItemSuffixes[j].PLMinLvl <= maxlvl
+		    && !((goe == GOE_GOOD && ItemSuffixes[j].PLGOE == GOE_EVIL) || (goe == GOE_EVIL && ItemSuffixes[j].PLGOE == GOE_GOOD))
+		    && (!onlygood || ItemSuffixes[j].PLOk)) {
+			candidates.push_back(j);
+		}
+	}
+	return candidates;
+}
+
+std::vector<int> GetStaffPrefixCandidates(int lvl, bool onlygood)
+{
+	std::vector<int> candidates;
+	for (int j = 0; ItemPrefixes[j].power.type != IPL_INVALID; j++) {
+		if (!IsPrefixValidForItemType(j, AffixItemType::Staff) || ItemPrefixes[j].PLMinLvl > lvl)
+			continue;
+		if (onlygood && !ItemPrefixes[j].PLOk)
+			continue;
+		candidates.push_back(j);
+		if (ItemPrefixes[j].PLDouble)
+			candidates.push_back(j);
+	}
+	return candidates;
+}
+
 int ItemsGetCurrlevel()
 {
 	if (leveltype == DTYPE_NEST)
@@ -515,6 +637,161 @@ void CalcSelfItems(Player &player)
 	} while (changeflag);
 }
 
+constexpr uint8_t AllBodySlots = (1 << NUM_INVLOC) - 1;
+
+bool ItemStatsVerified = false;
+
+/**
+ * @brief What an equipped item adds to the stats, nothing if its wearer can't use it.
+ */
+ItemStats GetItemStats(const Item &item)
+{
+	ItemStats stats {};
+	if (item.isEmpty() || !item._iStatFlag)
+		return stats;
+
+	stats.minDamage = item._iMinDam;
+	stats.maxDamage = item._iMaxDam;
+	stats.armorClass = item._iAC;
+
+	if (item._iSpell != SPL_NULL) {
+		stats.spells = GetSpellBitmask(item._iSpell);
+	}
+
+	if (item._iMagical == ITEM_QUALITY_NORMAL || item._iIdentified) {
+		stats.bonusDamage = item._iPLDam;
+		stats.bonusToHit = item._iPLToHit;
+		if (item._iPLAC != 0) {
+			int tmpac = item._iAC;
+			tmpac *= item._iPLAC;
+			tmpac /= 100;
+			if (tmpac == 0)
+				tmpac = math::Sign(item._iPLAC);
+			stats.bonusArmorClass = tmpac;
+		}
+		stats.flags = item._iFlags;
+		stats.damAcFlags = item._iDamAcFlags;
+		stats.strength = item._iPLStr;
+		stats.magic = item._iPLMag;
+		stats.dexterity = item._iPLDex;
+		stats.vitality = item._iPLVit;
+		stats.fireResist = item._iPLFR;
+		stats.lightningResist = item._iPLLR;
+		stats.magicResist = item._iPLMR;
+		stats.damageMod = item._iPLDamMod;
+		stats.getHit = item._iPLGetHit;
+		stats.lightRadius = item._iPLLight;
+		stats.hitPoints = item._iPLHP;
+		stats.mana = item._iPLMana;
+		stats.spellLevels = item._iSplLvlAdd;
+		stats.enhancedAccuracy = item._iPLEnAc;
+		stats.fireMinDamage = item._iFMinDam;
+		stats.fireMaxDamage = item._iFMaxDam;
+		stats.lightningMinDamage = item._iLMinDam;
+		stats.lightningMaxDamage = item._iLMaxDam;
+	}
+
+	return stats;
+}
+
+/**
+ * @brief Adds the stats that add up, or takes them out with a sign of -1. The flags and spells are left as they are.
+ */
+void AddItemStats(ItemStats &totals, const ItemStats &stats, int sign)
+{
+	totals.minDamage += sign * stats.minDamage;
+	totals.maxDamage += sign * stats.maxDamage;
+	totals.armorClass += sign * stats.armorClass;
+	totals.bonusDamage += sign * stats.bonusDamage;
+	totals.bonusToHit += sign * stats.bonusToHit;
+	totals.bonusArmorClass += sign * stats.bonusArmorClass;
+	totals.strength += sign * stats.strength;
+	totals.magic += sign * stats.magic;
+	totals.dexterity += sign * stats.dexterity;
+	totals.vitality += sign * stats.vitality;
+	totals.fireResist += sign * stats.fireResist;
+	totals.lightningResist += sign * stats.lightningResist;
+	totals.magicResist += sign * stats.magicResist;
+	totals.damageMod += sign * stats.damageMod;
+	totals.getHit += sign * stats.getHit;
+	totals.lightRadius += sign * stats.lightRadius;
+	totals.hitPoints += sign * stats.hitPoints;
+	totals.mana += sign * stats.mana;
+	totals.spellLevels += sign * stats.spellLevels;
+	totals.enhancedAccuracy += sign * stats.enhancedAccuracy;
+	totals.fireMinDamage += sign * stats.fireMinDamage;
+	totals.fireMaxDamage += sign * stats.fireMaxDamage;
+	totals.lightningMinDamage += sign * stats.lightningMinDamage;
+	totals.lightningMaxDamage += sign * stats.lightningMaxDamage;
+}
+
+/**
+ * @brief Combines the flags and spells of the body slots, which can't be taken out of the totals again.
+ */
+void CombineItemFlags(ItemStats &totals, const ItemStats (&bodySlotStats)[NUM_INVLOC])
+{
+	totals.flags = ItemSpecialEffect::None;
+	totals.damAcFlags = ItemSpecialEffectHf::None;
+	totals.spells = 0;
+	for (const ItemStats &stats : bodySlotStats) {
+		totals.flags |= stats.flags;
+		totals.damAcFlags |= stats.damAcFlags;
+		totals.spells |= stats.spells;
+	}
+}
+
+/**
+ * @brief Counts what the changed body slots add to the stats again and updates their sum.
+ *
+ * Slots whose items became usable or unusable count as changed, as these depend on the stats the other items add.
+ */
+const ItemStats &CountEquippedItemStats(Player &player, uint8_t changedBodySlots)
+{
+	uint8_t usableBodySlots = 0;
+	for (int slot = 0; slot < NUM_INVLOC; slot++) {
+		const Item &item = player.InvBody[slot];
+		if (!item.isEmpty() && item._iStatFlag)
+			usableBodySlots |= BodySlotBit(static_cast<inv_body_loc>(slot));
+	}
+	changedBodySlots |= usableBodySlots ^ player.usableBodySlots;
+	player.usableBodySlots = usableBodySlots;
+
+	ItemStats &totals = player.equippedItemStats;
+	if (!player.bodySlotStatsCounted || changedBodySlots == AllBodySlots) {
+		totals = {};
+		for (int slot = 0; slot < NUM_INVLOC; slot++) {
+			player.bodySlotStats[slot] = GetItemStats(player.InvBody[slot]);
+			AddItemStats(totals, player.bodySlotStats[slot], 1);
+		}
+		CombineItemFlags(totals, player.bodySlotStats);
+		player.bodySlotStatsCounted = true;
+		return totals;
+	}
+
+	for (int slot = 0; slot < NUM_INVLOC; slot++) {
+		if ((changedBodySlots & BodySlotBit(static_cast<inv_body_loc>(slot))) == 0)
+			continue;
+		AddItemStats(totals, player.bodySlotStats[slot], -1);
+		player.bodySlotStats[slot] = GetItemStats(player.InvBody[slot]);
+		AddItemStats(totals, player.bodySlotStats[slot], 1);
+	}
+	CombineItemFlags(totals, player.bodySlotStats);
+
+	if (ItemStatsVerified) {
+		ItemStats sum {};
+		for (int slot = 0; slot < NUM_INVLOC; slot++) {
+			if (GetItemStats(player.InvBody[slot]) != player.bodySlotStats[slot])
+				app_fatal("CalcPlrItemVals: body slot %i changed without being counted again", slot);
+			AddItemStats(sum, player.bodySlotStats[slot], 1);
+		}
+		CombineItemFlags(sum, player.bodySlotStats);
+		if (sum != totals)
+			app_fatal("CalcPlrItemVals: the sum of the body slots is off");
+	}
+
+	return totals;
+}
+
 bool GetItemSpace(Point position, int8_t inum)
 {
 	int xx = 0;
@@ -824,11 +1101,11 @@ int SaveItemPower(Item &item, ItemPower &power)
 		break;
 	case IPL_MANA:
 		item._iPLMana += r << 6;
-		drawmanaflag = true;
+		RedrawComponent(PanelDrawComponent::Mana);
 		break;
 	case IPL_MANA_CURSE:
 		item._iPLMana -= r << 6;
-		drawmanaflag = true;
+		RedrawComponent(PanelDrawComponent::Mana);
 		break;
 	case IPL_DUR: {
 		int bonus = r * item._iMaxDur / 100;
@@ -884,7 +1161,7 @@ int SaveItemPower(Item &item, ItemPower &power)
 		break;
 	case IPL_NOMANA:
 		item._iFlags |= ItemSpecialEffect::NoMana;
-		drawmanaflag = true;
+		RedrawComponent(PanelDrawComponent::Mana);
 		break;
 	case IPL_NOHEALPLR:
 		item._iFlags |= ItemSpecialEffect::NoHealOnPlayer;
@@ -909,14 +1186,14 @@ int SaveItemPower(Item &item, ItemPower &power)
 			item._iFlags |= ItemSpecialEffect::StealMana3;
 		if (power.param1 == 5)
 			item._iFlags |= ItemSpecialEffect::StealMana5;
-		drawmanaflag = true;
+		RedrawComponent(PanelDrawComponent::Mana);
 		break;
 	case IPL_STEALLIFE:
 		if (power.param1 == 3)
 			item._iFlags |= ItemSpecialEffect::StealLife3;
 		if (power.param1 == 5)
 			item._iFlags |= ItemSpecialEffect::StealLife5;
-		drawhpflag = true;
+		RedrawComponent(PanelDrawComponent::Health);
 		break;
 	case IPL_TARGAC:
 		if (gbIsHellfire)
@@ -1048,8 +1325,13 @@ int SaveItemPower(Item &item, ItemPower &power)
 	return r;
 }
 
+/** @brief Whether item rolls on this thread pick the short names that fit the info box, see `SetThreadItemNameMeasuring`. */
+thread_local bool MeasureItemNames = true;
+
 bool StringInPanel(const char *str)
 {
+	if (!MeasureItemNames)
+		return true;
 	return GetLineWidth(str, GameFont12, 2) < 254;
 }
 
@@ -1081,22 +1363,9 @@ void GetStaffPower(Item &item, int lvl, int bs, bool onlygood)
 {
 	int preidx = -1;
 	if (GenerateRnd(10) == 0 || onlygood) {
-		int nl = 0;
-		int l[256];
-		for (int j = 0; ItemPrefixes[j].power.type != IPL_INVALID; j++) {
-			if (!IsPrefixValidForItemType(j, AffixItemType::Staff) || ItemPrefixes[j].PLMinLvl > lvl)
-				continue;
-			if (onlygood && !ItemPrefixes[j].PLOk)
-				continue;
-			l[nl] = j;
-			nl++;
-			if (ItemPrefixes[j].PLDouble) {
-				l[nl] = j;
-				nl++;
-			}
-		}
-		if (nl != 0) {
-			preidx = l[GenerateRnd(nl)];
+		const std::vector<int> &prefixes = GetItemCandidates({ ItemPicker::StaffPrefix, lvl, onlygood ? 1 : 0, 0, 0 }, [=]() { return GetStaffPrefixCandidates(lvl, onlygood); });
+		if (!prefixes.empty()) {
+			preidx = prefixes[GenerateRnd(static_cast<int>(prefixes.size()))];
 			item._iMagical = ITEM_QUALITY_MAGIC;
 			SaveItemAffix(item, ItemPrefixes[preidx]);
 			item._iPrePower = ItemPrefixes[preidx].power.type;
@@ -1149,7 +1418,6 @@ std::string GenerateMagicItemName(const string_view &baseNamel, int preidx, int
 
 void GetItemPower(Item &item, int minlvl, int maxlvl, AffixItemType flgs, bool onlygood)
 {
-	int l[256];
 	goodorevil goe;
 
 	int pre = GenerateRnd(4);
@@ -1166,25 +1434,9 @@ void GetItemPower(Item &item, int minlvl, int maxlvl, AffixItemType flgs, bool o
 	if (!onlygood && GenerateRnd(3) != 0)
 		onlygood = true;
 	if (pre == 0) {
-		int nt = 0;
-		for (int j = 0; ItemPrefixes[j].power.type != IPL_INVALID; j++) {
-			if (!IsPrefixValidForItemType(j, flgs))
-				continue;
-			if (ItemPrefixes[j].PLMinLvl < minlvl || ItemPrefixes[j].PLMinLvl > maxlvl)
-				continue;
-			if (onlygood && !ItemPrefixes[j].PLOk)
-				continue;
-			if (HasAnyOf(flgs, AffixItemType::Staff) && ItemPrefixes[j].power.type == IPL_CHARGES)
-				continue;
-			l[nt] = j;
-			nt++;
-			if (ItemPrefixes[j].PLDouble) {
-				l[nt] = j;
-				nt++;
-			}
-		}
-		if (nt != 0) {
-			preidx = l[GenerateRnd(nt)];
+		const std::vector<int> &prefixes = GetItemCandidates({ ItemPicker::Prefix, static_cast<int>(flgs), minlvl, maxlvl, onlygood ? 1 : 0 }, [=]() { return GetPrefixCandidates(flgs, minlvl, maxlvl, onlygood); });
+		if (!prefixes.empty()) {
+			preidx = prefixes[GenerateRnd(static_cast<int>(prefixes.size()))];
 			item._iMagical = ITEM_QUALITY_MAGIC;
 			SaveItemAffix(item, ItemPrefixes[preidx]);
 			item._iPrePower = ItemPrefixes[preidx].power.type;
@@ -1192,18 +1444,9 @@ void GetItemPower(Item &item, int minlvl, int maxlvl, AffixItemType flgs, bool o
 		}
 	}
 	if (post != 0) {
-		int nl = 0;
-		for (int j = 0; ItemSuffixes[j].power.type != IPL_INVALID; j++) {
-			if (IsSuffixValidForItemType(j, flgs)
-			    && ItemSuffixes[j].PLMinLvl >= minlvl && ItemSuffixes[j].PLMinLvl <= maxlvl
-			    && !((goe == GOE_GOOD && ItemSuffixes[j].PLGOE == GOE_EVIL) || (goe == GOE_EVIL && ItemSuffixes[j].PLGOE == GOE_GOOD))
-			    && (!onlygood || ItemSuffixes[j].PLOk)) {
-				l[nl] = j;
-				nl++;
-			}
-		}
-		if (nl != 0) {
-			sufidx = l[GenerateRnd(nl)];
+		const std::vector<int> &suffixes = GetItemCandidates({ ItemPicker::Suffix, static_cast<int>(flgs), minlvl, maxlvl, (onlygood ? 1 : 0) | (goe << 1) }, [=]() { return GetSuffixCandidates(flgs, minlvl, maxlvl, onlygood, goe); });
+		if (!suffixes.empty()) {
+			sufidx = suffixes[GenerateRnd(static_cast<int>(suffixes.size()))];
 			item._iMagical = ITEM_QUALITY_MAGIC;
 			SaveItemAffix(item, ItemSuffixes[sufidx]);
 			item._iSufPower = ItemSuffixes[sufidx].power.type;
@@ -1331,14 +1574,38 @@ void GetItemBonus(Item &item, int minlvl, int maxlvl, bool onlygood, bool allows
 	}
 }
 
-int RndUItem(Monster *monster)
+std::vector<int> GetDropCandidates(int minMLvl)
 {
-	if (monster != nullptr && (monster->MData->mTreasure & T_UNIQ) != 0 && !gbIsMultiplayer)
-		return -((monster->MData->mTreasure & T_MASK) + 1);
+	int ril[512];
 
+	int ri = 0;
+	for (int i = 0; AllItemsList[i].iLoc != ILOC_INVALID; i++) {
+		if (!IsItemAvailable(i))
+			continue;
+
+		if (AllItemsList[i].iRnd == IDROP_DOUBLE && minMLvl >= AllItemsList[i].iMinMLvl
+		    && ri < 512) {
+			ril[ri] = i;
+			ri++;
+		}
+		if (AllItemsList[i].iRnd != IDROP_NEVER && minMLvl >= AllItemsList[i].iMinMLvl
+		    && ri < 512) {
+			ril[ri] = i;
+			ri++;
+		}
+		if (AllItemsList[i].iSpell == SPL_RESURRECT && !gbIsMultiplayer)
+			ri--;
+		if (AllItemsList[i].iSpell == SPL_HEALOTHER && !gbIsMultiplayer)
+			ri--;
+	}
+
+	return { ril, ril + std::max(ri, 0) };
+}
+
+std::vector<int> GetUniqueDropCandidates(int minMLvl)
+{
 	int ril[512];
 
-	int curlv = ItemsGetCurrlevel();
 	int ri = 0;
 	for (int i = 0; AllItemsList[i].iLoc != ILOC_INVALID; i++) {
 		if (!IsItemAvailable(i))
@@ -1347,13 +1614,8 @@ int RndUItem(Monster *monster)
 		bool okflag = true;
 		if (AllItemsList[i].iRnd == IDROP_NEVER)
 			okflag = false;
-		if (monster != nullptr) {
-			if (monster->mLevel < AllItemsList[i].iMinMLvl)
-				okflag = false;
-		} else {
-			if (2 * curlv < AllItemsList[i].iMinMLvl)
-				okflag = false;
-		}
+		if (minMLvl < AllItemsList[i].iMinMLvl)
+			okflag = false;
 		if (AllItemsList[i].itype == ItemType::Misc)
 			okflag = false;
 		if (AllItemsList[i].itype == ItemType::Gold)
@@ -1370,23 +1632,28 @@ int RndUItem(Monster *monster)
 		}
 	}
 
-	return ril[GenerateRnd(ri)];
+	return { ril, ril + ri };
 }
 
-int RndAllItems()
+int RndUItem(Monster *monster)
 {
-	if (GenerateRnd(100) > 25)
-		return 0;
+	if (monster != nullptr && (monster->MData->mTreasure & T_UNIQ) != 0 && !gbIsMultiplayer)
+		return -((monster->MData->mTreasure & T_MASK) + 1);
+
+	const int minMLvl = monster != nullptr ? monster->mLevel : 2 * ItemsGetCurrlevel();
+	return RndItemCandidate({ ItemPicker::Unique, minMLvl, 0, 0, 0 }, [minMLvl]() { return GetUniqueDropCandidates(minMLvl); });
+}
 
+std::vector<int> GetAllItemsCandidates(int minMLvl)
+{
 	int ril[512];
 
-	int curlv = ItemsGetCurrlevel();
 	int ri = 0;
 	for (int i = 0; AllItemsList[i].iLoc != ILOC_INVALID; i++) {
 		if (!IsItemAvailable(i))
 			continue;
 
-		if (AllItemsList[i].iRnd != IDROP_NEVER && 2 * curlv >= AllItemsList[i].iMinMLvl && ri < 512) {
+		if (AllItemsList[i].iRnd != IDROP_NEVER && minMLvl >= AllItemsList[i].iMinMLvl && ri < 512) {
 			ril[ri] = i;
 			ri++;
 		}
@@ -1396,10 +1663,19 @@ int RndAllItems()
 			ri--;
 	}
 
-	return ril[GenerateRnd(ri)];
+	return { ril, ril + std::max(ri, 0) };
 }
 
-int RndTypeItems(ItemType itemType, int imid, int lvl)
+int RndAllItems()
+{
+	if (GenerateRnd(100) > 25)
+		return 0;
+
+	const int minMLvl = 2 * ItemsGetCurrlevel();
+	return RndItemCandidate({ ItemPicker::All, minMLvl, 0, 0, 0 }, [minMLvl]() { return GetAllItemsCandidates(minMLvl); });
+}
+
+std::vector<int> GetTypeItemsCandidates(ItemType itemType, int imid, int lvl)
 {
 	int ril[512];
 
@@ -1423,7 +1699,12 @@ int RndTypeItems(ItemType itemType, int imid, int lvl)
 		}
 	}
 
-	return ril[GenerateRnd(ri)];
+	return { ril, ril + ri };
+}
+
+int RndTypeItems(ItemType itemType, int imid, int lvl)
+{
+	return RndItemCandidate({ ItemPicker::Type, static_cast<int>(itemType), imid, lvl, 0 }, [=]() { return GetTypeItemsCandidates(itemType, imid, lvl); });
 }
 
 _unique_items CheckUnique(Item &item, int lvl, int uper, bool recreate)
@@ -1439,7 +1720,7 @@ _unique_items CheckUnique(Item &item, int lvl, int uper, bool recreate)
 			break;
 		if (UniqueItems[j].UIItemId == AllItemsList[item.IDidx].iItemId
 		    && lvl >= UniqueItems[j].UIMinLvl
-		    && (recreate || !UniqueItemFlags[j] || gbIsMultiplayer)) {
+		    && (recreate || !CurrentUniqueItemFlags[j] || gbIsMultiplayer)) {
 			uok[j] = true;
 			numu++;
 		}
@@ -1462,7 +1743,7 @@ _unique_items CheckUnique(Item &item, int lvl, int uper, bool recreate)
 
 void GetUniqueItem(Item &item, _unique_items uid)
 {
-	UniqueItemFlags[uid] = true;
+	CurrentUniqueItemFlags[uid] = true;
 
 	for (auto power : UniqueItems[uid].powers) {
 		if (power.type == IPL_INVALID)
@@ -1487,59 +1768,6 @@ void ItemRndDur(Item &item)
 		item._iDurability = GenerateRnd(item._iMaxDur / 2) + (item._iMaxDur / 4) + 1;
 }
 
-void SetupAllItems(Item &item, int idx, int iseed, int lvl, int uper, bool onlygood, bool recreate, bool pregen)
-{
-	item._iSeed = iseed;
-	SetRndSeed(iseed);
-	GetItemAttrs(item, idx, lvl / 2);
-	item._iCreateInfo = lvl;
-
-	if (pregen)
-		item._iCreateInfo |= CF_PREGEN;
-	if (onlygood)
-		item._iCreateInfo |= CF_ONLYGOOD;
-
-	if (uper == 15)
-		item._iCreateInfo |= CF_UPER15;
-	else if (uper == 1)
-		item._iCreateInfo |= CF_UPER1;
-
-	if (item._iMiscId != IMISC_UNIQUE) {
-		int iblvl = -1;
-		if (GenerateRnd(100) <= 10 || GenerateRnd(100) <= lvl) {
-			iblvl = lvl;
-		}
-		if (iblvl == -1 && item._iMiscId == IMISC_STAFF) {
-			iblvl = lvl;
-		}
-		if (iblvl == -1 && item._iMiscId == IMISC_RING) {
-			iblvl = lvl;
-		}
-		if (iblvl == -1 && item._iMiscId == IMISC_AMULET) {
-			iblvl = lvl;
-		}
-		if (onlygood)
-			iblvl = lvl;
-		if (uper == 15)
-			iblvl = lvl + 4;
-		if (iblvl != -1) {
-			_unique_items uid = CheckUnique(item, iblvl, uper, recreate);
-			if (uid == UITEM_INVALID) {
-				GetItemBonus(item, iblvl / 2, iblvl, onlygood, true);
-			} else {
-				GetUniqueItem(item, uid);
-			}
-		}
-		if (item._iMagical != ITEM_QUALITY_UNIQUE)
-			ItemRndDur(item);
-	} else {
-		if (item._iLoc != ILOC_UNEQUIPABLE) {
-			GetUniqueItem(item, (_unique_items)iseed); // uid is stored in iseed for uniques
-		}
-	}
-	SetupItem(item);
-}
-
 void SetupBaseItem(Point position, int idx, bool onlygood, bool sendmsg, bool delta)
 {
 	if (ActiveItemCount >= MAXITEMS)
@@ -1877,8 +2105,8 @@ bool SmithItemOk(int i)
 	return true;
 }
 
-template <bool (*Ok)(int), bool ConsiderDropRate = false>
-int RndVendorItem(int minlvl, int maxlvl)
+template <bool (*Ok)(int), bool ConsiderDropRate>
+std::vector<int> GetVendorItemCandidates(int minlvl, int maxlvl)
 {
 	int ril[512];
 
@@ -1907,12 +2135,22 @@ int RndVendorItem(int minlvl, int maxlvl)
 			break;
 	}
 
-	return ril[GenerateRnd(ri)] + 1;
+	return { ril, ril + ri };
+}
+
+/**
+ * @param picker Identifies `Ok` in the candidate tables
+ * @param variant Anything else that `Ok` depends on
+ */
+template <bool (*Ok)(int), bool ConsiderDropRate = false>
+int RndVendorItem(ItemPicker picker, int minlvl, int maxlvl, int variant = 0)
+{
+	return RndItemCandidate({ picker, minlvl, maxlvl, variant, 0 }, [=]() { return GetVendorItemCandidates<Ok, ConsiderDropRate>(minlvl, maxlvl); }) + 1;
 }
 
 int RndSmithItem(int lvl)
 {
-	return RndVendorItem<SmithItemOk, true>(0, lvl);
+	return RndVendorItem<SmithItemOk, true>(ItemPicker::Smith, 0, lvl);
 }
 
 void SortVendor(Item *itemList)
@@ -1951,7 +2189,7 @@ bool PremiumItemOk(int i)
 
 int RndPremiumItem(int minlvl, int maxlvl)
 {
-	return RndVendorItem<PremiumItemOk>(minlvl, maxlvl);
+	return RndVendorItem<PremiumItemOk>(ItemPicker::Premium, minlvl, maxlvl);
 }
 
 void SpawnOnePremium(Item &premiumItem, int plvl, int playerId)
@@ -2062,12 +2300,12 @@ bool WitchItemOk(int i)
 
 int RndWitchItem(int lvl)
 {
-	return RndVendorItem<WitchItemOk>(0, lvl);
+	return RndVendorItem<WitchItemOk>(ItemPicker::Witch, 0, lvl);
 }
 
 int RndBoyItem(int lvl)
 {
-	return RndVendorItem<PremiumItemOk>(0, lvl);
+	return RndVendorItem<PremiumItemOk>(ItemPicker::Premium, 0, lvl);
 }
 
 bool HealerItemOk(int i)
@@ -2101,9 +2339,30 @@ bool HealerItemOk(int i)
 	return false;
 }
 
+/**
+ * @brief The elixirs that `HealerItemOk` accepts, the only part of it that depends on the player.
+ */
+int GetHealerElixirs()
+{
+	if (gbIsMultiplayer || !gbIsHellfire)
+		return 0;
+
+	const Player &myPlayer = *MyPlayer;
+	int elixirs = 0;
+	if (myPlayer._pBaseStr < myPlayer.GetMaximumAttributeValue(CharacterAttribute::Strength))
+		elixirs |= 1 << 0;
+	if (myPlayer._pBaseMag < myPlayer.GetMaximumAttributeValue(CharacterAttribute::Magic))
+		elixirs |= 1 << 1;
+	if (myPlayer._pBaseDex < myPlayer.GetMaximumAttributeValue(CharacterAttribute::Dexterity))
+		elixirs |= 1 << 2;
+	if (myPlayer._pBaseVit < myPlayer.GetMaximumAttributeValue(CharacterAttribute::Vitality))
+		elixirs |= 1 << 3;
+	return elixirs;
+}
+
 int RndHealerItem(int lvl)
 {
-	return RndVendorItem<HealerItemOk>(0, lvl);
+	return RndVendorItem<HealerItemOk>(ItemPicker::Healer, 0, lvl, GetHealerElixirs());
 }
 
 void RecreateSmithItem(Item &item, int lvl, int iseed)
@@ -2237,6 +2496,53 @@ void NextItemRecord(int i)
 
 } // namespace
 
+bool ItemStats::operator==(const ItemStats &other) const
+{
+	return minDamage == other.minDamage
+	    && maxDamage == other.maxDamage
+	    && armorClass == other.armorClass
+	    && bonusDamage == other.bonusDamage
+	    && bonusToHit == other.bonusToHit
+	    && bonusArmorClass == other.bonusArmorClass
+	    && strength == other.strength
+	    && magic == other.magic
+	    && dexterity == other.dexterity
+	    && vitality == other.vitality
+	    && fireResist == other.fireResist
+	    && lightningResist == other.lightningResist
+	    && magicResist == other.magicResist
+	    && damageMod == other.damageMod
+	    && getHit == other.getHit
+	    && lightRadius == other.lightRadius
+	    && hitPoints == other.hitPoints
+	    && mana == other.mana
+	    && spellLevels == other.spellLevels
+	    && enhancedAccuracy == other.enhancedAccuracy
+	    && fireMinDamage == other.fireMinDamage
+	    && fireMaxDamage == other.fireMaxDamage
+	    && lightningMinDamage == other.lightningMinDamage
+	    && lightningMaxDamage == other.lightningMaxDamage
+	    && flags == other.flags
+	    && damAcFlags == other.damAcFlags
+	    && spells == other.spells;
+}
+
+void SetItemCandidateTablesEnabled(bool enabled)
+{
+	ItemCandidateTablesEnabled = enabled;
+	ItemCandidateTables.clear();
+}
+
+void SetThreadUniqueItemFlags(bool *flags)
+{
+	CurrentUniqueItemFlags = flags != nullptr ? flags : UniqueItemFlags;
+}
+
+void SetThreadItemNameMeasuring(bool enabled)
+{
+	MeasureItemNames = enabled;
+}
+
 bool IsItemAvailable(int i)
 {
 	if (i < 0 || i > IDI_LAST)
@@ -2338,92 +2644,58 @@ void InitItems()
 	initItemGetRecords();
 }
 
+void SetItemStatsVerified(bool verified)
+{
+	ItemStatsVerified = verified;
+}
+
 void CalcPlrItemVals(Player &player, bool loadgfx)
 {
-	int mind = 0; // min damage
-	int maxd = 0; // max damage
-	int tac = 0;  // accuracy
+	CalcPlrItemVals(player, loadgfx, AllBodySlots);
+}
 
-	int bdam = 0;   // bonus damage
-	int btohit = 0; // bonus chance to hit
-	int bac = 0;    // bonus accuracy
+void CalcPlrItemVals(Player &player, bool loadgfx, uint8_t changedBodySlots)
+{
+	const ItemStats &items = CountEquippedItemStats(player, changedBodySlots);
 
-	ItemSpecialEffect iflgs = ItemSpecialEffect::None; // item_special_effect flags
+	int mind = items.minDamage; // min damage
+	int maxd = items.maxDamage; // max damage
+	int tac = items.armorClass; // accuracy
 
-	ItemSpecialEffectHf pDamAcFlags = ItemSpecialEffectHf::None;
+	int bdam = items.bonusDamage;    // bonus damage
+	int btohit = items.bonusToHit;   // bonus chance to hit
+	int bac = items.bonusArmorClass; // bonus accuracy
 
-	int sadd = 0; // added strength
-	int madd = 0; // added magic
-	int dadd = 0; // added dexterity
-	int vadd = 0; // added vitality
+	ItemSpecialEffect iflgs = items.flags; // item_special_effect flags
 
-	uint64_t spl = 0; // bitarray for all enabled/active spells
+	ItemSpecialEffectHf pDamAcFlags = items.damAcFlags;
 
-	int fr = 0; // fire resistance
-	int lr = 0; // lightning resistance
-	int mr = 0; // magic resistance
+	int sadd = items.strength;  // added strength
+	int madd = items.magic;     // added magic
+	int dadd = items.dexterity; // added dexterity
+	int vadd = items.vitality;  // added vitality
 
-	int dmod = 0; // bonus damage mod?
-	int ghit = 0; // increased damage from enemies
+	uint64_t spl = items.spells; // bitarray for all enabled/active spells
 
-	int lrad = 10; // light radius
+	int fr = items.fireResist;      // fire resistance
+	int lr = items.lightningResist; // lightning resistance
+	int mr = items.magicResist;     // magic resistance
 
-	int ihp = 0;   // increased HP
-	int imana = 0; // increased mana
+	int dmod = items.damageMod; // bonus damage mod?
+	int ghit = items.getHit;    // increased damage from enemies
 
-	int spllvladd = 0; // increased spell level
-	int enac = 0;      // enhanced accuracy
+	int lrad = 10 + items.lightRadius; // light radius
 
-	int fmin = 0; // minimum fire damage
-	int fmax = 0; // maximum fire damage
-	int lmin = 0; // minimum lightning damage
-	int lmax = 0; // maximum lightning damage
+	int ihp = items.hitPoints; // increased HP
+	int imana = items.mana;    // increased mana
 
-	for (auto &item : player.InvBody) {
-		if (!item.isEmpty() && item._iStatFlag) {
+	int spllvladd = items.spellLevels; // increased spell level
+	int enac = items.enhancedAccuracy; // enhanced accuracy
 
-			mind += item._iMinDam;
-			maxd += item._iMaxDam;
-			tac += item._iAC;
-
-			if (item._iSpell != SPL_NULL) {
-				spl |= GetSpellBitmask(item._iSpell);
-			}
-
-			if (item._iMagical == ITEM_QUALITY_NORMAL || item._iIdentified) {
-				bdam += item._iPLDam;
-				btohit += item._iPLToHit;
-				if (item._iPLAC != 0) {
-					int tmpac = item._iAC;
-					tmpac *= item._iPLAC;
-					tmpac /= 100;
-					if (tmpac == 0)
-						tmpac = math::Sign(item._iPLAC);
-					bac += tmpac;
-				}
-				iflgs |= item._iFlags;
-				pDamAcFlags |= item._iDamAcFlags;
-				sadd += item._iPLStr;
-				madd += item._iPLMag;
-				dadd += item._iPLDex;
-				vadd += item._iPLVit;
-				fr += item._iPLFR;
-				lr += item._iPLLR;
-				mr += item._iPLMR;
-				dmod += item._iPLDamMod;
-				ghit += item._iPLGetHit;
-				lrad += item._iPLLight;
-				ihp += item._iPLHP;
-				imana += item._iPLMana;
-				spllvladd += item._iSplLvlAdd;
-				enac += item._iPLEnAc;
-				fmin += item._iFMinDam;
-				fmax += item._iFMaxDam;
-				lmin += item._iLMinDam;
-				lmax += item._iLMaxDam;
-			}
-		}
-	}
+	int fmin = items.fireMinDamage;      // minimum fire damage
+	int fmax = items.fireMaxDamage;      // maximum fire damage
+	int lmin = items.lightningMinDamage; // minimum lightning damage
+	int lmax = items.lightningMaxDamage; // maximum lightning damage
 
 	if (mind == 0 && maxd == 0) {
 		mind = 1;
@@ -2698,18 +2970,23 @@ void CalcPlrItemVals(Player &player, bool loadgfx)
 		}
 	}
 
-	drawmanaflag = true;
-	drawhpflag = true;
+	RedrawComponent(PanelDrawComponent::Mana);
+	RedrawComponent(PanelDrawComponent::Health);
 }
 
 void CalcPlrInv(Player &player, bool loadgfx)
+{
+	CalcPlrInv(player, loadgfx, AllBodySlots);
+}
+
+void CalcPlrInv(Player &player, bool loadgfx, uint8_t changedBodySlots)
 {
 	// Determine the players current stats, this updates the statFlag on all equipped items that became unusable after
 	//  a change in equipment.
 	CalcSelfItems(player);
 
 	// Determine the current item bonuses gained from usable equipped items
-	CalcPlrItemVals(player, loadgfx);
+	CalcPlrItemVals(player, loadgfx, changedBodySlots);
 
 	if (&player == MyPlayer) {
 		// Now that stat gains from equipped items have been calculated, mark unusable scrolls etc
@@ -3000,6 +3277,59 @@ void GetItemAttrs(Item &item, int itemData, int lvl)
 	SetPlrHandGoldCurs(item);
 }
 
+void SetupAllItems(Item &item, int idx, int iseed, int lvl, int uper, bool onlygood, bool recreate, bool pregen)
+{
+	item._iSeed = iseed;
+	SetRndSeed(iseed);
+	GetItemAttrs(item, idx, lvl / 2);
+	item._iCreateInfo = lvl;
+
+	if (pregen)
+		item._iCreateInfo |= CF_PREGEN;
+	if (onlygood)
+		item._iCreateInfo |= CF_ONLYGOOD;
+
+	if (uper == 15)
+		item._iCreateInfo |= CF_UPER15;
+	else if (uper == 1)
+		item._iCreateInfo |= CF_UPER1;
+
+	if (item._iMiscId != IMISC_UNIQUE) {
+		int iblvl = -1;
+		if (GenerateRnd(100) <= 10 || GenerateRnd(100) <= lvl) {
+			iblvl = lvl;
+		}
+		if (iblvl == -1 && item._iMiscId == IMISC_STAFF) {
+			iblvl = lvl;
+		}
+		if (iblvl == -1 && item._iMiscId == IMISC_RING) {
+			iblvl = lvl;
+		}
+		if (iblvl == -1 && item._iMiscId == IMISC_AMULET) {
+			iblvl = lvl;
+		}
+		if (onlygood)
+			iblvl = lvl;
+		if (uper == 15)
+			iblvl = lvl + 4;
+		if (iblvl != -1) {
+			_unique_items uid = CheckUnique(item, iblvl, uper, recreate);
+			if (uid == UITEM_INVALID) {
+				GetItemBonus(item, iblvl / 2, iblvl, onlygood, true);
+			} else {
+				GetUniqueItem(item, uid);
+			}
+		}
+		if (item._iMagical != ITEM_QUALITY_UNIQUE)
+			ItemRndDur(item);
+	} else {
+		if (item._iLoc != ILOC_UNEQUIPABLE) {
+			GetUniqueItem(item, (_unique_items)iseed); // uid is stored in iseed for uniques
+		}
+	}
+	SetupItem(item);
+}
+
 void SetupItem(Item &item)
 {
 	item.setNewAnimation(MyPlayer->pLvlLoad == 0);
@@ -3020,31 +3350,8 @@ int RndItem(const Monster &monster)
 	if (GenerateRnd(100) > 25)
 		return IDI_GOLD + 1;
 
-	int ril[512];
-
-	int ri = 0;
-	for (int i = 0; AllItemsList[i].iLoc != ILOC_INVALID; i++) {
-		if (!IsItemAvailable(i))
-			continue;
-
-		if (AllItemsList[i].iRnd == IDROP_DOUBLE && monster.mLevel >= AllItemsList[i].iMinMLvl
-		    && ri < 512) {
-			ril[ri] = i;
-			ri++;
-		}
-		if (AllItemsList[i].iRnd != IDROP_NEVER && monster.mLevel >= AllItemsList[i].iMinMLvl
-		    && ri < 512) {
-			ril[ri] = i;
-			ri++;
-		}
-		if (AllItemsList[i].iSpell == SPL_RESURRECT && !gbIsMultiplayer)
-			ri--;
-		if (AllItemsList[i].iSpell == SPL_HEALOTHER && !gbIsMultiplayer)
-			ri--;
-	}
-
-	int r = GenerateRnd(ri);
-	return ril[r] + 1;
+	const int minMLvl = monster.mLevel;
+	return RndItemCandidate({ ItemPicker::Drop, minMLvl, 0, 0, 0 }, [minMLvl]() { return GetDropCandidates(minMLvl); }) + 1;
 }
 
 void SpawnUnique(_unique_items uid, Point position)
@@ -3432,6 +3739,7 @@ void ProcessItems()
 
 void FreeItemGFX()
 {
+	ClearOutlineCache();
 	for (auto &itemanim : itemanims) {
 		itemanim = std::nullopt;
 	}
@@ -3846,25 +4154,25 @@ void UseItem(int pnum, item_misc_id mid, spell_id spl)
 	case IMISC_FOOD:
 		player.RestorePartialLife();
 		if (&player == MyPlayer) {
-			drawhpflag = true;
+			RedrawComponent(PanelDrawComponent::Health);
 		}
 		break;
 	case IMISC_FULLHEAL:
 		player.RestoreFullLife();
 		if (&player == MyPlayer) {
-			drawhpflag = true;
+			RedrawComponent(PanelDrawComponent::Health);
 		}
 		break;
 	case IMISC_MANA:
 		player.RestorePartialMana();
 		if (&player == MyPlayer) {
-			drawmanaflag = true;
+			RedrawComponent(PanelDrawComponent::Mana);
 		}
 		break;
 	case IMISC_FULLMANA:
 		player.RestoreFullMana();
 		if (&player == MyPlayer) {
-			drawmanaflag = true;
+			RedrawComponent(PanelDrawComponent::Mana);
 		}
 		break;
 	case IMISC_ELIXSTR:
@@ -3875,7 +4183,7 @@ void UseItem(int pnum, item_misc_id mid, spell_id spl)
 		if (gbIsHellfire) {
 			player.RestoreFullMana();
 			if (&player == MyPlayer) {
-				drawmanaflag = true;
+				RedrawComponent(PanelDrawComponent::Mana);
 			}
 		}
 		break;
@@ -3887,7 +4195,7 @@ void UseItem(int pnum, item_misc_id mid, spell_id spl)
 		if (gbIsHellfire) {
 			player.RestoreFullLife();
 			if (&player == MyPlayer) {
-				drawhpflag = true;
+				RedrawComponent(PanelDrawComponent::Health);
 			}
 		}
 		break;
@@ -3895,16 +4203,16 @@ void UseItem(int pnum, item_misc_id mid, spell_id spl)
 		player.RestorePartialLife();
 		player.RestorePartialMana();
 		if (&player == MyPlayer) {
-			drawhpflag = true;
-			drawmanaflag = true;
+			RedrawComponent(PanelDrawComponent::Health);
+			RedrawComponent(PanelDrawComponent::Mana);
 		}
 	} break;
 	case IMISC_FULLREJUV:
 		player.RestoreFullLife();
 		player.RestoreFullMana();
 		if (&player == MyPlayer) {
-			drawhpflag = true;
-			drawmanaflag = true;
+			RedrawComponent(PanelDrawComponent::Health);
+			RedrawComponent(PanelDrawComponent::Mana);
 		}
 		break;
 	case IMISC_SCROLL:
@@ -3957,7 +4265,7 @@ void UseItem(int pnum, item_misc_id mid, spell_id spl)
 				Stash.RefreshItemStatFlags();
 			}
 		}
-		drawmanaflag = true;
+		RedrawComponent(PanelDrawComponent::Mana);
 		break;
 	case IMISC_MAPOFDOOM:
 		doom_init();
@@ -4445,74 +4753,46 @@ void PutItemRecord(int nSeed, uint16_t wCI, int nIndex)
 
 #ifdef _DEBUG
 std::mt19937 BetterRng;
-std::string DebugSpawnItem(std::string itemName)
+
+namespace {
+
+/**
+ * @brief Searches a seed rolling an item that matches the query and drops that item next to the player.
+ */
+std::string DebugSpawnSearchedItem(const ItemSearchQuery &query)
 {
 	if (ActiveItemCount >= MAXITEMS)
 		return "No space to generate the item!";
 
-	const int max_time = 3000;
-	const int max_iter = 1000000;
-
-	std::transform(itemName.begin(), itemName.end(), itemName.begin(), [](unsigned char c) { return std::tolower(c); });
+	ItemSearchOptions options;
+	options.firstSeed = BetterRng();
+	options.maxCandidates = std::numeric_limits<uint32_t>::max();
+	options.timeLimitMs = 3000;
+	const ItemSearchResult result = SearchItem(query, options);
+	if (!result.found)
+		return fmt::format("Item not found in {:d} seconds! ({:d} seeds/s on {:d} threads)", options.timeLimitMs / 1000, result.SeedsPerSecond(), result.threads);
 
 	int ii = AllocateItem();
 	auto &item = Items[ii];
-	Point pos = MyPlayer->position.tile;
-	GetSuperItemSpace(pos, ii);
-
-	uint32_t begin = SDL_GetTicks();
-	Monster fake_m;
-	fake_m.MData = &MonstersData[0];
-	fake_m._uniqtype = 0;
-
-	int i = 0;
-	for (;; i++) {
-		// using a better rng here to seed the item to prevent getting stuck repeating same values using old one
-		std::uniform_int_distribution<int32_t> dist(0, INT_MAX);
-		SetRndSeed(dist(BetterRng));
-		if (SDL_GetTicks() - begin > max_time)
-			return fmt::format("Item not found in {:d} seconds!", max_time / 1000);
-
-		if (i > max_iter)
-			return fmt::format("Item not found in {:d} tries!", max_iter);
-
-		fake_m.mLevel = dist(BetterRng) % CF_LEVEL + 1;
-
-		int idx = RndItem(fake_m);
-		if (idx > 1) {
-			idx--;
-		} else
-			continue;
-
-		Point bkp = item.position;
-		item = {};
-		item.position = bkp;
-		SetupAllItems(item, idx, AdvanceRndSeed(), fake_m.mLevel, 1, false, false, false);
-
-		std::string tmp(item._iIName);
-		std::transform(tmp.begin(), tmp.end(), tmp.begin(), [](unsigned char c) { return std::tolower(c); });
-		if (tmp.find(itemName) != std::string::npos)
-			break;
-	}
-
+	GenerateSearchCandidate(item, query, result.seed);
+	GetSuperItemSpace(MyPlayer->position.tile, ii);
 	item._iIdentified = true;
 	NetSendCmdPItem(false, CMD_DROPITEM, item.position, item);
-	return fmt::format("Item generated successfully - iterations: {:d}", i);
+	return fmt::format("Item generated successfully - iterations: {:d} ({:d} seeds/s on {:d} threads)", result.candidates, result.SeedsPerSecond(), result.threads);
 }
 
-std::string DebugSpawnUniqueItem(std::string itemName)
-{
-	if (ActiveItemCount >= MAXITEMS)
-		return "No space to generate the item!";
+} // namespace
 
-	const int max_time = 3000;
-	const int max_iter = 1000000;
+std::string DebugSpawnItem(std::string itemName)
+{
+	return DebugSpawnSearchedItem(ParseItemSearchQuery(itemName));
+}
 
+std::string DebugSpawnUniqueItem(std::string itemName)
+{
 	std::transform(itemName.begin(), itemName.end(), itemName.begin(), [](unsigned char c) { return std::tolower(c); });
-	UniqueItem uniqueItem;
-	bool foundUnique = false;
-	int uniqueBaseIndex = 0;
-	int uniqueIndex = 0;
+	ItemSearchQuery query;
+	query.source = ItemSearchSource::Unique;
 	for (int j = 0; UniqueItems[j].UIItemId != UITYPE_INVALID; j++) {
 		if (!IsUniqueAvailable(j))
 			break;
@@ -4520,61 +4800,22 @@ std::string DebugSpawnUniqueItem(std::string itemName)
 		std::string tmp(UniqueItems[j].UIName);
 		std::transform(tmp.begin(), tmp.end(), tmp.begin(), [](unsigned char c) { return std::tolower(c); });
 		if (tmp.find(itemName) != std::string::npos) {
-			itemName = tmp;
-			uniqueItem = UniqueItems[j];
-			uniqueIndex = j;
-			foundUnique = true;
+			query.uniqueIndex = j;
 			break;
 		}
 	}
-	if (!foundUnique)
+	if (query.uniqueIndex == -1)
 		return "No unique found!";
 
+	bool foundBase = false;
 	for (int j = 0; AllItemsList[j].iLoc != ILOC_INVALID; j++) {
-		if (!IsItemAvailable(j))
-			continue;
-		if (AllItemsList[j].iItemId == uniqueItem.UIItemId)
-			uniqueBaseIndex = j;
+		if (IsItemAvailable(j) && AllItemsList[j].iItemId == UniqueItems[query.uniqueIndex].UIItemId)
+			foundBase = true;
 	}
-
-	int ii = AllocateItem();
-	auto &item = Items[ii];
-	Point pos = MyPlayer->position.tile;
-	GetSuperItemSpace(pos, ii);
-
-	int i = 0;
-	for (uint32_t begin = SDL_GetTicks();; i++) {
-		if (SDL_GetTicks() - begin > max_time)
-			return fmt::format("Item not found in {:d} seconds!", max_time / 1000);
-
-		if (i > max_iter)
-			return fmt::format("Item not found in {:d} tries!", max_iter);
-
-		Point bkp = item.position;
-		item = {};
-		item.position = bkp;
-		std::uniform_int_distribution<int32_t> dist(0, INT_MAX);
-		SetRndSeed(dist(BetterRng));
-		for (auto &flag : UniqueItemFlags)
-			flag = true;
-		UniqueItemFlags[uniqueIndex] = false;
-		SetupAllItems(item, uniqueBaseIndex, AdvanceRndSeed(), uniqueItem.UIMinLvl, 1, false, false, false);
-		for (auto &flag : UniqueItemFlags)
-			flag = false;
-
-		if (item._iMagical != ITEM_QUALITY_UNIQUE)
-			continue;
-
-		std::string tmp(item._iIName);
-		std::transform(tmp.begin(), tmp.end(), tmp.begin(), [](unsigned char c) { return std::tolower(c); });
-		if (tmp.find(itemName) != std::string::npos)
-			break;
+	if (!foundBase)
 		return "Impossible to generate!";
-	}
 
-	item._iIdentified = true;
-	NetSendCmdPItem(false, CMD_DROPITEM, item.position, item);
-	return fmt::format("Item generated successfully - iterations: {:d}", i);
+	return DebugSpawnSearchedItem(query);
 }
 #endif
 
@@ -426,6 +426,46 @@ struct Item {
 	void updateRequiredStatsCacheForPlayer(const Player &player);
 };
 
+/**
+ * @brief What usable equipped items add to the stats of their wearer, before the class and level of the hero come in.
+ */
+struct ItemStats {
+	int minDamage;
+	int maxDamage;
+	int armorClass;
+	int bonusDamage;
+	int bonusToHit;
+	int bonusArmorClass;
+	int strength;
+	int magic;
+	int dexterity;
+	int vitality;
+	int fireResist;
+	int lightningResist;
+	int magicResist;
+	int damageMod;
+	int getHit;
+	int lightRadius;
+	int hitPoints;
+	int mana;
+	int spellLevels;
+	int enhancedAccuracy;
+	int fireMinDamage;
+	int fireMaxDamage;
+	int lightningMinDamage;
+	int lightningMaxDamage;
+	ItemSpecialEffect flags;
+	ItemSpecialEffectHf damAcFlags;
+	/** Bitmask of the spells of the items */
+	uint64_t spells;
+
+	bool operator==(const ItemStats &other) const;
+	bool operator!=(const ItemStats &other) const
+	{
+		return !(*this == other);
+	}
+};
+
 struct ItemGetRecordStruct {
 	int32_t nSeed;
 	uint16_t wCI;
@@ -446,16 +486,47 @@ extern uint8_t ActiveItemCount;
 /** Contains the location of dropped items. */
 extern int8_t dItem[MAXDUNX][MAXDUNY];
 extern bool ShowUniqueItemInfoBox;
-extern CornerStoneStruct CornerStone;
+extern DVL_LEVEL_THREAD_LOCAL CornerStoneStruct CornerStone;
 extern bool UniqueItemFlags[128];
 
 BYTE GetOutlineColor(const Item &item, bool checkReq);
 bool IsItemAvailable(int i);
+/**
+ * @brief Enables keeping the base items and affixes each roll picks from, instead of listing them for every roll.
+ */
+void SetItemCandidateTablesEnabled(bool enabled);
+/**
+ * @brief Makes the item rolls of the calling thread check and mark other unique item flags than UniqueItemFlags.
+ * @param flags 128 flags, nullptr to use UniqueItemFlags again
+ */
+void SetThreadUniqueItemFlags(bool *flags);
+/**
+ * @brief Lets the item rolls of the calling thread keep the long item names without checking that they fit the info box.
+ *
+ * Only the names change, the rolls are the same either way.
+ */
+void SetThreadItemNameMeasuring(bool enabled);
 bool IsUniqueAvailable(int i);
 void InitItemGFX();
 void InitItems();
+/**
+ * @brief Makes CalcPlrItemVals count every body slot again after leaving out the unchanged ones, stopping the game if the
+ * stats differ.
+ */
+void SetItemStatsVerified(bool verified);
 void CalcPlrItemVals(Player &player, bool Loadgfx);
+/**
+ * @brief Like CalcPlrItemVals, after only the items of the given body slots changed.
+ *
+ * The other slots keep what they added to the stats the last time, unless their items became usable or unusable since.
+ * @param changedBodySlots One bit for each changed slot, see BodySlotBit
+ */
+void CalcPlrItemVals(Player &player, bool loadgfx, uint8_t changedBodySlots);
 void CalcPlrInv(Player &player, bool Loadgfx);
+/**
+ * @brief Like CalcPlrInv, after only the items of the given body slots changed, see CalcPlrItemVals.
+ */
+void CalcPlrInv(Player &player, bool loadgfx, uint8_t changedBodySlots);
 void InitializeItem(Item &item, int itemData);
 void GenerateNewSeed(Item &h);
 int GetGoldCursor(int value);
@@ -470,6 +541,7 @@ bool ItemSpaceOk(Point position);
 int AllocateItem();
 Point GetSuperItemLoc(Point position);
 void GetItemAttrs(Item &item, int itemData, int lvl);
+void SetupAllItems(Item &item, int idx, int iseed, int lvl, int uper, bool onlygood, bool recreate, bool pregen);
 void SetupItem(Item &item);
 int RndItem(const Monster &monster);
 void SpawnUnique(_unique_items uid, Point position);
@@ -15,26 +15,28 @@
 
 namespace devilution {
 
-int UberRow;
-int UberCol;
-bool IsUberRoomOpened;
+DVL_LEVEL_THREAD_LOCAL int UberRow;
+DVL_LEVEL_THREAD_LOCAL int UberCol;
+DVL_LEVEL_THREAD_LOCAL bool IsUberRoomOpened;
 bool IsUberLeverActivated;
 int UberDiabloMonsterIndex;
 
 namespace {
 
 /** Represents a tile ID map of twice the size, repeating each tile of the original map in blocks of 4. */
-BYTE L5dungeon[80][80];
+DVL_LEVEL_THREAD_LOCAL BYTE L5dungeon[80][80];
 /** Marks where walls may not be added to the level */
-Bitset2d<DMAXX, DMAXY> Chamber;
+DVL_LEVEL_THREAD_LOCAL Bitset2d<DMAXX, DMAXY> Chamber;
+/** Marks the tiles FirstRoom() mapped, to check and count them a row at a time. */
+DVL_LEVEL_THREAD_LOCAL Bitset2d<DMAXX, DMAXY> RoomTiles;
 /** Specifies whether to generate a horizontal or vertical layout. */
-bool VerticalLayout;
+DVL_LEVEL_THREAD_LOCAL bool VerticalLayout;
 /** Specifies whether to generate a room at position 1 in the Cathedral. */
-bool HasChamber1;
+DVL_LEVEL_THREAD_LOCAL bool HasChamber1;
 /** Specifies whether to generate a room at position 2 in the Cathedral. */
-bool HasChamber2;
+DVL_LEVEL_THREAD_LOCAL bool HasChamber2;
 /** Specifies whether to generate a room at position 3 in the Cathedral. */
-bool HasChamber3;
+DVL_LEVEL_THREAD_LOCAL bool HasChamber3;
 
 /** Contains shadows for 2x2 blocks of base tile IDs in the Cathedral. */
 const ShadowStruct SPATS[37] = {
@@ -867,31 +869,31 @@ void InitDungeonFlags()
 	memset(dungeon, 0, sizeof(dungeon));
 	Protected.reset();
 	Chamber.reset();
+	RoomTiles.reset();
 }
 
 void MapRoom(int x, int y, int width, int height)
 {
+	if (width <= 0 || height <= 0)
+		return;
+
 	for (int j = 0; j < height; j++) {
 		for (int i = 0; i < width; i++) {
 			dungeon[x + i][y + j] = Tile::VWall;
 		}
 	}
+	RoomTiles.set(x, y, width, height);
 }
 
 bool CheckRoom(int x, int y, int width, int height)
 {
-	for (int j = 0; j < height; j++) {
-		for (int i = 0; i < width; i++) {
-			if (i + x < 0 || i + x >= DMAXX || j + y < 0 || j + y >= DMAXY) {
-				return false;
-			}
-			if (dungeon[i + x][j + y] != 0) {
-				return false;
-			}
-		}
-	}
+	if (width <= 0 || height <= 0)
+		return true;
+	if (x < 0 || x + width > DMAXX || y < 0 || y + height > DMAXY)
+		return false;
 
-	return true;
+	// Until FirstRoom() is done, the tiles that aren't 0 are the ones it mapped.
+	return !RoomTiles.any(x, y, width, height);
 }
 
 void GenerateRoom(int x, int y, int w, int h, int dir)
@@ -978,14 +980,7 @@ void FirstRoom()
 		else
 			ye = 22;
 
-		for (int y = ys; y < ye; y++) {
-			dungeon[17][y] = Tile::VWall;
-			dungeon[18][y] = Tile::VWall;
-			dungeon[19][y] = Tile::VWall;
-			dungeon[20][y] = Tile::VWall;
-			dungeon[21][y] = Tile::VWall;
-			dungeon[22][y] = Tile::VWall;
-		}
+		MapRoom(17, ys, 6, ye - ys);
 
 		if (HasChamber1)
 			GenerateRoom(15, 1, 10, 10, 0);
@@ -1009,14 +1004,7 @@ void FirstRoom()
 		else
 			xe = 22;
 
-		for (int x = xs; x < xe; x++) {
-			dungeon[x][17] = Tile::VWall;
-			dungeon[x][18] = Tile::VWall;
-			dungeon[x][19] = Tile::VWall;
-			dungeon[x][20] = Tile::VWall;
-			dungeon[x][21] = Tile::VWall;
-			dungeon[x][22] = Tile::VWall;
-		}
+		MapRoom(xs, 17, xe - xs, 6);
 
 		if (HasChamber1)
 			GenerateRoom(1, 15, 10, 10, 1);
@@ -1029,16 +1017,7 @@ void FirstRoom()
 
 int FindArea()
 {
-	int rv = 0;
-
-	for (int j = 0; j < DMAXY; j++) {
-		for (int i = 0; i < DMAXX; i++) { // NOLINT(modernize-loop-convert)
-			if (dungeon[i][j] == Tile::VWall)
-				rv++;
-		}
-	}
-
-	return rv;
+	return static_cast<int>(RoomTiles.count());
 }
 
 void MakeDungeon()
@@ -1916,6 +1895,7 @@ void GenerateLevel(lvl_entry entry)
 		DRLG_InitTrans();
 
 		do {
+			LevelLayoutAttempts++;
 			InitDungeonFlags();
 			FirstRoom();
 		} while (FindArea() < minarea);
@@ -9,9 +9,9 @@
 
 namespace devilution {
 
-extern int UberRow;
-extern int UberCol;
-extern bool IsUberRoomOpened;
+extern DVL_LEVEL_THREAD_LOCAL int UberRow;
+extern DVL_LEVEL_THREAD_LOCAL int UberCol;
+extern DVL_LEVEL_THREAD_LOCAL bool IsUberRoomOpened;
 extern bool IsUberLeverActivated;
 extern int UberDiabloMonsterIndex;
 
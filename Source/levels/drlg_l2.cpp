@@ -19,13 +19,13 @@
 
 namespace devilution {
 
-BYTE predungeon[DMAXX][DMAXY];
+DVL_LEVEL_THREAD_LOCAL BYTE predungeon[DMAXX][DMAXY];
 
 namespace {
 
-int nRoomCnt;
-ROOMNODE RoomList[81];
-std::list<HALLNODE> HallList;
+DVL_LEVEL_THREAD_LOCAL int nRoomCnt;
+DVL_LEVEL_THREAD_LOCAL ROOMNODE RoomList[81];
+DVL_LEVEL_THREAD_LOCAL std::list<HALLNODE> HallList;
 
 const int DirXadd[5] = { 0, 0, 1, 0, -1 };
 const int DirYadd[5] = { 0, -1, 0, 1, 0 };
@@ -2404,8 +2404,10 @@ void FillVoid(bool xf1, bool yf1, bool xf2, bool yf2, int xx, int yy)
 
 bool FillVoids()
 {
+	// Only filling a void changes the count, most tries don't find one to fill.
+	int emptyTiles = CountEmptyTiles();
 	int to = 0;
-	while (CountEmptyTiles() > 700 && to < 100) {
+	while (emptyTiles > 700 && to < 100) {
 		int xx = GenerateRnd(38) + 1;
 		int yy = GenerateRnd(38) + 1;
 		if (predungeon[xx][yy] != 35) {
@@ -2454,11 +2456,12 @@ bool FillVoids()
 		}
 		if (xf1 || yf1 || xf2 || yf2) {
 			FillVoid(xf1, yf1, xf2, yf2, xx, yy);
+			emptyTiles = CountEmptyTiles();
 		}
 		to++;
 	}
 
-	return CountEmptyTiles() <= 700;
+	return emptyTiles <= 700;
 }
 
 bool CreateDungeon()
@@ -2711,6 +2714,7 @@ void GenerateLevel(lvl_entry entry)
 	LoadQuestSetPieces();
 
 	while (true) {
+		LevelLayoutAttempts++;
 		nRoomCnt = 0;
 		InitDungeonFlags();
 		DRLG_InitTrans();
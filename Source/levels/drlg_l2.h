@@ -24,7 +24,7 @@ struct ROOMNODE {
 	int nRoomy2;
 };
 
-extern BYTE predungeon[DMAXX][DMAXY];
+extern DVL_LEVEL_THREAD_LOCAL BYTE predungeon[DMAXX][DMAXY];
 
 void CreateL2Dungeon(uint32_t rseed, lvl_entry entry);
 void LoadPreL2Dungeon(const char *path);
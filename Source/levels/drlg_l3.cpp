@@ -10,13 +10,16 @@
 #include "objdat.h"
 #include "objects.h"
 #include "quests.h"
+#include "utils/bitset2d.hpp"
 
 namespace devilution {
 
 namespace {
 
-int lockoutcnt;
-bool lockout[DMAXX][DMAXY];
+DVL_LEVEL_THREAD_LOCAL int lockoutcnt;
+DVL_LEVEL_THREAD_LOCAL bool lockout[DMAXX][DMAXY];
+/** Marks the tiles the blocks of CreateBlock() filled, to check a block's area a row at a time. */
+DVL_LEVEL_THREAD_LOCAL Bitset2d<DMAXX, DMAXY> BlockTiles;
 
 /**
  * A lookup table for the 16 possible patterns of a 2x2 area,
@@ -704,6 +707,13 @@ void InitDungeonFlags()
 {
 	memset(dungeon, 0, sizeof(dungeon));
 	Protected.reset();
+	BlockTiles.reset();
+}
+
+void FillBlockTile(int x, int y)
+{
+	dungeon[x][y] = 1;
+	BlockTiles.set(x, y);
 }
 
 bool FillRoom(int x1, int y1, int x2, int y2)
@@ -712,14 +722,8 @@ bool FillRoom(int x1, int y1, int x2, int y2)
 		return false;
 	}
 
-	int v = 0;
-	for (int j = y1; j <= y2; j++) {
-		for (int i = x1; i <= x2; i++) {
-			v += dungeon[i][j];
-		}
-	}
-
-	if (v != 0) {
+	// Until the blocks are done, the tiles that aren't 0 are the ones they filled.
+	if (BlockTiles.any(x1, y1, x2 - x1 + 1, y2 - y1 + 1)) {
 		return false;
 	}
 
@@ -728,20 +732,22 @@ bool FillRoom(int x1, int y1, int x2, int y2)
 			dungeon[i][j] = 1;
 		}
 	}
+	if (x2 - x1 > 1 && y2 - y1 > 1)
+		BlockTiles.set(x1 + 1, y1 + 1, x2 - x1 - 1, y2 - y1 - 1);
 	for (int j = y1; j <= y2; j++) {
 		if (GenerateRnd(2) != 0) {
-			dungeon[x1][j] = 1;
+			FillBlockTile(x1, j);
 		}
 		if (GenerateRnd(2) != 0) {
-			dungeon[x2][j] = 1;
+			FillBlockTile(x2, j);
 		}
 	}
 	for (int i = x1; i <= x2; i++) {
 		if (GenerateRnd(2) != 0) {
-			dungeon[i][y1] = 1;
+			FillBlockTile(i, y1);
 		}
 		if (GenerateRnd(2) != 0) {
-			dungeon[i][y2] = 1;
+			FillBlockTile(i, y2);
 		}
 	}
 
@@ -2026,6 +2032,7 @@ void GenerateLevel(lvl_entry entry)
 	LoadQuestSetPieces();
 
 	while (true) {
+		LevelLayoutAttempts++;
 		InitDungeonFlags();
 		int x1 = GenerateRnd(20) + 10;
 		int y1 = GenerateRnd(20) + 10;
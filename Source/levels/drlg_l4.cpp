@@ -14,17 +14,17 @@
 
 namespace devilution {
 
-Point DiabloQuad1;
-Point DiabloQuad2;
-Point DiabloQuad3;
-Point DiabloQuad4;
+DVL_LEVEL_THREAD_LOCAL Point DiabloQuad1;
+DVL_LEVEL_THREAD_LOCAL Point DiabloQuad2;
+DVL_LEVEL_THREAD_LOCAL Point DiabloQuad3;
+DVL_LEVEL_THREAD_LOCAL Point DiabloQuad4;
 
 namespace {
 
-bool hallok[20];
-Point L4Hold;
-BYTE L4dungeon[80][80];
-BYTE dung[20][20];
+DVL_LEVEL_THREAD_LOCAL bool hallok[20];
+DVL_LEVEL_THREAD_LOCAL Point L4Hold;
+DVL_LEVEL_THREAD_LOCAL BYTE L4dungeon[80][80];
+DVL_LEVEL_THREAD_LOCAL BYTE dung[20][20];
 // int dword_52A4DC;
 
 /**
@@ -1203,6 +1203,7 @@ void GenerateLevel(lvl_entry entry)
 
 		constexpr int Minarea = 173;
 		do {
+			LevelLayoutAttempts++;
 			InitDungeonFlags();
 			FirstRoom();
 			FixRim();
@@ -9,10 +9,10 @@
 
 namespace devilution {
 
-extern Point DiabloQuad1;
-extern Point DiabloQuad2;
-extern Point DiabloQuad3;
-extern Point DiabloQuad4;
+extern DVL_LEVEL_THREAD_LOCAL Point DiabloQuad1;
+extern DVL_LEVEL_THREAD_LOCAL Point DiabloQuad2;
+extern DVL_LEVEL_THREAD_LOCAL Point DiabloQuad3;
+extern DVL_LEVEL_THREAD_LOCAL Point DiabloQuad4;
 
 void CreateL4Dungeon(uint32_t rseed, lvl_entry entry);
 void LoadPreL4Dungeon(const char *path);
@@ -15,41 +15,42 @@
 
 namespace devilution {
 
-uint8_t dungeon[DMAXX][DMAXY];
-uint8_t pdungeon[DMAXX][DMAXY];
-Bitset2d<DMAXX, DMAXY> Protected;
-Rectangle SetPieceRoom;
-Rectangle SetPiece;
-std::unique_ptr<uint16_t[]> pSetPiece;
+DVL_API_FOR_TEST DVL_LEVEL_THREAD_LOCAL uint8_t dungeon[DMAXX][DMAXY];
+DVL_LEVEL_THREAD_LOCAL uint8_t pdungeon[DMAXX][DMAXY];
+DVL_LEVEL_THREAD_LOCAL Bitset2d<DMAXX, DMAXY> Protected;
+DVL_LEVEL_THREAD_LOCAL Rectangle SetPieceRoom;
+DVL_LEVEL_THREAD_LOCAL Rectangle SetPiece;
+DVL_LEVEL_THREAD_LOCAL std::unique_ptr<uint16_t[]> pSetPiece;
 std::optional<OwnedCelSprite> pSpecialCels;
 std::unique_ptr<MegaTile[]> pMegaTiles;
 std::unique_ptr<byte[]> pDungeonCels;
 std::array<TileProperties, MAXTILES> SOLData;
-Point dminPosition;
-Point dmaxPosition;
-dungeon_type leveltype;
-uint8_t currlevel;
+DVL_LEVEL_THREAD_LOCAL Point dminPosition;
+DVL_LEVEL_THREAD_LOCAL Point dmaxPosition;
+DVL_API_FOR_TEST DVL_LEVEL_THREAD_LOCAL dungeon_type leveltype;
+DVL_API_FOR_TEST DVL_LEVEL_THREAD_LOCAL uint8_t currlevel;
 bool setlevel;
 _setlevels setlvlnum;
 dungeon_type setlvltype;
-Point ViewPosition;
+DVL_API_FOR_TEST DVL_LEVEL_THREAD_LOCAL Point ViewPosition;
 ScrollStruct ScrollInfo;
 int MicroTileLen;
-char TransVal;
-bool TransList[256];
-uint16_t dPiece[MAXDUNX][MAXDUNY];
+DVL_LEVEL_THREAD_LOCAL char TransVal;
+DVL_API_FOR_TEST DVL_LEVEL_THREAD_LOCAL bool TransList[256];
+DVL_API_FOR_TEST DVL_LEVEL_THREAD_LOCAL uint16_t dPiece[MAXDUNX][MAXDUNY];
 MICROS DPieceMicros[MAXTILES];
-int8_t dTransVal[MAXDUNX][MAXDUNY];
+DVL_API_FOR_TEST DVL_LEVEL_THREAD_LOCAL int8_t dTransVal[MAXDUNX][MAXDUNY];
 char dLight[MAXDUNX][MAXDUNY];
 char dPreLight[MAXDUNX][MAXDUNY];
-DungeonFlag dFlags[MAXDUNX][MAXDUNY];
+DVL_API_FOR_TEST DVL_LEVEL_THREAD_LOCAL DungeonFlag dFlags[MAXDUNX][MAXDUNY];
 int8_t dPlayer[MAXDUNX][MAXDUNY];
 int16_t dMonster[MAXDUNX][MAXDUNY];
 int8_t dCorpse[MAXDUNX][MAXDUNY];
 int8_t dObject[MAXDUNX][MAXDUNY];
-char dSpecial[MAXDUNX][MAXDUNY];
-int themeCount;
-THEME_LOC themeLoc[MAXTHEMES];
+DVL_LEVEL_THREAD_LOCAL char dSpecial[MAXDUNX][MAXDUNY];
+DVL_LEVEL_THREAD_LOCAL int themeCount;
+DVL_LEVEL_THREAD_LOCAL THEME_LOC themeLoc[MAXTHEMES];
+DVL_API_FOR_TEST DVL_LEVEL_THREAD_LOCAL int LevelLayoutAttempts;
 
 namespace {
 
@@ -365,13 +366,7 @@ void FindTransparencyValues(Point floor, uint8_t floorID)
 void InitGlobals()
 {
 	memset(dFlags, 0, sizeof(dFlags));
-	memset(dPlayer, 0, sizeof(dPlayer));
-	memset(dMonster, 0, sizeof(dMonster));
-	memset(dCorpse, 0, sizeof(dCorpse));
-	memset(dItem, 0, sizeof(dItem));
-	memset(dObject, 0, sizeof(dObject));
 	memset(dSpecial, 0, sizeof(dSpecial));
-	memset(dLight, DisableLighting || leveltype == DTYPE_TOWN ? 0 : 15, sizeof(dLight));
 
 	DRLG_InitTrans();
 
@@ -403,9 +398,20 @@ dungeon_type GetLevelType(int level)
 	return DTYPE_NONE;
 }
 
+void ClearLevelOccupants()
+{
+	memset(dPlayer, 0, sizeof(dPlayer));
+	memset(dMonster, 0, sizeof(dMonster));
+	memset(dCorpse, 0, sizeof(dCorpse));
+	memset(dItem, 0, sizeof(dItem));
+	memset(dObject, 0, sizeof(dObject));
+	memset(dLight, DisableLighting || leveltype == DTYPE_TOWN ? 0 : 15, sizeof(dLight));
+}
+
 void CreateDungeon(uint32_t rseed, lvl_entry entry)
 {
 	InitGlobals();
+	LevelLayoutAttempts = 0;
 
 	switch (leveltype) {
 	case DTYPE_TOWN:
@@ -558,6 +564,7 @@ void LoadDungeonBase(const char *path, Point spawn, int floorId, int dirtId)
 {
 	ViewPosition = spawn;
 
+	ClearLevelOccupants();
 	InitGlobals();
 
 	memset(dungeon, dirtId, sizeof(dungeon));
@@ -137,17 +137,23 @@ struct ShadowStruct {
 	uint8_t nv3;
 };
 
+/*
+ * The state a level is generated into is marked DVL_LEVEL_THREAD_LOCAL. Builds with the dungeon seed farm make it
+ * thread-local, so that levels can be generated on several threads at once. The game generates and plays its levels on
+ * the main thread.
+ */
+
 /** Contains the tile IDs of the map. */
-extern DVL_API_FOR_TEST uint8_t dungeon[DMAXX][DMAXY];
+extern DVL_API_FOR_TEST DVL_LEVEL_THREAD_LOCAL uint8_t dungeon[DMAXX][DMAXY];
 /** Contains a backup of the tile IDs of the map. */
-extern uint8_t pdungeon[DMAXX][DMAXY];
+extern DVL_LEVEL_THREAD_LOCAL uint8_t pdungeon[DMAXX][DMAXY];
 /** Tile that may not be overwritten by the level generator */
-extern Bitset2d<DMAXX, DMAXY> Protected;
-extern Rectangle SetPieceRoom;
+extern DVL_LEVEL_THREAD_LOCAL Bitset2d<DMAXX, DMAXY> Protected;
+extern DVL_LEVEL_THREAD_LOCAL Rectangle SetPieceRoom;
 /** Specifies the active set quest piece in coordinate. */
-extern Rectangle SetPiece;
+extern DVL_LEVEL_THREAD_LOCAL Rectangle SetPiece;
 /** Contains the contents of the single player quest DUN file. */
-extern std::unique_ptr<uint16_t[]> pSetPiece;
+extern DVL_LEVEL_THREAD_LOCAL std::unique_ptr<uint16_t[]> pSetPiece;
 extern std::optional<OwnedCelSprite> pSpecialCels;
 /** Specifies the tile definitions of the active dungeon type; (e.g. levels/l1data/l1.til). */
 extern DVL_API_FOR_TEST std::unique_ptr<MegaTile[]> pMegaTiles;
@@ -157,35 +163,35 @@ extern std::unique_ptr<byte[]> pDungeonCels;
  */
 extern DVL_API_FOR_TEST std::array<TileProperties, MAXTILES> SOLData;
 /** Specifies the minimum X,Y-coordinates of the map. */
-extern Point dminPosition;
+extern DVL_LEVEL_THREAD_LOCAL Point dminPosition;
 /** Specifies the maximum X,Y-coordinates of the map. */
-extern Point dmaxPosition;
+extern DVL_LEVEL_THREAD_LOCAL Point dmaxPosition;
 /** Specifies the active dungeon type of the current game. */
-extern DVL_API_FOR_TEST dungeon_type leveltype;
+extern DVL_API_FOR_TEST DVL_LEVEL_THREAD_LOCAL dungeon_type leveltype;
 /** Specifies the active dungeon level of the current game. */
-extern DVL_API_FOR_TEST uint8_t currlevel;
+extern DVL_API_FOR_TEST DVL_LEVEL_THREAD_LOCAL uint8_t currlevel;
 extern bool setlevel;
 /** Specifies the active quest level of the current game. */
 extern _setlevels setlvlnum;
 /** Specifies the player viewpoint X-coordinate of the map. */
 extern dungeon_type setlvltype;
 /** Specifies the player viewpoint X,Y-coordinates of the map. */
-extern DVL_API_FOR_TEST Point ViewPosition;
+extern DVL_API_FOR_TEST DVL_LEVEL_THREAD_LOCAL Point ViewPosition;
 extern ScrollStruct ScrollInfo;
 extern int MicroTileLen;
-extern char TransVal;
+extern DVL_LEVEL_THREAD_LOCAL char TransVal;
 /** Specifies the active transparency indices. */
-extern bool TransList[256];
+extern DVL_API_FOR_TEST DVL_LEVEL_THREAD_LOCAL bool TransList[256];
 /** Contains the piece IDs of each tile on the map. */
-extern DVL_API_FOR_TEST uint16_t dPiece[MAXDUNX][MAXDUNY];
+extern DVL_API_FOR_TEST DVL_LEVEL_THREAD_LOCAL uint16_t dPiece[MAXDUNX][MAXDUNY];
 /** Map of micros that comprises a full tile for any given dungeon piece. */
 extern MICROS DPieceMicros[MAXTILES];
 /** Specifies the transparency at each coordinate of the map. */
-extern DVL_API_FOR_TEST int8_t dTransVal[MAXDUNX][MAXDUNY];
+extern DVL_API_FOR_TEST DVL_LEVEL_THREAD_LOCAL int8_t dTransVal[MAXDUNX][MAXDUNY];
 extern char dLight[MAXDUNX][MAXDUNY];
 extern char dPreLight[MAXDUNX][MAXDUNY];
 /** Holds various information about dungeon tiles, @see DungeonFlag */
-extern DungeonFlag dFlags[MAXDUNX][MAXDUNY];
+extern DVL_API_FOR_TEST DVL_LEVEL_THREAD_LOCAL DungeonFlag dFlags[MAXDUNX][MAXDUNY];
 
 /** Contains the player numbers (players array indices) of the map. */
 extern int8_t dPlayer[MAXDUNX][MAXDUNY];
@@ -209,11 +215,24 @@ extern DVL_API_FOR_TEST int8_t dObject[MAXDUNX][MAXDUNY];
  * (e.g. "levels/l1data/l1s.cel"). Note, the special tileset of Tristram (i.e.
  * "levels/towndata/towns.cel") contains trees rather than arches.
  */
-extern char dSpecial[MAXDUNX][MAXDUNY];
-extern int themeCount;
-extern THEME_LOC themeLoc[MAXTHEMES];
+extern DVL_LEVEL_THREAD_LOCAL char dSpecial[MAXDUNX][MAXDUNY];
+extern DVL_LEVEL_THREAD_LOCAL int themeCount;
+extern DVL_LEVEL_THREAD_LOCAL THEME_LOC themeLoc[MAXTHEMES];
+/**
+ * Number of layouts the generator of the current level started, more than one when it started over because a layout
+ * failed its checks.
+ */
+extern DVL_API_FOR_TEST DVL_LEVEL_THREAD_LOCAL int LevelLayoutAttempts;
 
 dungeon_type GetLevelType(int level);
+/**
+ * @brief Clears the players, monsters, corpses, items and objects of the map and resets its light, before a level is
+ * created.
+ */
+void ClearLevelOccupants();
+/**
+ * @brief Generates the layout of the current level.
+ */
 void CreateDungeon(uint32_t rseed, lvl_entry entry);
 
 constexpr bool InDungeonBounds(Point position)
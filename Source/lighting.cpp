@@ -6,6 +6,9 @@
 #include "lighting.h"
 
 #include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory>
 
 #include "automap.h"
 #include "diablo.h"
@@ -456,6 +459,184 @@ uint8_t lightblock[64][16][16];
 /** RadiusAdj maps from VisionCrawlTable index to lighting vision radius adjustment. */
 const BYTE RadiusAdj[23] = { 0, 0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 4, 3, 2, 2, 2, 1, 1, 1, 0, 0, 0, 0 };
 
+/** @brief Number of steps of each ray of VisionCrawlTable. */
+constexpr int VisionRaySteps = 15;
+
+/** @brief A step of a ray, turned to one of the quadrants. */
+struct VisionStep {
+	/** @brief Offset of the step's tile from the center of the vision. */
+	Displacement tile;
+	/** @brief Offsets of the tiles next to a diagonal step, one of which must let the light through for the step to be seen. */
+	Displacement beside[2];
+	/** @brief The same offsets in the dungeon arrays, indexed as one. */
+	int tileOffset;
+	int besideOffset[2];
+};
+
+using VisionRay = std::array<VisionStep, VisionRaySteps>;
+
+/**
+ * @brief Turns the rays of VisionCrawlTable to each quadrant once, instead of on each step of DoVision().
+ */
+std::array<std::array<VisionRay, 23>, 4> BuildVisionRays()
+{
+	std::array<std::array<VisionRay, 23>, 4> rays {};
+	for (int v = 0; v < 4; v++) {
+		for (int j = 0; j < 23; j++) {
+			for (int k = 0; k < VisionRaySteps; k++) {
+				const int x = VisionCrawlTable[j][2 * k];
+				const int y = VisionCrawlTable[j][2 * k + 1];
+				const bool diagonal = x > 0 && y > 0;
+				VisionStep &step = rays[v][j][k];
+				switch (v) {
+				case 0:
+					step.tile = { x, y };
+					step.beside[0] = step.tile + Displacement { diagonal ? -1 : 0, 0 };
+					step.beside[1] = step.tile + Displacement { 0, diagonal ? -1 : 0 };
+					break;
+				case 1:
+					step.tile = { -x, -y };
+					step.beside[0] = step.tile + Displacement { 0, diagonal ? 1 : 0 };
+					step.beside[1] = step.tile + Displacement { diagonal ? 1 : 0, 0 };
+					break;
+				case 2:
+					step.tile = { x, -y };
+					step.beside[0] = step.tile + Displacement { diagonal ? -1 : 0, 0 };
+					step.beside[1] = step.tile + Displacement { 0, diagonal ? 1 : 0 };
+					break;
+				case 3:
+					step.tile = { -x, y };
+					step.beside[0] = step.tile + Displacement { 0, diagonal ? -1 : 0 };
+					step.beside[1] = step.tile + Displacement { diagonal ? 1 : 0, 0 };
+					break;
+				}
+				step.tileOffset = step.tile.deltaX * MAXDUNY + step.tile.deltaY;
+				for (int i = 0; i < 2; i++)
+					step.besideOffset[i] = step.beside[i].deltaX * MAXDUNY + step.beside[i].deltaY;
+			}
+		}
+	}
+	return rays;
+}
+
+const std::array<std::array<VisionRay, 23>, 4> VisionRays = BuildVisionRays();
+
+enum class VisionLight : uint8_t {
+	Unknown,
+	Transparent,
+	Blocked,
+};
+
+/**
+ * @brief What the visions of a ProcessVisionList() call found out about a tile.
+ *
+ * The rays of a vision and the visions of nearby players cross the same tiles many times.
+ */
+struct VisionTile {
+	/** @brief Whether the tile blocks the light, looked up once for all the visions. */
+	VisionLight light;
+	/** @brief Best explorer the tile was added to the automap for, adding it again for the same one changes nothing. */
+	MapExplorationType explorer;
+};
+
+VisionTile VisionTiles[MAXDUNX][MAXDUNY];
+
+void ClearVisionTiles()
+{
+	memset(VisionTiles, 0, sizeof(VisionTiles));
+}
+
+/**
+ * @brief The tiles of the dungeon, indexed by the offsets of the vision rays.
+ */
+struct VisionMap {
+	VisionTile *tiles = &VisionTiles[0][0];
+	const uint16_t *pieces = &dPiece[0][0];
+	DungeonFlag *flags = &dFlags[0][0];
+	const int8_t *transVal = &dTransVal[0][0];
+
+	bool IsBlocked(int tile) const
+	{
+		VisionLight &light = tiles[tile].light;
+		if (light == VisionLight::Unknown)
+			light = TileHasAny(pieces[tile], TileProperties::BlockLight) ? VisionLight::Blocked : VisionLight::Transparent;
+		return light == VisionLight::Blocked;
+	}
+
+	void SetVisible(int tile, MapExplorationType doautomap, bool visible) const
+	{
+		DungeonFlag &tileFlags = flags[tile];
+		if (doautomap != MAP_EXP_NONE) {
+			MapExplorationType &explorer = tiles[tile].explorer;
+			if (tileFlags != DungeonFlag::None && explorer < doautomap) {
+				SetAutomapView({ tile / MAXDUNY, tile % MAXDUNY }, doautomap);
+				explorer = doautomap;
+			}
+			tileFlags |= DungeonFlag::Explored;
+		}
+		if (visible) {
+			tileFlags |= DungeonFlag::Lit;
+		}
+		tileFlags |= DungeonFlag::Visible;
+	}
+};
+
+/**
+ * @brief Follows each ray of a vision until a tile blocks the light.
+ * @tparam CheckBounds Whether the rays may leave the dungeon, so that each tile has to be checked
+ */
+template <bool CheckBounds>
+void CrawlVisionRays(Point position, int nRadius, MapExplorationType doautomap, bool visible)
+{
+	const VisionMap map;
+	const int center = position.x * MAXDUNY + position.y;
+	const auto letsLightThrough = [&](Displacement beside, int offset) {
+		return (!CheckBounds || InDungeonBounds(position + beside)) && !map.IsBlocked(center + offset);
+	};
+
+	for (const std::array<VisionRay, 23> &quadrant : VisionRays) {
+		for (int j = 0; j < 23; j++) {
+			const int steps = std::min(nRadius - RadiusAdj[j], VisionRaySteps);
+			for (int k = 0; k < steps; k++) {
+				const VisionStep &step = quadrant[j][k];
+				if (CheckBounds && !InDungeonBounds(position + step.tile))
+					continue;
+				const int tile = center + step.tileOffset;
+				const bool blocker = map.IsBlocked(tile);
+				if (letsLightThrough(step.beside[0], step.besideOffset[0]) || letsLightThrough(step.beside[1], step.besideOffset[1])) {
+					map.SetVisible(tile, doautomap, visible);
+					if (!blocker) {
+						int8_t nTrans = map.transVal[tile];
+						if (nTrans != 0) {
+							TransList[nTrans] = true;
+						}
+					}
+				}
+				if (blocker)
+					break;
+			}
+		}
+	}
+}
+
+/**
+ * @brief Marks what a vision sees.
+ *
+ * The tiles must have been cleared by ClearVisionTiles() since the dungeon last changed.
+ */
+void CrawlVision(Point position, int nRadius, MapExplorationType doautomap, bool visible)
+{
+	if (InDungeonBounds(position))
+		VisionMap {}.SetVisible(position.x * MAXDUNY + position.y, doautomap, visible);
+
+	// The visions of the players and of the level's triggers are far enough from the edges for the rays to stay in the dungeon.
+	constexpr int Margin = VisionRaySteps + 1;
+	if (position.x >= Margin && position.x < MAXDUNX - Margin && position.y >= Margin && position.y < MAXDUNY - Margin)
+		CrawlVisionRays<false>(position, nRadius, doautomap, visible);
+	else
+		CrawlVisionRays<true>(position, nRadius, doautomap, visible);
+}
+
 void RotateRadius(int *x, int *y, int *dx, int *dy, int *lx, int *ly, int *bx, int *by)
 {
 	*bx = 0;
@@ -611,94 +792,24 @@ void DoUnVision(Point position, int nRadius)
 
 void DoVision(Point position, int nRadius, MapExplorationType doautomap, bool visible)
 {
-	if (InDungeonBounds(position)) {
-		if (doautomap != MAP_EXP_NONE) {
-			if (dFlags[position.x][position.y] != DungeonFlag::None) {
-				SetAutomapView(position, doautomap);
-			}
-			dFlags[position.x][position.y] |= DungeonFlag::Explored;
-		}
-		if (visible) {
-			dFlags[position.x][position.y] |= DungeonFlag::Lit;
-		}
-		dFlags[position.x][position.y] |= DungeonFlag::Visible;
-	}
-
-	for (int v = 0; v < 4; v++) {
-		for (int j = 0; j < 23; j++) {
-			bool nBlockerFlag = false;
-			int nLineLen = 2 * (nRadius - RadiusAdj[j]);
-			for (int k = 0; k < nLineLen && !nBlockerFlag; k += 2) {
-				int x1adj = 0;
-				int x2adj = 0;
-				int y1adj = 0;
-				int y2adj = 0;
-				int nCrawlX = 0;
-				int nCrawlY = 0;
-				switch (v) {
-				case 0:
-					nCrawlX = position.x + VisionCrawlTable[j][k];
-					nCrawlY = position.y + VisionCrawlTable[j][k + 1];
-					if (VisionCrawlTable[j][k] > 0 && VisionCrawlTable[j][k + 1] > 0) {
-						x1adj = -1;
-						y2adj = -1;
-					}
-					break;
-				case 1:
-					nCrawlX = position.x - VisionCrawlTable[j][k];
-					nCrawlY = position.y - VisionCrawlTable[j][k + 1];
-					if (VisionCrawlTable[j][k] > 0 && VisionCrawlTable[j][k + 1] > 0) {
-						y1adj = 1;
-						x2adj = 1;
-					}
-					break;
-				case 2:
-					nCrawlX = position.x + VisionCrawlTable[j][k];
-					nCrawlY = position.y - VisionCrawlTable[j][k + 1];
-					if (VisionCrawlTable[j][k] > 0 && VisionCrawlTable[j][k + 1] > 0) {
-						x1adj = -1;
-						y2adj = 1;
-					}
-					break;
-				case 3:
-					nCrawlX = position.x - VisionCrawlTable[j][k];
-					nCrawlY = position.y + VisionCrawlTable[j][k + 1];
-					if (VisionCrawlTable[j][k] > 0 && VisionCrawlTable[j][k + 1] > 0) {
-						y1adj = -1;
-						x2adj = 1;
-					}
-					break;
-				}
-				if (InDungeonBounds({ nCrawlX, nCrawlY })) {
-					nBlockerFlag = TileHasAny(dPiece[nCrawlX][nCrawlY], TileProperties::BlockLight);
-					if ((InDungeonBounds({ x1adj + nCrawlX, y1adj + nCrawlY })
-					        && !TileHasAny(dPiece[x1adj + nCrawlX][y1adj + nCrawlY], TileProperties::BlockLight))
-					    || (InDungeonBounds({ x2adj + nCrawlX, y2adj + nCrawlY })
-					        && !TileHasAny(dPiece[x2adj + nCrawlX][y2adj + nCrawlY], TileProperties::BlockLight))) {
-						if (doautomap != MAP_EXP_NONE) {
-							if (dFlags[nCrawlX][nCrawlY] != DungeonFlag::None) {
-								SetAutomapView({ nCrawlX, nCrawlY }, doautomap);
-							}
-							dFlags[nCrawlX][nCrawlY] |= DungeonFlag::Explored;
-						}
-						if (visible) {
-							dFlags[nCrawlX][nCrawlY] |= DungeonFlag::Lit;
-						}
-						dFlags[nCrawlX][nCrawlY] |= DungeonFlag::Visible;
-						if (!nBlockerFlag) {
-							int8_t nTrans = dTransVal[nCrawlX][nCrawlY];
-							if (nTrans != 0) {
-								TransList[nTrans] = true;
-							}
-						}
-					}
-				}
-			}
-		}
-	}
+	ClearVisionTiles();
+	CrawlVision(position, nRadius, doautomap, visible);
 }
 
-void MakeLightTable()
+namespace {
+
+/** @brief The tables built by MakeLightTable() for one dungeon type. */
+struct LightTableSet {
+	std::array<uint8_t, LIGHTSIZE> lightTables;
+	uint8_t lightRadius[16][128];
+};
+
+/** @brief Tables of the dungeon types visited so far, they only depend on the dungeon type. */
+std::array<std::unique_ptr<LightTableSet>, DTYPE_LAST + 1> CachedLightTables;
+
+bool LightBlockBuilt;
+
+void BuildLightTables()
 {
 	uint8_t *tbl = LightTables.data();
 	int shade = 0;
@@ -870,6 +981,10 @@ void MakeLightTable()
 			}
 		}
 	}
+}
+
+void BuildLightBlock()
+{
 	for (int j = 0; j < 8; j++) {
 		for (int i = 0; i < 8; i++) {
 			for (int k = 0; k < 16; k++) {
@@ -883,6 +998,34 @@ void MakeLightTable()
 	}
 }
 
+} // namespace
+
+void MakeLightTable()
+{
+	if (!LightBlockBuilt) {
+		BuildLightBlock();
+		LightBlockBuilt = true;
+	}
+
+	if (leveltype < 0 || leveltype > DTYPE_LAST) {
+		BuildLightTables();
+		return;
+	}
+
+	// Copying also undoes the color cycling of the previous visit.
+	std::unique_ptr<LightTableSet> &cached = CachedLightTables[leveltype];
+	if (cached != nullptr) {
+		LightTables = cached->lightTables;
+		memcpy(lightradius, cached->lightRadius, sizeof(lightradius));
+		return;
+	}
+
+	BuildLightTables();
+	cached = std::make_unique<LightTableSet>();
+	cached->lightTables = LightTables;
+	memcpy(cached->lightRadius, lightradius, sizeof(lightradius));
+}
+
 #ifdef _DEBUG
 void ToggleLighting()
 {
@@ -1126,6 +1269,7 @@ void ProcessVisionList()
 	for (int i = 0; i < TransVal; i++) {
 		TransList[i] = false;
 	}
+	ClearVisionTiles();
 	for (int i = 0; i < VisionCount; i++) {
 		auto &vision = VisionList[i];
 		if (vision._ldel)
@@ -1144,7 +1288,7 @@ void ProcessVisionList()
 				break;
 			}
 		}
-		DoVision(
+		CrawlVision(
 		    vision.position.tile,
 		    vision._lradius,
 		    doautomap,
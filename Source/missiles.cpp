@@ -17,6 +17,7 @@
 #include "engine/cel_header.hpp"
 #include "engine/load_file.hpp"
 #include "engine/random.hpp"
+#include "engine/render/scrollrt.h"
 #include "init.h"
 #include "inv.h"
 #include "levels/trigs.h"
@@ -1324,7 +1325,7 @@ void AddManaTrap(Missile &missile, const AddMissileParameter & /*parameter*/)
 		player._pMana = 0;
 		player._pManaBase = player._pMana + player._pMaxManaBase - player._pMaxMana;
 		CalcPlrInv(player, false);
-		drawmanaflag = true;
+		RedrawComponent(PanelDrawComponent::Mana);
 		PlaySfxLoc(TSFX_COW7, *trappedPlayerPosition);
 	}
 
@@ -1480,7 +1481,7 @@ void AddMana(Missile &missile, const AddMissileParameter & /*parameter*/)
 		player._pManaBase = player._pMaxManaBase;
 	UseMana(missile._misource, SPL_MANA);
 	missile._miDelFlag = true;
-	drawmanaflag = true;
+	RedrawComponent(PanelDrawComponent::Mana);
 }
 
 void AddMagi(Missile &missile, const AddMissileParameter & /*parameter*/)
@@ -1491,7 +1492,7 @@ void AddMagi(Missile &missile, const AddMissileParameter & /*parameter*/)
 	player._pManaBase = player._pMaxManaBase;
 	UseMana(missile._misource, SPL_MAGI);
 	missile._miDelFlag = true;
-	drawmanaflag = true;
+	RedrawComponent(PanelDrawComponent::Mana);
 }
 
 void AddRing(Missile &missile, const AddMissileParameter & /*parameter*/)
@@ -2227,7 +2228,7 @@ void AddHeal(Missile &missile, const AddMissileParameter & /*parameter*/)
 
 	UseMana(missile._misource, SPL_HEAL);
 	missile._miDelFlag = true;
-	drawhpflag = true;
+	RedrawComponent(PanelDrawComponent::Health);
 }
 
 void AddHealOther(Missile &missile, const AddMissileParameter & /*parameter*/)
@@ -7,6 +7,7 @@
 
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <climits>
 
 #include <fmt/format.h>
@@ -18,7 +19,9 @@
 #include "engine/load_file.hpp"
 #include "engine/points_in_rectangle_range.hpp"
 #include "engine/random.hpp"
+#include "engine/render/cl2_atlas.hpp"
 #include "engine/render/cl2_render.hpp"
+#include "engine/render/sprite_outline.hpp"
 #include "init.h"
 #include "levels/drlg_l1.h"
 #include "levels/drlg_l4.h"
@@ -34,6 +37,7 @@
 #include "towners.h"
 #include "utils/file_name_generator.hpp"
 #include "utils/language.h"
+#include "utils/log.hpp"
 #include "utils/stdcompat/string_view.hpp"
 #include "utils/utf8.hpp"
 
@@ -48,6 +52,8 @@ int LevelMonsterTypeCount;
 Monster Monsters[MAXMONSTERS];
 int ActiveMonsters[MAXMONSTERS];
 int ActiveMonsterCount;
+int AwakeMonsterCount;
+int DormantMonsterCount;
 // BUGFIX: replace MonsterKillCounts[MAXMONSTERS] with MonsterKillCounts[NUM_MTYPES].
 /** Tracks the total number of monsters killed per monster_id. */
 int MonsterKillCounts[MAXMONSTERS];
@@ -55,6 +61,16 @@ bool sgbSaveSoundOn;
 
 namespace {
 
+/**
+ * Whether a monster with MFLAG_GOLEM may be outside of GolemHoldingCell, which is what the other monsters check before
+ * looking for a monster to fight. Berserk monsters get MFLAG_GOLEM too, so they count. ProcessMonsters clears it for the
+ * duration of a tick when there is none, as only the players can cast golem and berserk.
+ */
+bool GolemsOnLevel = true;
+
+/** Whether ProcessMonsters skips the AI of the monsters that aren't alerted, see IsDormant. */
+bool DormantMonstersSkipped = true;
+
 #define NIGHTMARE_TO_HIT_BONUS 85
 #define HELL_TO_HIT_BONUS 120
 
@@ -186,6 +202,47 @@ void InitMonsterTRN(CMonster &monst)
 	}
 }
 
+/**
+ * @brief Decodes the animations of a monster type so they are faster to draw, see Cl2Atlas.
+ */
+void PredecodeMonsterGFX(const CMonster &monst)
+{
+	const auto start = std::chrono::steady_clock::now();
+	size_t sourceSize = 0;
+	size_t decodedSize = 0;
+
+	const size_t numAnims = GetNumAnims(*monst.MData);
+	for (size_t i = 0; i < numAnims; i++) {
+		const AnimStruct &anim = monst.Anims[i];
+		if (anim.Frames == 0)
+			continue;
+		for (size_t j = 0; j < 8; j++) {
+			const byte *data = anim.CelSpritesForDirections[j];
+			if (j > 0 && data == anim.CelSpritesForDirections[j - 1])
+				continue;
+			const Cl2Atlas &atlas = RegisterCl2Atlas(CelSprite(data, anim.Width));
+			sourceSize += atlas.SourceSize();
+			decodedSize += atlas.MemoryUsage();
+		}
+	}
+
+	const std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	LogVerbose("Predecoded {}: {} KiB of CL2 as {} KiB in {:.1f} ms", monst.MData->mName, sourceSize / 1024, decodedSize / 1024, elapsed.count());
+}
+
+/**
+ * @brief Drops what was decoded from the animations of a monster type, has to be called before they are freed.
+ */
+void FreeMonsterSpriteCaches(const CMonster &monst)
+{
+	for (const AnimStruct &anim : monst.Anims) {
+		for (const byte *data : anim.CelSpritesForDirections) {
+			UnregisterCl2Atlas(data);
+			EvictCachedOutlines(data);
+		}
+	}
+}
+
 void InitMonster(Monster &monster, Direction rd, int mtype, Point position)
 {
 	monster._mdir = rd;
@@ -731,9 +788,14 @@ void UpdateEnemy(Monster &monster)
 			}
 		}
 	}
-	for (int j = 0; j < ActiveMonsterCount; j++) {
+	// Monsters other than golems only fight golems, unless one of them is berserk.
+	const bool targetsAnyMonster = (monster._mFlags & (MFLAG_GOLEM | MFLAG_BERSERK)) != 0;
+	const int candidateCount = targetsAnyMonster || GolemsOnLevel ? ActiveMonsterCount : 0;
+	for (int j = 0; j < candidateCount; j++) {
 		int mi = ActiveMonsters[j];
 		auto &otherMonster = Monsters[mi];
+		if (!targetsAnyMonster && (otherMonster._mFlags & MFLAG_GOLEM) == 0)
+			continue;
 		if (&otherMonster == &monster)
 			continue;
 		if ((otherMonster._mhitpoints >> 6) <= 0)
@@ -3380,6 +3442,19 @@ void (*AiProc[])(int i) = {
 	/*AI_BONEDEMON*/ &AiRangedAvoidance
 };
 
+/**
+ * @brief Returns whether running the AI of the monster this tick would leave the game as it is.
+ *
+ * Only the state that all the players share is checked, so that every game skips the same monsters.
+ */
+bool IsDormant(const Monster &monster)
+{
+	return monster._msquelch == 0
+	    && monster._mmode == MonsterMode::Stand
+	    && (monster._mFlags & (MFLAG_SEARCH | MFLAG_TARGETS_MONSTER | MFLAG_GOLEM | MFLAG_BERSERK)) == 0
+	    && IsAiIdleWhenNotAlerted(monster._mAi);
+}
+
 bool IsRelativeMoveOK(const Monster &monster, Point position, Direction mdir)
 {
 	Point futurePosition = position + mdir;
@@ -3648,6 +3723,9 @@ void InitMonsterGFX(int monst)
 		return monsterData.Frames[i] != 0;
 	};
 
+	if (monster.animData != nullptr)
+		FreeMonsterSpriteCaches(monster);
+
 	std::array<uint32_t, MaxAnims> animOffsets;
 	monster.animData = MultiFileLoader<MaxAnims> {}(
 	    numAnims,
@@ -3683,6 +3761,9 @@ void InitMonsterGFX(int monst)
 		InitMonsterTRN(monster);
 	}
 
+	if (*sgOptions.Graphics.predecodeSprites)
+		PredecodeMonsterGFX(monster);
+
 	if (IsAnyOf(mtype, MT_NMAGMA, MT_YMAGMA, MT_BMAGMA, MT_WMAGMA))
 		MissileSpriteData[MFILE_MAGBALL].LoadGFX();
 	if (IsAnyOf(mtype, MT_STORM, MT_RSTORM, MT_STORML, MT_MAEL))
@@ -4205,11 +4286,58 @@ void DeleteMonsterList()
 	}
 }
 
+bool IsAiIdleWhenNotAlerted(_mai_id ai)
+{
+	switch (ai) {
+	case AI_ZOMBIE:
+	case AI_FAT:
+	case AI_SKELSD:
+	case AI_SKELBOW:
+	case AI_RHINO:
+	case AI_GOATMC:
+	case AI_GOATBOW:
+	case AI_MAGMA:
+	case AI_SKELKING:
+	case AI_BAT:
+	case AI_CLEAVER:
+	case AI_SUCC:
+	case AI_STORM:
+	case AI_ACID:
+	case AI_ACIDUNIQ:
+	case AI_SNAKE:
+	case AI_COUNSLR:
+	case AI_DIABLO:
+	case AI_FIREBAT:
+	case AI_TORCHANT:
+	case AI_HORKDMN:
+	case AI_LICH:
+	case AI_ARCHLICH:
+	case AI_PSYCHORB:
+	case AI_NECROMORB:
+	case AI_BONEDEMON:
+		return true;
+	default:
+		return false;
+	}
+}
+
+void SetDormantMonstersSkipped(bool skipped)
+{
+	DormantMonstersSkipped = skipped;
+}
+
 void ProcessMonsters()
 {
 	DeleteMonsterList();
 
 	assert(ActiveMonsterCount >= 0 && ActiveMonsterCount <= MAXMONSTERS);
+	// Monsters never cast golem or berserk, so no golem can join the level before the tick is over.
+	GolemsOnLevel = std::any_of(ActiveMonsters, ActiveMonsters + ActiveMonsterCount, [](int mi) {
+		const Monster &monster = Monsters[mi];
+		return (monster._mFlags & MFLAG_GOLEM) != 0 && monster.position.tile != GolemHoldingCell;
+	});
+	AwakeMonsterCount = 0;
+	DormantMonsterCount = 0;
 	for (int i = 0; i < ActiveMonsterCount; i++) {
 		int mi = ActiveMonsters[i];
 		auto &monster = Monsters[mi];
@@ -4262,8 +4390,14 @@ void ProcessMonsters()
 				monster._msquelch--;
 			}
 		}
+		// A monster that isn't alerted only idles until it is, so its AI isn't run.
+		const bool dormant = DormantMonstersSkipped && IsDormant(monster);
+		if (dormant)
+			DormantMonsterCount++;
+		else
+			AwakeMonsterCount++;
 		do {
-			if ((monster._mFlags & MFLAG_SEARCH) == 0 || !AiPlanPath(mi)) {
+			if (!dormant && ((monster._mFlags & MFLAG_SEARCH) == 0 || !AiPlanPath(mi))) {
 				AiProc[monster._mAi](mi);
 			}
 			switch (monster._mmode) {
@@ -4326,6 +4460,7 @@ void ProcessMonsters()
 			monster.AnimInfo.ProcessAnimation((monster._mFlags & MFLAG_LOCK_ANIMATION) != 0, (monster._mFlags & MFLAG_ALLOW_SPECIAL) != 0);
 		}
 	}
+	GolemsOnLevel = true;
 
 	DeleteMonsterList();
 }
@@ -4333,6 +4468,7 @@ void ProcessMonsters()
 void FreeMonsters()
 {
 	for (int i = 0; i < LevelMonsterTypeCount; i++) {
+		FreeMonsterSpriteCaches(LevelMonsterTypes[i]);
 		LevelMonsterTypes[i].animData = nullptr;
 	}
 }
@@ -164,44 +164,58 @@ struct CMonster {
 	const MonsterData *MData;
 };
 
+/**
+ * @brief A monster of the current level.
+ *
+ * The fields are ordered by how often the game logic reads them. The ones up to `position` fill the first cache line,
+ * as ProcessMonsters reads them for every monster on every game tick and UpdateEnemy for each monster it passes over
+ * while looking for an enemy. The fields of the AI and the animation follow, the ones only needed when the monster
+ * fights, dies or is drawn come last.
+ */
 struct Monster { // note: missing field _mAFNum
-	int _mMTidx;
+	uint32_t _mFlags;
+	int _mhitpoints;
 	MonsterMode _mmode;
-	monster_goal _mgoal;
-	int _mgoalvar1;
-	int _mgoalvar2;
-	int _mgoalvar3;
-	uint8_t _pathcount;
-	ActorPosition position;
-	/** Direction faced by monster (direction enum) */
-	Direction _mdir;
 	/** The current target of the mosnter. An index in to either the plr or monster array based on the _meflag value. */
 	int _menemy;
+	uint8_t _msquelch;
+	_mai_id _mAi;
+	_speech_id mtalkmsg;
+	int _mmaxhp;
+	ActorPosition position;
 	/** Usually correspond's to the enemy's future position */
 	Point enemyPosition;
+	/** Direction faced by monster (direction enum) */
+	Direction _mdir;
+	int8_t mLevel;
+	uint8_t leader;
+	LeaderRelation leaderRelation;
+	/** Seed used to determine AI behaviour/sync sounds in multiplayer games? */
+	uint32_t _mAISeed;
+	CMonster *MType;
+
 	/**
 	 * @brief Contains Information for current Animation
 	 */
 	AnimationInfo AnimInfo;
+	monster_goal _mgoal;
+	uint8_t _mint;
+	uint8_t _pathcount;
 	bool _mDelFlag;
+	int _mgoalvar1;
+	int _mgoalvar2;
+	int _mgoalvar3;
 	int _mVar1;
 	int _mVar2;
 	int _mVar3;
-	int _mmaxhp;
-	int _mhitpoints;
-	_mai_id _mAi;
-	uint8_t _mint;
-	uint32_t _mFlags;
-	uint8_t _msquelch;
+
+	int _mMTidx;
 	/** Seed used to determine item drops on death */
 	uint32_t _mRndSeed;
-	/** Seed used to determine AI behaviour/sync sounds in multiplayer games? */
-	uint32_t _mAISeed;
 	uint8_t _uniqtype;
 	uint8_t _uniqtrans;
 	int8_t _udeadval;
 	int8_t mWhoHit;
-	int8_t mLevel;
 	uint16_t mExp;
 	uint16_t mHit;
 	uint8_t mMinDamage;
@@ -211,13 +225,9 @@ struct Monster { // note: missing field _mAFNum
 	uint8_t mMaxDamage2;
 	uint8_t mArmorClass;
 	uint16_t mMagicRes;
-	_speech_id mtalkmsg;
-	uint8_t leader;
-	LeaderRelation leaderRelation;
 	uint8_t packsize;
 	int8_t mlid; // BUGFIX -1 is used when not emitting light this should be signed (fixed)
 	const char *mName;
-	CMonster *MType;
 	const MonsterData *MData;
 	std::unique_ptr<uint8_t[]> uniqueTRN;
 
@@ -269,6 +279,10 @@ extern int LevelMonsterTypeCount;
 extern Monster Monsters[MAXMONSTERS];
 extern int ActiveMonsters[MAXMONSTERS];
 extern int ActiveMonsterCount;
+/** Number of monsters whose AI ran during the last game tick. */
+extern int AwakeMonsterCount;
+/** Number of monsters that only idled during the last game tick, as their AI had nothing to do until they are alerted. */
+extern int DormantMonsterCount;
 extern int MonsterKillCounts[MAXMONSTERS];
 extern bool sgbSaveSoundOn;
 
@@ -295,6 +309,15 @@ void PrepDoEnding();
 void M_WalkDir(int i, Direction md);
 void GolumAi(int i);
 void DeleteMonsterList();
+/**
+ * @brief Returns whether the AI returns without doing anything for a standing monster that isn't alerted and can't see
+ * its enemy, so that ProcessMonsters doesn't have to run it for such a monster.
+ */
+bool IsAiIdleWhenNotAlerted(_mai_id ai);
+/**
+ * @brief Enables skipping the AI of the monsters that aren't alerted, which leaves the game as it would be with their AI.
+ */
+void SetDormantMonstersSkipped(bool skipped);
 void ProcessMonsters();
 void FreeMonsters();
 bool DirOK(int i, Direction mdir);
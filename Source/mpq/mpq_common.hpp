@@ -69,6 +69,8 @@ struct MpqHashEntry {
 struct MpqBlockEntry {
 	static constexpr uint32_t FlagExists = 0x80000000;
 	static constexpr uint32_t CompressPkZip = 0x00000100;
+	// Each sector starts with a byte that specifies its compression methods.
+	static constexpr uint32_t CompressMulti = 0x00000200;
 
 	// Offset to the start of this block.
 	uint32_t offset;
@@ -1,5 +1,6 @@
 #include "mpq/mpq_writer.hpp"
 
+#include <cassert>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
@@ -59,6 +60,9 @@ constexpr uint32_t BlockSize = 512 << BlockSizeFactor; // 4096
 // Sometimes we can end up with smaller blocks.
 constexpr uint32_t MinBlockSize = 1024;
 
+// Sector compression byte for deflate, used with `MpqBlockEntry::CompressMulti`.
+constexpr uint8_t MultiCompressionZlib = 0x02;
+
 void ByteSwapHdr(MpqFileHeader *hdr)
 {
 	hdr->signature = SDL_SwapLE32(hdr->signature);
@@ -84,8 +88,10 @@ bool IsUnallocatedBlock(const MpqBlockEntry *block)
 
 } // namespace
 
-MpqWriter::MpqWriter(const char *path)
+MpqWriter::MpqWriter(const char *path, CompressionType compression)
+    : compression_(compression)
 {
+	assert(compression == CompressionType::Implode || compression == CompressionType::Zlib);
 	LogVerbose("Opening {}", path);
 	bool exists = FileExists(path);
 	std::ios::openmode mode = std::ios::in | std::ios::out | std::ios::binary;
@@ -367,7 +373,8 @@ bool MpqWriter::WriteFileContents(const char *filename, const byte *fileData, si
 	// `packedSize` is reduced at the end of the function if it turns out to be smaller.
 	block->packedSize = fileSize + offsetTableByteSize;
 	block->unpackedSize = fileSize;
-	block->flags = MpqBlockEntry::FlagExists | MpqBlockEntry::CompressPkZip;
+	block->flags = MpqBlockEntry::FlagExists;
+	block->flags |= compression_ == CompressionType::Zlib ? MpqBlockEntry::CompressMulti : MpqBlockEntry::CompressPkZip;
 
 	// We populate the table of sector offsets while we write the data.
 	// We can't pre-populate it because we don't know the compressed sector sizes yet.
@@ -398,14 +405,26 @@ bool MpqWriter::WriteFileContents(const char *filename, const byte *fileData, si
 #endif
 
 	uint32_t destSize = offsetTableByteSize;
-	byte mpqBuf[BlockSize];
+	// The first byte is reserved for the sector compression byte of multi-compressed sectors.
+	byte mpqBuf[BlockSize + 1];
 	size_t curSector = 0;
 	while (true) {
 		uint32_t len = std::min<uint32_t>(fileSize, BlockSize);
-		memcpy(mpqBuf, fileData, len);
+		byte *sector = &mpqBuf[1];
+		memcpy(sector, fileData, len);
 		fileData += len;
-		len = PkwareCompress(mpqBuf, len);
-		if (!stream_.Write(reinterpret_cast<const char *>(&mpqBuf[0]), len))
+		if (compression_ == CompressionType::Zlib) {
+			// Sectors that do not shrink by more than the compression byte are stored as is.
+			const uint32_t compressedLen = ZlibCompress(sector, len, len - 1);
+			if (compressedLen + 1 < len) {
+				sector = &mpqBuf[0];
+				*sector = static_cast<byte>(MultiCompressionZlib);
+				len = compressedLen + 1;
+			}
+		} else {
+			len = PkwareCompress(sector, len);
+		}
+		if (!stream_.Write(reinterpret_cast<const char *>(sector), len))
 			return false;
 		offsetTable[curSector++] = SDL_SwapLE32(destSize);
 		destSize += len; // compressed length
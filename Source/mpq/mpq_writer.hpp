@@ -7,6 +7,7 @@
 
 #include <cstdint>
 
+#include "encrypt.h"
 #include "mpq/mpq_common.hpp"
 #include "utils/logged_fstream.hpp"
 #include "utils/stdcompat/cstddef.hpp"
@@ -14,7 +15,12 @@
 namespace devilution {
 class MpqWriter {
 public:
-	explicit MpqWriter(const char *path);
+	/**
+	 * @param path Path to the archive, it is created if it does not exist.
+	 * @param compression Compression used for files written to the archive, either `Implode` or `Zlib`.
+	 * Archives written with `Zlib` cannot be read by Diablo.
+	 */
+	explicit MpqWriter(const char *path, CompressionType compression = CompressionType::Implode);
 	MpqWriter(MpqWriter &&other) = default;
 	MpqWriter &operator=(MpqWriter &&other) = default;
 	~MpqWriter();
@@ -52,6 +58,7 @@ private:
 
 	LoggedFStream stream_;
 	std::string name_;
+	CompressionType compression_;
 	std::uintmax_t size_ {};
 	std::unique_ptr<MpqHashEntry[]> hashTable_;
 	std::unique_ptr<MpqBlockEntry[]> blockTable_;
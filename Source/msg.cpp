@@ -124,6 +124,13 @@ Item ItemLimbo;
 /** @brief Last sent player command for the local player. */
 TCmdLocParam4 lastSentPlayerCmd;
 
+/**
+ * @brief Compression used for outgoing level deltas.
+ *
+ * Joining a game requires the exact same version, so every peer is able to unpack it.
+ */
+constexpr CompressionType DeltaCompressionType = CompressionType::Lz4;
+
 uint8_t GetLevelForMultiplayer(uint8_t level, bool isSetLevel)
 {
 	if (isSetLevel)
@@ -420,20 +427,29 @@ void DeltaImportJunk(const byte *src)
 	}
 }
 
+/**
+ * @brief Compresses a delta chunk in place.
+ *
+ * The first byte of the chunk is reserved for the compression type so that the receiver knows how to unpack it.
+ */
 uint32_t CompressData(byte *buffer, byte *end)
 {
 	const auto size = static_cast<uint32_t>(end - buffer - 1);
-	const uint32_t pkSize = PkwareCompress(buffer + 1, size);
+	const uint32_t compressedSize = CompressBuffer(DeltaCompressionType, buffer + 1, size);
 
-	*buffer = size != pkSize ? byte { 1 } : byte { 0 };
+	const CompressionType type = size != compressedSize ? DeltaCompressionType : CompressionType::None;
+	*buffer = static_cast<byte>(type);
 
-	return pkSize + 1;
+	return compressedSize + 1;
 }
 
 void DeltaImportData(_cmd_id cmd, DWORD recvOffset)
 {
-	if (sgRecvBuf[0] != byte { 0 })
-		PkwareDecompress(&sgRecvBuf[1], recvOffset, sizeof(sgRecvBuf) - 1);
+	const auto type = static_cast<CompressionType>(sgRecvBuf[0]);
+	if (type != CompressionType::None && !DecompressBuffer(type, &sgRecvBuf[1], recvOffset - 1, sizeof(sgRecvBuf) - 1)) {
+		Log("Discarding invalid level delta");
+		return;
+	}
 
 	byte *src = &sgRecvBuf[1];
 	if (cmd == CMD_DLEVEL_JUNK) {
@@ -2171,19 +2187,27 @@ void run_delta_info()
 	FreePackets();
 }
 
+std::unique_ptr<byte[]> DeltaExportLevel(uint8_t level, uint32_t *size)
+{
+	std::unique_ptr<byte[]> dst { new byte[sizeof(DLevel) + 1 + sizeof(uint8_t)] };
+	byte *dstEnd = &dst.get()[1];
+	DLevel &deltaLevel = GetDeltaLevel(level);
+	*dstEnd = static_cast<byte>(level);
+	dstEnd += sizeof(uint8_t);
+	dstEnd = DeltaExportItem(dstEnd, deltaLevel.item);
+	dstEnd = DeltaExportObject(dstEnd, deltaLevel.object);
+	dstEnd = DeltaExportMonster(dstEnd, deltaLevel.monster);
+	*size = static_cast<uint32_t>(dstEnd - &dst.get()[1]);
+	return dst;
+}
+
 void DeltaExportData(int pnum)
 {
 	if (sgbDeltaChanged) {
 		for (auto &it : DeltaLevels) {
-			std::unique_ptr<byte[]> dst { new byte[sizeof(DLevel) + 1 + sizeof(uint8_t)] };
-			byte *dstEnd = &dst.get()[1];
-			DLevel &deltaLevel = it.second;
-			*dstEnd = static_cast<byte>(it.first);
-			dstEnd += sizeof(uint8_t);
-			dstEnd = DeltaExportItem(dstEnd, deltaLevel.item);
-			dstEnd = DeltaExportObject(dstEnd, deltaLevel.object);
-			dstEnd = DeltaExportMonster(dstEnd, deltaLevel.monster);
-			uint32_t size = CompressData(dst.get(), dstEnd);
+			uint32_t size;
+			std::unique_ptr<byte[]> dst = DeltaExportLevel(it.first, &size);
+			size = CompressData(dst.get(), &dst.get()[1 + size]);
 			dthread_send_delta(pnum, CMD_DLEVEL, std::move(dst), size);
 		}
 
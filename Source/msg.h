@@ -6,6 +6,7 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 
 #include "engine/point.hpp"
 #include "items.h"
@@ -718,6 +719,12 @@ extern int dwRecCount;
 void msg_send_drop_pkt(int pnum, int reason);
 bool msg_wait_resync();
 void run_delta_info();
+/**
+ * @brief Packs the delta of a level the way `DeltaExportData` sends it, before it is compressed.
+ * @param size Receives the size of the packed delta
+ * @return The packed delta, after a byte kept for the compression type
+ */
+std::unique_ptr<byte[]> DeltaExportLevel(uint8_t level, uint32_t *size);
 void DeltaExportData(int pnum);
 void DeltaSyncJunk();
 void delta_init();
@@ -4,6 +4,8 @@
  * Implementation of functions for keeping multiplaye games in sync.
  */
 
+#include <algorithm>
+
 #include <SDL.h>
 #include <config.h>
 
@@ -215,9 +217,15 @@ void ParseTurn(int pnum, uint32_t turn)
 {
 	if ((turn & 0x80000000) != 0)
 		HandleTurnUpperBit(pnum);
-	uint32_t absTurns = turn & 0x7FFFFFFF;
+	const uint32_t turnCounterMask = GetTurnCounterMask();
+	uint32_t absTurns = turn & turnCounterMask;
+	if (sgGameInitInfo.bAdaptiveTurns != 0) {
+		uint32_t senderTurnsInTransit = (turn & TurnsInTransitMask) >> TurnsInTransitShift;
+		// The sender might keep a different number of turns in transit, so compare the turns played so far.
+		absTurns = absTurns + 1 - std::min(absTurns + 1, senderTurnsInTransit);
+	}
 	if (sgbSentThisCycle < gdwTurnsInTransit + absTurns) {
-		if (absTurns >= 0x7FFFFFFF)
+		if (absTurns >= turnCounterMask)
 			absTurns &= 0xFFFF;
 		sgbSentThisCycle = absTurns + gdwTurnsInTransit;
 		sgdwGameLoops = 4 * absTurns * sgbNetUpdateRate;
@@ -321,12 +329,12 @@ void HandleAllPackets(int pnum, const byte *data, size_t size)
 void ProcessTmsgs()
 {
 	while (true) {
-		std::unique_ptr<byte[]> msg;
-		uint8_t size = tmsg_get(&msg);
+		byte msg[MaxTmsgLen];
+		uint8_t size = tmsg_get(msg);
 		if (size == 0)
 			break;
 
-		HandleAllPackets(MyPlayerId, msg.get(), size);
+		HandleAllPackets(MyPlayerId, msg, size);
 	}
 }
 
@@ -478,6 +486,7 @@ void InitGameInfo()
 	sgGameInitInfo.bTheoQuest = *sgOptions.Gameplay.theoQuest ? 1 : 0;
 	sgGameInitInfo.bCowQuest = *sgOptions.Gameplay.cowQuest ? 1 : 0;
 	sgGameInitInfo.bFriendlyFire = *sgOptions.Gameplay.friendlyFire ? 1 : 0;
+	sgGameInitInfo.bAdaptiveTurns = *sgOptions.Network.adaptiveTurns ? 1 : 0;
 }
 
 void NetSendLoPri(int playerId, const byte *data, size_t size)
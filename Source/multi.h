@@ -31,6 +31,12 @@ struct GameData {
 	uint8_t bTheoQuest;
 	uint8_t bCowQuest;
 	uint8_t bFriendlyFire;
+	/**
+	 * Whether the players adjust their turns in transit to the latency, which changes how turns are numbered and
+	 * encoded. Set by the host so that every player agrees, and zero in games hosted by older versions, as it takes
+	 * up what used to be padding.
+	 */
+	uint8_t bAdaptiveTurns;
 };
 
 /* @brief Contains info of running public game (for game list browsing) */
@@ -5,12 +5,17 @@
  */
 
 #include "nthread.h"
+
+#include <algorithm>
+
 #include "diablo.h"
 #include "engine/demomode.h"
 #include "gmenu.h"
+#include "multi.h"
 #include "storm/storm_net.hpp"
 #include "utils/sdl_mutex.h"
 #include "utils/sdl_thread.h"
+#include "utils/stdcompat/algorithm.hpp"
 
 namespace devilution {
 
@@ -34,6 +39,29 @@ bool sgbTicsOutOfSync;
 char sgbPacketCountdown;
 bool sgbThreadIsRunning;
 SdlThread Thread;
+TurnScheduler AdaptiveTurns;
+
+/** Number of packet intervals per turn, see `nthread_recv_turns`. */
+constexpr uint32_t PacketsPerTurn = 4;
+/** A turn has to be sent this many jitter deviations early to reliably arrive in time. */
+constexpr uint32_t JitterMargin = 4;
+
+uint32_t RequiredTurnsInTransit(uint32_t leadTime, uint32_t turnDuration, uint32_t minTurnsInTransit)
+{
+	// Each turn in transit gives the other players one more turn to receive it.
+	uint32_t turns = (leadTime + turnDuration - 1) / std::max<uint32_t>(turnDuration, 1);
+	return clamp(turns, minTurnsInTransit, TurnScheduler::MaxTurnsInTransit);
+}
+
+void UpdateTurnsInTransit()
+{
+	uint32_t roundTripLatency;
+	uint32_t jitter;
+	if (!SNetGetLatency(&roundTripLatency, &jitter))
+		return;
+
+	gdwTurnsInTransit = AdaptiveTurns.Update(roundTripLatency, jitter, gnTickDelay * PacketsPerTurn * sgbNetUpdateRate);
+}
 
 void NthreadHandler()
 {
@@ -61,6 +89,44 @@ void NthreadHandler()
 
 } // namespace
 
+void TurnScheduler::Reset(uint32_t minTurnsInTransit)
+{
+	minTurnsInTransit_ = std::min(minTurnsInTransit, MaxTurnsInTransit);
+	turnsInTransit_ = minTurnsInTransit_;
+	stableTurns_ = 0;
+}
+
+uint32_t TurnScheduler::Update(uint32_t roundTripLatency, uint32_t jitter, uint32_t turnDuration)
+{
+	uint32_t leadTime = roundTripLatency / 2 + JitterMargin * jitter;
+
+	uint32_t required = RequiredTurnsInTransit(leadTime, turnDuration, minTurnsInTransit_);
+	if (required >= turnsInTransit_) {
+		turnsInTransit_ = required;
+		stableTurns_ = 0;
+		return turnsInTransit_;
+	}
+
+	// Leave some headroom when lowering, so that a connection close to the threshold does not flip back and forth.
+	uint32_t relaxed = RequiredTurnsInTransit(leadTime + leadTime / 4, turnDuration, minTurnsInTransit_);
+	if (relaxed >= turnsInTransit_) {
+		stableTurns_ = 0;
+		return turnsInTransit_;
+	}
+
+	stableTurns_++;
+	if (stableTurns_ >= StableTurnsBeforeLowering) {
+		turnsInTransit_--;
+		stableTurns_ = 0;
+	}
+	return turnsInTransit_;
+}
+
+uint32_t GetTurnCounterMask()
+{
+	return sgGameInitInfo.bAdaptiveTurns != 0 ? TurnCounterMask : 0x7FFFFFFF;
+}
+
 void nthread_terminate_game(const char *pszFcn)
 {
 	uint32_t sErr = SErrGetLastError();
@@ -81,9 +147,13 @@ uint32_t nthread_send_and_recv_turn(uint32_t curTurn, int turnDelta)
 		nthread_terminate_game("SNetGetTurnsInTransit");
 		return 0;
 	}
+	const uint32_t turnCounterMask = GetTurnCounterMask();
 	while (curTurnsInTransit++ < gdwTurnsInTransit) {
 
-		uint32_t turnTmp = turn_upper_bit | (curTurn & 0x7FFFFFFF);
+		uint32_t turnTmp = turn_upper_bit | (curTurn & turnCounterMask);
+		// Other players need to know how far ahead this turn was sent to derive the turns actually played.
+		if (sgGameInitInfo.bAdaptiveTurns != 0)
+			turnTmp |= gdwTurnsInTransit << TurnsInTransitShift;
 		turn_upper_bit = 0;
 		uint32_t turn = turnTmp;
 
@@ -93,7 +163,7 @@ uint32_t nthread_send_and_recv_turn(uint32_t curTurn, int turnDelta)
 		}
 
 		curTurn += turnDelta;
-		if (curTurn >= 0x7FFFFFFF)
+		if (curTurn >= turnCounterMask)
 			curTurn &= 0xFFFF;
 	}
 	return curTurn;
@@ -128,8 +198,11 @@ bool nthread_recv_turns(bool *pfSendAsync)
 		sgbTicsOutOfSync = true;
 		last_tick = SDL_GetTicks();
 	}
-	sgbSyncCountdown = 4;
+	sgbSyncCountdown = PacketsPerTurn;
 	multi_msg_countdown();
+	// Only after the received turns were parsed, as they were sent with the previous number of turns in transit.
+	if (sgGameInitInfo.bAdaptiveTurns != 0)
+		UpdateTurnsInTransit();
 	if (pfSendAsync != nullptr)
 		*pfSendAsync = true;
 	last_tick += gnTickDelay;
@@ -157,6 +230,8 @@ void nthread_start(bool setTurnUpperBit)
 	gdwTurnsInTransit = caps.defaultturnsintransit;
 	if (gdwTurnsInTransit == 0)
 		gdwTurnsInTransit = 1;
+	AdaptiveTurns.Reset(gdwTurnsInTransit);
+	gdwTurnsInTransit = AdaptiveTurns.TurnsInTransit();
 	if (caps.defaultturnssec <= 20 && caps.defaultturnssec != 0)
 		sgbNetUpdateRate = 20 / caps.defaultturnssec;
 	else
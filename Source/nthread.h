@@ -10,6 +10,51 @@
 
 namespace devilution {
 
+/** @brief Bits of a turn value that hold the sender's number of turns in transit, in games with adaptive turns. */
+constexpr uint32_t TurnsInTransitMask = 0x70000000;
+constexpr int TurnsInTransitShift = 28;
+/** @brief Bits of a turn value that hold the sender's turn counter, in games with adaptive turns. */
+constexpr uint32_t TurnCounterMask = 0x0FFFFFFF;
+
+/**
+ * @brief Chooses how many turns to keep in transit from the measured round trip time and jitter.
+ *
+ * More turns in transit hide network latency but make the game stall for longer when a player lags behind.
+ * The number is raised as soon as the connection gets worse, but only lowered after it was better for a while.
+ */
+class TurnScheduler {
+public:
+	static constexpr uint32_t MaxTurnsInTransit = TurnsInTransitMask >> TurnsInTransitShift;
+	/** @brief Consecutive turns with a better connection that are needed to lower the turns in transit by one. */
+	static constexpr uint32_t StableTurnsBeforeLowering = 10;
+
+	void Reset(uint32_t minTurnsInTransit);
+
+	/**
+	 * @brief Updates the number of turns in transit with a new measurement.
+	 * @param roundTripLatency Smoothed round trip time in milliseconds.
+	 * @param jitter Smoothed deviation of the round trip time in milliseconds.
+	 * @param turnDuration Duration of a turn in milliseconds.
+	 * @return The number of turns to keep in transit.
+	 */
+	uint32_t Update(uint32_t roundTripLatency, uint32_t jitter, uint32_t turnDuration);
+
+	[[nodiscard]] uint32_t TurnsInTransit() const
+	{
+		return turnsInTransit_;
+	}
+
+private:
+	uint32_t minTurnsInTransit_ = 1;
+	uint32_t turnsInTransit_ = 1;
+	uint32_t stableTurns_ = 0;
+};
+
+/**
+ * @brief Returns the bits of a turn value that hold the sender's turn counter in the current game.
+ */
+uint32_t GetTurnCounterMask();
+
 extern BYTE sgbNetUpdateRate;
 extern size_t gdwMsgLenTbl[MAX_PLRS];
 extern uint32_t gdwTurnsInTransit;
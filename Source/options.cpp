@@ -16,6 +16,7 @@
 #include "control.h"
 #include "discord/discord.h"
 #include "engine/demomode.h"
+#include "engine/render/text_render.hpp"
 #include "engine/sound_defs.hpp"
 #include "hwcursor.hpp"
 #include "options.h"
@@ -289,6 +290,7 @@ void OptionLanguageCodeChanged()
 {
 	LanguageInitialize();
 	LoadLanguageArchive();
+	UnloadFonts();
 }
 
 void OptionGameModeChanged()
@@ -344,6 +346,7 @@ void LoadOptions()
 	GetIniValue("Hellfire", "SItem", sgOptions.Hellfire.szItem, sizeof(sgOptions.Hellfire.szItem), "");
 
 	GetIniValue("Network", "Bind Address", sgOptions.Network.szBindAddress, sizeof(sgOptions.Network.szBindAddress), "0.0.0.0");
+	GetIniValue("Network", "Relay Server", sgOptions.Network.szRelayServer, sizeof(sgOptions.Network.szRelayServer), "");
 	GetIniValue("Network", "Previous Game ID", sgOptions.Network.szPreviousZTGame, sizeof(sgOptions.Network.szPreviousZTGame), "");
 	GetIniValue("Network", "Previous Host", sgOptions.Network.szPreviousHost, sizeof(sgOptions.Network.szPreviousHost), "");
 
@@ -376,6 +379,7 @@ void SaveOptions()
 	SetIniValue("Hellfire", "SItem", sgOptions.Hellfire.szItem);
 
 	SetIniValue("Network", "Bind Address", sgOptions.Network.szBindAddress);
+	SetIniValue("Network", "Relay Server", sgOptions.Network.szRelayServer);
 	SetIniValue("Network", "Previous Game ID", sgOptions.Network.szPreviousZTGame);
 	SetIniValue("Network", "Previous Host", sgOptions.Network.szPreviousHost);
 
@@ -903,10 +907,12 @@ GraphicsOptions::GraphicsOptions()
           })
     , integerScaling("Integer Scaling", OptionEntryFlags::CantChangeInGame | OptionEntryFlags::RecreateUI, N_("Integer Scaling"), N_("Scales the image using whole number pixel ratio."), false)
     , vSync("Vertical Sync", OptionEntryFlags::RecreateUI, N_("Vertical Sync"), N_("Forces waiting for Vertical Sync. Prevents tearing effect when drawing a frame. Disabling it can help with mouse lag on some systems."), true)
+    , pipelinedPresent("Pipelined Present", OptionEntryFlags::None, N_("Pipelined Present"), N_("Converts each frame for the screen on a separate thread while the next frame is drawn. Improves the frame rate on slow CPUs but shows every frame one frame later."), false)
 #endif
     , gammaCorrection("Gamma Correction", OptionEntryFlags::Invisible, "Gamma Correction", "Gamma correction level.", 100)
     , colorCycling("Color Cycling", OptionEntryFlags::None, N_("Color Cycling"), N_("Color cycling effect used for water, lava, and acid animation."), true)
     , alternateNestArt("Alternate nest art", OptionEntryFlags::OnlyHellfire | OptionEntryFlags::CantChangeInGame, N_("Alternate nest art"), N_("The game will use an alternative palette for Hellfire’s nest tileset."), false)
+    , predecodeSprites("Predecode Sprites", OptionEntryFlags::CantChangeInGame, N_("Predecode Sprites"), N_("Decodes monster and player animations when they are loaded, which makes drawing them faster but uses more memory."), false)
 #if SDL_VERSION_ATLEAST(2, 0, 0)
     , hardwareCursor("Hardware Cursor", OptionEntryFlags::CantChangeInGame | OptionEntryFlags::RecreateUI | (HardwareCursorSupported() ? OptionEntryFlags::None : OptionEntryFlags::Invisible), N_("Hardware Cursor"), N_("Use a hardware cursor"), HardwareCursorDefault())
     , hardwareCursorForItems("Hardware Cursor For Items", OptionEntryFlags::CantChangeInGame | (HardwareCursorSupported() ? OptionEntryFlags::None : OptionEntryFlags::Invisible), N_("Hardware Cursor For Items"), N_("Use a hardware cursor for items."), false)
@@ -946,6 +952,7 @@ std::vector<OptionEntryBase *> GraphicsOptions::GetEntries()
 		&scaleQuality,
 		&integerScaling,
 		&vSync,
+		&pipelinedPresent,
 #endif
 		&gammaCorrection,
 		&limitFPS,
@@ -954,6 +961,7 @@ std::vector<OptionEntryBase *> GraphicsOptions::GetEntries()
 		&showManaValues,
 		&colorCycling,
 		&alternateNestArt,
+		&predecodeSprites,
 #if SDL_VERSION_ATLEAST(2, 0, 0)
 		&hardwareCursor,
 		&hardwareCursorForItems,
@@ -966,6 +974,7 @@ std::vector<OptionEntryBase *> GraphicsOptions::GetEntries()
 GameplayOptions::GameplayOptions()
     : OptionCategoryBase("Game", N_("Gameplay"), N_("Gameplay Settings"))
     , tickRate("Speed", OptionEntryFlags::Invisible, "Speed", "Gameplay ticks per second.", 20)
+    , deflateSaves("Deflate Saves", OptionEntryFlags::Invisible, "Deflate Saves", "Compress save games with deflate, which is much faster than implode. Such save games cannot be loaded by Diablo.", false)
     , runInTown("Run in Town", OptionEntryFlags::CantChangeInMultiPlayer, N_("Run in Town"), N_("Enable jogging/fast walking in town for Diablo and Hellfire. This option was introduced in the expansion."), false)
     , grabInput("Grab Input", OptionEntryFlags::None, N_("Grab Input"), N_("When enabled mouse is locked to the game window."), false)
     , theoQuest("Theo Quest", OptionEntryFlags::CantChangeInGame | OptionEntryFlags::OnlyHellfire, N_("Theo Quest"), N_("Enable Little Girl quest."), false)
@@ -1004,6 +1013,7 @@ std::vector<OptionEntryBase *> GameplayOptions::GetEntries()
 {
 	return {
 		&tickRate,
+		&deflateSaves,
 		&grabInput,
 		&runInTown,
 		&adriaRefillsMana,
@@ -1048,12 +1058,14 @@ std::vector<OptionEntryBase *> ControllerOptions::GetEntries()
 NetworkOptions::NetworkOptions()
     : OptionCategoryBase("Network", N_("Network"), N_("Network Settings"))
     , port("Port", OptionEntryFlags::Invisible, "Port", "What network port to use.", 6112)
+    , adaptiveTurns("Adaptive Turns", OptionEntryFlags::Invisible, "Adaptive Turns", "Adjust the number of turns in transit to the measured latency and jitter in hosted games.", false)
 {
 }
 std::vector<OptionEntryBase *> NetworkOptions::GetEntries()
 {
 	return {
 		&port,
+		&adaptiveTurns,
 	};
 }
 
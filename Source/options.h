@@ -466,6 +466,8 @@ struct GraphicsOptions : OptionCategoryBase {
 	OptionEntryBoolean integerScaling;
 	/** @brief Enable vsync on the output. */
 	OptionEntryBoolean vSync;
+	/** @brief Convert and upload each frame on a separate thread while the next one is rendered. */
+	OptionEntryBoolean pipelinedPresent;
 #endif
 	/** @brief Gamma correction level. */
 	OptionEntryInt<int> gammaCorrection;
@@ -473,6 +475,8 @@ struct GraphicsOptions : OptionCategoryBase {
 	OptionEntryBoolean colorCycling;
 	/** @brief Use alternate nest palette. */
 	OptionEntryBoolean alternateNestArt;
+	/** @brief Decode monster and player animations when they are loaded. */
+	OptionEntryBoolean predecodeSprites;
 #if SDL_VERSION_ATLEAST(2, 0, 0)
 	/** @brief Use a hardware cursor (SDL2 only). */
 	OptionEntryBoolean hardwareCursor;
@@ -497,6 +501,8 @@ struct GameplayOptions : OptionCategoryBase {
 
 	/** @brief Gameplay ticks per second. */
 	OptionEntryInt<int> tickRate;
+	/** @brief Compress save games with deflate instead of PKWare implode. */
+	OptionEntryBoolean deflateSaves;
 	/** @brief Enable double walk speed when in town. */
 	OptionEntryBoolean runInTown;
 	/** @brief Do not let the mouse leave the application window. */
@@ -581,12 +587,16 @@ struct NetworkOptions : OptionCategoryBase {
 
 	/** @brief Optionally bind to a specific network interface. */
 	char szBindAddress[129];
+	/** @brief Optionally create TCP games on a relay server instead of hosting them. */
+	char szRelayServer[129];
 	/** @brief Most recently entered ZeroTier Game ID. */
 	char szPreviousZTGame[129];
 	/** @brief Most recently entered Hostname in join dialog. */
 	char szPreviousHost[129];
 	/** @brief What network port to use. */
 	OptionEntryInt<uint16_t> port;
+	/** @brief Adjust the number of turns in transit to the measured latency in the games this player hosts. */
+	OptionEntryBoolean adaptiveTurns;
 };
 
 struct ChatOptions : OptionCategoryBase {
@@ -4,12 +4,18 @@
  * Implementation of functions for handling the engines color palette.
  */
 
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <vector>
+
 #include "engine/dx.h"
 #include "engine/load_file.hpp"
 #include "engine/random.hpp"
 #include "hwcursor.hpp"
 #include "options.h"
 #include "utils/display.h"
+#include "utils/palette_blending.hpp"
 #include "utils/sdl_compat.h"
 
 namespace devilution {
@@ -55,43 +61,52 @@ Uint8 FindBestMatchForColor(SDL_Color *palette, SDL_Color color, int skipFrom, i
 	return best;
 }
 
+/** @brief A transparency lookup table as generated for a palette, see GenerateBlendedLookupTable(). */
+struct BlendedLookupTable {
+	std::array<uint8_t, 256 * 3> colors;
+	int skipFrom;
+	int skipTo;
+	std::unique_ptr<uint8_t[][256]> table;
+};
+
+/** @brief Number of tables kept for palettes loaded again, such as when revisiting a level. */
+constexpr size_t BlendedLookupTableCacheSize = 8;
+
+/** @brief The recently generated tables, the most recently used first. */
+std::vector<BlendedLookupTable> BlendedLookupTables;
+
+std::array<uint8_t, 256 * 3> GetPaletteColors(const SDL_Color *palette)
+{
+	std::array<uint8_t, 256 * 3> colors;
+	for (int i = 0; i < 256; i++) {
+		colors[i * 3 + 0] = palette[i].r;
+		colors[i * 3 + 1] = palette[i].g;
+		colors[i * 3 + 2] = palette[i].b;
+	}
+	return colors;
+}
+
 /**
- * @brief Generate lookup table for transparency
- *
- * This is based of the same technique found in Quake2.
- *
- * To mimic 50% transparency we figure out what colors in the existing palette are the best match for the combination of any 2 colors.
- * We save this into a lookup table for use during rendering.
- *
- * @param palette The colors to operate on
- * @param skipFrom Do not use colors between this index and skipTo
- * @param skipTo Do not use colors between skipFrom and this index
- * @param toUpdate Only update the first n colors
+ * @brief Generates the transparency lookup table of a palette, or reuses the one generated the last times it was loaded.
  */
-void GenerateBlendedLookupTable(SDL_Color *palette, int skipFrom, int skipTo, int toUpdate = 256)
+void LoadBlendedLookupTable(SDL_Color *palette, int skipFrom, int skipTo)
 {
-	for (int i = 0; i < 256; i++) {
-		for (int j = 0; j < 256; j++) {
-			if (i == j) { // No need to calculate transparency between 2 identical colors
-				paletteTransparencyLookup[i][j] = j;
-				continue;
-			}
-			if (i > j) { // Half the blends will be mirror identical ([i][j] is the same as [j][i]), so simply copy the existing combination.
-				paletteTransparencyLookup[i][j] = paletteTransparencyLookup[j][i];
-				continue;
-			}
-			if (i > toUpdate && j > toUpdate) {
-				continue;
-			}
-
-			SDL_Color blendedColor;
-			blendedColor.r = ((int)palette[i].r + (int)palette[j].r) / 2;
-			blendedColor.g = ((int)palette[i].g + (int)palette[j].g) / 2;
-			blendedColor.b = ((int)palette[i].b + (int)palette[j].b) / 2;
-			Uint8 best = FindBestMatchForColor(palette, blendedColor, skipFrom, skipTo);
-			paletteTransparencyLookup[i][j] = best;
+	const std::array<uint8_t, 256 * 3> colors = GetPaletteColors(palette);
+	auto cached = std::find_if(BlendedLookupTables.begin(), BlendedLookupTables.end(), [&](const BlendedLookupTable &blendedTable) {
+		return blendedTable.skipFrom == skipFrom && blendedTable.skipTo == skipTo && blendedTable.colors == colors;
+	});
+	if (cached == BlendedLookupTables.end()) {
+		if (BlendedLookupTables.size() < BlendedLookupTableCacheSize) {
+			BlendedLookupTables.push_back({ {}, 0, 0, std::unique_ptr<uint8_t[][256]> { new uint8_t[256][256] } });
 		}
+		cached = BlendedLookupTables.end() - 1;
+		cached->colors = colors;
+		cached->skipFrom = skipFrom;
+		cached->skipTo = skipTo;
+		GenerateBlendedLookupTable(palette, skipFrom, skipTo, cached->table.get());
 	}
+	std::rotate(BlendedLookupTables.begin(), cached, cached + 1);
+	memcpy(paletteTransparencyLookup, BlendedLookupTables.front().table.get(), sizeof(paletteTransparencyLookup));
 
 #if DEVILUTIONX_PALETTE_TRANSPARENCY_BLACK_16_LUT
 	for (unsigned i = 0; i < 256; ++i) {
@@ -224,11 +239,11 @@ void LoadPalette(const char *pszFileName, bool blend /*= true*/)
 
 	if (blend) {
 		if (leveltype == DTYPE_CAVES || leveltype == DTYPE_CRYPT) {
-			GenerateBlendedLookupTable(orig_palette, 1, 31);
+			LoadBlendedLookupTable(orig_palette, 1, 31);
 		} else if (leveltype == DTYPE_NEST) {
-			GenerateBlendedLookupTable(orig_palette, 1, 15);
+			LoadBlendedLookupTable(orig_palette, 1, 15);
 		} else {
-			GenerateBlendedLookupTable(orig_palette, -1, -1);
+			LoadBlendedLookupTable(orig_palette, -1, -1);
 		}
 	}
 }
@@ -12,6 +12,7 @@
 #include "init.h"
 #include "loadsave.h"
 #include "menu.h"
+#include "options.h"
 #include "mpq/mpq_reader.hpp"
 #include "pack.h"
 #include "qol/stash.h"
@@ -159,14 +160,19 @@ void EncodeHero(MpqWriter &saveWriter, const PlayerPack *pack)
 	saveWriter.WriteFile("hero", packed.get(), packedLen);
 }
 
+CompressionType GetSaveCompressionType()
+{
+	return *sgOptions.Gameplay.deflateSaves ? CompressionType::Zlib : CompressionType::Implode;
+}
+
 MpqWriter GetSaveWriter(uint32_t saveNum)
 {
-	return MpqWriter(GetSavePath(saveNum).c_str());
+	return MpqWriter(GetSavePath(saveNum).c_str(), GetSaveCompressionType());
 }
 
 MpqWriter GetStashWriter()
 {
-	return MpqWriter(GetStashSavePath().c_str());
+	return MpqWriter(GetStashSavePath().c_str(), GetSaveCompressionType());
 }
 
 void Game2UiPlayer(const Player &player, _uiheroinfo *heroinfo, bool bHasSaveFile)
@@ -16,6 +16,9 @@
 #include "engine/cel_header.hpp"
 #include "engine/load_file.hpp"
 #include "engine/random.hpp"
+#include "engine/render/cl2_atlas.hpp"
+#include "engine/render/scrollrt.h"
+#include "engine/render/sprite_outline.hpp"
 #include "gamemenu.h"
 #include "init.h"
 #include "inv_iterators.hpp"
@@ -364,8 +367,23 @@ void StartWalk(int pnum, Displacement vel, Direction dir, bool pmWillBeCalled)
 	StartWalkAnimation(player, dir, pmWillBeCalled);
 }
 
+/**
+ * @brief Drops what was decoded from a player animation, has to be called before it is freed.
+ */
+void FreePlayerSpriteCaches(const std::array<std::optional<CelSprite>, 8> &anim)
+{
+	for (const std::optional<CelSprite> &celSprite : anim) {
+		if (!celSprite)
+			continue;
+		UnregisterCl2Atlas(celSprite->Data());
+		EvictCachedOutlines(celSprite->Data());
+	}
+}
+
 void SetPlayerGPtrs(const char *path, std::unique_ptr<byte[]> &data, std::array<std::optional<CelSprite>, 8> &anim, int width)
 {
+	if (data != nullptr)
+		FreePlayerSpriteCaches(anim);
 	data = nullptr;
 	data = LoadFileInMem(path);
 	if (data == nullptr && gbQuietMode)
@@ -375,6 +393,8 @@ void SetPlayerGPtrs(const char *path, std::unique_ptr<byte[]> &data, std::array<
 	CelGetDirectionFrames(data.get(), directionFrames);
 	for (size_t i = 0; i < 8; i++) {
 		anim[i].emplace(directionFrames[i], width);
+		if (*sgOptions.Graphics.predecodeSprites)
+			RegisterCl2Atlas(*anim[i]);
 	}
 }
 
@@ -939,7 +959,7 @@ bool PlrHitMonst(int pnum, int m, bool adjacentDamage = false)
 		if (player._pHPBase > player._pMaxHPBase) {
 			player._pHPBase = player._pMaxHPBase;
 		}
-		drawhpflag = true;
+		RedrawComponent(PanelDrawComponent::Health);
 	}
 	if (HasAnyOf(player._pIFlags, ItemSpecialEffect::StealMana3 | ItemSpecialEffect::StealMana5) && HasNoneOf(player._pIFlags, ItemSpecialEffect::NoMana)) {
 		if (HasAnyOf(player._pIFlags, ItemSpecialEffect::StealMana3)) {
@@ -956,7 +976,7 @@ bool PlrHitMonst(int pnum, int m, bool adjacentDamage = false)
 		if (player._pManaBase > player._pMaxManaBase) {
 			player._pManaBase = player._pMaxManaBase;
 		}
-		drawmanaflag = true;
+		RedrawComponent(PanelDrawComponent::Mana);
 	}
 	if (HasAnyOf(player._pIFlags, ItemSpecialEffect::StealLife3 | ItemSpecialEffect::StealLife5)) {
 		if (HasAnyOf(player._pIFlags, ItemSpecialEffect::StealLife3)) {
@@ -973,7 +993,7 @@ bool PlrHitMonst(int pnum, int m, bool adjacentDamage = false)
 		if (player._pHPBase > player._pMaxHPBase) {
 			player._pHPBase = player._pMaxHPBase;
 		}
-		drawhpflag = true;
+		RedrawComponent(PanelDrawComponent::Health);
 	}
 	if (HasAnyOf(player._pIFlags, ItemSpecialEffect::NoHealOnPlayer)) { // Why is there a different ItemSpecialEffect here? (see missile.cpp) is this a BUG?
 		monster._mFlags |= MFLAG_NOHEAL;
@@ -1059,7 +1079,7 @@ bool PlrHitPlr(int pnum, int8_t p)
 		if (attacker._pHPBase > attacker._pMaxHPBase) {
 			attacker._pHPBase = attacker._pMaxHPBase;
 		}
-		drawhpflag = true;
+		RedrawComponent(PanelDrawComponent::Health);
 	}
 	if (pnum == MyPlayerId) {
 		NetSendCmdDamage(true, p, skdam);
@@ -2348,6 +2368,8 @@ void ResetPlayerGFX(Player &player)
 {
 	player.AnimInfo.celSprite = std::nullopt;
 	for (auto &animData : player.AnimationData) {
+		if (animData.RawData != nullptr)
+			FreePlayerSpriteCaches(animData.CelSpritesForDirections);
 		for (auto &celSprite : animData.CelSpritesForDirections)
 			celSprite = std::nullopt;
 		animData.RawData = nullptr;
@@ -2668,7 +2690,7 @@ void NextPlrLevel(int pnum)
 	player._pHPBase = player._pMaxHPBase;
 
 	if (pnum == MyPlayerId) {
-		drawhpflag = true;
+		RedrawComponent(PanelDrawComponent::Health);
 	}
 
 	int mana = 128;
@@ -2686,7 +2708,7 @@ void NextPlrLevel(int pnum)
 	}
 
 	if (pnum == MyPlayerId) {
-		drawmanaflag = true;
+		RedrawComponent(PanelDrawComponent::Mana);
 	}
 
 	if (ControlMode != ControlTypes::KeyboardAndMouse)
@@ -3004,7 +3026,7 @@ void StartPlrHit(int pnum, int dam, bool forcehit)
 
 	player.Say(HeroSpeech::ArghClang);
 
-	drawhpflag = true;
+	RedrawComponent(PanelDrawComponent::Health);
 	if (player._pClass == HeroClass::Barbarian) {
 		if (dam >> 6 < player._pLevel + player._pLevel / 4 && !forcehit) {
 			return;
@@ -3091,7 +3113,7 @@ StartPlayerKill(int pnum, int earflag)
 		SetPlayerOld(player);
 
 		if (pnum == MyPlayerId) {
-			drawhpflag = true;
+			RedrawComponent(PanelDrawComponent::Health);
 
 			if (!player.HoldItem.isEmpty()) {
 				DeadItem(player, std::move(player.HoldItem), { 0, 0 });
@@ -3173,7 +3195,7 @@ void ApplyPlrDamage(int pnum, int dam, int minHP /*= 0*/, int frac /*= 0*/, int
 			totalDamage += totalDamage / -player.GetManaShieldDamageReduction();
 		}
 		if (pnum == MyPlayerId)
-			drawmanaflag = true;
+			RedrawComponent(PanelDrawComponent::Mana);
 		if (player._pMana >= totalDamage) {
 			player._pMana -= totalDamage;
 			player._pManaBase -= totalDamage;
@@ -3193,7 +3215,7 @@ void ApplyPlrDamage(int pnum, int dam, int minHP /*= 0*/, int frac /*= 0*/, int
 	if (totalDamage == 0)
 		return;
 
-	drawhpflag = true;
+	RedrawComponent(PanelDrawComponent::Health);
 	player._pHitPoints -= totalDamage;
 	player._pHPBase -= totalDamage;
 	if (player._pHitPoints > player._pMaxHP) {
@@ -3390,7 +3412,7 @@ void ProcessPlayers()
 				if (HasAnyOf(player._pIFlags, ItemSpecialEffect::NoMana) && player._pManaBase > 0) {
 					player._pManaBase -= player._pMana;
 					player._pMana = 0;
-					drawmanaflag = true;
+					RedrawComponent(PanelDrawComponent::Mana);
 				}
 			}
 
@@ -3829,7 +3851,7 @@ void SetPlayerHitPoints(Player &player, int val)
 	player._pHPBase = val + player._pMaxHPBase - player._pMaxHP;
 
 	if (&player == MyPlayer) {
-		drawhpflag = true;
+		RedrawComponent(PanelDrawComponent::Health);
 	}
 }
 
@@ -85,6 +85,12 @@ enum inv_body_loc : uint8_t {
 	NUM_INVLOC,
 };
 
+/** @brief The bit of a body slot in the masks of changed body slots given to CalcPlrInv. */
+constexpr uint8_t BodySlotBit(inv_body_loc bodyLocation)
+{
+	return 1 << bodyLocation;
+}
+
 enum class player_graphic : uint8_t {
 	Stand,
 	Walk,
@@ -348,6 +354,14 @@ struct Player {
 	uint8_t pDiabloKillLevel;
 	_difficulty pDifficulty;
 	ItemSpecialEffectHf pDamAcFlags;
+	/** @brief What the item of each body slot added to the stats the last time CalcPlrItemVals counted it. */
+	ItemStats bodySlotStats[NUM_INVLOC];
+	/** @brief Sum of bodySlotStats. */
+	ItemStats equippedItemStats;
+	/** @brief Bitmask of the body slots whose items were usable when counted, see BodySlotBit. */
+	uint8_t usableBodySlots;
+	/** @brief Whether CalcPlrItemVals counted every body slot since the player was set up. */
+	bool bodySlotStatsCounted = false;
 	/** @brief Specifies whether players are in non-PvP mode. */
 	bool friendlyMode = true;
 
@@ -12,6 +12,7 @@
 #include "DiabloUI/art_draw.h"
 #include "control.h"
 #include "engine/point.hpp"
+#include "engine/render/scrollrt.h"
 #include "options.h"
 #include "utils/format_int.hpp"
 #include "utils/language.h"
@@ -31,6 +32,20 @@ constexpr int BackHeight = 9;
 
 Art xpbarArt;
 
+/** @brief What the experience bar showed when it was last drawn. */
+struct XPBarState {
+	bool visible;
+	int8_t charLevel;
+	uint32_t experience;
+
+	bool operator==(const XPBarState &other) const
+	{
+		return visible == other.visible && charLevel == other.charLevel && experience == other.experience;
+	}
+};
+
+XPBarState DrawnXPBarState;
+
 void DrawBar(const Surface &out, Point screenPosition, int width, const ColorGradient &gradient)
 {
 	UnsafeDrawHorizontalLine(out, screenPosition + Displacement { 0, 1 }, width, gradient[gradient.size() * 3 / 4 - 1]);
@@ -108,6 +123,16 @@ void DrawXPBar(const Surface &out)
 	DrawEndCap(out, position + Displacement { static_cast<int>(fullBar), 0 }, fade, SilverGradient);
 }
 
+void CheckXPBarRedraw()
+{
+	const Player &player = *MyPlayer;
+	const XPBarState state { *sgOptions.Gameplay.experienceBar && !talkflag, player._pLevel, player._pExperience };
+	if (state == DrawnXPBarState)
+		return;
+	DrawnXPBarState = state;
+	RedrawComponent(PanelDrawComponent::ExperienceBar);
+}
+
 bool CheckXPBarInfo()
 {
 	if (!*sgOptions.Gameplay.experienceBar)
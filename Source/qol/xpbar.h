@@ -13,6 +13,12 @@ void InitXPBar();
 void FreeXPBar();
 
 void DrawXPBar(const Surface &out);
+
+/**
+ * @brief Marks the experience bar for redraw when the experience it shows changed since it was drawn.
+ */
+void CheckXPBarRedraw();
+
 bool CheckXPBarInfo();
 
 } // namespace devilution
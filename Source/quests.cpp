@@ -32,7 +32,7 @@ namespace devilution {
 bool QuestLogIsOpen;
 std::optional<OwnedCelSprite> pQLogCel;
 /** Contains the quests of the current game. */
-Quest Quests[MAXQUESTS];
+DVL_LEVEL_THREAD_LOCAL Quest Quests[MAXQUESTS];
 Point ReturnLvlPosition;
 dungeon_type ReturnLevelType;
 int ReturnLevel;
@@ -75,7 +75,7 @@ struct QuestData {
 
 extern bool QuestLogIsOpen;
 extern std::optional<OwnedCelSprite> pQLogCel;
-extern DVL_API_FOR_TEST Quest Quests[MAXQUESTS];
+extern DVL_API_FOR_TEST DVL_LEVEL_THREAD_LOCAL Quest Quests[MAXQUESTS];
 extern Point ReturnLvlPosition;
 extern dungeon_type ReturnLevelType;
 extern int ReturnLevel;
@@ -0,0 +1,160 @@
+/**
+ * @file relay_main.cpp
+ *
+ * Entry point of the headless relay server, which hosts TCP games without running the game itself.
+ */
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <string>
+
+#include <asio/signal_set.hpp>
+#include <asio/steady_timer.hpp>
+#include <asio/ts/io_context.hpp>
+
+#include <SDL.h>
+
+#include "diablo.h"
+#include "dvlnet/packet.h"
+#include "dvlnet/tcp_relay.h"
+#include "utils/console.h"
+#include "utils/log.hpp"
+#include "utils/stdcompat/string_view.hpp"
+
+namespace devilution {
+namespace {
+
+struct RelayOptions {
+	std::string bindAddress = "0.0.0.0";
+	unsigned short firstPort = 6112;
+	unsigned short roomCount = 16;
+	std::string password;
+	int statsInterval = 60;
+};
+
+void PrintHelpOption(string_view flags, string_view description)
+{
+	printInConsole("    ");
+	printInConsole(flags);
+	for (size_t i = flags.size(); i < 30; i++)
+		printInConsole(" ");
+	printInConsole(description);
+	printNewlineInConsole();
+}
+
+void PrintHelp()
+{
+	printInConsole("Options:");
+	printNewlineInConsole();
+	PrintHelpOption("-h, --help", "Print this message and exit");
+	PrintHelpOption("--bind <address>", "Network interface to listen on (default 0.0.0.0)");
+	PrintHelpOption("--port <#>", "Port of the first room (default 6112)");
+	PrintHelpOption("--rooms <#>", "Number of rooms, each on the next port (default 16)");
+	PrintHelpOption("--password <password>", "Password shared by all rooms");
+	PrintHelpOption("--stats <#>", "Seconds between room statistics, 0 to disable (default 60)");
+}
+
+bool ParseFlags(int argc, char **argv, RelayOptions &options)
+{
+	for (int i = 1; i < argc; i++) {
+		const string_view arg = argv[i];
+		if (arg == "-h" || arg == "--help") {
+			PrintHelp();
+			return false;
+		}
+		if (arg != "--bind" && arg != "--port" && arg != "--rooms" && arg != "--password" && arg != "--stats") {
+			printfInConsole("unrecognized option '%s'", argv[i]);
+			printNewlineInConsole();
+			PrintHelp();
+			return false;
+		}
+		if (i + 1 == argc) {
+			printfInConsole("%s requires an argument", argv[i]);
+			printNewlineInConsole();
+			return false;
+		}
+		const char *value = argv[++i];
+		if (arg == "--bind")
+			options.bindAddress = value;
+		else if (arg == "--port")
+			options.firstPort = static_cast<unsigned short>(SDL_atoi(value));
+		else if (arg == "--rooms")
+			options.roomCount = static_cast<unsigned short>(SDL_atoi(value));
+		else if (arg == "--password")
+			options.password = value;
+		else
+			options.statsInterval = SDL_atoi(value);
+	}
+	if (options.roomCount == 0 || options.firstPort + options.roomCount - 1 > UINT16_MAX) {
+		printInConsole("invalid port range");
+		printNewlineInConsole();
+		return false;
+	}
+	return true;
+}
+
+void LogStats(const net::tcp_relay &relay)
+{
+	for (const std::string &line : relay.FormatStats())
+		Log("{}", line);
+}
+
+void ScheduleStats(asio::steady_timer &timer, const net::tcp_relay &relay, int interval)
+{
+	timer.expires_after(std::chrono::seconds(interval));
+	timer.async_wait([&timer, &relay, interval](const asio::error_code &ec) {
+		if (ec)
+			return;
+		LogStats(relay);
+		ScheduleStats(timer, relay, interval);
+	});
+}
+
+int RelayMain(int argc, char **argv)
+{
+	// Errors have to end up in the log, there is nobody to click away a dialog.
+	gbQuietMode = true;
+
+	RelayOptions options;
+	if (!ParseFlags(argc, argv, options))
+		return 1;
+
+	std::unique_ptr<net::packet_factory> pktfty;
+	if (options.password.empty())
+		pktfty = std::make_unique<net::packet_factory>();
+	else
+		pktfty = std::make_unique<net::packet_factory>(options.password);
+
+	asio::io_context ioc;
+	std::unique_ptr<net::tcp_relay> relay;
+	try {
+		relay = std::make_unique<net::tcp_relay>(ioc, options.bindAddress, options.firstPort, options.roomCount, *pktfty);
+	} catch (std::exception &e) {
+		LogError("Unable to start the relay: {}", e.what());
+		return 1;
+	}
+	Log("Relaying {} rooms on {} ports {}-{}", options.roomCount, options.bindAddress, options.firstPort, options.firstPort + options.roomCount - 1);
+
+	asio::steady_timer statsTimer(ioc);
+	if (options.statsInterval > 0)
+		ScheduleStats(statsTimer, *relay, options.statsInterval);
+
+	asio::signal_set signals(ioc, SIGINT, SIGTERM);
+	signals.async_wait([&](const asio::error_code &ec, int signal) {
+		LogStats(*relay);
+		relay->Close();
+		ioc.stop();
+	});
+
+	ioc.run();
+	return 0;
+}
+
+} // namespace
+} // namespace devilution
+
+int main(int argc, char **argv)
+{
+	return devilution::RelayMain(argc, argv);
+}
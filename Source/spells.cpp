@@ -12,6 +12,7 @@
 #endif
 #include "engine/point.hpp"
 #include "engine/random.hpp"
+#include "engine/render/scrollrt.h"
 #include "gamemenu.h"
 #include "inv.h"
 #include "missiles.h"
@@ -193,7 +194,7 @@ void UseMana(int id, spell_id sn)
 		ma = GetManaAmount(myPlayer, sn);
 		myPlayer._pMana -= ma;
 		myPlayer._pManaBase -= ma;
-		drawmanaflag = true;
+		RedrawComponent(PanelDrawComponent::Mana);
 		break;
 	}
 }
@@ -270,8 +271,8 @@ void DoResurrect(int pnum, uint16_t rid)
 	if (rid == MyPlayerId) {
 		MyPlayerIsDead = false;
 		gamemenu_off();
-		drawhpflag = true;
-		drawmanaflag = true;
+		RedrawComponent(PanelDrawComponent::Health);
+		RedrawComponent(PanelDrawComponent::Mana);
 	}
 
 	ClrPlrPath(target);
@@ -324,7 +325,7 @@ void DoHealOther(const Player &caster, Player &target)
 	target._pHPBase = std::min(target._pHPBase + hp, target._pMaxHPBase);
 
 	if (&target == MyPlayer) {
-		drawhpflag = true;
+		RedrawComponent(PanelDrawComponent::Health);
 	}
 }
 
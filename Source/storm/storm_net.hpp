@@ -99,6 +99,12 @@ bool SNetGetGameInfo(game_info type, void *dst, unsigned int length);
  */
 bool SNetGetTurnsInTransit(uint32_t *turns);
 
+/**
+ * @brief Retrieves the worst smoothed round trip time and jitter to the other players, in milliseconds.
+ * @return false if no measurement is available yet.
+ */
+bool SNetGetLatency(uint32_t *roundTripLatency, uint32_t *jitter);
+
 bool SNetJoinGame(char *gameName, char *gamePassword, int *playerid);
 
 /*  SNetLeaveGame @ 119
@@ -281,6 +281,9 @@ bool SVidPlayBegin(const char *filename, int flags)
 	SVidFrameLength = 1000000.0 / Smacker_GetFrameRate(SVidHandle);
 	Smacker_GetFrameSize(SVidHandle, SVidWidth, SVidHeight);
 
+	// The video is written to the output surface directly.
+	FlushPresentPipeline();
+
 #ifndef USE_SDL1
 	if (renderer != nullptr) {
 		int renderWidth = static_cast<int>(SVidWidth);
@@ -3,7 +3,8 @@
  *
  * Implementation of functionality transmitting chat messages.
  */
-#include <list>
+#include <algorithm>
+#include <vector>
 
 #include "diablo.h"
 #include "tmsg.h"
@@ -14,51 +15,67 @@ namespace {
 
 struct TMsg {
 	uint32_t time;
-	std::unique_ptr<byte[]> body;
 	uint8_t len;
-
-	TMsg(uint32_t time, const byte *data, uint8_t len)
-	    : time(time)
-	    , body(new byte[len])
-	    , len(len)
-	{
-		memcpy(body.get(), data, len);
-	}
+	byte body[MaxTmsgLen];
 };
 
-std::list<TMsg> TimedMsgList;
+/** Messages are only delayed by a few hundred milliseconds, so only a handful are usually queued. */
+constexpr size_t InitialTimedMsgCapacity = 16;
+
+/** Ring of the queued messages, grows when a burst doesn't fit. */
+std::vector<TMsg> TimedMsgRing;
+/** Index of the oldest message in `TimedMsgRing` */
+size_t TimedMsgHead;
+size_t TimedMsgCount;
+
+void GrowTimedMsgRing()
+{
+	std::vector<TMsg> ring(std::max(TimedMsgRing.size() * 2, InitialTimedMsgCapacity));
+	for (size_t i = 0; i < TimedMsgCount; i++)
+		ring[i] = TimedMsgRing[(TimedMsgHead + i) % TimedMsgRing.size()];
+	TimedMsgRing.swap(ring);
+	TimedMsgHead = 0;
+}
 
 } // namespace
 
-uint8_t tmsg_get(std::unique_ptr<byte[]> *msg)
+uint8_t tmsg_get(byte *msg)
 {
-	if (TimedMsgList.empty())
+	if (TimedMsgCount == 0)
 		return 0;
 
-	TMsg &head = TimedMsgList.front();
+	const TMsg &head = TimedMsgRing[TimedMsgHead];
 	if ((int)(head.time - SDL_GetTicks()) >= 0)
 		return 0;
 
 	uint8_t len = head.len;
-	*msg = std::move(head.body);
-	TimedMsgList.pop_front();
+	memcpy(msg, head.body, len);
+	TimedMsgHead = (TimedMsgHead + 1) % TimedMsgRing.size();
+	TimedMsgCount--;
 	return len;
 }
 
 void tmsg_add(const byte *msg, uint8_t len)
 {
-	uint32_t time = SDL_GetTicks() + gnTickDelay * 10;
-	TimedMsgList.emplace_back(time, msg, len);
+	if (TimedMsgCount == TimedMsgRing.size())
+		GrowTimedMsgRing();
+
+	TMsg &tmsg = TimedMsgRing[(TimedMsgHead + TimedMsgCount) % TimedMsgRing.size()];
+	tmsg.time = SDL_GetTicks() + gnTickDelay * 10;
+	tmsg.len = len;
+	memcpy(tmsg.body, msg, len);
+	TimedMsgCount++;
 }
 
 void tmsg_start()
 {
-	assert(TimedMsgList.empty());
+	assert(TimedMsgCount == 0);
 }
 
 void tmsg_cleanup()
 {
-	TimedMsgList.clear();
+	TimedMsgHead = 0;
+	TimedMsgCount = 0;
 }
 
 } // namespace devilution
@@ -6,13 +6,20 @@
 #pragma once
 
 #include <cstdint>
-#include <memory>
 
 #include "utils/stdcompat/cstddef.hpp"
 
 namespace devilution {
 
-uint8_t tmsg_get(std::unique_ptr<byte[]> *msg);
+/** Longest message that can be delayed */
+constexpr size_t MaxTmsgLen = UINT8_MAX;
+
+/**
+ * @brief Takes the oldest delayed message once it is due.
+ * @param msg Receives the message, room for `MaxTmsgLen` bytes
+ * @return Length of the message, 0 if none is due
+ */
+uint8_t tmsg_get(byte *msg);
 void tmsg_add(const byte *msg, uint8_t bLen);
 void tmsg_start();
 void tmsg_cleanup();
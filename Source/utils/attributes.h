@@ -43,6 +43,14 @@
 #define DVL_API_FOR_TEST
 #endif
 
+// Level generation state must be marked with `DVL_LEVEL_THREAD_LOCAL`. It is only thread-local in builds with the
+// dungeon seed farm (test/drlg_farm.cpp), which generates levels on several threads at once.
+#ifdef BUILD_DRLG_FARM
+#define DVL_LEVEL_THREAD_LOCAL thread_local
+#else
+#define DVL_LEVEL_THREAD_LOCAL
+#endif
+
 #if defined(__clang__)
 #define DVL_REINITIALIZES [[clang::reinitializes]]
 #elif DVL_HAVE_ATTRIBUTE(reinitializes)
@@ -1,14 +1,17 @@
 #pragma once
 
+#include <algorithm>
 #include <bitset>
 #include <cstddef>
+#include <cstdint>
 
 namespace devilution {
 
 /**
  * @brief A 2D variant of std::bitset.
  *
- * For function documentation, see `std::bitset`
+ * For function documentation, see `std::bitset`. Each row is stored in 64-bit words, so that the rectangle
+ * functions test and set a whole row of a rectangle at a time.
  *
  * @tparam Width
  * @tparam Height
@@ -18,31 +21,86 @@ class Bitset2d {
 public:
 	bool test(size_t x, size_t y) const
 	{
-		return data_.test(index(x, y));
+		return (rows_[y][x / WordBits] & Bit(x)) != 0;
 	}
 
 	void set(size_t x, size_t y, bool value = true)
 	{
-		data_.set(index(x, y), value);
+		if (value)
+			rows_[y][x / WordBits] |= Bit(x);
+		else
+			reset(x, y);
 	}
 
 	void reset(size_t x, size_t y)
 	{
-		data_.reset(index(x, y));
+		rows_[y][x / WordBits] &= ~Bit(x);
 	}
 
 	void reset()
 	{
-		data_.reset();
+		std::fill(&rows_[0][0], &rows_[0][0] + Height * WordsPerRow, 0);
+	}
+
+	size_t count() const
+	{
+		size_t count = 0;
+		for (const Word(&row)[WordsPerRow] : rows_) {
+			for (Word word : row)
+				count += std::bitset<WordBits>(word).count();
+		}
+		return count;
+	}
+
+	/**
+	 * @brief Sets the bits of a rectangle, which has to fit in the bitset.
+	 */
+	void set(size_t x, size_t y, size_t width, size_t height)
+	{
+		for (size_t i = x / WordBits; width != 0 && i <= (x + width - 1) / WordBits; i++) {
+			const Word mask = RangeMask(i, x, width);
+			for (size_t j = y; j < y + height; j++)
+				rows_[j][i] |= mask;
+		}
+	}
+
+	/**
+	 * @brief Whether any bit of a rectangle, which has to fit in the bitset, is set.
+	 */
+	bool any(size_t x, size_t y, size_t width, size_t height) const
+	{
+		for (size_t i = x / WordBits; width != 0 && i <= (x + width - 1) / WordBits; i++) {
+			const Word mask = RangeMask(i, x, width);
+			for (size_t j = y; j < y + height; j++) {
+				if ((rows_[j][i] & mask) != 0)
+					return true;
+			}
+		}
+		return false;
 	}
 
 private:
-	static size_t index(size_t x, size_t y)
+	using Word = uint64_t;
+	static constexpr size_t WordBits = 64;
+	static constexpr size_t WordsPerRow = (Width + WordBits - 1) / WordBits;
+
+	static Word Bit(size_t x)
+	{
+		return Word { 1 } << (x % WordBits);
+	}
+
+	/**
+	 * @brief Mask of the bits of the columns x to x + width - 1 that the word at the given index of a row holds.
+	 */
+	static Word RangeMask(size_t index, size_t x, size_t width)
 	{
-		return y * Width + x;
+		const size_t begin = std::max(x, index * WordBits) - index * WordBits;
+		const size_t end = std::min(x + width, (index + 1) * WordBits) - index * WordBits;
+		const Word bits = end - begin == WordBits ? ~Word { 0 } : (Word { 1 } << (end - begin)) - 1;
+		return bits << begin;
 	}
 
-	std::bitset<Width * Height> data_;
+	Word rows_[Height][WordsPerRow] = {};
 };
 
 } // namespace devilution
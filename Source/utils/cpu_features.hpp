@@ -0,0 +1,19 @@
+#pragma once
+
+namespace devilution {
+
+/** Marks a function that may use AVX2 instructions, it must only be called if `CpuSupportsAvx2()`. */
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define DVL_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define DVL_TARGET_AVX2
+#endif
+
+/**
+ * @brief Whether the CPU and the OS support AVX2, detected on first use.
+ *
+ * Always false when not compiling for x86.
+ */
+bool CpuSupportsAvx2();
+
+} // namespace devilution
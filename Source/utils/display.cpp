@@ -363,6 +363,7 @@ void ReinitializeRenderer()
 	Size windowSize = { current.current_w, current.current_h };
 	AdjustToScreenGeometry(windowSize);
 #else
+	FlushPresentPipeline();
 	if (texture)
 		texture.reset();
 
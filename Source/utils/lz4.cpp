@@ -0,0 +1,202 @@
+#include "utils/lz4.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace devilution {
+
+namespace {
+
+constexpr size_t MinMatch = 4;
+/** The last 5 bytes of a block are always literals. */
+constexpr size_t LastLiterals = 5;
+/** A match may not start within the last 12 bytes of a block. */
+constexpr size_t MatchFindLimit = 12;
+constexpr size_t MaxDistance = 65535;
+constexpr unsigned HashLog = 12;
+constexpr uint8_t RunMask = 15;
+
+uint32_t Read32(const uint8_t *p)
+{
+	uint32_t value;
+	memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+uint32_t HashSequence(uint32_t sequence)
+{
+	return (sequence * 2654435761U) >> (32 - HashLog);
+}
+
+/**
+ * @brief Writes a length that did not fit in the token nibble.
+ * @return The new output position, or nullptr if the output is full.
+ */
+uint8_t *WriteLengthExtension(uint8_t *op, const uint8_t *opEnd, size_t length)
+{
+	for (; length >= 255; length -= 255) {
+		if (op >= opEnd)
+			return nullptr;
+		*op++ = 255;
+	}
+	if (op >= opEnd)
+		return nullptr;
+	*op++ = static_cast<uint8_t>(length);
+	return op;
+}
+
+/**
+ * @brief Writes the token, the literals and, unless this is the last sequence, the match.
+ * @return The new output position, or nullptr if the output is full.
+ */
+uint8_t *WriteSequence(uint8_t *op, const uint8_t *opEnd, const uint8_t *literals, size_t literalLength, size_t offset, size_t matchLength, bool lastSequence)
+{
+	if (op >= opEnd)
+		return nullptr;
+	uint8_t *token = op++;
+	*token = static_cast<uint8_t>(std::min<size_t>(literalLength, RunMask) << 4);
+	if (literalLength >= RunMask) {
+		op = WriteLengthExtension(op, opEnd, literalLength - RunMask);
+		if (op == nullptr)
+			return nullptr;
+	}
+	if (static_cast<size_t>(opEnd - op) < literalLength)
+		return nullptr;
+	memcpy(op, literals, literalLength);
+	op += literalLength;
+	if (lastSequence)
+		return op;
+
+	if (opEnd - op < 2)
+		return nullptr;
+	*op++ = static_cast<uint8_t>(offset & 0xFF);
+	*op++ = static_cast<uint8_t>(offset >> 8);
+	*token |= static_cast<uint8_t>(std::min<size_t>(matchLength, RunMask));
+	if (matchLength >= RunMask)
+		return WriteLengthExtension(op, opEnd, matchLength - RunMask);
+	return op;
+}
+
+/**
+ * @brief Reads a length continued in extension bytes.
+ * @return false if the input ended before the length did.
+ */
+bool ReadLengthExtension(const uint8_t *&ip, const uint8_t *ipEnd, size_t &length)
+{
+	uint8_t value;
+	do {
+		if (ip >= ipEnd)
+			return false;
+		value = *ip++;
+		length += value;
+	} while (value == 255);
+	return true;
+}
+
+} // namespace
+
+size_t Lz4Compress(const byte *src, size_t srcSize, byte *dst, size_t dstCapacity)
+{
+	const auto *base = reinterpret_cast<const uint8_t *>(src);
+	const uint8_t *ip = base;
+	const uint8_t *anchor = base;
+	const uint8_t *const end = base + srcSize;
+	auto *const out = reinterpret_cast<uint8_t *>(dst);
+	uint8_t *op = out;
+	const uint8_t *const opEnd = out + dstCapacity;
+
+	if (srcSize >= MatchFindLimit) {
+		const uint8_t *const matchLimit = end - LastLiterals;
+		const uint8_t *const matchStartLimit = end - MatchFindLimit;
+		std::array<uint32_t, 1 << HashLog> hashTable {};
+
+		while (ip <= matchStartLimit) {
+			const uint32_t sequence = Read32(ip);
+			uint32_t &entry = hashTable[HashSequence(sequence)];
+			const uint8_t *ref = base + entry;
+			entry = static_cast<uint32_t>(ip - base);
+			if (ref >= ip || static_cast<size_t>(ip - ref) > MaxDistance || Read32(ref) != sequence) {
+				ip++;
+				continue;
+			}
+
+			while (ip > anchor && ref > base && ip[-1] == ref[-1]) {
+				ip--;
+				ref--;
+			}
+			const uint8_t *matchEnd = ip + MinMatch;
+			const uint8_t *refEnd = ref + MinMatch;
+			while (matchEnd < matchLimit && *matchEnd == *refEnd) {
+				matchEnd++;
+				refEnd++;
+			}
+
+			op = WriteSequence(op, opEnd, anchor, ip - anchor, ip - ref, matchEnd - ip - MinMatch, /*lastSequence=*/false);
+			if (op == nullptr)
+				return 0;
+			ip = matchEnd;
+			anchor = ip;
+		}
+	}
+
+	op = WriteSequence(op, opEnd, anchor, end - anchor, 0, 0, /*lastSequence=*/true);
+	if (op == nullptr)
+		return 0;
+	return op - out;
+}
+
+std::optional<size_t> Lz4Decompress(const byte *src, size_t srcSize, byte *dst, size_t dstCapacity)
+{
+	const auto *ip = reinterpret_cast<const uint8_t *>(src);
+	const uint8_t *const ipEnd = ip + srcSize;
+	auto *const out = reinterpret_cast<uint8_t *>(dst);
+	uint8_t *op = out;
+	const uint8_t *const opEnd = out + dstCapacity;
+
+	while (ip < ipEnd) {
+		const uint8_t token = *ip++;
+
+		size_t literalLength = token >> 4;
+		if (literalLength == RunMask && !ReadLengthExtension(ip, ipEnd, literalLength))
+			return std::nullopt;
+		if (literalLength > static_cast<size_t>(ipEnd - ip) || literalLength > static_cast<size_t>(opEnd - op))
+			return std::nullopt;
+		memcpy(op, ip, literalLength);
+		ip += literalLength;
+		op += literalLength;
+
+		// The last sequence consists of literals only.
+		if (ip == ipEnd)
+			break;
+
+		if (ipEnd - ip < 2)
+			return std::nullopt;
+		const size_t offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+		if (offset == 0 || offset > static_cast<size_t>(op - out))
+			return std::nullopt;
+
+		size_t matchLength = token & RunMask;
+		if (matchLength == RunMask && !ReadLengthExtension(ip, ipEnd, matchLength))
+			return std::nullopt;
+		matchLength += MinMatch;
+		if (matchLength > static_cast<size_t>(opEnd - op))
+			return std::nullopt;
+
+		const uint8_t *ref = op - offset;
+		if (offset >= matchLength) {
+			memcpy(op, ref, matchLength);
+			op += matchLength;
+		} else {
+			// Overlapping copy, repeats the last `offset` bytes.
+			for (size_t i = 0; i < matchLength; i++)
+				*op++ = *ref++;
+		}
+	}
+
+	return op - out;
+}
+
+} // namespace devilution
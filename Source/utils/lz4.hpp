@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+
+#include "utils/stdcompat/cstddef.hpp"
+#include "utils/stdcompat/optional.hpp"
+
+namespace devilution {
+
+/**
+ * @brief Returns the worst-case size of `Lz4Compress` output for `size` bytes of input.
+ */
+constexpr size_t Lz4CompressBound(size_t size)
+{
+	return size + size / 255 + 16;
+}
+
+/**
+ * @brief Compresses data into the LZ4 block format.
+ *
+ * Favours speed over ratio: a single greedy pass with a small hash table.
+ *
+ * @param src Data to compress.
+ * @param srcSize Size of the data to compress.
+ * @param dst Output buffer.
+ * @param dstCapacity Size of the output buffer, at least `Lz4CompressBound(srcSize)` to never fail.
+ * @return The compressed size, or 0 if the output did not fit into `dst`.
+ */
+size_t Lz4Compress(const byte *src, size_t srcSize, byte *dst, size_t dstCapacity);
+
+/**
+ * @brief Decompresses a LZ4 block.
+ *
+ * All offsets and lengths are validated, so it is safe to call with data received over the network.
+ *
+ * @param src Compressed block.
+ * @param srcSize Size of the compressed block.
+ * @param dst Output buffer, must not overlap with `src`.
+ * @param dstCapacity Size of the output buffer.
+ * @return The decompressed size, or nullopt if the block is malformed or does not fit into `dst`.
+ */
+std::optional<size_t> Lz4Decompress(const byte *src, size_t srcSize, byte *dst, size_t dstCapacity);
+
+} // namespace devilution
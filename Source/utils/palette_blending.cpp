@@ -0,0 +1,109 @@
+#include "utils/palette_blending.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace devilution {
+
+namespace {
+
+/** @brief Squared distances from a color to the nearest and to the furthest point of a box of the color space. */
+struct BoxDistance {
+	uint32_t min;
+	uint32_t max;
+};
+
+BoxDistance GetBoxDistance(const SDL_Color &color, const uint8_t *low, int size)
+{
+	BoxDistance distance { 0, 0 };
+	for (int channel = 0; channel < 3; channel++) {
+		const int value = channel == 0 ? color.r : (channel == 1 ? color.g : color.b);
+		const int first = low[channel];
+		const int last = first + size - 1;
+		const int nearest = value < first ? first - value : (value > last ? value - last : 0);
+		const int furthest = std::max(std::abs(value - first), std::abs(value - last));
+		distance.min += nearest * nearest;
+		distance.max += furthest * furthest;
+	}
+	return distance;
+}
+
+} // namespace
+
+PaletteColorIndex::PaletteColorIndex(const SDL_Color *palette, int skipFrom, int skipTo)
+{
+	cellStart_.reserve(GridSize * GridSize * GridSize + 1);
+	cellStart_.push_back(0);
+
+	BoxDistance distances[256];
+	for (int r = 0; r < GridSize; r++) {
+		for (int g = 0; g < GridSize; g++) {
+			for (int b = 0; b < GridSize; b++) {
+				const uint8_t low[3] = { static_cast<uint8_t>(r * CellSize), static_cast<uint8_t>(g * CellSize), static_cast<uint8_t>(b * CellSize) };
+				uint32_t bound = UINT32_MAX;
+				for (int i = 0; i < 256; i++) {
+					if (i >= skipFrom && i <= skipTo)
+						continue;
+					distances[i] = GetBoxDistance(palette[i], low, CellSize);
+					bound = std::min(bound, distances[i].max);
+				}
+				for (int i = 0; i < 256; i++) {
+					if (i >= skipFrom && i <= skipTo)
+						continue;
+					// Entries at the bound can still tie with the closest one.
+					if (distances[i].min <= bound) {
+						const SDL_Color &color = palette[i];
+						candidates_.push_back({ color.r, color.g, color.b, static_cast<uint8_t>(i) });
+					}
+				}
+				cellStart_.push_back(static_cast<uint32_t>(candidates_.size()));
+			}
+		}
+	}
+}
+
+uint8_t PaletteColorIndex::FindBestMatch(SDL_Color color) const
+{
+	const int cell = ((color.r >> CellBits) * GridSize + (color.g >> CellBits)) * GridSize + (color.b >> CellBits);
+
+	uint8_t best = 0;
+	uint32_t bestDiff = UINT32_MAX;
+	for (uint32_t i = cellStart_[cell]; i < cellStart_[cell + 1]; i++) {
+		const Entry &entry = candidates_[i];
+		const int diffr = entry.r - color.r;
+		const int diffg = entry.g - color.g;
+		const int diffb = entry.b - color.b;
+		const auto diff = static_cast<uint32_t>(diffr * diffr + diffg * diffg + diffb * diffb);
+		if (bestDiff > diff) {
+			best = entry.index;
+			bestDiff = diff;
+		}
+	}
+	return best;
+}
+
+void GenerateBlendedLookupTable(const SDL_Color *palette, int skipFrom, int skipTo, uint8_t table[256][256])
+{
+	const PaletteColorIndex colorIndex(palette, skipFrom, skipTo);
+
+	for (int i = 0; i < 256; i++) {
+		for (int j = 0; j < 256; j++) {
+			if (i == j) { // No need to calculate transparency between 2 identical colors
+				table[i][j] = j;
+				continue;
+			}
+			if (i > j) { // Half the blends will be mirror identical ([i][j] is the same as [j][i]), so simply copy the existing combination.
+				table[i][j] = table[j][i];
+				continue;
+			}
+
+			SDL_Color blendedColor;
+			blendedColor.r = ((int)palette[i].r + (int)palette[j].r) / 2;
+			blendedColor.g = ((int)palette[i].g + (int)palette[j].g) / 2;
+			blendedColor.b = ((int)palette[i].b + (int)palette[j].b) / 2;
+			table[i][j] = colorIndex.FindBestMatch(blendedColor);
+		}
+	}
+}
+
+} // namespace devilution
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <SDL.h>
+
+namespace devilution {
+
+/**
+ * @brief Finds the palette entries closest to arbitrary colors.
+ *
+ * The color space is split into a grid of cubes, each listing the entries that can be the closest
+ * to a color inside it. Any entry further from the cube than the furthest point of the cube is from
+ * some other entry is left out, so a search only compares a few candidates.
+ */
+class PaletteColorIndex {
+public:
+	/**
+	 * @param palette The 256 colors to search
+	 * @param skipFrom Do not use colors between this index and skipTo
+	 * @param skipTo Do not use colors between skipFrom and this index
+	 */
+	PaletteColorIndex(const SDL_Color *palette, int skipFrom, int skipTo);
+
+	/**
+	 * @brief Index of the entry with the least squared distance to `color`, the lowest one on ties.
+	 */
+	[[nodiscard]] uint8_t FindBestMatch(SDL_Color color) const;
+
+private:
+	static constexpr int CellBits = 5;
+	static constexpr int CellSize = 1 << CellBits;
+	static constexpr int GridSize = 256 / CellSize;
+
+	struct Entry {
+		uint8_t r;
+		uint8_t g;
+		uint8_t b;
+		uint8_t index;
+	};
+
+	/** @brief Position of the first candidate of each cell, followed by the number of candidates. */
+	std::vector<uint32_t> cellStart_;
+	/** @brief The candidates of each cell, in palette order. */
+	std::vector<Entry> candidates_;
+};
+
+/**
+ * @brief Generate lookup table for transparency
+ *
+ * This is based of the same technique found in Quake2.
+ *
+ * To mimic 50% transparency we figure out what colors in the existing palette are the best match for the combination of any 2 colors.
+ * We save this into a lookup table for use during rendering.
+ *
+ * @param palette The colors to operate on
+ * @param skipFrom Do not use colors between this index and skipTo
+ * @param skipTo Do not use colors between skipFrom and this index
+ * @param table Receives the index of the blend of each pair of colors
+ */
+void GenerateBlendedLookupTable(const SDL_Color *palette, int skipFrom, int skipTo, uint8_t table[256][256]);
+
+} // namespace devilution
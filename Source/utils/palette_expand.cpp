@@ -0,0 +1,159 @@
+#include "utils/palette_expand.hpp"
+
+#include <initializer_list>
+
+#include "utils/cpu_features.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define DEVILUTIONX_PALETTE_EXPAND_X86
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define DEVILUTIONX_PALETTE_EXPAND_NEON
+#include <arm_neon.h>
+#endif
+
+namespace devilution {
+
+namespace {
+
+void ExpandRowScalar(const uint8_t *src, uint32_t *dst, size_t count, const uint32_t *lut)
+{
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		dst[i + 0] = lut[src[i + 0]];
+		dst[i + 1] = lut[src[i + 1]];
+		dst[i + 2] = lut[src[i + 2]];
+		dst[i + 3] = lut[src[i + 3]];
+	}
+	for (; i < count; i++)
+		dst[i] = lut[src[i]];
+}
+
+#ifdef DEVILUTIONX_PALETTE_EXPAND_X86
+DVL_TARGET_AVX2 void ExpandRowAvx2(const uint8_t *src, uint32_t *dst, size_t count, const uint32_t *lut)
+{
+	const auto *table = reinterpret_cast<const int *>(lut);
+	size_t i = 0;
+	for (; i + 16 <= count; i += 16) {
+		const __m128i indices = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+		const __m256i low = _mm256_cvtepu8_epi32(indices);
+		const __m256i high = _mm256_cvtepu8_epi32(_mm_srli_si128(indices, 8));
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), _mm256_i32gather_epi32(table, low, 4));
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i + 8), _mm256_i32gather_epi32(table, high, 4));
+	}
+	ExpandRowScalar(src + i, dst + i, count - i, lut);
+}
+#endif
+
+#ifdef DEVILUTIONX_PALETTE_EXPAND_NEON
+uint8x16x4_t LoadTable(const uint8_t *plane, int part)
+{
+	const uint8_t *first = plane + 64 * part;
+	uint8x16x4_t table;
+	table.val[0] = vld1q_u8(first);
+	table.val[1] = vld1q_u8(first + 16);
+	table.val[2] = vld1q_u8(first + 32);
+	table.val[3] = vld1q_u8(first + 48);
+	return table;
+}
+
+/** @brief Looks up 16 indices in a 256-byte plane, in four 64-byte parts. */
+uint8x16_t LookupPlane(const uint8x16x4_t (&table)[4], uint8x16_t indices)
+{
+	// Out of range indices produce 0 in `vqtbl4q` and keep the previous value in `vqtbx4q`.
+	const uint8x16_t partSize = vdupq_n_u8(64);
+	uint8x16_t result = vqtbl4q_u8(table[0], indices);
+	indices = vsubq_u8(indices, partSize);
+	result = vqtbx4q_u8(result, table[1], indices);
+	indices = vsubq_u8(indices, partSize);
+	result = vqtbx4q_u8(result, table[2], indices);
+	indices = vsubq_u8(indices, partSize);
+	return vqtbx4q_u8(result, table[3], indices);
+}
+
+void ExpandRowNeon(const uint8_t *src, uint32_t *dst, size_t count, const uint8x16x4_t (&tables)[4][4], const uint32_t *lut)
+{
+	size_t i = 0;
+	for (; i + 16 <= count; i += 16) {
+		const uint8x16_t indices = vld1q_u8(src + i);
+		uint8x16x4_t pixels;
+		pixels.val[0] = LookupPlane(tables[0], indices);
+		pixels.val[1] = LookupPlane(tables[1], indices);
+		pixels.val[2] = LookupPlane(tables[2], indices);
+		pixels.val[3] = LookupPlane(tables[3], indices);
+		// Interleaves the planes back into little-endian 32-bit pixels.
+		vst4q_u8(reinterpret_cast<uint8_t *>(dst + i), pixels);
+	}
+	ExpandRowScalar(src + i, dst + i, count - i, lut);
+}
+
+void ExpandRectNeon(const uint8_t *src, size_t srcPitch, uint32_t *dst, size_t dstPitch, size_t width, int height, const PaletteLut &lut)
+{
+	uint8x16x4_t tables[4][4];
+	for (int plane = 0; plane < 4; plane++) {
+		for (int part = 0; part < 4; part++)
+			tables[plane][part] = LoadTable(lut.Plane(plane), part);
+	}
+	for (int y = 0; y < height; y++, src += srcPitch, dst += dstPitch)
+		ExpandRowNeon(src, dst, width, tables, lut.Pixels());
+}
+#endif
+
+} // namespace
+
+bool IsPaletteExpandKernelSupported(PaletteExpandKernel kernel)
+{
+	switch (kernel) {
+	case PaletteExpandKernel::Scalar:
+		return true;
+	case PaletteExpandKernel::Avx2:
+#ifdef DEVILUTIONX_PALETTE_EXPAND_X86
+		return CpuSupportsAvx2();
+#else
+		return false;
+#endif
+	case PaletteExpandKernel::Neon:
+#ifdef DEVILUTIONX_PALETTE_EXPAND_NEON
+		return true;
+#else
+		return false;
+#endif
+	}
+	return false;
+}
+
+PaletteExpandKernel GetBestPaletteExpandKernel()
+{
+	static const PaletteExpandKernel Best = []() {
+		for (PaletteExpandKernel kernel : { PaletteExpandKernel::Avx2, PaletteExpandKernel::Neon }) {
+			if (IsPaletteExpandKernelSupported(kernel))
+				return kernel;
+		}
+		return PaletteExpandKernel::Scalar;
+	}();
+	return Best;
+}
+
+void ExpandPalette(const uint8_t *src, size_t srcPitch, uint32_t *dst, size_t dstPitch, int width, int height, const PaletteLut &lut, PaletteExpandKernel kernel)
+{
+	const auto count = static_cast<size_t>(width);
+#ifdef DEVILUTIONX_PALETTE_EXPAND_NEON
+	if (kernel == PaletteExpandKernel::Neon) {
+		ExpandRectNeon(src, srcPitch, dst, dstPitch, count, height, lut);
+		return;
+	}
+#endif
+	for (int y = 0; y < height; y++, src += srcPitch, dst += dstPitch) {
+#ifdef DEVILUTIONX_PALETTE_EXPAND_X86
+		if (kernel == PaletteExpandKernel::Avx2) {
+			ExpandRowAvx2(src, dst, count, lut.Pixels());
+			continue;
+		}
+#endif
+		ExpandRowScalar(src, dst, count, lut.Pixels());
+	}
+}
+
+} // namespace devilution
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace devilution {
+
+/**
+ * @brief Maps the 256 palette indices to pixels of a 32-bit output format.
+ *
+ * Besides the pixels themselves, the entries are kept split into byte planes for kernels
+ * that look up one byte at a time.
+ */
+class PaletteLut {
+public:
+	void SetEntry(uint8_t index, uint32_t pixel)
+	{
+		pixels_[index] = pixel;
+		for (int plane = 0; plane < 4; plane++)
+			planes_[plane][index] = static_cast<uint8_t>(pixel >> (8 * plane));
+	}
+
+	uint32_t operator[](uint8_t index) const
+	{
+		return pixels_[index];
+	}
+
+	const uint32_t *Pixels() const
+	{
+		return pixels_;
+	}
+
+	/** @brief Byte `plane` of every entry, starting with the least significant byte. */
+	const uint8_t *Plane(int plane) const
+	{
+		return planes_[plane];
+	}
+
+private:
+	alignas(32) uint32_t pixels_[256] = {};
+	alignas(16) uint8_t planes_[4][256] = {};
+};
+
+enum class PaletteExpandKernel : uint8_t {
+	Scalar,
+	/** x86 with AVX2, using gathers from the lookup table. */
+	Avx2,
+	/** AArch64 Advanced SIMD, using 64-byte table lookups on the byte planes. */
+	Neon,
+};
+
+/**
+ * @brief Whether `kernel` was compiled in and is supported by this CPU.
+ */
+bool IsPaletteExpandKernelSupported(PaletteExpandKernel kernel);
+
+/**
+ * @brief The fastest kernel supported by this CPU, detected on first use.
+ */
+PaletteExpandKernel GetBestPaletteExpandKernel();
+
+/**
+ * @brief Converts a rectangle of 8-bit palette indices to 32-bit pixels.
+ *
+ * @param src First index of the rectangle.
+ * @param srcPitch Distance between rows of `src`, in bytes.
+ * @param dst First pixel of the rectangle.
+ * @param dstPitch Distance between rows of `dst`, in pixels.
+ * @param width Width of the rectangle.
+ * @param height Height of the rectangle.
+ * @param lut Pixel values for each palette index.
+ * @param kernel Implementation to use, must be supported.
+ */
+void ExpandPalette(const uint8_t *src, size_t srcPitch, uint32_t *dst, size_t dstPitch, int width, int height, const PaletteLut &lut, PaletteExpandKernel kernel);
+
+inline void ExpandPalette(const uint8_t *src, size_t srcPitch, uint32_t *dst, size_t dstPitch, int width, int height, const PaletteLut &lut)
+{
+	ExpandPalette(src, srcPitch, dst, dstPitch, width, height, lut, GetBestPaletteExpandKernel());
+}
+
+} // namespace devilution
@@ -1,8 +1,14 @@
 #include "utils/sdl_bilinear_scale.hpp"
 
 #include <cstdint>
+#include <cstring>
 #include <memory>
 
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DEVILUTIONX_BILINEAR_SCALE_SSE2
+#include <emmintrin.h>
+#endif
+
 // Performs bilinear scaling using fixed-width integer math.
 
 namespace devilution {
@@ -62,69 +68,93 @@ uint8_t MixColorsWithAlpha(uint8_t first, uint8_t firstAlpha,
 	return ToInt((secondWithAlpha - firstWithAlpha) * ((ratio + (mixedAlpha - 1)) / mixedAlpha)) + (firstWithAlpha + (mixedAlpha - 1)) / mixedAlpha;
 }
 
-} // namespace
+/**
+ * @brief Mixes a pixel from its 4 source pixels.
+ * @param s The source pixels: self, right, bottom and bottom right.
+ */
+void MixPixel(const uint8_t *const s[4], int mixX, int mixY, uint8_t *dstPixel)
+{
+	const uint8_t alpha0 = MixColors(s[0][3], s[1][3], mixX);
+	const uint8_t alpha1 = MixColors(s[2][3], s[3][3], mixX);
+	const uint8_t finalAlpha = MixColors(alpha0, alpha1, mixY);
 
-void BilinearScale32(SDL_Surface *src, SDL_Surface *dst)
+	if (finalAlpha == 0) {
+		dstPixel[0] = 0;
+		dstPixel[1] = 0;
+		dstPixel[2] = 0;
+		dstPixel[3] = 0;
+	} else if (finalAlpha == 255) {
+		for (unsigned channel = 0; channel < 3; ++channel) {
+			dstPixel[channel] = MixColors(
+			    MixColors(s[0][channel], s[1][channel], mixX),
+			    MixColors(s[2][channel], s[3][channel], mixX),
+			    mixY);
+		}
+		dstPixel[3] = 255;
+	} else {
+		for (unsigned channel = 0; channel < 3; ++channel) {
+			dstPixel[channel] = MixColorsWithAlpha(
+			    MixColorsWithAlpha(s[0][channel], s[0][3], s[1][channel], s[1][3], alpha0, mixX),
+			    alpha0,
+			    MixColorsWithAlpha(s[2][channel], s[2][3], s[3][channel], s[3][3], alpha1, mixX),
+			    alpha1,
+			    finalAlpha,
+			    mixY);
+		}
+		dstPixel[3] = finalAlpha;
+	}
+}
+
+/**
+ * @brief Byte offset of the source pixel of each destination column.
+ *
+ * Steps through `mixXs` the same way as `BilinearScale32Scalar`.
+ */
+std::unique_ptr<int[]> CreateSourceOffsets(const int *mixXs, unsigned srcWidth, unsigned dstWidth)
 {
-	const std::unique_ptr<int[]> mixXs = CreateMixFactors(src->w, dst->w);
-	const std::unique_ptr<int[]> mixYs = CreateMixFactors(src->h, dst->h);
+	std::unique_ptr<int[]> result { new int[dstWidth] };
+	int offset = 0;
+	unsigned srcX = 0;
+	for (unsigned x = 0; x < dstWidth; ++x) {
+		result[x] = offset;
+		if (mixXs[x + 1] > 0) {
+			const unsigned step = ToInt(mixXs[x + 1]);
+			srcX += step;
+			if (srcX <= srcWidth)
+				offset += step * 4;
+		}
+	}
+	return result;
+}
 
-	const unsigned dgap = dst->pitch - dst->w * 4;
+void BilinearScale32Scalar(const uint8_t *srcPixels, int srcWidth, int srcHeight, int srcPitch,
+    uint8_t *dstPixels, int dstWidth, int dstHeight, int dstPitch)
+{
+	const std::unique_ptr<int[]> mixXs = CreateMixFactors(srcWidth, dstWidth);
+	const std::unique_ptr<int[]> mixYs = CreateMixFactors(srcHeight, dstHeight);
 
-	auto *srcPixels = static_cast<uint8_t *>(src->pixels);
-	auto *dstPixels = static_cast<uint8_t *>(dst->pixels);
+	const unsigned dgap = dstPitch - dstWidth * 4;
 
 	int *curMixY = &mixYs[0];
 	unsigned srcY = 0;
-	for (unsigned y = 0; y < static_cast<unsigned>(dst->h); ++y) {
-		uint8_t *s[4] = {
-			srcPixels,                 // Self
-			srcPixels + 4,             // Right
-			srcPixels + src->pitch,    // Bottom
-			srcPixels + src->pitch + 4 // Bottom right
+	for (unsigned y = 0; y < static_cast<unsigned>(dstHeight); ++y) {
+		const uint8_t *s[4] = {
+			srcPixels,                // Self
+			srcPixels + 4,            // Right
+			srcPixels + srcPitch,     // Bottom
+			srcPixels + srcPitch + 4, // Bottom right
 		};
 
 		int *curMixX = &mixXs[0];
 		unsigned srcX = 0;
-		for (unsigned x = 0; x < static_cast<unsigned>(dst->w); ++x) {
-			const int mixX = Frac(*curMixX);
-			const int mixY = Frac(*curMixY);
-
-			const uint8_t alpha0 = MixColors(s[0][3], s[1][3], mixX);
-			const uint8_t alpha1 = MixColors(s[2][3], s[3][3], mixX);
-			const uint8_t finalAlpha = MixColors(alpha0, alpha1, mixY);
-
-			if (finalAlpha == 0) {
-				dstPixels[0] = 0;
-				dstPixels[1] = 0;
-				dstPixels[2] = 0;
-				dstPixels[3] = 0;
-			} else if (finalAlpha == 255) {
-				for (unsigned channel = 0; channel < 3; ++channel) {
-					dstPixels[channel] = MixColors(
-					    MixColors(s[0][channel], s[1][channel], mixX),
-					    MixColors(s[2][channel], s[3][channel], mixX),
-					    mixY);
-				}
-				dstPixels[3] = 255;
-			} else {
-				for (unsigned channel = 0; channel < 3; ++channel) {
-					dstPixels[channel] = MixColorsWithAlpha(
-					    MixColorsWithAlpha(s[0][channel], s[0][3], s[1][channel], s[1][3], alpha0, mixX),
-					    alpha0,
-					    MixColorsWithAlpha(s[2][channel], s[2][3], s[3][channel], s[3][3], alpha1, mixX),
-					    alpha1,
-					    finalAlpha,
-					    mixY);
-				}
-				dstPixels[3] = finalAlpha;
-			}
+		for (unsigned x = 0; x < static_cast<unsigned>(dstWidth); ++x) {
+			MixPixel(s, Frac(*curMixX), Frac(*curMixY), dstPixels);
 
 			++curMixX;
 			if (*curMixX > 0) {
 				unsigned step = ToInt(*curMixX);
 				srcX += step;
-				if (srcX <= static_cast<unsigned>(src->w)) {
+				if (srcX <= static_cast<unsigned>(srcWidth)) {
 					step *= 4;
 					for (auto &v : s) {
 						v += step;
@@ -139,8 +169,8 @@ void BilinearScale32(SDL_Surface *src, SDL_Surface *dst)
 		if (*curMixY > 0) {
 			const unsigned step = ToInt(*curMixY);
 			srcY += step;
-			if (srcY < static_cast<unsigned>(src->h)) {
-				srcPixels += step * src->pitch;
+			if (srcY < static_cast<unsigned>(srcHeight)) {
+				srcPixels += step * srcPitch;
 			}
 		}
 
@@ -148,4 +178,132 @@ void BilinearScale32(SDL_Surface *src, SDL_Surface *dst)
 	}
 }
 
+#ifdef DEVILUTIONX_BILINEAR_SCALE_SSE2
+/**
+ * @brief `MixColors` on 16-bit lanes.
+ *
+ * `_mm_mulhi_epi16` reads ratios of 32768 and above as `ratio - 65536`, which takes away `second - first`
+ * from the result, so it is added back. This keeps the result exactly the same as `MixColors`.
+ */
+__m128i MixLanes(__m128i first, __m128i second, int ratio)
+{
+	const __m128i diff = _mm_sub_epi16(second, first);
+	__m128i mixed = _mm_mulhi_epi16(diff, _mm_set1_epi16(static_cast<int16_t>(ratio)));
+	if (ratio >= 32768)
+		mixed = _mm_add_epi16(mixed, diff);
+	return _mm_add_epi16(first, mixed);
+}
+
+/** @brief The channels of two pixels as 16-bit lanes. */
+__m128i LoadPixelPair(const uint8_t *first, const uint8_t *second)
+{
+	uint32_t a;
+	uint32_t b;
+	memcpy(&a, first, sizeof(a));
+	memcpy(&b, second, sizeof(b));
+	const __m128i pixels = _mm_unpacklo_epi32(_mm_cvtsi32_si128(static_cast<int>(a)), _mm_cvtsi32_si128(static_cast<int>(b)));
+	return _mm_unpacklo_epi8(pixels, _mm_setzero_si128());
+}
+
+/**
+ * @brief Scales a row two pixels at a time.
+ *
+ * Only opaque and fully transparent pixels are finished here, the others go through `MixPixel`.
+ */
+void BilinearScaleRowSse2(const uint8_t *srcRow, int srcPitch, const int *offsets, const int *mixXs, int mixY, uint8_t *dst, int width)
+{
+	int x = 0;
+	for (; x + 2 <= width; x += 2) {
+		__m128i horizontal[2];
+		for (int i = 0; i < 2; i++) {
+			const uint8_t *s = srcRow + offsets[x + i];
+			// Top in the low half and bottom in the high half.
+			horizontal[i] = MixLanes(LoadPixelPair(s, s + srcPitch), LoadPixelPair(s + 4, s + srcPitch + 4), Frac(mixXs[x + i]));
+		}
+		const __m128i top = _mm_unpacklo_epi64(horizontal[0], horizontal[1]);
+		const __m128i bottom = _mm_unpackhi_epi64(horizontal[0], horizontal[1]);
+		alignas(16) uint8_t mixed[16];
+		_mm_store_si128(reinterpret_cast<__m128i *>(mixed), _mm_packus_epi16(MixLanes(top, bottom, mixY), _mm_setzero_si128()));
+
+		for (int i = 0; i < 2; i++) {
+			uint8_t *dstPixel = dst + 4 * (x + i);
+			const uint8_t alpha = mixed[4 * i + 3];
+			if (alpha == 255) {
+				memcpy(dstPixel, &mixed[4 * i], 4);
+			} else if (alpha == 0) {
+				memset(dstPixel, 0, 4);
+			} else {
+				const uint8_t *s = srcRow + offsets[x + i];
+				const uint8_t *const neighbours[4] = { s, s + 4, s + srcPitch, s + srcPitch + 4 };
+				MixPixel(neighbours, Frac(mixXs[x + i]), mixY, dstPixel);
+			}
+		}
+	}
+	for (; x < width; x++) {
+		const uint8_t *s = srcRow + offsets[x];
+		const uint8_t *const neighbours[4] = { s, s + 4, s + srcPitch, s + srcPitch + 4 };
+		MixPixel(neighbours, Frac(mixXs[x]), mixY, dst + 4 * x);
+	}
+}
+
+void BilinearScale32Sse2(const uint8_t *srcPixels, int srcWidth, int srcHeight, int srcPitch,
+    uint8_t *dstPixels, int dstWidth, int dstHeight, int dstPitch)
+{
+	const std::unique_ptr<int[]> mixXs = CreateMixFactors(srcWidth, dstWidth);
+	const std::unique_ptr<int[]> mixYs = CreateMixFactors(srcHeight, dstHeight);
+	const std::unique_ptr<int[]> offsets = CreateSourceOffsets(mixXs.get(), srcWidth, dstWidth);
+
+	unsigned srcY = 0;
+	for (int y = 0; y < dstHeight; ++y) {
+		BilinearScaleRowSse2(srcPixels, srcPitch, offsets.get(), mixXs.get(), Frac(mixYs[y]), dstPixels, dstWidth);
+
+		if (mixYs[y + 1] > 0) {
+			const unsigned step = ToInt(mixYs[y + 1]);
+			srcY += step;
+			if (srcY < static_cast<unsigned>(srcHeight)) {
+				srcPixels += step * srcPitch;
+			}
+		}
+
+		dstPixels += dstPitch;
+	}
+}
+#endif
+
+} // namespace
+
+bool IsBilinearScaleKernelSupported(BilinearScaleKernel kernel)
+{
+	switch (kernel) {
+	case BilinearScaleKernel::Scalar:
+		return true;
+	case BilinearScaleKernel::Sse2:
+#ifdef DEVILUTIONX_BILINEAR_SCALE_SSE2
+		return true;
+#else
+		return false;
+#endif
+	}
+	return false;
+}
+
+void BilinearScale32(const uint8_t *src, int srcWidth, int srcHeight, int srcPitch,
+    uint8_t *dst, int dstWidth, int dstHeight, int dstPitch, BilinearScaleKernel kernel)
+{
+#ifdef DEVILUTIONX_BILINEAR_SCALE_SSE2
+	if (kernel == BilinearScaleKernel::Sse2) {
+		BilinearScale32Sse2(src, srcWidth, srcHeight, srcPitch, dst, dstWidth, dstHeight, dstPitch);
+		return;
+	}
+#endif
+	BilinearScale32Scalar(src, srcWidth, srcHeight, srcPitch, dst, dstWidth, dstHeight, dstPitch);
+}
+
+void BilinearScale32(SDL_Surface *src, SDL_Surface *dst)
+{
+	const BilinearScaleKernel kernel = IsBilinearScaleKernelSupported(BilinearScaleKernel::Sse2) ? BilinearScaleKernel::Sse2 : BilinearScaleKernel::Scalar;
+	BilinearScale32(static_cast<const uint8_t *>(src->pixels), src->w, src->h, src->pitch,
+	    static_cast<uint8_t *>(dst->pixels), dst->w, dst->h, dst->pitch, kernel);
+}
+
 } // namespace devilution
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 #include <SDL_version.h>
 
 #if SDL_VERSION_ATLEAST(2, 0, 0)
@@ -10,6 +12,25 @@
 
 namespace devilution {
 
+enum class BilinearScaleKernel : uint8_t {
+	Scalar,
+	/** x86 SSE2, always available on x86-64. */
+	Sse2,
+};
+
+/**
+ * @brief Whether `kernel` was compiled in and is supported by this CPU.
+ */
+bool IsBilinearScaleKernelSupported(BilinearScaleKernel kernel);
+
+/**
+ * @brief Bilinear 32-bit scaling of raw pixels, with the alpha channel in the last byte of each pixel.
+ *
+ * All kernels produce the same pixels.
+ */
+void BilinearScale32(const uint8_t *src, int srcWidth, int srcHeight, int srcPitch,
+    uint8_t *dst, int dstWidth, int dstHeight, int dstPitch, BilinearScaleKernel kernel);
+
 /**
  * @brief Bilinear 32-bit scaling.
  * Requires `src` and `dst` to have the same pixel format (ARGB8888 or RGBA8888).
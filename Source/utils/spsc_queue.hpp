@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace devilution {
+
+/**
+ * @brief A bounded lock-free queue for exactly one producer thread and one consumer thread.
+ *
+ * `TryPush` may only be called by the producer, `Front`, `TryPop` and `Pop` only by the consumer.
+ * Popped slots are left in a moved-from state until they are reused.
+ *
+ * @tparam T element type, must be default constructible and move assignable.
+ * @tparam Capacity maximum number of queued elements, must be a power of two.
+ */
+template <typename T, size_t Capacity>
+class SpscQueue {
+	static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+	/**
+	 * @brief Appends an element, producer only.
+	 * @return false if the queue is full, `value` is left untouched in that case.
+	 */
+	bool TryPush(T &&value)
+	{
+		const size_t tail = tail_.load(std::memory_order_relaxed);
+		if (tail - headCache_ == Capacity) {
+			headCache_ = head_.load(std::memory_order_acquire);
+			if (tail - headCache_ == Capacity)
+				return false;
+		}
+		slots_[tail & Mask] = std::move(value);
+		tail_.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * @brief Returns the oldest element without removing it, consumer only.
+	 * @return nullptr if the queue is empty.
+	 */
+	T *Front()
+	{
+		const size_t head = head_.load(std::memory_order_relaxed);
+		if (head == tailCache_) {
+			tailCache_ = tail_.load(std::memory_order_acquire);
+			if (head == tailCache_)
+				return nullptr;
+		}
+		return &slots_[head & Mask];
+	}
+
+	/**
+	 * @brief Moves the oldest element into `value`, consumer only.
+	 * @return false if the queue is empty.
+	 */
+	bool TryPop(T &value)
+	{
+		T *front = Front();
+		if (front == nullptr)
+			return false;
+		value = std::move(*front);
+		Pop();
+		return true;
+	}
+
+	/**
+	 * @brief Removes the element returned by `Front`, consumer only.
+	 */
+	void Pop()
+	{
+		head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	/**
+	 * @brief Removes all elements, consumer only.
+	 */
+	void Clear()
+	{
+		for (T *front = Front(); front != nullptr; front = Front()) {
+			*front = T {};
+			Pop();
+		}
+	}
+
+	/**
+	 * @brief Whether the queue is empty, exact only when called from the consumer.
+	 */
+	[[nodiscard]] bool Empty() const
+	{
+		return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+	}
+
+private:
+	static constexpr size_t Mask = Capacity - 1;
+	/** Keeps the producer and consumer indices on separate cache lines to avoid false sharing. */
+	static constexpr size_t CacheLineSize = 64;
+
+	alignas(CacheLineSize) std::atomic<size_t> head_ { 0 };
+	/** The consumer's last known value of `tail_`. */
+	size_t tailCache_ = 0;
+
+	alignas(CacheLineSize) std::atomic<size_t> tail_ { 0 };
+	/** The producer's last known value of `head_`. */
+	size_t headCache_ = 0;
+
+	alignas(CacheLineSize) std::array<T, Capacity> slots_;
+};
+
+} // namespace devilution
@@ -0,0 +1,252 @@
+#include "utils/upscale.hpp"
+
+#include <cstring>
+#include <initializer_list>
+
+#include "utils/cpu_features.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DEVILUTIONX_UPSCALE_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define DEVILUTIONX_UPSCALE_AVX2
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define DEVILUTIONX_UPSCALE_NEON
+#include <arm_neon.h>
+#endif
+
+namespace devilution {
+
+namespace {
+
+// All of the row functions go from right to left, see `DoublePixels`.
+
+void DoubleRow8Scalar(const uint8_t *src, uint8_t *dst, int count)
+{
+	for (int i = count - 1; i >= 0; i--) {
+		const uint8_t pixel = src[i];
+		dst[2 * i] = pixel;
+		dst[2 * i + 1] = pixel;
+	}
+}
+
+void DoubleRow32Scalar(const uint32_t *src, uint32_t *dst, int count)
+{
+	for (int i = count - 1; i >= 0; i--) {
+		const uint32_t pixel = src[i];
+		dst[2 * i] = pixel;
+		dst[2 * i + 1] = pixel;
+	}
+}
+
+#ifdef DEVILUTIONX_UPSCALE_SSE2
+void DoubleRow8Sse2(const uint8_t *src, uint8_t *dst, int count)
+{
+	const int vectorCount = count & ~15;
+	DoubleRow8Scalar(src + vectorCount, dst + 2 * vectorCount, count - vectorCount);
+	for (int i = vectorCount - 16; i >= 0; i -= 16) {
+		const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 2 * i + 16), _mm_unpackhi_epi8(pixels, pixels));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 2 * i), _mm_unpacklo_epi8(pixels, pixels));
+	}
+}
+
+void DoubleRow32Sse2(const uint32_t *src, uint32_t *dst, int count)
+{
+	const int vectorCount = count & ~3;
+	DoubleRow32Scalar(src + vectorCount, dst + 2 * vectorCount, count - vectorCount);
+	for (int i = vectorCount - 4; i >= 0; i -= 4) {
+		const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 2 * i + 4), _mm_unpackhi_epi32(pixels, pixels));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 2 * i), _mm_unpacklo_epi32(pixels, pixels));
+	}
+}
+#endif
+
+#ifdef DEVILUTIONX_UPSCALE_AVX2
+DVL_TARGET_AVX2 void DoubleRow8Avx2(const uint8_t *src, uint8_t *dst, int count)
+{
+	const int vectorCount = count & ~31;
+	DoubleRow8Scalar(src + vectorCount, dst + 2 * vectorCount, count - vectorCount);
+	for (int i = vectorCount - 32; i >= 0; i -= 32) {
+		// The unpack instructions work within 128-bit lanes, so the 64-bit quarters are put in the order 0, 2, 1, 3 first.
+		const __m256i pixels = _mm256_permute4x64_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i)), 0xD8);
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 2 * i + 32), _mm256_unpackhi_epi8(pixels, pixels));
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 2 * i), _mm256_unpacklo_epi8(pixels, pixels));
+	}
+}
+
+DVL_TARGET_AVX2 void DoubleRow32Avx2(const uint32_t *src, uint32_t *dst, int count)
+{
+	const int vectorCount = count & ~7;
+	DoubleRow32Scalar(src + vectorCount, dst + 2 * vectorCount, count - vectorCount);
+	for (int i = vectorCount - 8; i >= 0; i -= 8) {
+		const __m256i pixels = _mm256_permute4x64_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i)), 0xD8);
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 2 * i + 8), _mm256_unpackhi_epi32(pixels, pixels));
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 2 * i), _mm256_unpacklo_epi32(pixels, pixels));
+	}
+}
+#endif
+
+#ifdef DEVILUTIONX_UPSCALE_NEON
+void DoubleRow8Neon(const uint8_t *src, uint8_t *dst, int count)
+{
+	const int vectorCount = count & ~15;
+	DoubleRow8Scalar(src + vectorCount, dst + 2 * vectorCount, count - vectorCount);
+	for (int i = vectorCount - 16; i >= 0; i -= 16) {
+		const uint8x16_t pixels = vld1q_u8(src + i);
+		vst2q_u8(dst + 2 * i, (uint8x16x2_t { { pixels, pixels } }));
+	}
+}
+
+void DoubleRow32Neon(const uint32_t *src, uint32_t *dst, int count)
+{
+	const int vectorCount = count & ~3;
+	DoubleRow32Scalar(src + vectorCount, dst + 2 * vectorCount, count - vectorCount);
+	for (int i = vectorCount - 4; i >= 0; i -= 4) {
+		const uint32x4_t pixels = vld1q_u32(src + i);
+		vst2q_u32(dst + 2 * i, (uint32x4x2_t { { pixels, pixels } }));
+	}
+}
+#endif
+
+void DoubleRow32(const uint32_t *src, uint32_t *dst, int count, UpscaleKernel kernel)
+{
+	switch (kernel) {
+#ifdef DEVILUTIONX_UPSCALE_SSE2
+	case UpscaleKernel::Sse2:
+		DoubleRow32Sse2(src, dst, count);
+		return;
+#endif
+#ifdef DEVILUTIONX_UPSCALE_AVX2
+	case UpscaleKernel::Avx2:
+		DoubleRow32Avx2(src, dst, count);
+		return;
+#endif
+#ifdef DEVILUTIONX_UPSCALE_NEON
+	case UpscaleKernel::Neon:
+		DoubleRow32Neon(src, dst, count);
+		return;
+#endif
+	default:
+		DoubleRow32Scalar(src, dst, count);
+		return;
+	}
+}
+
+template <typename Pixel>
+void RepeatRowScalar(const Pixel *src, Pixel *dst, int count, int factor)
+{
+	for (int i = count - 1; i >= 0; i--) {
+		const Pixel pixel = src[i];
+		for (int j = 0; j < factor; j++)
+			dst[i * factor + j] = pixel;
+	}
+}
+
+/** @brief Scales the first row, using in-place doubling for powers of two. */
+void UpscaleRow(const uint8_t *src, uint8_t *dst, int width, int bytesPerPixel, int factor, UpscaleKernel kernel)
+{
+	if ((factor & (factor - 1)) != 0) {
+		if (bytesPerPixel == 1)
+			RepeatRowScalar(src, dst, width, factor);
+		else
+			RepeatRowScalar(reinterpret_cast<const uint32_t *>(src), reinterpret_cast<uint32_t *>(dst), width, factor);
+		return;
+	}
+	if (factor == 1) {
+		memcpy(dst, src, static_cast<size_t>(width) * bytesPerPixel);
+		return;
+	}
+	for (int count = width; count < width * factor; count *= 2) {
+		if (bytesPerPixel == 1)
+			DoublePixels(src, dst, count, kernel);
+		else
+			DoubleRow32(reinterpret_cast<const uint32_t *>(src), reinterpret_cast<uint32_t *>(dst), count, kernel);
+		src = dst;
+	}
+}
+
+} // namespace
+
+bool IsUpscaleKernelSupported(UpscaleKernel kernel)
+{
+	switch (kernel) {
+	case UpscaleKernel::Scalar:
+		return true;
+	case UpscaleKernel::Sse2:
+#ifdef DEVILUTIONX_UPSCALE_SSE2
+		return true;
+#else
+		return false;
+#endif
+	case UpscaleKernel::Avx2:
+#ifdef DEVILUTIONX_UPSCALE_AVX2
+		return CpuSupportsAvx2();
+#else
+		return false;
+#endif
+	case UpscaleKernel::Neon:
+#ifdef DEVILUTIONX_UPSCALE_NEON
+		return true;
+#else
+		return false;
+#endif
+	}
+	return false;
+}
+
+UpscaleKernel GetBestUpscaleKernel()
+{
+	static const UpscaleKernel Best = []() {
+		for (UpscaleKernel kernel : { UpscaleKernel::Avx2, UpscaleKernel::Sse2, UpscaleKernel::Neon }) {
+			if (IsUpscaleKernelSupported(kernel))
+				return kernel;
+		}
+		return UpscaleKernel::Scalar;
+	}();
+	return Best;
+}
+
+void DoublePixels(const uint8_t *src, uint8_t *dst, int count, UpscaleKernel kernel)
+{
+	switch (kernel) {
+#ifdef DEVILUTIONX_UPSCALE_SSE2
+	case UpscaleKernel::Sse2:
+		DoubleRow8Sse2(src, dst, count);
+		return;
+#endif
+#ifdef DEVILUTIONX_UPSCALE_AVX2
+	case UpscaleKernel::Avx2:
+		DoubleRow8Avx2(src, dst, count);
+		return;
+#endif
+#ifdef DEVILUTIONX_UPSCALE_NEON
+	case UpscaleKernel::Neon:
+		DoubleRow8Neon(src, dst, count);
+		return;
+#endif
+	default:
+		DoubleRow8Scalar(src, dst, count);
+		return;
+	}
+}
+
+void UpscaleNearest(const uint8_t *src, size_t srcPitch, uint8_t *dst, size_t dstPitch, int width, int height, int bytesPerPixel, int factor, UpscaleKernel kernel)
+{
+	const size_t rowSize = static_cast<size_t>(width) * factor * bytesPerPixel;
+	for (int y = 0; y < height; y++, src += srcPitch) {
+		UpscaleRow(src, dst, width, bytesPerPixel, factor, kernel);
+		const uint8_t *firstRow = dst;
+		dst += dstPitch;
+		for (int i = 1; i < factor; i++, dst += dstPitch)
+			memcpy(dst, firstRow, rowSize);
+	}
+}
+
+} // namespace devilution
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace devilution {
+
+enum class UpscaleKernel : uint8_t {
+	Scalar,
+	/** x86 SSE2, always available on x86-64. */
+	Sse2,
+	/** x86 with AVX2. */
+	Avx2,
+	/** AArch64 Advanced SIMD. */
+	Neon,
+};
+
+/**
+ * @brief Whether `kernel` was compiled in and is supported by this CPU.
+ */
+bool IsUpscaleKernelSupported(UpscaleKernel kernel);
+
+/**
+ * @brief The fastest kernel supported by this CPU, detected on first use.
+ */
+UpscaleKernel GetBestUpscaleKernel();
+
+/**
+ * @brief Writes each of `count` 8-bit pixels twice.
+ *
+ * The pixels are processed from right to left, so `dst` may overlap `src` as long as it does not start before it.
+ */
+void DoublePixels(const uint8_t *src, uint8_t *dst, int count, UpscaleKernel kernel);
+
+inline void DoublePixels(const uint8_t *src, uint8_t *dst, int count)
+{
+	DoublePixels(src, dst, count, GetBestUpscaleKernel());
+}
+
+/**
+ * @brief Nearest-neighbour scaling by a whole number.
+ *
+ * @param src First pixel of the source rectangle.
+ * @param srcPitch Distance between rows of `src`, in bytes.
+ * @param dst First pixel of the destination rectangle, `factor` times the size of the source, must not overlap `src`.
+ * @param dstPitch Distance between rows of `dst`, in bytes.
+ * @param width Width of the source rectangle.
+ * @param height Height of the source rectangle.
+ * @param bytesPerPixel 1 or 4.
+ * @param factor Scaling factor, at least 1.
+ * @param kernel Implementation to use, must be supported.
+ */
+void UpscaleNearest(const uint8_t *src, size_t srcPitch, uint8_t *dst, size_t dstPitch, int width, int height, int bytesPerPixel, int factor, UpscaleKernel kernel);
+
+inline void UpscaleNearest(const uint8_t *src, size_t srcPitch, uint8_t *dst, size_t dstPitch, int width, int height, int bytesPerPixel, int factor)
+{
+	UpscaleNearest(src, srcPitch, dst, dstPitch, width, height, bytesPerPixel, factor, GetBestUpscaleKernel());
+}
+
+} // namespace devilution
@@ -42,6 +42,7 @@ set(devilutionx_fixtures
   hellfire/22-1191662129.dun
   hellfire/23-97055268.dun
   hellfire/24-1324803725.dun
+  items/rolls.txt
   Levels/L1Data/Banner1.DUN
   Levels/L1Data/Banner2.DUN
   Levels/L1Data/rnd6.DUN
@@ -62,6 +63,8 @@ set(devilutionx_fixtures
   Levels/L4Data/Vile1.DUN
   Levels/L4Data/Warlord.DUN
   Levels/L4Data/Warlord2.DUN
+  PlrGFX/Infra.TRN
+  PlrGFX/Stone.TRN
 )
 
 foreach(fixture ${devilutionx_fixtures})
@@ -0,0 +1,76 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "automap.h"
+#include "engine/surface.hpp"
+#include "init.h"
+#include "levels/gendung.h"
+#include "player.h"
+#include "utils/paths.h"
+#include "utils/ui_fwd.h"
+
+using namespace devilution;
+
+namespace {
+
+bool LoadLevel()
+{
+	if (diabdat_mpq)
+		return true;
+	for (const char *name : { "DIABDAT.MPQ", "diabdat.mpq" }) {
+		const std::string path = paths::BasePath() + name;
+		int32_t error = 0;
+		diabdat_mpq = MpqArchive::Open(path.c_str(), error);
+		if (!diabdat_mpq)
+			continue;
+
+		MyPlayer = &Players[0];
+		currlevel = 1;
+		leveltype = DTYPE_CATHEDRAL;
+		pMegaTiles = std::make_unique<MegaTile[]>(206);
+		CreateDungeon(2588, ENTRY_MAIN);
+		InitAutomapOnce();
+		InitAutomap();
+		return true;
+	}
+	return false;
+}
+
+/** @brief Draws the automap of a fully explored level, as each frame does while it is open. */
+void BM_DrawAutomap(benchmark::State &state)
+{
+	if (!LoadLevel()) {
+		state.SkipWithError("DIABDAT.MPQ not found");
+		return;
+	}
+	SetAutomapCacheEnabled(state.range(0) != 0);
+	memset(AutomapView, MAP_EXP_SELF, sizeof(AutomapView));
+	StartAutomap();
+	ViewPosition = { 56, 56 };
+	gnScreenWidth = 640;
+	gnScreenHeight = 480;
+
+	std::vector<uint8_t> pixels(640 * 352);
+	SDL_Surface surface {};
+	surface.w = 640;
+	surface.h = 352;
+	surface.pitch = 640;
+	surface.pixels = pixels.data();
+	const Surface out(&surface);
+
+	for (auto _ : state) {
+		DrawAutomap(out);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations());
+
+	SetAutomapCacheEnabled(true);
+}
+
+BENCHMARK(BM_DrawAutomap)->Arg(0)->Arg(1)->ArgName("cached");
+
+} // namespace
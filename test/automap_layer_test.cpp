@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+
+#include "engine/render/automap_layer.hpp"
+
+using namespace devilution;
+
+namespace {
+
+constexpr Size MapSize { 9, 8 };
+constexpr int TileWidth = 16;
+constexpr int RowHeight = 8;
+constexpr int HalfRowHeight = 4;
+constexpr int TileExtent = 12;
+
+uint8_t TileColors[MapSize.width + 1][MapSize.height + 1];
+
+/** @brief A cross wide enough to overlap the neighbouring tiles, so that the drawing order matters. */
+void DrawTestTile(const Surface &out, Point center, Point map)
+{
+	if (map.x < -1 || map.x >= MapSize.width || map.y < -1 || map.y >= MapSize.height)
+		return;
+	const uint8_t color = TileColors[map.x + 1][map.y + 1];
+	if (color == 0)
+		return;
+	for (int i = -TileExtent; i <= TileExtent; i++)
+		out.SetPixel({ center.x + i, center.y }, color);
+	for (int i = -RowHeight; i <= RowHeight; i++)
+		out.SetPixel({ center.x, center.y + i }, static_cast<uint8_t>(color + 1));
+}
+
+void SetTileColors(uint32_t seed)
+{
+	for (auto &column : TileColors) {
+		for (uint8_t &color : column) {
+			seed = seed * 1103515245 + 12345;
+			color = static_cast<uint8_t>((seed >> 16) % 4 == 0 ? 0 : (seed >> 8) % 200 + 1);
+		}
+	}
+}
+
+void ExpectSameLayer(const AutomapLayer &actual, const AutomapLayer &expected)
+{
+	const Surface &a = actual.GetSurface();
+	const Surface &b = expected.GetSurface();
+	ASSERT_EQ(a.w(), b.w());
+	ASSERT_EQ(a.h(), b.h());
+	for (int y = 0; y < a.h(); y++)
+		ASSERT_EQ(memcmp(a.at(0, y), b.at(0, y), a.w()), 0) << "row " << y;
+}
+
+} // namespace
+
+TEST(AutomapLayer, TileCenters)
+{
+	SetTileColors(1);
+	const AutomapLayer layer(MapSize, TileWidth, RowHeight, HalfRowHeight, TileExtent, 0, &DrawTestTile);
+	const Point origin = layer.GetTileCenter({ 0, 0 });
+	EXPECT_EQ(layer.GetTileCenter({ 1, -1 }) - origin, (Displacement { TileWidth, 0 }));
+	EXPECT_EQ(layer.GetTileCenter({ 0, 1 }) - origin, (Displacement { -RowHeight, HalfRowHeight }));
+	EXPECT_EQ(layer.GetTileCenter({ 1, 0 }) - origin, (Displacement { TileWidth - RowHeight, HalfRowHeight }));
+	EXPECT_EQ(layer.GetTileCenter({ 1, 1 }) - origin, (Displacement { 0, RowHeight }));
+	EXPECT_EQ(layer.GetTileCenter({ -1, -1 }) - origin, (Displacement { 0, -RowHeight }));
+
+	const Size layerSize = AutomapLayer::GetLayerSize(MapSize, TileWidth, RowHeight, HalfRowHeight, TileExtent);
+	EXPECT_EQ(layer.GetSurface().w(), layerSize.width);
+	EXPECT_EQ(layer.GetSurface().h(), layerSize.height);
+	for (int y = -1; y < MapSize.height; y++) {
+		for (int x = -1; x < MapSize.width; x++) {
+			const Point center = layer.GetTileCenter({ x, y });
+			EXPECT_GE(center.x - TileExtent, 0);
+			EXPECT_GE(center.y - TileExtent, 0);
+			EXPECT_LT(center.x + TileExtent, layerSize.width);
+			EXPECT_LT(center.y + TileExtent, layerSize.height);
+		}
+	}
+}
+
+TEST(AutomapLayer, RedrawTileMatchesFullRedraw)
+{
+	SetTileColors(2);
+	AutomapLayer layer(MapSize, TileWidth, RowHeight, HalfRowHeight, TileExtent, 0, &DrawTestTile);
+	for (uint32_t seed = 3; seed < 10; seed++) {
+		uint8_t previousColors[sizeof(TileColors)];
+		memcpy(previousColors, TileColors, sizeof(TileColors));
+		SetTileColors(seed);
+		for (int x = -1; x < MapSize.width; x++) {
+			for (int y = -1; y < MapSize.height; y++) {
+				if (TileColors[x + 1][y + 1] != previousColors[(x + 1) * (MapSize.height + 1) + y + 1])
+					layer.RedrawTile({ x, y });
+			}
+		}
+
+		const AutomapLayer expected(MapSize, TileWidth, RowHeight, HalfRowHeight, TileExtent, 0, &DrawTestTile);
+		ExpectSameLayer(layer, expected);
+	}
+}
+
+TEST(AutomapLayer, CompositeMatchesDirectDrawing)
+{
+	SetTileColors(11);
+	const AutomapLayer layer(MapSize, TileWidth, RowHeight, HalfRowHeight, TileExtent, 0, &DrawTestTile);
+	for (Displacement offset : { Displacement { 0, 0 }, Displacement { -37, 5 }, Displacement { 21, -13 }, Displacement { 90, 60 } }) {
+		OwnedSurface expected(Size { 120, 80 });
+		OwnedSurface actual(Size { 120, 80 });
+		for (int y = 0; y < expected.h(); y++) {
+			for (int x = 0; x < expected.w(); x++) {
+				expected[{ x, y }] = static_cast<uint8_t>(x ^ y);
+				actual[{ x, y }] = static_cast<uint8_t>(x ^ y);
+			}
+		}
+
+		for (int row = -2; row <= MapSize.width + MapSize.height - 2; row++) {
+			for (int x = -1; x < MapSize.width; x++) {
+				const int y = row - x;
+				if (y >= -1 && y < MapSize.height)
+					DrawTestTile(expected, layer.GetTileCenter({ x, y }) + offset, { x, y });
+			}
+		}
+		layer.Composite(actual, offset);
+
+		for (int y = 0; y < expected.h(); y++)
+			ASSERT_EQ(memcmp(actual.at(0, y), expected.at(0, y), actual.w()), 0) << "offset " << offset.deltaX << ", " << offset.deltaY << ", row " << y;
+	}
+}
+
+TEST(AutomapLayer, CompositeMatchesScreenLayout)
+{
+	SetTileColors(12);
+	// Same as `DrawAutomap` with uneven spacing, where the screen layout depends on the parity of the first row.
+	constexpr int Width = 35;
+	constexpr int Height = 17;
+	constexpr int HalfHeight = 8;
+	constexpr int Cells = 5;
+	for (int rowParity : { 0, 1 }) {
+		const AutomapLayer layer(MapSize, Width, Height, HalfHeight, TileExtent, rowParity, &DrawTestTile);
+		for (Point map : { Point { -Cells, -1 }, Point { -Cells + 1, 1 }, Point { -2, 0 }, Point { 1, -1 } }) {
+			if (((map.x + map.y) & 1) != rowParity)
+				continue;
+			const Point screen { 20, 10 };
+			OwnedSurface expected(Size { 160, 100 });
+			OwnedSurface actual(Size { 160, 100 });
+
+			Point rowStart = screen;
+			Point rowMap = map;
+			for (int i = 0; i <= Cells + 1; i++) {
+				for (int j = 0; j < Cells; j++)
+					DrawTestTile(expected, { rowStart.x + j * Width, rowStart.y }, { rowMap.x + j, rowMap.y - j });
+				rowMap.y++;
+				for (int j = 0; j <= Cells; j++)
+					DrawTestTile(expected, { rowStart.x - Height + j * Width, rowStart.y + HalfHeight }, { rowMap.x + j, rowMap.y - j });
+				rowMap.x++;
+				rowStart.y += Height;
+			}
+			layer.Composite(actual, screen - layer.GetTileCenter(map));
+
+			// Only compare the area that the loop above fully covers.
+			for (int y = screen.y + Height; y < screen.y + 5 * Height; y++)
+				ASSERT_EQ(memcmp(actual.at(screen.x, y), expected.at(screen.x, y), Width * (Cells - 1)), 0) << "parity " << rowParity << ", row " << y;
+		}
+	}
+}
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+
+#include "utils/bitset2d.hpp"
+
+using namespace devilution;
+
+namespace {
+
+TEST(Bitset2dTest, SetAndReset)
+{
+	Bitset2d<40, 40> bits;
+	EXPECT_EQ(bits.count(), 0);
+	bits.set(0, 0);
+	bits.set(39, 39);
+	bits.set(5, 7, false);
+	EXPECT_TRUE(bits.test(0, 0));
+	EXPECT_TRUE(bits.test(39, 39));
+	EXPECT_FALSE(bits.test(5, 7));
+	EXPECT_EQ(bits.count(), 2);
+
+	bits.reset(0, 0);
+	EXPECT_FALSE(bits.test(0, 0));
+	bits.reset();
+	EXPECT_EQ(bits.count(), 0);
+}
+
+TEST(Bitset2dTest, Rectangle)
+{
+	Bitset2d<40, 40> bits;
+	bits.set(10, 20, 6, 3);
+	EXPECT_EQ(bits.count(), 18);
+	EXPECT_TRUE(bits.test(10, 20));
+	EXPECT_TRUE(bits.test(15, 22));
+	EXPECT_FALSE(bits.test(16, 22));
+	EXPECT_FALSE(bits.test(15, 23));
+
+	EXPECT_TRUE(bits.any(15, 22, 1, 1));
+	EXPECT_TRUE(bits.any(0, 0, 11, 21));
+	EXPECT_FALSE(bits.any(0, 0, 10, 40));
+	EXPECT_FALSE(bits.any(16, 0, 24, 40));
+	EXPECT_FALSE(bits.any(10, 23, 6, 17));
+	EXPECT_FALSE(bits.any(10, 20, 0, 3));
+}
+
+TEST(Bitset2dTest, RectangleAcrossWords)
+{
+	Bitset2d<112, 3> bits;
+	bits.set(60, 1, 52, 2);
+	EXPECT_EQ(bits.count(), 104);
+	EXPECT_TRUE(bits.test(63, 1));
+	EXPECT_TRUE(bits.test(64, 1));
+	EXPECT_TRUE(bits.test(111, 2));
+	EXPECT_FALSE(bits.test(59, 1));
+
+	EXPECT_FALSE(bits.any(0, 0, 112, 1));
+	EXPECT_FALSE(bits.any(0, 1, 60, 2));
+	EXPECT_TRUE(bits.any(0, 1, 61, 1));
+	EXPECT_TRUE(bits.any(100, 0, 12, 2));
+
+	bits.reset(64, 1);
+	EXPECT_FALSE(bits.test(64, 1));
+	EXPECT_TRUE(bits.any(64, 1, 1, 2));
+	EXPECT_FALSE(bits.any(64, 1, 1, 1));
+}
+
+} // namespace
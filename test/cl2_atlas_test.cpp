@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "engine/render/cl2_atlas.hpp"
+#include "engine/render/cl2_render.hpp"
+#include "sprite_test.hpp"
+
+using namespace devilution;
+
+namespace {
+
+constexpr int SpriteWidth = 40;
+constexpr int SpriteHeight = 30;
+
+std::vector<byte> MakeSprite()
+{
+	std::vector<TestImage> images;
+	for (uint32_t seed : { 3, 17, 42 })
+		images.push_back(MakeTestImage(SpriteWidth, SpriteHeight, seed));
+	return EncodeCl2Sprite(images, SpriteWidth, SpriteHeight);
+}
+
+template <typename Draw>
+std::vector<std::vector<uint8_t>> DrawAtEveryPosition(const Draw &draw)
+{
+	std::vector<std::vector<uint8_t>> results;
+	for (int y = -4; y < 48 + SpriteHeight + 4; y += 3) {
+		for (int x = -SpriteWidth - 3; x < 64 + 3; x += 5) {
+			TestSurface out;
+			draw(out.Region(), x, y);
+			results.push_back(out.pixels);
+		}
+	}
+	return results;
+}
+
+} // namespace
+
+TEST(Cl2Atlas, DecodesEveryFrame)
+{
+	const std::vector<byte> sprite = MakeSprite();
+	const Cl2Atlas atlas { CelSprite(sprite.data(), SpriteWidth) };
+
+	ASSERT_EQ(atlas.NumFrames(), 3);
+	EXPECT_EQ(atlas.SourceSize(), sprite.size());
+	for (int frame = 0; frame < atlas.NumFrames(); frame++) {
+		const Cl2Atlas::Frame &decoded = atlas.GetFrame(frame);
+		EXPECT_EQ(decoded.width, SpriteWidth);
+		EXPECT_LE(decoded.height, SpriteHeight);
+	}
+}
+
+TEST(Cl2Atlas, RunsMatchImage)
+{
+	const TestImage image = MakeTestImage(SpriteWidth, SpriteHeight, 5);
+	const std::vector<byte> sprite = EncodeCl2Sprite({ image }, SpriteWidth, SpriteHeight);
+	const Cl2Atlas atlas { CelSprite(sprite.data(), SpriteWidth) };
+
+	const Cl2Atlas::Frame &frame = atlas.GetFrame(0);
+	TestImage decoded(SpriteWidth * SpriteHeight, -1);
+	for (int row = 0; row < frame.height; row++) {
+		const int y = SpriteHeight - 1 - row;
+		for (const Cl2Atlas::Run *run = atlas.RowBegin(frame, row); run != atlas.RowEnd(frame, row); ++run) {
+			for (int i = 0; i < run->width; i++)
+				decoded[y * SpriteWidth + run->x + i] = run->IsFill() ? run->FillColor() : atlas.Pixels()[run->data + i];
+		}
+	}
+	EXPECT_EQ(decoded, image);
+}
+
+TEST(Cl2Atlas, DrawMatchesCl2)
+{
+	const std::vector<byte> sprite = MakeSprite();
+	const CelSprite cel(sprite.data(), SpriteWidth);
+	const auto draw = [&](const Surface &out, int x, int y) {
+		for (int frame = 0; frame < 3; frame++)
+			Cl2Draw(out, x + frame, y - frame, cel, frame);
+	};
+
+	const auto expected = DrawAtEveryPosition(draw);
+	RegisterCl2Atlas(cel);
+	ASSERT_NE(FindCl2Atlas(sprite.data()), nullptr);
+	const auto actual = DrawAtEveryPosition(draw);
+	UnregisterCl2Atlas(sprite.data());
+	EXPECT_EQ(FindCl2Atlas(sprite.data()), nullptr);
+
+	ASSERT_EQ(actual.size(), expected.size());
+	for (size_t i = 0; i < expected.size(); i++)
+		EXPECT_EQ(actual[i], expected[i]) << "at position " << i;
+}
+
+TEST(Cl2Atlas, DrawTRNMatchesCl2)
+{
+	const std::vector<byte> sprite = MakeSprite();
+	const CelSprite cel(sprite.data(), SpriteWidth);
+	std::array<uint8_t, 256> trn;
+	for (int i = 0; i < 256; i++)
+		trn[i] = static_cast<uint8_t>(255 - i);
+	const auto draw = [&](const Surface &out, int x, int y) {
+		Cl2DrawTRN(out, x, y, cel, 1, trn.data());
+	};
+
+	const auto expected = DrawAtEveryPosition(draw);
+	RegisterCl2Atlas(cel);
+	const auto actual = DrawAtEveryPosition(draw);
+	UnregisterCl2Atlas(sprite.data());
+
+	EXPECT_EQ(actual, expected);
+}
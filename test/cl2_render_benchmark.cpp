@@ -0,0 +1,61 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+#include "engine/render/cl2_atlas.hpp"
+#include "engine/render/cl2_render.hpp"
+#include "engine/surface.hpp"
+#include "sprite_test.hpp"
+
+using namespace devilution;
+
+namespace {
+
+/** @brief Draws a 96x96 sprite, as used by monsters and players, on a 640x352 viewport. */
+void BM_Cl2Draw(benchmark::State &state)
+{
+	const bool predecoded = state.range(0) != 0;
+	const int x = static_cast<int>(state.range(1));
+	const int y = static_cast<int>(state.range(2));
+
+	constexpr int Width = 96;
+	constexpr int Height = 96;
+	const std::vector<byte> sprite = EncodeCl2Sprite({ MakeTestImage(Width, Height, 7) }, Width, Height);
+	const CelSprite cel(sprite.data(), Width);
+	if (predecoded)
+		RegisterCl2Atlas(cel);
+
+	std::vector<uint8_t> pixels(640 * 352);
+	SDL_Surface surface {};
+	surface.w = 640;
+	surface.h = 352;
+	surface.pitch = 640;
+	surface.pixels = pixels.data();
+	const Surface out(&surface);
+
+	for (auto _ : state) {
+		Cl2Draw(out, x, y, cel, 0);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * Width * Height);
+
+	if (predecoded)
+		UnregisterCl2Atlas(sprite.data());
+}
+
+void Cl2DrawArguments(benchmark::internal::Benchmark *benchmark)
+{
+	// Unclipped, clipped at the bottom left and clipped at the top right.
+	for (int predecoded : { 0, 1 }) {
+		benchmark->Args({ predecoded, 200, 200 });
+		benchmark->Args({ predecoded, -40, 400 });
+		benchmark->Args({ predecoded, 600, 40 });
+	}
+	benchmark->ArgNames({ "predecoded", "x", "y" });
+}
+
+BENCHMARK(BM_Cl2Draw)->Apply(Cl2DrawArguments);
+
+} // namespace
@@ -0,0 +1,50 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "encrypt.h"
+#include "msg_test.hpp"
+
+using namespace devilution;
+
+namespace {
+
+/**
+ * @brief Compresses the delta of a cleared level, as it is sent to each player joining the game.
+ */
+void BM_Compress(benchmark::State &state)
+{
+	const auto type = static_cast<CompressionType>(state.range(0));
+	const std::vector<byte> payload = MakeLevelDelta(1);
+	const auto size = static_cast<uint32_t>(payload.size());
+	std::vector<byte> buffer;
+	uint32_t compressedSize = 0;
+	for (auto _ : state) {
+		buffer = payload;
+		compressedSize = CompressBuffer(type, buffer.data(), size);
+		benchmark::DoNotOptimize(compressedSize);
+	}
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * size);
+	state.counters["ratio"] = static_cast<double>(compressedSize) / size;
+}
+
+void BM_Decompress(benchmark::State &state)
+{
+	const auto type = static_cast<CompressionType>(state.range(0));
+	std::vector<byte> compressed = MakeLevelDelta(1);
+	const auto size = static_cast<uint32_t>(compressed.size());
+	const uint32_t compressedSize = CompressBuffer(type, compressed.data(), size);
+	compressed.resize(compressedSize);
+	std::vector<byte> buffer(size);
+	for (auto _ : state) {
+		std::copy(compressed.begin(), compressed.end(), buffer.begin());
+		benchmark::DoNotOptimize(DecompressBuffer(type, buffer.data(), compressedSize, size));
+	}
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * size);
+}
+
+BENCHMARK(BM_Compress)->Arg(static_cast<int>(CompressionType::Implode))->Arg(static_cast<int>(CompressionType::Lz4))->Arg(static_cast<int>(CompressionType::Zlib));
+BENCHMARK(BM_Decompress)->Arg(static_cast<int>(CompressionType::Implode))->Arg(static_cast<int>(CompressionType::Lz4))->Arg(static_cast<int>(CompressionType::Zlib));
+
+} // namespace
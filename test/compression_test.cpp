@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "encrypt.h"
+#include "msg_test.hpp"
+#include "utils/lz4.hpp"
+
+using namespace devilution;
+
+namespace {
+
+std::vector<byte> MakeRandomPayload(size_t size)
+{
+	std::vector<byte> data(size);
+	uint32_t seed = 7;
+	for (auto &value : data) {
+		seed = seed * 1103515245 + 12345;
+		value = static_cast<byte>(seed >> 16);
+	}
+	return data;
+}
+
+void ExpectRoundTrip(CompressionType type, const std::vector<byte> &original)
+{
+	std::vector<byte> buffer = original;
+	const auto size = static_cast<uint32_t>(buffer.size());
+	const uint32_t compressedSize = CompressBuffer(type, buffer.data(), size);
+	ASSERT_LE(compressedSize, size);
+	if (compressedSize == size) {
+		EXPECT_EQ(buffer, original);
+		return;
+	}
+
+	const std::optional<uint32_t> decompressedSize = DecompressBuffer(type, buffer.data(), compressedSize, size);
+	ASSERT_TRUE(decompressedSize);
+	EXPECT_EQ(*decompressedSize, size);
+	EXPECT_EQ(buffer, original);
+}
+
+} // namespace
+
+TEST(Compression, RoundTripDeltaPayload)
+{
+	const std::vector<byte> payload = MakeLevelDelta(1);
+	for (CompressionType type : { CompressionType::None, CompressionType::Implode, CompressionType::Lz4, CompressionType::Zlib }) {
+		SCOPED_TRACE(static_cast<int>(type));
+		ExpectRoundTrip(type, payload);
+	}
+}
+
+TEST(Compression, RoundTripRandomPayload)
+{
+	const std::vector<byte> payload = MakeRandomPayload(5000);
+	for (CompressionType type : { CompressionType::Implode, CompressionType::Lz4, CompressionType::Zlib }) {
+		SCOPED_TRACE(static_cast<int>(type));
+		ExpectRoundTrip(type, payload);
+	}
+}
+
+TEST(Compression, CompressesDeltaPayload)
+{
+	// The records of the dead monsters and dropped items keep a real delta from shrinking as much as the empty slots would.
+	std::vector<byte> payload = MakeLevelDelta(2);
+	EXPECT_LT(CompressBuffer(CompressionType::Lz4, payload.data(), static_cast<uint32_t>(payload.size())), payload.size() * 2 / 3);
+}
+
+TEST(Compression, RejectsUnknownType)
+{
+	std::vector<byte> payload = MakeLevelDelta(3);
+	const auto size = static_cast<uint32_t>(payload.size());
+	EXPECT_FALSE(DecompressBuffer(static_cast<CompressionType>(42), payload.data(), size, size));
+}
+
+TEST(Compression, RejectsOversizedRawData)
+{
+	std::vector<byte> payload(100);
+	EXPECT_FALSE(DecompressBuffer(CompressionType::None, payload.data(), 100, 50));
+}
+
+TEST(Lz4, Empty)
+{
+	const byte original[1] {};
+	byte compressed[Lz4CompressBound(0)];
+	const size_t compressedSize = Lz4Compress(original, 0, compressed, sizeof(compressed));
+	ASSERT_EQ(compressedSize, 1);
+
+	byte decompressed[1];
+	EXPECT_EQ(Lz4Decompress(compressed, compressedSize, decompressed, sizeof(decompressed)), 0);
+}
+
+TEST(Lz4, ShortInput)
+{
+	const std::vector<byte> original { byte { 1 }, byte { 2 }, byte { 1 }, byte { 2 }, byte { 1 } };
+	byte compressed[Lz4CompressBound(5)];
+	const size_t compressedSize = Lz4Compress(original.data(), original.size(), compressed, sizeof(compressed));
+	ASSERT_EQ(compressedSize, original.size() + 1);
+
+	std::vector<byte> decompressed(original.size());
+	EXPECT_EQ(Lz4Decompress(compressed, compressedSize, decompressed.data(), decompressed.size()), original.size());
+	EXPECT_EQ(decompressed, original);
+}
+
+TEST(Lz4, LongRun)
+{
+	const std::vector<byte> original(100000, byte { 0xAB });
+	std::vector<byte> compressed(Lz4CompressBound(original.size()));
+	const size_t compressedSize = Lz4Compress(original.data(), original.size(), compressed.data(), compressed.size());
+	ASSERT_NE(compressedSize, 0);
+	EXPECT_LT(compressedSize, 1000);
+
+	std::vector<byte> decompressed(original.size());
+	EXPECT_EQ(Lz4Decompress(compressed.data(), compressedSize, decompressed.data(), decompressed.size()), original.size());
+	EXPECT_EQ(decompressed, original);
+}
+
+TEST(Lz4, IncompressibleFitsBound)
+{
+	const std::vector<byte> original = MakeRandomPayload(70000);
+	std::vector<byte> compressed(Lz4CompressBound(original.size()));
+	const size_t compressedSize = Lz4Compress(original.data(), original.size(), compressed.data(), compressed.size());
+	ASSERT_NE(compressedSize, 0);
+
+	std::vector<byte> decompressed(original.size());
+	EXPECT_EQ(Lz4Decompress(compressed.data(), compressedSize, decompressed.data(), decompressed.size()), original.size());
+	EXPECT_EQ(decompressed, original);
+}
+
+TEST(Lz4, OutputTooSmall)
+{
+	const std::vector<byte> original = MakeRandomPayload(1000);
+	std::vector<byte> compressed(500);
+	EXPECT_EQ(Lz4Compress(original.data(), original.size(), compressed.data(), compressed.size()), 0);
+}
+
+TEST(Lz4, RejectsMalformedInput)
+{
+	const std::vector<byte> original = MakeLevelDelta(4);
+	std::vector<byte> compressed(Lz4CompressBound(original.size()));
+	const size_t compressedSize = Lz4Compress(original.data(), original.size(), compressed.data(), compressed.size());
+	std::vector<byte> decompressed(original.size());
+
+	// Truncated input.
+	EXPECT_FALSE(Lz4Decompress(compressed.data(), compressedSize - 3, decompressed.data(), decompressed.size()));
+	// Output buffer too small.
+	EXPECT_FALSE(Lz4Decompress(compressed.data(), compressedSize, decompressed.data(), decompressed.size() - 1));
+
+	// Match offset pointing before the start of the output.
+	const byte badOffset[] { byte { 0x10 }, byte { 0x55 }, byte { 0x10 }, byte { 0x00 }, byte { 0x00 } };
+	EXPECT_FALSE(Lz4Decompress(badOffset, sizeof(badOffset), decompressed.data(), decompressed.size()));
+	// Literal length beyond the end of the input.
+	const byte badLiterals[] { byte { 0xF0 }, byte { 0xFF }, byte { 0x01 } };
+	EXPECT_FALSE(Lz4Decompress(badLiterals, sizeof(badLiterals), decompressed.data(), decompressed.size()));
+}
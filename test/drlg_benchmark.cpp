@@ -0,0 +1,59 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <memory>
+
+#include "diablo.h"
+#include "engine/random.hpp"
+#include "levels/gendung.h"
+#include "utils/paths.h"
+
+using namespace devilution;
+
+namespace {
+
+/**
+ * @brief Generates the dungeons of consecutive seeds for the first level of a dungeon type, counting the layouts started.
+ *
+ * With several threads each one generates its own seeds with its own RNG context into its own level state, which needs
+ * a build with BUILD_DRLG_FARM, see gendung.h.
+ */
+void BM_CreateDungeon(benchmark::State &state)
+{
+#ifndef BUILD_DRLG_FARM
+	if (state.threads() > 1) {
+		state.SkipWithError("The level state is shared, generating on several threads needs BUILD_DRLG_FARM");
+		return;
+	}
+#endif
+	if (state.thread_index() == 0) {
+		paths::SetPrefPath(paths::BasePath());
+		paths::SetAssetsPath(paths::BasePath() + "/test/fixtures/");
+		gbIsHellfire = state.range(0) > 16;
+		// The layouts don't depend on the tiles, so every dungeon type shares blank ones.
+		pMegaTiles = std::make_unique<MegaTile[]>(256);
+	}
+	RandomContext random;
+	RandomContextScope randomScope { random };
+	currlevel = static_cast<uint8_t>(state.range(0));
+	leveltype = GetLevelType(currlevel);
+
+	uint32_t seed = static_cast<uint32_t>(state.thread_index()) << 24;
+	int64_t attempts = 0;
+	for (auto _ : state) {
+		CreateDungeon(seed++, ENTRY_MAIN);
+		attempts += LevelLayoutAttempts;
+	}
+	state.SetItemsProcessed(state.iterations());
+	state.counters["attempts"] = benchmark::Counter(static_cast<double>(attempts), benchmark::Counter::kAvgIterations);
+
+	if (state.thread_index() == 0)
+		gbIsHellfire = false;
+}
+
+// The cathedral, catacombs, caves, hell, nest and crypt.
+BENCHMARK(BM_CreateDungeon)->Arg(1)->Arg(5)->Arg(9)->Arg(13)->Arg(17)->Arg(21)->ArgName("level")->Unit(benchmark::kMillisecond);
+// The catacombs on several threads at once, the dungeons per second should grow with the threads.
+BENCHMARK(BM_CreateDungeon)->Arg(5)->ArgName("level")->Threads(2)->Threads(4)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+} // namespace
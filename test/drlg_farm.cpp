@@ -0,0 +1,397 @@
+/**
+ * @file drlg_farm.cpp
+ *
+ * Generates the dungeons of many seeds on all cores, to validate the level generators and find slow seeds.
+ *
+ * Needs a build with BUILD_DRLG_FARM, where each worker thread generates into its own level state, see gendung.h. Each
+ * dungeon gets the quests of a single player game with its seed, so that the quest set pieces are generated too. The
+ * layout checksum covers every dungeon generated, so runs with different thread counts have to report the same one.
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "diablo.h"
+#include "engine/random.hpp"
+#include "levels/gendung.h"
+#include "quests.h"
+#include "utils/paths.h"
+#include "utils/stdcompat/string_view.hpp"
+
+using namespace devilution;
+
+namespace {
+
+/** @brief Number of dungeons a worker thread claims at a time. */
+constexpr uint32_t JobsPerChunk = 64;
+
+struct FarmOptions {
+	unsigned threads = 0;
+	uint32_t seeds = 10000;
+	uint32_t firstSeed = 0;
+	int firstLevel = 1;
+	int lastLevel = 16;
+	/** @brief Dungeons that start their layout over this many times more than the median of their type are reported as pathological. */
+	int outlierFactor = 10;
+	/** @brief Number of the slowest dungeons to report. */
+	unsigned slowest = 10;
+	std::string assetsPath;
+};
+
+struct FarmJob {
+	uint8_t level;
+	lvl_entry entry;
+};
+
+struct DungeonRecord {
+	uint32_t seed;
+	FarmJob job;
+	uint32_t microseconds;
+	int attempts;
+};
+
+/** @brief What a worker thread recorded, merged once all threads are done. */
+struct WorkerResults {
+	/** @brief Every dungeon generated, by dungeon type. */
+	std::vector<DungeonRecord> dungeons[DTYPE_LAST + 1];
+	std::vector<DungeonRecord> slowest;
+	std::vector<DungeonRecord> invalid;
+	uint64_t checksum = 0;
+};
+
+struct FarmState {
+	explicit FarmState(const FarmOptions &options)
+	    : options(options)
+	{
+	}
+
+	const FarmOptions &options;
+	std::vector<FarmJob> jobs;
+	uint64_t jobCount = 0;
+	std::atomic<uint64_t> nextJob { 0 };
+	std::vector<WorkerResults> results;
+};
+
+const char *DungeonTypeName(dungeon_type type)
+{
+	switch (type) {
+	case DTYPE_CATHEDRAL:
+		return "cathedral";
+	case DTYPE_CATACOMBS:
+		return "catacombs";
+	case DTYPE_CAVES:
+		return "caves";
+	case DTYPE_HELL:
+		return "hell";
+	case DTYPE_NEST:
+		return "nest";
+	case DTYPE_CRYPT:
+		return "crypt";
+	default:
+		return "town";
+	}
+}
+
+const char *EntryName(lvl_entry entry)
+{
+	switch (entry) {
+	case ENTRY_MAIN:
+		return "main";
+	case ENTRY_PREV:
+		return "prev";
+	default:
+		return "twarpdn";
+	}
+}
+
+void PrintHelpOption(string_view flags, string_view description)
+{
+	std::cout << fmt::format("    {:<30}{}", flags, description) << std::endl;
+}
+
+void PrintHelp()
+{
+	std::cout << "Options:" << std::endl;
+	PrintHelpOption("-h, --help", "Print this message and exit");
+	PrintHelpOption("--threads <#>", "Number of worker threads (default one per core)");
+	PrintHelpOption("--seeds <#>", "Seeds to generate for each level and entry (default 10000)");
+	PrintHelpOption("--first-seed <#>", "First seed to generate (default 0)");
+	PrintHelpOption("--levels <#>-<#>", "Levels to generate, 17-24 for Hellfire (default 1-16)");
+	PrintHelpOption("--outlier <#>", "Report dungeons starting over # times more than the median (default 10)");
+	PrintHelpOption("--slowest <#>", "Number of the slowest dungeons to report (default 10)");
+	PrintHelpOption("--assets <path>", "Directory with the quest DUN files (default test/fixtures/)");
+}
+
+bool ParseFlags(int argc, char **argv, FarmOptions &options)
+{
+	for (int i = 1; i < argc; i++) {
+		const string_view arg = argv[i];
+		if (arg == "-h" || arg == "--help") {
+			PrintHelp();
+			return false;
+		}
+		if (arg != "--threads" && arg != "--seeds" && arg != "--first-seed" && arg != "--levels" && arg != "--outlier" && arg != "--slowest" && arg != "--assets") {
+			std::cout << "unrecognized option '" << arg << "'" << std::endl;
+			PrintHelp();
+			return false;
+		}
+		if (i + 1 == argc) {
+			std::cout << arg << " requires an argument" << std::endl;
+			return false;
+		}
+		const char *value = argv[++i];
+		if (arg == "--threads") {
+			options.threads = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+		} else if (arg == "--seeds") {
+			options.seeds = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+		} else if (arg == "--first-seed") {
+			options.firstSeed = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+		} else if (arg == "--levels") {
+			char *end;
+			options.firstLevel = static_cast<int>(std::strtol(value, &end, 10));
+			options.lastLevel = *end == '-' ? static_cast<int>(std::strtol(end + 1, nullptr, 10)) : options.firstLevel;
+		} else if (arg == "--outlier") {
+			options.outlierFactor = std::atoi(value);
+		} else if (arg == "--slowest") {
+			options.slowest = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+		} else {
+			options.assetsPath = value;
+		}
+	}
+	if (options.firstLevel < 1 || options.lastLevel > 24 || options.firstLevel > options.lastLevel) {
+		std::cout << "invalid level range" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+std::vector<FarmJob> GetJobs(const FarmOptions &options)
+{
+	std::vector<FarmJob> jobs;
+	for (int level = options.firstLevel; level <= options.lastLevel; level++) {
+		jobs.push_back({ static_cast<uint8_t>(level), ENTRY_MAIN });
+		// Nothing leads up to the last level of Hell and of the crypt, it has no start position for this entry.
+		if (!IsAnyOf(level, 16, 24))
+			jobs.push_back({ static_cast<uint8_t>(level), ENTRY_PREV });
+		// The first level of each dungeon type below the cathedral has a town portal.
+		if (IsAnyOf(level, 5, 9, 13, 17, 21))
+			jobs.push_back({ static_cast<uint8_t>(level), ENTRY_TWARPDN });
+	}
+	return jobs;
+}
+
+uint64_t HashLayout(uint64_t hash, const void *data, size_t size)
+{
+	const auto *bytes = static_cast<const uint8_t *>(data);
+	for (size_t i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= 1099511628211U;
+	}
+	return hash;
+}
+
+/**
+ * @brief Checks what every dungeon needs to be playable: tiles everywhere and a start position on the map.
+ */
+bool IsValidLayout()
+{
+	for (int x = 0; x < DMAXX; x++) {
+		for (int y = 0; y < DMAXY; y++) {
+			if (dungeon[x][y] == 0)
+				return false;
+		}
+	}
+	return ViewPosition.x >= dminPosition.x && ViewPosition.x < dmaxPosition.x
+	    && ViewPosition.y >= dminPosition.y && ViewPosition.y < dmaxPosition.y;
+}
+
+void KeepSlowest(std::vector<DungeonRecord> &slowest, const DungeonRecord &record, size_t count)
+{
+	if (slowest.size() == count && (count == 0 || slowest.back().microseconds >= record.microseconds))
+		return;
+	auto position = std::upper_bound(slowest.begin(), slowest.end(), record, [](const DungeonRecord &a, const DungeonRecord &b) {
+		return a.microseconds > b.microseconds;
+	});
+	slowest.insert(position, record);
+	if (slowest.size() > count)
+		slowest.pop_back();
+}
+
+/**
+ * @brief Sets up the quests of the calling thread like InitQuests does for a single player game with randomized quests.
+ */
+void InitQuestsForSeed(uint32_t seed)
+{
+	for (int q = 0; q < MAXQUESTS; q++) {
+		const QuestData &questData = QuestsData[q];
+		Quest &quest = Quests[q];
+		quest = {};
+		quest._qidx = static_cast<quest_id>(q);
+		quest._qactive = QUEST_INIT;
+		quest._qlevel = questData._qdlvl;
+		quest._qlvltype = questData._qlvlt;
+		quest._qslvl = questData._qslvl;
+		quest._qmsg = questData._qdmsg;
+	}
+	InitialiseQuestPools(seed, Quests);
+}
+
+void GenerateDungeons(FarmState &state, WorkerResults &results)
+{
+	const FarmOptions &options = state.options;
+	// Without a context of its own the thread would roll in the game's global one.
+	RandomContext random;
+	RandomContextScope randomScope { random };
+	while (true) {
+		const uint64_t first = state.nextJob.fetch_add(JobsPerChunk);
+		if (first >= state.jobCount)
+			break;
+		const uint64_t last = std::min<uint64_t>(first + JobsPerChunk, state.jobCount);
+		for (uint64_t index = first; index < last; index++) {
+			// Seeds vary fastest so that the levels of each chunk are the same.
+			const FarmJob &job = state.jobs[index / options.seeds];
+			const auto seed = static_cast<uint32_t>(options.firstSeed + index % options.seeds);
+
+			InitQuestsForSeed(seed);
+			currlevel = job.level;
+			leveltype = GetLevelType(job.level);
+			const auto begin = std::chrono::steady_clock::now();
+			CreateDungeon(seed, job.entry);
+			const auto elapsed = std::chrono::steady_clock::now() - begin;
+
+			const DungeonRecord record {
+				seed,
+				job,
+				static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()),
+				LevelLayoutAttempts,
+			};
+			results.dungeons[leveltype].push_back(record);
+			KeepSlowest(results.slowest, record, options.slowest);
+			if (!IsValidLayout())
+				results.invalid.push_back(record);
+
+			uint64_t hash = HashLayout(14695981039346656037U, &index, sizeof(index));
+			hash = HashLayout(hash, dungeon, sizeof(dungeon));
+			hash = HashLayout(hash, dTransVal, sizeof(dTransVal));
+			hash = HashLayout(hash, &ViewPosition, sizeof(ViewPosition));
+			// Added up, so that the checksum doesn't depend on which thread generated which dungeon.
+			results.checksum += hash;
+		}
+	}
+}
+
+template <typename T>
+T Percentile(const std::vector<T> &sorted, unsigned permille)
+{
+	return sorted[std::min<size_t>(sorted.size() * permille / 1000, sorted.size() - 1)];
+}
+
+void PrintRecord(const DungeonRecord &record)
+{
+	std::cout << fmt::format("  level {:>2} {:<7} seed {:>10}: {:>7}us, {} attempts", record.job.level, EntryName(record.job.entry), record.seed, record.microseconds, record.attempts) << std::endl;
+}
+
+int FarmMain(int argc, char **argv)
+{
+	gbQuietMode = true;
+
+	FarmOptions options;
+	if (!ParseFlags(argc, argv, options))
+		return 1;
+
+	paths::SetPrefPath(paths::BasePath());
+	paths::SetAssetsPath(options.assetsPath.empty() ? paths::BasePath() + "/test/fixtures/" : options.assetsPath);
+	gbIsHellfire = options.lastLevel > 16;
+
+	// The layouts don't depend on the tiles, so every dungeon type shares blank ones.
+	pMegaTiles = std::make_unique<MegaTile[]>(256);
+
+	FarmState state { options };
+	state.jobs = GetJobs(options);
+	state.jobCount = static_cast<uint64_t>(state.jobs.size()) * options.seeds;
+	const unsigned threadCount = options.threads != 0 ? options.threads : std::max(std::thread::hardware_concurrency(), 1U);
+	state.results.resize(threadCount);
+
+	std::cout << fmt::format("Generating {} dungeons of levels {}-{} on {} threads", state.jobCount, options.firstLevel, options.lastLevel, threadCount) << std::endl;
+	const auto begin = std::chrono::steady_clock::now();
+	{
+		std::vector<std::thread> threads;
+		for (unsigned i = 0; i < threadCount; i++)
+			threads.emplace_back(GenerateDungeons, std::ref(state), std::ref(state.results[i]));
+		for (std::thread &thread : threads)
+			thread.join();
+	}
+	const auto elapsedMs = std::max<int64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin).count(), 1);
+
+	WorkerResults total;
+	for (WorkerResults &results : state.results) {
+		for (int type = 0; type <= DTYPE_LAST; type++)
+			total.dungeons[type].insert(total.dungeons[type].end(), results.dungeons[type].begin(), results.dungeons[type].end());
+		for (const DungeonRecord &record : results.slowest)
+			KeepSlowest(total.slowest, record, options.slowest);
+		total.invalid.insert(total.invalid.end(), results.invalid.begin(), results.invalid.end());
+		total.checksum += results.checksum;
+	}
+
+	std::cout << fmt::format("{} ms, {} dungeons/s, layout checksum {:016x}", elapsedMs, state.jobCount * 1000 / elapsedMs, total.checksum) << std::endl;
+	std::cout << fmt::format("{:<10} {:>9} {:>8} {:>8} {:>8} {:>8} {:>8} {:>8} {:>8} {:>8}", "type", "dungeons", "p50 us", "p90 us", "p99 us", "p99.9 us", "max us", "p50 att.", "p99 att.", "max att.") << std::endl;
+	std::vector<DungeonRecord> pathological;
+	for (int type = 0; type <= DTYPE_LAST; type++) {
+		const std::vector<DungeonRecord> &dungeons = total.dungeons[type];
+		if (dungeons.empty())
+			continue;
+		std::vector<uint32_t> times;
+		std::vector<int> attempts;
+		for (const DungeonRecord &record : dungeons) {
+			times.push_back(record.microseconds);
+			attempts.push_back(record.attempts);
+		}
+		std::sort(times.begin(), times.end());
+		std::sort(attempts.begin(), attempts.end());
+		std::cout << fmt::format("{:<10} {:>9} {:>8} {:>8} {:>8} {:>8} {:>8} {:>8} {:>8} {:>8}",
+		    DungeonTypeName(static_cast<dungeon_type>(type)), dungeons.size(), Percentile(times, 500), Percentile(times, 900),
+		    Percentile(times, 990), Percentile(times, 999), times.back(), Percentile(attempts, 500), Percentile(attempts, 990), attempts.back())
+		          << std::endl;
+
+		// Each generator starts over at its own rate, so the outliers are relative to the dungeons of the same type.
+		const int64_t maxAttempts = static_cast<int64_t>(std::max(Percentile(attempts, 500), 1)) * options.outlierFactor;
+		for (const DungeonRecord &record : dungeons) {
+			if (record.attempts > maxAttempts)
+				pathological.push_back(record);
+		}
+	}
+
+	std::cout << "Slowest dungeons:" << std::endl;
+	for (const DungeonRecord &record : total.slowest)
+		PrintRecord(record);
+
+	std::sort(pathological.begin(), pathological.end(), [](const DungeonRecord &a, const DungeonRecord &b) { return a.attempts > b.attempts; });
+	std::cout << fmt::format("{} dungeons started over more than {} times the median of their type", pathological.size(), options.outlierFactor) << std::endl;
+	for (size_t i = 0; i < std::min<size_t>(pathological.size(), options.slowest); i++)
+		PrintRecord(pathological[i]);
+
+	if (!total.invalid.empty()) {
+		std::cout << fmt::format("{} dungeons are invalid", total.invalid.size()) << std::endl;
+		for (size_t i = 0; i < std::min<size_t>(total.invalid.size(), options.slowest); i++)
+			PrintRecord(total.invalid[i]);
+		return 1;
+	}
+	return 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	return FarmMain(argc, argv);
+}
@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 
+#include <thread>
+
 #include "drlg_test.hpp"
+#include "engine/random.hpp"
 #include "player.h"
 #include "quests.h"
 
@@ -20,6 +23,28 @@ TEST(Drlg_l1, CreateL5Dungeon_diablo_1_2588)
 	EXPECT_EQ(ViewPosition, Point(49, 49));
 }
 
+#ifdef BUILD_DRLG_FARM
+TEST(Drlg_l1, CreateL5Dungeon_diablo_1_2588_on_another_thread)
+{
+	LoadExpectedLevelData("diablo/1-2588.dun");
+
+	MyPlayer->pOriginalCathedral = true;
+
+	TestCreateDungeon(1, 2588, ENTRY_MAIN);
+	std::thread thread([]() {
+		// Each thread generates into a level of its own.
+		RandomContext random;
+		RandomContextScope randomScope { random };
+		EXPECT_EQ(currlevel, 0);
+		TestCreateDungeon(1, 2588, ENTRY_PREV);
+		EXPECT_EQ(ViewPosition, Point(49, 49));
+	});
+	thread.join();
+	EXPECT_EQ(ViewPosition, Point(77, 46));
+	EXPECT_EQ(currlevel, 1);
+}
+#endif
+
 TEST(Drlg_l1, CreateL5Dungeon_diablo_1_743271966)
 {
 	LoadExpectedLevelData("diablo/1-743271966.dun");
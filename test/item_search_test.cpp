@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+
+#include "engine/random.hpp"
+#include "item_search.h"
+#include "items.h"
+
+using namespace devilution;
+
+namespace {
+
+ItemSearchQuery StrengthQuery()
+{
+	ItemSearchQuery query;
+	query.minQuality = ITEM_QUALITY_MAGIC;
+	query.minStats.push_back({ ItemSearchStat::Strength, 5 });
+	return query;
+}
+
+ItemSearchOptions FirstSeedOptions(uint32_t firstSeed, unsigned threads)
+{
+	ItemSearchOptions options;
+	options.threads = threads;
+	options.firstSeed = firstSeed;
+	options.maxCandidates = 10000000;
+	return options;
+}
+
+TEST(ItemSearch, ParseQuery)
+{
+	const ItemSearchQuery query = ParseItemSearchQuery("type:Sword  str:10 of THE whale dam:25");
+	EXPECT_EQ(query.itemType, ItemType::Sword);
+	ASSERT_EQ(query.minStats.size(), 2);
+	EXPECT_EQ(query.minStats[0].stat, ItemSearchStat::Strength);
+	EXPECT_EQ(query.minStats[0].minValue, 10);
+	EXPECT_EQ(query.minStats[1].stat, ItemSearchStat::DamagePercent);
+	EXPECT_EQ(query.minStats[1].minValue, 25);
+	EXPECT_EQ(query.name, "of the whale");
+
+	EXPECT_EQ(ParseItemSearchQuery("king's").name, "king's");
+	EXPECT_EQ(ParseItemSearchQuery("type:unknown").name, "type:unknown");
+}
+
+TEST(ItemSearch, FoundItemMatches)
+{
+	InitItems();
+	const ItemSearchQuery query = StrengthQuery();
+	SetRndSeed(42);
+	const ItemSearchResult result = SearchItem(query, FirstSeedOptions(7, 4));
+	ASSERT_TRUE(result.found);
+	EXPECT_GT(result.candidates, 0);
+	EXPECT_EQ(GetLCGEngineState(), 42);
+
+	Item item;
+	ASSERT_TRUE(GenerateSearchCandidate(item, query, result.seed));
+	EXPECT_TRUE(ItemMatchesSearchQuery(item, query));
+	EXPECT_GE(item._iPLStr, 5);
+	EXPECT_EQ(GetLCGEngineState(), 42);
+}
+
+TEST(ItemSearch, SameSeedForAnyThreadCount)
+{
+	InitItems();
+	// Rare enough for the threads to go through several chunks of candidates.
+	ItemSearchQuery query = StrengthQuery();
+	query.minStats[0].minValue = 16;
+	for (uint32_t firstSeed : { 1U, 1000U, 123456789U }) {
+		const ItemSearchResult expected = SearchItem(query, FirstSeedOptions(firstSeed, 1));
+		ASSERT_TRUE(expected.found);
+		for (unsigned threads : { 2U, 3U, 8U }) {
+			const ItemSearchResult result = SearchItem(query, FirstSeedOptions(firstSeed, threads));
+			ASSERT_TRUE(result.found);
+			EXPECT_EQ(result.seed, expected.seed) << "first seed " << firstSeed << ", threads " << threads;
+			EXPECT_GE(result.candidates, expected.candidates);
+		}
+	}
+}
+
+TEST(ItemSearch, NameMeasuredOnEveryThread)
+{
+	InitItems();
+	// Each thread measures the names with text caches of its own.
+	ItemSearchQuery query;
+	query.name = "of the whale";
+	const ItemSearchResult expected = SearchItem(query, FirstSeedOptions(7, 1));
+	ASSERT_TRUE(expected.found);
+	const ItemSearchResult result = SearchItem(query, FirstSeedOptions(7, 4));
+	ASSERT_TRUE(result.found);
+	EXPECT_EQ(result.seed, expected.seed);
+
+	Item item;
+	ASSERT_TRUE(GenerateSearchCandidate(item, query, result.seed));
+	EXPECT_TRUE(ItemMatchesSearchQuery(item, query));
+}
+
+TEST(ItemSearch, UniqueLeavesFlagsAlone)
+{
+	InitItems();
+	// The Rift Bow and The Needler share their base item, the search must only ever roll the latter.
+	constexpr int RiftBow = 10;
+	constexpr int Needler = 11;
+	UniqueItemFlags[RiftBow] = true;
+	bool flags[sizeof(UniqueItemFlags)];
+	memcpy(flags, UniqueItemFlags, sizeof(flags));
+
+	ItemSearchQuery query;
+	query.source = ItemSearchSource::Unique;
+	query.uniqueIndex = Needler;
+	const ItemSearchResult result = SearchItem(query, FirstSeedOptions(3, 4));
+	ASSERT_TRUE(result.found);
+	EXPECT_EQ(memcmp(flags, UniqueItemFlags, sizeof(flags)), 0);
+
+	Item item;
+	ASSERT_TRUE(GenerateSearchCandidate(item, query, result.seed));
+	EXPECT_EQ(item._iMagical, ITEM_QUALITY_UNIQUE);
+	EXPECT_EQ(item._iUid, Needler);
+	EXPECT_EQ(memcmp(flags, UniqueItemFlags, sizeof(flags)), 0);
+	UniqueItemFlags[RiftBow] = false;
+}
+
+TEST(ItemSearch, QuestUnique)
+{
+	InitItems();
+	constexpr int UndeadCrown = 1;
+	ItemSearchQuery query;
+	query.source = ItemSearchSource::Unique;
+	query.uniqueIndex = UndeadCrown;
+	const ItemSearchResult result = SearchItem(query, FirstSeedOptions(3, 2));
+	ASSERT_TRUE(result.found);
+	EXPECT_EQ(result.seed, 3);
+
+	Item item;
+	ASSERT_TRUE(GenerateSearchCandidate(item, query, result.seed));
+	EXPECT_EQ(item.IDidx, IDI_SKCROWN);
+	EXPECT_EQ(item._iUid, UndeadCrown);
+}
+
+TEST(ItemSearch, GivesUpAfterMaxCandidates)
+{
+	InitItems();
+	ItemSearchQuery query = StrengthQuery();
+	query.name = "no item is called this";
+	ItemSearchOptions options = FirstSeedOptions(5, 4);
+	options.maxCandidates = 1000;
+	const ItemSearchResult result = SearchItem(query, options);
+	EXPECT_FALSE(result.found);
+	EXPECT_EQ(result.candidates, 1000);
+}
+
+} // namespace
@@ -0,0 +1,132 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "engine/random.hpp"
+#include "item_search.h"
+#include "items.h"
+#include "items_test.hpp"
+#include "player.h"
+#include "stores.h"
+
+using namespace devilution;
+
+namespace {
+
+template <size_t N>
+int CountItems(const Item (&stock)[N])
+{
+	int count = 0;
+	for (const Item &item : stock) {
+		if (!item.isEmpty())
+			count++;
+	}
+	return count;
+}
+
+/**
+ * @brief Restocks the smith, the witch and the premium items for each level, the premium items and the staves rolling their affixes.
+ */
+void BM_RestockVendors(benchmark::State &state)
+{
+	SetItemCandidateTablesEnabled(state.range(0) != 0);
+	gbIsHellfire = state.range(1) != 0;
+	InitItems();
+	MyPlayer->_pLevel = 30;
+	SetRndSeed(1);
+
+	int64_t items = 0;
+	for (auto _ : state) {
+		for (int lvl = 1; lvl <= 16; lvl++) {
+			SpawnSmith(lvl);
+			SpawnWitch(lvl);
+			for (Item &item : premiumitems)
+				item.clear();
+			numpremium = 0;
+			premiumlevel = lvl;
+			SpawnPremium(MyPlayerId);
+			items += CountItems(smithitem) + CountItems(witchitem) + CountItems(premiumitems);
+		}
+	}
+	state.SetItemsProcessed(items);
+
+	SetItemCandidateTablesEnabled(true);
+	gbIsHellfire = false;
+}
+
+BENCHMARK(BM_RestockVendors)->ArgsProduct({ { 0, 1 }, { 0, 1 } })->ArgNames({ "tables", "hellfire" });
+
+/**
+ * @brief Rolls monster drops for a query no item matches, as the item debug commands do until they give up.
+ */
+void BM_SearchItem(benchmark::State &state)
+{
+	InitItems();
+	ItemSearchQuery query;
+	query.minStats.push_back({ ItemSearchStat::Strength, 1000 });
+	ItemSearchOptions options;
+	options.threads = static_cast<unsigned>(state.range(0));
+	options.maxCandidates = 100000;
+
+	int64_t seeds = 0;
+	for (auto _ : state) {
+		const ItemSearchResult result = SearchItem(query, options);
+		seeds += result.candidates;
+		options.firstSeed += result.candidates;
+	}
+	state.SetItemsProcessed(seeds);
+}
+
+BENCHMARK(BM_SearchItem)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->ArgName("threads")->UseRealTime();
+
+/**
+ * @brief Takes off and puts on again a ring and the armor of another player, as the messages of their equipment do,
+ * counting either only the changed body slot or all of them.
+ */
+void BM_ChangeEquipment(benchmark::State &state)
+{
+	InitItems();
+	const bool changedSlotsOnly = state.range(0) != 0;
+	Player &player = Players[1];
+	player._pClass = HeroClass::Warrior;
+	player._pLevel = 30;
+	player._pBaseStr = 100;
+	player._pBaseMag = 50;
+	player._pBaseDex = 80;
+	player._pBaseVit = 80;
+
+	SetRndSeed(1);
+	player.InvBody[INVLOC_HEAD] = RollBodyItem(INVLOC_HEAD, 30);
+	player.InvBody[INVLOC_RING_LEFT] = RollBodyItem(INVLOC_RING_LEFT, 30);
+	player.InvBody[INVLOC_RING_RIGHT] = RollBodyItem(INVLOC_RING_RIGHT, 30);
+	player.InvBody[INVLOC_AMULET] = RollBodyItem(INVLOC_AMULET, 30);
+	player.InvBody[INVLOC_HAND_LEFT] = RollBodyItem(INVLOC_HAND_LEFT, 30);
+	player.InvBody[INVLOC_HAND_RIGHT] = RollBodyItem(INVLOC_HAND_RIGHT, 30);
+	player.InvBody[INVLOC_CHEST] = RollBodyItem(INVLOC_CHEST, 30);
+	CalcPlrInv(player, false);
+
+	const auto calcPlrInv = [&](inv_body_loc bodyLocation) {
+		if (changedSlotsOnly)
+			CalcPlrInv(player, false, BodySlotBit(bodyLocation));
+		else
+			CalcPlrInv(player, false);
+	};
+	const Item ring = player.InvBody[INVLOC_RING_LEFT];
+	const Item armor = player.InvBody[INVLOC_CHEST];
+	for (auto _ : state) {
+		player.InvBody[INVLOC_RING_LEFT].clear();
+		calcPlrInv(INVLOC_RING_LEFT);
+		player.InvBody[INVLOC_RING_LEFT] = ring;
+		calcPlrInv(INVLOC_RING_LEFT);
+		player.InvBody[INVLOC_CHEST].clear();
+		calcPlrInv(INVLOC_CHEST);
+		player.InvBody[INVLOC_CHEST] = armor;
+		calcPlrInv(INVLOC_CHEST);
+	}
+	state.SetItemsProcessed(state.iterations() * 4);
+}
+
+BENCHMARK(BM_ChangeEquipment)->Arg(0)->Arg(1)->ArgName("changed_slots_only");
+
+} // namespace
@@ -0,0 +1,269 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "engine/load_file.hpp"
+#include "engine/random.hpp"
+#include "items.h"
+#include "items_test.hpp"
+#include "monster.h"
+#include "player.h"
+#include "stores.h"
+#include "utils/paths.h"
+
+using namespace devilution;
+
+namespace {
+
+struct GameMode {
+	bool multiplayer;
+	bool hellfire;
+	bool spawn;
+};
+
+constexpr GameMode GameModes[] = {
+	{ false, false, false },
+	{ true, false, false },
+	{ false, true, false },
+	{ true, true, false },
+	{ false, false, true },
+	{ true, false, true },
+};
+
+void RecordItem(std::vector<int> &items, const Item &item)
+{
+	if (item.isEmpty()) {
+		items.push_back(-1);
+		return;
+	}
+	items.push_back(item.IDidx);
+	items.push_back(item._iSeed);
+	items.push_back(item._iIvalue);
+	items.push_back(item._iPrePower);
+	items.push_back(item._iSufPower);
+}
+
+/**
+ * @brief Rolls monster drops, ground items, magic items and the stock of every vendor.
+ */
+std::vector<int> GenerateItems(const GameMode &mode, uint32_t seed)
+{
+	gbIsMultiplayer = mode.multiplayer;
+	gbIsHellfire = mode.hellfire;
+	gbIsSpawn = mode.spawn;
+
+	Player &myPlayer = *MyPlayer;
+	myPlayer._pLevel = static_cast<int8_t>(seed % 50 + 1);
+	myPlayer._pBaseStr = (seed & 1) != 0 ? 250 : 0;
+	myPlayer._pBaseMag = (seed & 2) != 0 ? 250 : 0;
+	myPlayer._pBaseDex = (seed & 4) != 0 ? 250 : 0;
+	myPlayer._pBaseVit = (seed & 8) != 0 ? 250 : 0;
+
+	for (bool &dropped : UniqueItemFlags)
+		dropped = false;
+
+	std::vector<int> items;
+	SetRndSeed(seed);
+
+	MonsterData monsterData = MonstersData[0];
+	monsterData.mTreasure = 0;
+	Monster monster {};
+	monster.MData = &monsterData;
+	for (int level = 1; level <= 61; level += 3) {
+		monster.mLevel = static_cast<int8_t>(level);
+		items.push_back(RndItem(monster));
+	}
+
+	currlevel = static_cast<uint8_t>(seed % 16 + 1);
+	leveltype = DTYPE_CATHEDRAL;
+	const Point position { 50, 50 };
+	for (int i = 0; i < 8; i++) {
+		if (i < 3)
+			CreateRndItem(position, i == 0, false, false);
+		else if (i < 6)
+			CreateTypeItem(position, false, i == 3 ? ItemType::Sword : ItemType::Misc, i == 5 ? IMISC_BOOK : -1, false, false);
+		else
+			CreateRndUseful(position, false);
+		const Item &item = Items[ActiveItems[ActiveItemCount - 1]];
+		RecordItem(items, item);
+		dItem[item.position.x][item.position.y] = 0;
+		DeleteItem(ActiveItemCount - 1);
+	}
+	for (int i = 0; i < 6; i++) {
+		if (i < 4)
+			CreateAmulet(position, 4 + i * 10 + static_cast<int>(seed % 10), false, false);
+		else
+			CreateMagicWeapon(position, ItemType::Staff, ICURS_SHORT_STAFF, false, false);
+		const Item &item = Items[ActiveItems[ActiveItemCount - 1]];
+		RecordItem(items, item);
+		dItem[item.position.x][item.position.y] = 0;
+		DeleteItem(ActiveItemCount - 1);
+	}
+
+	const int lvl = static_cast<int>(seed % 30) + 1;
+	SpawnSmith(lvl);
+	for (const Item &item : smithitem)
+		RecordItem(items, item);
+	SpawnWitch(lvl);
+	for (const Item &item : witchitem)
+		RecordItem(items, item);
+	SpawnHealer(lvl);
+	for (const Item &item : healitem)
+		RecordItem(items, item);
+	boyitem.clear();
+	boylevel = 0;
+	SpawnBoy(lvl);
+	RecordItem(items, boyitem);
+	for (Item &item : premiumitems)
+		item.clear();
+	numpremium = 0;
+	premiumlevel = lvl;
+	SpawnPremium(MyPlayerId);
+	for (const Item &item : premiumitems)
+		RecordItem(items, item);
+
+	items.push_back(GenerateRnd(INT32_MAX));
+	return items;
+}
+
+std::vector<int> RecordPlayerStats(const Player &player)
+{
+	return {
+		player._pIMinDam,
+		player._pIMaxDam,
+		player._pIAC,
+		player._pIBonusDam,
+		player._pIBonusToHit,
+		player._pIBonusAC,
+		player._pIBonusDamMod,
+		static_cast<int>(player._pIFlags),
+		static_cast<int>(player.pDamAcFlags),
+		static_cast<int>(player._pISpells),
+		static_cast<int>(player._pISpells >> 32),
+		player._pIGetHit,
+		player._pISplLvlAdd,
+		player._pIEnAc,
+		player._pIFMinDam,
+		player._pIFMaxDam,
+		player._pILMinDam,
+		player._pILMaxDam,
+		player._pStrength,
+		player._pMagic,
+		player._pDexterity,
+		player._pVitality,
+		player._pDamageMod,
+		player._pMagResist,
+		player._pFireResist,
+		player._pLghtResist,
+		player._pMaxHP,
+		player._pHitPoints,
+		player._pMaxMana,
+		player._pMana,
+		player._pLightRad,
+		player._pgfxnum,
+		player._pBlockFlag ? 1 : 0,
+	};
+}
+
+/**
+ * @brief Hashes the rolls of GenerateItems, so that the fixture doesn't have to keep all of them.
+ */
+uint64_t HashItems(const std::vector<int> &items)
+{
+	uint64_t hash = 14695981039346656037U;
+	for (int value : items) {
+		hash ^= static_cast<uint32_t>(value);
+		hash *= 1099511628211U;
+	}
+	return hash;
+}
+
+/**
+ * @brief Loads the hashes of what GenerateItems rolled for the first seeds before the candidate tables were added, one
+ * line per seed with a column per game mode.
+ */
+std::vector<uint64_t> LoadExpectedItemHashes()
+{
+	paths::SetPrefPath(paths::BasePath());
+	paths::SetAssetsPath(paths::BasePath() + "/test/fixtures/");
+	size_t size;
+	std::unique_ptr<char[]> fixture = LoadFileInMem<char>("items/rolls.txt", &size);
+	if (fixture == nullptr)
+		return {};
+
+	std::istringstream stream(std::string(fixture.get(), size));
+	std::vector<uint64_t> hashes;
+	uint64_t hash;
+	while (stream >> std::hex >> hash)
+		hashes.push_back(hash);
+	return hashes;
+}
+
+TEST(Items, RollsMatchTheRollsBeforeCandidateTables)
+{
+	const std::vector<uint64_t> expected = LoadExpectedItemHashes();
+	ASSERT_FALSE(expected.empty()) << "Unable to load test fixture items/rolls.txt";
+	const uint32_t seeds = static_cast<uint32_t>(expected.size() / std::size(GameModes));
+	InitItems();
+
+	for (bool candidateTables : { false, true }) {
+		SetItemCandidateTablesEnabled(candidateTables);
+		size_t i = 0;
+		for (uint32_t seed = 0; seed < seeds; seed++) {
+			for (const GameMode &mode : GameModes) {
+				ASSERT_EQ(HashItems(GenerateItems(mode, seed)), expected[i]) << "seed " << seed << ", multiplayer " << mode.multiplayer << ", hellfire " << mode.hellfire << ", spawn " << mode.spawn << ", candidate tables " << candidateTables;
+				i++;
+			}
+		}
+	}
+
+	gbIsMultiplayer = false;
+	gbIsHellfire = false;
+	gbIsSpawn = false;
+}
+
+TEST(Items, CountingChangedBodySlotsMatchesCountingAll)
+{
+	InitItems();
+	SetItemStatsVerified(true);
+	SetRndSeed(7);
+
+	for (HeroClass heroClass : { HeroClass::Warrior, HeroClass::Monk, HeroClass::Barbarian }) {
+		// Another player, as the equipment of the others changes through CheckInvSwap and inv_update_rem_item.
+		Player &player = Players[1];
+		player._pClass = heroClass;
+		player._pLevel = 30;
+		player._pBaseStr = 60;
+		player._pBaseMag = 40;
+		player._pBaseDex = 50;
+		player._pBaseVit = 40;
+		for (Item &item : player.InvBody)
+			item.clear();
+		CalcPlrInv(player, false);
+
+		for (int change = 0; change < 1000; change++) {
+			const auto bodyLocation = static_cast<inv_body_loc>(GenerateRnd(NUM_INVLOC));
+			if (GenerateRnd(4) == 0) {
+				player.InvBody[bodyLocation].clear();
+			} else {
+				player.InvBody[bodyLocation] = RollBodyItem(bodyLocation, GenerateRnd(30) + 1);
+				// Also unidentified items, whose affixes don't count.
+				player.InvBody[bodyLocation]._iIdentified = GenerateRnd(2) == 0;
+			}
+			CalcPlrInv(player, false, BodySlotBit(bodyLocation));
+
+			const std::vector<int> counted = RecordPlayerStats(player);
+			CalcPlrInv(player, false);
+			ASSERT_EQ(RecordPlayerStats(player), counted) << "class " << static_cast<int>(heroClass) << ", change " << change;
+		}
+	}
+
+	SetItemStatsVerified(false);
+}
+
+} // namespace
@@ -0,0 +1,56 @@
+/**
+ * @file items_test.hpp
+ *
+ * Helpers for item related tests.
+ */
+#pragma once
+
+#include <vector>
+
+#include "engine.h"
+#include "engine/random.hpp"
+#include "items.h"
+#include "player.h"
+
+using namespace devilution;
+
+/**
+ * @brief Rolls an identified magic item that fits the given body slot, so that its affixes count.
+ */
+Item RollBodyItem(inv_body_loc bodyLocation, int lvl)
+{
+	std::vector<int> bases;
+	for (int idx = 0; idx <= IDI_LAST; idx++) {
+		const ItemData &data = AllItemsList[idx];
+		if (data.iRnd == IDROP_NEVER)
+			continue;
+		switch (bodyLocation) {
+		case INVLOC_HEAD:
+			if (data.iLoc == ILOC_HELM)
+				bases.push_back(idx);
+			break;
+		case INVLOC_RING_LEFT:
+		case INVLOC_RING_RIGHT:
+			if (data.iLoc == ILOC_RING)
+				bases.push_back(idx);
+			break;
+		case INVLOC_AMULET:
+			if (data.iLoc == ILOC_AMULET)
+				bases.push_back(idx);
+			break;
+		case INVLOC_CHEST:
+			if (data.iLoc == ILOC_ARMOR)
+				bases.push_back(idx);
+			break;
+		default:
+			if (IsAnyOf(data.iLoc, ILOC_ONEHAND, ILOC_TWOHAND))
+				bases.push_back(idx);
+			break;
+		}
+	}
+
+	Item item {};
+	SetupAllItems(item, bases[GenerateRnd(static_cast<int>(bases.size()))], AdvanceRndSeed(), 2 * lvl, 1, true, false, false);
+	item._iIdentified = true;
+	return item;
+}
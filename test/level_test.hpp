@@ -0,0 +1,35 @@
+/**
+ * @file level_test.hpp
+ *
+ * Helpers for tests that need a generated level without the game data.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "diablo.h"
+#include "levels/gendung.h"
+#include "utils/paths.h"
+
+using namespace devilution;
+
+/**
+ * @brief Generates the dungeon of `currlevel`, with made up pieces for its tiles of which about a third have the given
+ * properties.
+ */
+void CreateFakeTileLevel(TileProperties blocking, uint32_t seed)
+{
+	paths::SetPrefPath(paths::BasePath());
+	paths::SetAssetsPath(paths::BasePath() + "/test/fixtures/");
+	leveltype = GetLevelType(currlevel);
+
+	pMegaTiles = std::make_unique<MegaTile[]>(256);
+	for (uint16_t i = 0; i < 256; i++)
+		pMegaTiles[i] = { static_cast<uint16_t>(4 * i), static_cast<uint16_t>(4 * i + 1), static_cast<uint16_t>(4 * i + 2), static_cast<uint16_t>(4 * i + 3) };
+	for (size_t piece = 0; piece < SOLData.size(); piece++)
+		SOLData[piece] = (piece * 2654435761U) % 3 == 0 ? blocking : TileProperties::None;
+
+	CreateDungeon(seed, ENTRY_MAIN);
+}
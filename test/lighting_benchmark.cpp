@@ -0,0 +1,71 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+#include "diablo.h"
+#include "level_test.hpp"
+#include "levels/gendung.h"
+#include "lighting.h"
+#include "utils/paths.h"
+
+using namespace devilution;
+
+namespace {
+
+/**
+ * @brief Moves the visions of 4 players through the level, updating them on each step as the game does.
+ *
+ * Golems don't have a vision of their own, 4 more visions at their usual distance from the players stand in for them
+ * to check how the cost grows with the number of visions.
+ */
+void BM_ProcessVisionList(benchmark::State &state)
+{
+	// A catacombs level.
+	currlevel = 5;
+	CreateFakeTileLevel(TileProperties::BlockLight, 68685319);
+	InitVision();
+
+	const int visions = static_cast<int>(state.range(0));
+	constexpr Point Starts[] = { { 40, 40 }, { 44, 42 }, { 60, 60 }, { 38, 70 } };
+	Point positions[8];
+	int ids[8];
+	for (int i = 0; i < visions; i++) {
+		positions[i] = Starts[i % 4] + Displacement { i / 4 * 2, i / 4 * 2 };
+		ids[i] = AddVision(positions[i], i < 4 ? 10 : 8, i == 0);
+	}
+
+	int step = 0;
+	for (auto _ : state) {
+		// Walk back and forth so that the visions stay in the dungeon.
+		const Displacement move = (step++ / 20) % 2 == 0 ? Displacement { 1, 0 } : Displacement { -1, 0 };
+		for (int i = 0; i < visions; i++) {
+			positions[i] += move;
+			ChangeVisionXY(ids[i], positions[i]);
+		}
+		ProcessVisionList();
+	}
+	state.SetItemsProcessed(state.iterations() * visions);
+}
+
+BENCHMARK(BM_ProcessVisionList)->Arg(4)->Arg(8)->ArgName("visions");
+
+/**
+ * @brief Builds the light tables as every level load does.
+ *
+ * The infravision and stone TRNs are read from stand-in fixtures, the game data is not needed.
+ */
+void BM_MakeLightTable(benchmark::State &state)
+{
+	paths::SetPrefPath(paths::BasePath());
+	paths::SetAssetsPath(paths::BasePath() + "/test/fixtures/");
+	leveltype = static_cast<dungeon_type>(state.range(0));
+
+	for (auto _ : state) {
+		MakeLightTable();
+		benchmark::DoNotOptimize(LightTables.data());
+	}
+}
+
+BENCHMARK(BM_MakeLightTable)->DenseRange(DTYPE_TOWN, DTYPE_HELL)->ArgName("leveltype");
+
+} // namespace
@@ -1,6 +1,12 @@
 #include <gtest/gtest.h>
 
+#include <cstring>
+
+#include "automap.h"
 #include "control.h"
+#include "diablo.h"
+#include "level_test.hpp"
+#include "levels/gendung.h"
 #include "lighting.h"
 
 using namespace devilution;
@@ -32,3 +38,237 @@ TEST(Lighting, CrawlTables)
 		}
 	}
 }
+
+namespace {
+
+const uint8_t ReferenceRadiusAdj[23] = { 0, 0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 4, 3, 2, 2, 2, 1, 1, 1, 0, 0, 0, 0 };
+
+/**
+ * @brief DoVision() as it crawled VisionCrawlTable before the rays were turned once for all visions.
+ */
+void ReferenceDoVision(Point position, int nRadius, MapExplorationType doautomap, bool visible)
+{
+	if (InDungeonBounds(position)) {
+		if (doautomap != MAP_EXP_NONE) {
+			if (dFlags[position.x][position.y] != DungeonFlag::None) {
+				SetAutomapView(position, doautomap);
+			}
+			dFlags[position.x][position.y] |= DungeonFlag::Explored;
+		}
+		if (visible) {
+			dFlags[position.x][position.y] |= DungeonFlag::Lit;
+		}
+		dFlags[position.x][position.y] |= DungeonFlag::Visible;
+	}
+
+	for (int v = 0; v < 4; v++) {
+		for (int j = 0; j < 23; j++) {
+			bool nBlockerFlag = false;
+			int nLineLen = 2 * (nRadius - ReferenceRadiusAdj[j]);
+			for (int k = 0; k < nLineLen && !nBlockerFlag; k += 2) {
+				int x1adj = 0;
+				int x2adj = 0;
+				int y1adj = 0;
+				int y2adj = 0;
+				int nCrawlX = 0;
+				int nCrawlY = 0;
+				switch (v) {
+				case 0:
+					nCrawlX = position.x + VisionCrawlTable[j][k];
+					nCrawlY = position.y + VisionCrawlTable[j][k + 1];
+					if (VisionCrawlTable[j][k] > 0 && VisionCrawlTable[j][k + 1] > 0) {
+						x1adj = -1;
+						y2adj = -1;
+					}
+					break;
+				case 1:
+					nCrawlX = position.x - VisionCrawlTable[j][k];
+					nCrawlY = position.y - VisionCrawlTable[j][k + 1];
+					if (VisionCrawlTable[j][k] > 0 && VisionCrawlTable[j][k + 1] > 0) {
+						y1adj = 1;
+						x2adj = 1;
+					}
+					break;
+				case 2:
+					nCrawlX = position.x + VisionCrawlTable[j][k];
+					nCrawlY = position.y - VisionCrawlTable[j][k + 1];
+					if (VisionCrawlTable[j][k] > 0 && VisionCrawlTable[j][k + 1] > 0) {
+						x1adj = -1;
+						y2adj = 1;
+					}
+					break;
+				case 3:
+					nCrawlX = position.x - VisionCrawlTable[j][k];
+					nCrawlY = position.y + VisionCrawlTable[j][k + 1];
+					if (VisionCrawlTable[j][k] > 0 && VisionCrawlTable[j][k + 1] > 0) {
+						y1adj = -1;
+						x2adj = 1;
+					}
+					break;
+				}
+				if (InDungeonBounds({ nCrawlX, nCrawlY })) {
+					nBlockerFlag = TileHasAny(dPiece[nCrawlX][nCrawlY], TileProperties::BlockLight);
+					if ((InDungeonBounds({ x1adj + nCrawlX, y1adj + nCrawlY })
+					        && !TileHasAny(dPiece[x1adj + nCrawlX][y1adj + nCrawlY], TileProperties::BlockLight))
+					    || (InDungeonBounds({ x2adj + nCrawlX, y2adj + nCrawlY })
+					        && !TileHasAny(dPiece[x2adj + nCrawlX][y2adj + nCrawlY], TileProperties::BlockLight))) {
+						if (doautomap != MAP_EXP_NONE) {
+							if (dFlags[nCrawlX][nCrawlY] != DungeonFlag::None) {
+								SetAutomapView({ nCrawlX, nCrawlY }, doautomap);
+							}
+							dFlags[nCrawlX][nCrawlY] |= DungeonFlag::Explored;
+						}
+						if (visible) {
+							dFlags[nCrawlX][nCrawlY] |= DungeonFlag::Lit;
+						}
+						dFlags[nCrawlX][nCrawlY] |= DungeonFlag::Visible;
+						if (!nBlockerFlag) {
+							int8_t nTrans = dTransVal[nCrawlX][nCrawlY];
+							if (nTrans != 0) {
+								TransList[nTrans] = true;
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+struct VisionState {
+	DungeonFlag flags[MAXDUNX][MAXDUNY];
+	bool transList[256];
+	uint8_t automapView[DMAXX][DMAXY];
+};
+
+void SaveVisionState(VisionState &state)
+{
+	memcpy(state.flags, dFlags, sizeof(state.flags));
+	memcpy(state.transList, TransList, sizeof(state.transList));
+	memcpy(state.automapView, AutomapView, sizeof(state.automapView));
+}
+
+void RestoreVisionState(const VisionState &state)
+{
+	memcpy(dFlags, state.flags, sizeof(dFlags));
+	memcpy(TransList, state.transList, sizeof(TransList));
+	memcpy(AutomapView, state.automapView, sizeof(AutomapView));
+}
+
+bool IsSameVisionState(const VisionState &a, const VisionState &b)
+{
+	return memcmp(a.flags, b.flags, sizeof(a.flags)) == 0
+	    && memcmp(a.transList, b.transList, sizeof(a.transList)) == 0
+	    && memcmp(a.automapView, b.automapView, sizeof(a.automapView)) == 0;
+}
+
+struct VisionLevel {
+	int level;
+	uint32_t seed;
+	bool hellfire;
+};
+
+/** @brief The levels of the dungeon generation fixtures. */
+constexpr VisionLevel VisionLevels[] = {
+	{ 1, 2588, false }, { 1, 743271966, false }, { 2, 1383137027, false }, { 3, 844660068, false },
+	{ 4, 609325643, false }, { 5, 68685319, false }, { 5, 1677631846, false }, { 6, 1824554527, false },
+	{ 6, 2034738122, false }, { 7, 680552750, false }, { 7, 1607627156, false }, { 8, 1999936419, false },
+	{ 9, 262005438, false }, { 10, 879635115, false }, { 10, 1630062353, false }, { 11, 384626536, false },
+	{ 12, 2104541047, false }, { 13, 428074402, false }, { 13, 594689775, false }, { 14, 717625719, false },
+	{ 15, 1256511996, false }, { 15, 1583642716, false }, { 16, 741281013, false },
+	{ 1, 401921334, true }, { 2, 128964898, true }, { 2, 1180526547, true }, { 3, 1512491184, true },
+	{ 3, 1799396623, true }, { 4, 1190318991, true }, { 4, 1924296259, true }, { 17, 19770182, true },
+	{ 18, 1522546307, true }, { 19, 125121312, true }, { 20, 1511478689, true }, { 21, 2122696790, true },
+	{ 22, 1191662129, true }, { 23, 97055268, true }, { 24, 1324803725, true },
+};
+
+/**
+ * @brief Generates a level, with made up pieces for its tiles of which about a third block the light.
+ */
+void CreateVisionLevel(const VisionLevel &level)
+{
+	gbIsHellfire = level.hellfire;
+	currlevel = level.level;
+	CreateFakeTileLevel(TileProperties::BlockLight, level.seed);
+	memset(AutomapView, 0, sizeof(AutomapView));
+	memset(TransList, 0, sizeof(TransList));
+}
+
+TEST(Lighting, DoVisionMatchesReference)
+{
+	static VisionState before;
+	static VisionState expected;
+	static VisionState actual;
+	constexpr int Radii[] = { 2, 5, 8, 10, 15 };
+	constexpr MapExplorationType Explorers[] = { MAP_EXP_SELF, MAP_EXP_OTHERS, MAP_EXP_NONE };
+
+	for (const VisionLevel &level : VisionLevels) {
+		CreateVisionLevel(level);
+		int index = 0;
+		for (int x = -3; x < MAXDUNX + 3; x += 5) {
+			for (int y = -3; y < MAXDUNY + 3; y += 5, index++) {
+				const Point position { x, y };
+				const int radius = Radii[index % 5];
+				const MapExplorationType explorer = Explorers[index % 3];
+				const bool visible = index % 2 == 0;
+
+				SaveVisionState(before);
+				ReferenceDoVision(position, radius, explorer, visible);
+				SaveVisionState(expected);
+				RestoreVisionState(before);
+				DoVision(position, radius, explorer, visible);
+				SaveVisionState(actual);
+				ASSERT_TRUE(IsSameVisionState(expected, actual)) << "level " << level.level << " seed " << level.seed << " at " << x << "x" << y << " radius " << radius;
+			}
+		}
+	}
+	gbIsHellfire = false;
+}
+
+TEST(Lighting, ProcessVisionListMatchesReference)
+{
+	static VisionState before;
+	static VisionState expected;
+	static VisionState actual;
+	// Two players close enough to see the same tiles, and two away from them.
+	constexpr Point Starts[] = { { 40, 40 }, { 42, 45 }, { 60, 30 }, { 17, 90 } };
+	constexpr int Radii[] = { 10, 15, 8, 2 };
+
+	for (const VisionLevel &level : VisionLevels) {
+		CreateVisionLevel(level);
+		InitVision();
+		Point positions[4];
+		int ids[4];
+		for (int i = 0; i < 4; i++) {
+			positions[i] = Starts[i];
+			ids[i] = AddVision(positions[i], Radii[i], i % 2 == 0);
+		}
+		ProcessVisionList();
+
+		for (int step = 0; step < 8; step++) {
+			const Displacement move { step % 3 - 1, step % 2 };
+			Point old[4];
+			for (int i = 0; i < 4; i++) {
+				old[i] = positions[i];
+				positions[i] += move;
+				ChangeVisionXY(ids[i], positions[i]);
+			}
+
+			SaveVisionState(before);
+			for (int i = 0; i < 4; i++)
+				DoUnVision(old[i], Radii[i]);
+			memset(TransList, 0, sizeof(TransList));
+			for (int i = 0; i < 4; i++)
+				ReferenceDoVision(positions[i], Radii[i], i % 2 == 0 ? MAP_EXP_SELF : MAP_EXP_OTHERS, i % 2 == 0);
+			SaveVisionState(expected);
+			RestoreVisionState(before);
+
+			ProcessVisionList();
+			SaveVisionState(actual);
+			ASSERT_TRUE(IsSameVisionState(expected, actual)) << "level " << level.level << " seed " << level.seed << " step " << step;
+		}
+	}
+	gbIsHellfire = false;
+}
+
+} // namespace
@@ -0,0 +1,33 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+#include "monster.h"
+#include "monster_test.hpp"
+
+using namespace devilution;
+
+namespace {
+
+/**
+ * @brief Runs the monsters of a full level for a game tick, counting how many of them were awake and how many dormant.
+ */
+void BM_ProcessMonsters(benchmark::State &state)
+{
+	CreateMonsterLevel();
+
+	int64_t awake = 0;
+	int64_t dormant = 0;
+	for (auto _ : state) {
+		ProcessMonsters();
+		awake += AwakeMonsterCount;
+		dormant += DormantMonsterCount;
+	}
+	state.SetItemsProcessed(state.iterations() * ActiveMonsterCount);
+	state.counters["awake"] = benchmark::Counter(static_cast<double>(awake), benchmark::Counter::kAvgIterations);
+	state.counters["dormant"] = benchmark::Counter(static_cast<double>(dormant), benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_ProcessMonsters);
+
+} // namespace
@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "monster.h"
+#include "monster_test.hpp"
+
+using namespace devilution;
+
+namespace {
+
+uint64_t Mix(uint64_t hash, int64_t value)
+{
+	return (hash ^ static_cast<uint64_t>(value)) * 1099511628211U;
+}
+
+uint64_t Mix(uint64_t hash, Point point)
+{
+	return Mix(Mix(hash, point.x), point.y);
+}
+
+uint64_t Mix(uint64_t hash, Displacement displacement)
+{
+	return Mix(Mix(hash, displacement.deltaX), displacement.deltaY);
+}
+
+/**
+ * @brief Hashes the state of every monster that the AI of the monsters can change, and the state of the random number
+ * generator.
+ *
+ * Only the gameplay fields are hashed, the pointers to the monster type, name and sprites aren't.
+ */
+uint64_t HashMonsters(uint64_t hash)
+{
+	for (const Monster &monster : Monsters) {
+		hash = Mix(hash, monster._mFlags);
+		hash = Mix(hash, monster._mhitpoints);
+		hash = Mix(hash, static_cast<int>(monster._mmode));
+		hash = Mix(hash, monster._menemy);
+		hash = Mix(hash, monster._msquelch);
+		hash = Mix(hash, monster._mAi);
+		hash = Mix(hash, monster.mtalkmsg);
+		hash = Mix(hash, monster.position.tile);
+		hash = Mix(hash, monster.position.future);
+		hash = Mix(hash, monster.position.old);
+		hash = Mix(hash, monster.position.offset);
+		hash = Mix(hash, monster.position.offset2);
+		hash = Mix(hash, monster.position.velocity);
+		hash = Mix(hash, monster.position.temp);
+		hash = Mix(hash, monster.enemyPosition);
+		hash = Mix(hash, static_cast<int>(monster._mdir));
+		hash = Mix(hash, monster.leader);
+		hash = Mix(hash, static_cast<int>(monster.leaderRelation));
+		hash = Mix(hash, monster._mAISeed);
+		hash = Mix(hash, monster.AnimInfo.CurrentFrame);
+		hash = Mix(hash, monster.AnimInfo.NumberOfFrames);
+		hash = Mix(hash, monster.AnimInfo.TickCounterOfCurrentFrame);
+		hash = Mix(hash, monster.AnimInfo.IsPetrified ? 1 : 0);
+		hash = Mix(hash, monster._mgoal);
+		hash = Mix(hash, monster._mint);
+		hash = Mix(hash, monster._pathcount);
+		hash = Mix(hash, monster._mDelFlag ? 1 : 0);
+		hash = Mix(hash, monster._mgoalvar1);
+		hash = Mix(hash, monster._mgoalvar2);
+		hash = Mix(hash, monster._mgoalvar3);
+		hash = Mix(hash, monster._mVar1);
+		hash = Mix(hash, monster._mVar2);
+		hash = Mix(hash, monster._mVar3);
+		hash = Mix(hash, monster._mRndSeed);
+		hash = Mix(hash, monster.mWhoHit);
+		hash = Mix(hash, monster.mlid);
+	}
+	return Mix(hash, GetLCGEngineState());
+}
+
+void MovePlayer(Player &player, Point position)
+{
+	dPlayer[player.position.tile.x][player.position.tile.y] = 0;
+	player.position.tile = position;
+	player.position.future = position;
+	dPlayer[position.x][position.y] = MyPlayerId + 1;
+	ChangeVisionXY(player._pvid, position);
+	ProcessVisionList();
+}
+
+/**
+ * @brief Runs the monsters of a full level for 3000 ticks while the player walks around, and makes a monster berserk
+ * halfway through.
+ * @return A hash of the monsters after every tick.
+ */
+uint64_t PlayMonsterLevel(bool skipDormantMonsters, bool multiplayer)
+{
+	SetDormantMonstersSkipped(skipDormantMonsters);
+	CreateMonsterLevel();
+	gbIsMultiplayer = multiplayer;
+
+	Player &player = *MyPlayer;
+	uint64_t hash = 14695981039346656037U;
+	int dormantTicks = 0;
+	for (int tick = 0; tick < 3000; tick++) {
+		// Walks a step every few ticks and turns every 20 steps, so that the player alerts new monsters all along.
+		if (tick % 7 == 0) {
+			const Point position = player.position.tile + static_cast<Direction>((tick / 140) % 8);
+			if (!IsTileOccupied(position))
+				MovePlayer(player, position);
+		}
+		if (tick == 1500)
+			Monsters[ActiveMonsters[ActiveMonsterCount - 1]]._mFlags |= MFLAG_BERSERK | MFLAG_GOLEM;
+		ProcessMonsters();
+		hash = HashMonsters(hash);
+		if (DormantMonsterCount != 0)
+			dormantTicks++;
+	}
+	// Otherwise the hashes would match whether the monsters are skipped or not.
+	EXPECT_EQ(dormantTicks != 0, skipDormantMonsters);
+
+	gbIsMultiplayer = false;
+	SetDormantMonstersSkipped(true);
+	return hash;
+}
+
+TEST(Monster, SkippingDormantMonstersKeepsSinglePlayerGamesTheSame)
+{
+	EXPECT_EQ(PlayMonsterLevel(true, false), PlayMonsterLevel(false, false));
+}
+
+TEST(Monster, SkippingDormantMonstersKeepsMultiplayerGamesTheSame)
+{
+	EXPECT_EQ(PlayMonsterLevel(true, true), PlayMonsterLevel(false, true));
+}
+
+/**
+ * @brief Runs the monsters of a full level that all have the same AI and can't see the player for a while.
+ *
+ * The state that doesn't keep a monster from being dormant is made up, so that the AI is run with more than the state
+ * of a monster that was just placed.
+ * @return A hash of the monsters after every tick.
+ */
+uint64_t IdleMonsterLevel(_mai_id ai, bool skipDormantMonsters)
+{
+	SetDormantMonstersSkipped(skipDormantMonsters);
+	CreateMonsterLevel();
+	for (int x = 0; x < MAXDUNX; x++) {
+		for (int y = 0; y < MAXDUNY; y++)
+			dFlags[x][y] &= ~DungeonFlag::Visible;
+	}
+	SetRndSeed(ai);
+	for (int i = 0; i < ActiveMonsterCount; i++) {
+		Monster &monster = Monsters[ActiveMonsters[i]];
+		monster._mAi = ai;
+		monster._mhitpoints = std::max(GenerateRnd(monster._mmaxhp) + 1, 64);
+		monster._mgoal = static_cast<monster_goal>(GenerateRnd(MGOAL_TALKING + 1));
+		monster._mgoalvar1 = GenerateRnd(8);
+		monster._mgoalvar2 = GenerateRnd(8);
+		monster._mgoalvar3 = GenerateRnd(8);
+		monster._mVar1 = GenerateRnd(8);
+		monster._mVar2 = GenerateRnd(8);
+		monster._mVar3 = GenerateRnd(8);
+	}
+
+	uint64_t hash = 14695981039346656037U;
+	for (int tick = 0; tick < 100; tick++) {
+		ProcessMonsters();
+		hash = HashMonsters(hash);
+	}
+
+	SetDormantMonstersSkipped(true);
+	return hash;
+}
+
+TEST(Monster, AisIdleWhenNotAlertedDoNothingForMonstersThatArentAlerted)
+{
+	for (int ai = 0; ai <= AI_BONEDEMON; ai++) {
+		if (!IsAiIdleWhenNotAlerted(static_cast<_mai_id>(ai)))
+			continue;
+		EXPECT_EQ(IdleMonsterLevel(static_cast<_mai_id>(ai), true), IdleMonsterLevel(static_cast<_mai_id>(ai), false)) << "AI " << ai;
+	}
+}
+
+} // namespace
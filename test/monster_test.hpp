@@ -0,0 +1,87 @@
+/**
+ * @file monster_test.hpp
+ *
+ * Helpers for monster related tests.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "diablo.h"
+#include "engine/random.hpp"
+#include "level_test.hpp"
+#include "levels/gendung.h"
+#include "lighting.h"
+#include "monster.h"
+#include "player.h"
+
+using namespace devilution;
+
+/**
+ * @brief Adds a monster type with the frame counts of its animations, but without loading its graphics or sounds.
+ */
+int AddMonsterTypeWithoutGraphics(_monster_id type)
+{
+	const int index = LevelMonsterTypeCount++;
+	CMonster &monsterType = LevelMonsterTypes[index];
+	monsterType.mtype = type;
+	monsterType.MData = &MonstersData[type];
+	for (size_t i = 0; i < 6; i++) {
+		monsterType.Anims[i].Frames = monsterType.MData->Frames[i];
+		monsterType.Anims[i].Rate = monsterType.MData->Rate[i];
+	}
+	return index;
+}
+
+/**
+ * @brief Fills a cathedral level, with made up pieces of which about a third are walls, with as many monsters as
+ * there can be.
+ *
+ * The player stands in the middle of the level and can't be hurt, so that the monsters that see them keep fighting.
+ */
+void CreateMonsterLevel()
+{
+	currlevel = 1;
+	gbIsMultiplayer = false;
+	CreateFakeTileLevel(TileProperties::Solid | TileProperties::BlockLight, 68685319);
+	memset(dMonster, 0, sizeof(dMonster));
+	memset(dPlayer, 0, sizeof(dPlayer));
+
+	Player &myPlayer = *MyPlayer;
+	myPlayer.plractive = true;
+	myPlayer.plrlevel = currlevel;
+	myPlayer._pmode = PM_STAND;
+	myPlayer._pHitPoints = 100 << 6;
+	myPlayer._pMaxHP = 100 << 6;
+	myPlayer._pInvincible = true;
+	myPlayer.position.tile = ViewPosition;
+	myPlayer.position.future = ViewPosition;
+	dPlayer[ViewPosition.x][ViewPosition.y] = MyPlayerId + 1;
+
+	InitVision();
+	myPlayer._pvid = AddVision(ViewPosition, 10, true);
+	ProcessVisionList();
+
+	// InitGolems leaves the rest of the golem slots as the last level left them, so every level starts from blank ones.
+	for (Monster &monster : Monsters)
+		monster = {};
+	InitLevelMonsters();
+	AddMonsterTypeWithoutGraphics(MT_GOLEM);
+	InitGolems();
+	const int types[] = {
+		AddMonsterTypeWithoutGraphics(MT_NZOMBIE),
+		AddMonsterTypeWithoutGraphics(MT_RFALLSP),
+		AddMonsterTypeWithoutGraphics(MT_WSKELAX),
+		AddMonsterTypeWithoutGraphics(MT_NSCAV),
+	};
+
+	SetRndSeed(1);
+	while (ActiveMonsterCount < MAXMONSTERS) {
+		const Point position { GenerateRnd(DMAXX * 2 - 32) + 16, GenerateRnd(DMAXY * 2 - 32) + 16 };
+		if (IsTileOccupied(position))
+			continue;
+		AddMonster(position, static_cast<Direction>(GenerateRnd(8)), types[GenerateRnd(4)], true);
+	}
+}
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "encrypt.h"
+#include "mpq/mpq_reader.hpp"
+#include "mpq/mpq_writer.hpp"
+
+using namespace devilution;
+
+namespace {
+
+constexpr uint32_t SectorSize = 4096;
+
+std::string GetTmpPathName()
+{
+	const auto *currentTest = ::testing::UnitTest::GetInstance()->current_test_info();
+	std::string result = "Test_";
+	result.append(currentTest->test_case_name());
+	result += '_';
+	result.append(currentTest->name());
+	result.append(".mpq");
+	return result;
+}
+
+/**
+ * @brief Returns a sector of zeroes followed by noise, where the length of the zeroes is chosen so that
+ * deflate shrinks the sector by exactly `saved` bytes.
+ */
+std::vector<byte> MakeSectorThatShrinksBy(uint32_t saved)
+{
+	std::vector<byte> noise(SectorSize);
+	uint32_t seed = 7;
+	for (auto &value : noise) {
+		seed = seed * 1103515245 + 12345;
+		value = static_cast<byte>(seed >> 16);
+	}
+
+	for (uint32_t zeroes = 0; zeroes < SectorSize; zeroes++) {
+		std::vector<byte> sector(SectorSize);
+		std::copy(noise.begin(), noise.end() - zeroes, sector.begin() + zeroes);
+		std::vector<byte> compressed = sector;
+		if (ZlibCompress(compressed.data(), SectorSize, SectorSize) == SectorSize - saved)
+			return sector;
+	}
+	return {};
+}
+
+void ExpectRoundTrip(CompressionType compression, const std::vector<byte> &original)
+{
+	const std::string path = GetTmpPathName();
+	std::remove(path.c_str());
+	{
+		MpqWriter writer(path.c_str(), compression);
+		ASSERT_TRUE(writer.WriteFile("hero", original.data(), original.size()));
+	}
+
+	int32_t error;
+	std::optional<MpqArchive> archive = MpqArchive::Open(path.c_str(), error);
+	ASSERT_TRUE(archive);
+	size_t size;
+	std::unique_ptr<byte[]> data = archive->ReadFile("hero", size, error);
+	ASSERT_EQ(error, 0);
+	ASSERT_EQ(size, original.size());
+	EXPECT_EQ(memcmp(data.get(), original.data(), size), 0);
+
+	archive = std::nullopt;
+	std::remove(path.c_str());
+}
+
+} // namespace
+
+TEST(MpqWriter, RoundTripsSectorsThatBarelyShrink)
+{
+	// One byte saved is eaten by the compression byte of the sector, two bytes saved are not.
+	for (uint32_t saved : { 1, 2 }) {
+		SCOPED_TRACE(saved);
+		const std::vector<byte> sector = MakeSectorThatShrinksBy(saved);
+		ASSERT_EQ(sector.size(), SectorSize);
+		ExpectRoundTrip(CompressionType::Zlib, sector);
+	}
+}
+
+TEST(MpqWriter, RoundTripsSeveralSectors)
+{
+	std::vector<byte> original(3 * SectorSize + 100);
+	for (size_t i = 0; i < original.size(); i++)
+		original[i] = static_cast<byte>(i % 7 == 0 ? i / 7 : 0);
+	for (CompressionType compression : { CompressionType::Implode, CompressionType::Zlib }) {
+		SCOPED_TRACE(static_cast<int>(compression));
+		ExpectRoundTrip(compression, original);
+	}
+}
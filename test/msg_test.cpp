@@ -0,0 +1,31 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include "encrypt.h"
+#include "msg.h"
+
+using namespace devilution;
+
+namespace {
+
+uint32_t SendLevelData(_cmd_id cmd, const byte *body, uint16_t size)
+{
+	byte packet[sizeof(TCmdPlrInfoHdr) + 16] {};
+	const TCmdPlrInfoHdr header { cmd, 0, size };
+	memcpy(packet, &header, sizeof(header));
+	if (size != 0)
+		memcpy(packet + sizeof(header), body, size);
+	return ParseCmd(1, reinterpret_cast<const TCmd *>(packet));
+}
+
+TEST(Msg, DiscardsInvalidLevelDelta)
+{
+	// An LZ4 chunk whose literals run past the end of the data.
+	const byte delta[] { static_cast<byte>(CompressionType::Lz4), byte { 0xF0 }, byte { 0xFF }, byte { 0x01 } };
+	EXPECT_EQ(SendLevelData(CMD_DLEVEL, delta, sizeof(delta)), sizeof(TCmdPlrInfoHdr) + sizeof(delta));
+	// The end of the level data makes the client import the chunk, which it drops instead of closing the game.
+	EXPECT_EQ(SendLevelData(CMD_DLEVEL_END, nullptr, 0), sizeof(TCmdPlrInfoHdr));
+}
+
+} // namespace
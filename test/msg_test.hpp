@@ -0,0 +1,75 @@
+/**
+ * @file msg_test.hpp
+ *
+ * Helpers for tests of the network messages.
+ */
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "diablo.h"
+#include "engine/random.hpp"
+#include "items.h"
+#include "levels/gendung.h"
+#include "monster.h"
+#include "msg.h"
+#include "player.h"
+#include "utils/paths.h"
+
+using namespace devilution;
+
+/**
+ * @brief Packs the delta of a cleared level the way it is sent to players joining the game, before it is compressed.
+ *
+ * The catacombs level of the seed is generated, then most of its monsters are killed and items are dropped on its floor.
+ */
+std::vector<byte> MakeLevelDelta(uint32_t seed)
+{
+	paths::SetPrefPath(paths::BasePath());
+	paths::SetAssetsPath(paths::BasePath() + "/test/fixtures/");
+	currlevel = 5;
+	leveltype = GetLevelType(currlevel);
+	// The layouts don't depend on the tiles.
+	pMegaTiles = std::make_unique<MegaTile[]>(256);
+	CreateDungeon(seed, ENTRY_MAIN);
+
+	std::vector<Point> floor;
+	for (int y = 0; y < MAXDUNY; y++) {
+		for (int x = 0; x < MAXDUNX; x++) {
+			if (dTransVal[x][y] != 0)
+				floor.push_back({ x, y });
+		}
+	}
+	std::vector<int> baseItems;
+	for (int idx = 0; idx <= IDI_LAST; idx++) {
+		if (AllItemsList[idx].iRnd != IDROP_NEVER)
+			baseItems.push_back(idx);
+	}
+
+	gbIsMultiplayer = true;
+	MyPlayerId = 0;
+	MyPlayer = &Players[MyPlayerId];
+	MyPlayer->plrlevel = currlevel;
+	MyPlayer->plrIsOnSetLevel = false;
+	delta_init();
+
+	SetRndSeed(seed);
+	for (int mi = 0; mi < 120; mi++) {
+		Monsters[mi]._mdir = static_cast<Direction>(GenerateRnd(8));
+		delta_kill_monster(mi, floor[GenerateRnd(static_cast<int>(floor.size()))], *MyPlayer);
+	}
+	for (int i = 0; i < 40; i++) {
+		Item &item = Items[0];
+		item = {};
+		SetupAllItems(item, baseItems[GenerateRnd(static_cast<int>(baseItems.size()))], AdvanceRndSeed(), 2 * currlevel, 1, false, false, false);
+		item.position = floor[GenerateRnd(static_cast<int>(floor.size()))];
+		DeltaAddItem(0);
+	}
+
+	uint32_t size;
+	const std::unique_ptr<byte[]> packed = DeltaExportLevel(GetLevelForMultiplayer(*MyPlayer), &size);
+	delta_init();
+	gbIsMultiplayer = false;
+	return { &packed[1], &packed[1 + size] };
+}
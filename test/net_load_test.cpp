@@ -0,0 +1,424 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include <asio/post.hpp>
+#include <asio/ts/io_context.hpp>
+
+#include <SDL.h>
+
+#include "dvlnet/tcp_client.h"
+#include "dvlnet/tcp_relay.h"
+#include "msg.h"
+#include "multi.h"
+#include "net_test.hpp"
+#include "options.h"
+#include "utils/endian.hpp"
+
+using namespace devilution;
+
+namespace {
+
+constexpr int NumClients = MAX_PLRS;
+constexpr uint16_t Port = 46112;
+constexpr uint16_t RelayPort = 46120;
+constexpr uint32_t TurnDuration = 20;
+constexpr uint32_t TurnsToPlay = 150;
+
+uint32_t Fnv1a(const void *data, size_t size)
+{
+	uint32_t hash = 2166136261U;
+	const auto *bytes = static_cast<const uint8_t *>(data);
+	for (size_t i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= 16777619U;
+	}
+	return hash;
+}
+
+struct LoadStats {
+	uint64_t bytesSent = 0;
+	uint64_t packetsSent = 0;
+	uint64_t messagesReceived = 0;
+	uint64_t turnLatencySum = 0;
+	uint32_t turnLatencyMax = 0;
+	uint32_t turnsReceived = 0;
+};
+
+/**
+ * @brief A headless TCP client that plays a scripted session instead of running the game.
+ *
+ * Every turn it sends a `TPkt` filled with the same commands the `NetSendCmd*` functions
+ * produce for a player that keeps walking and attacking, followed by its turn.
+ */
+class LoadTestClient;
+using Clients = std::vector<std::unique_ptr<LoadTestClient>>;
+
+class LoadTestClient : public net::tcp_client {
+public:
+	using tcp_client::IsGameHost;
+
+	void send(net::packet &pkt) override
+	{
+		stats.bytesSent += pkt.Data().size();
+		stats.packetsSent++;
+		tcp_client::send(pkt);
+	}
+
+	net::plr_t Id() const
+	{
+		return plr_self;
+	}
+
+	/** @brief Receives the messages, then keeps one turn in transit and plays the turns of everyone when they are due. */
+	void Step(const Clients &clients)
+	{
+		ReceiveMessages();
+
+		std::optional<PlayedTurns> played = turnLoop.Step(*this, 1, [this]() { SendScriptedTurn(); });
+		if (!played)
+			return;
+
+		for (int i = 0; i < MAX_PLRS; i++) {
+			if (played->values[i] < 0)
+				continue;
+			uint32_t latency = played->time - clients[i]->turnSentAt[played->values[i]];
+			stats.turnLatencySum += latency;
+			stats.turnLatencyMax = std::max(stats.turnLatencyMax, latency);
+			stats.turnsReceived++;
+		}
+		playedTurns.push_back(played->values);
+	}
+
+	void ReceiveMessages()
+	{
+		int sender;
+		void *data;
+		uint32_t size;
+		while (SNetReceiveMessage(&sender, &data, &size)) {
+			receivedMessages[sender].push_back(Fnv1a(data, size));
+			stats.messagesReceived++;
+		}
+	}
+
+	/** @brief Forgets what was sent and received so far, to check a new session against the players that are left. */
+	void ForgetSession()
+	{
+		turnSentAt.clear();
+		sentMessages.clear();
+		for (std::vector<uint32_t> &messages : receivedMessages)
+			messages.clear();
+		playedTurns.clear();
+	}
+
+	LoadStats stats;
+	std::vector<uint32_t> turnSentAt;
+	std::vector<uint32_t> sentMessages;
+	std::vector<uint32_t> receivedMessages[MAX_PLRS];
+	std::vector<std::array<int32_t, MAX_PLRS>> playedTurns;
+
+private:
+	template <typename T>
+	void AppendCommand(TPkt &pkt, size_t &offset, const T &cmd)
+	{
+		memcpy(&pkt.body[offset], &cmd, sizeof(cmd));
+		offset += sizeof(cmd);
+	}
+
+	void SendScriptedTurn()
+	{
+		auto turn = static_cast<int32_t>(turnSentAt.size());
+		const auto x = static_cast<uint8_t>(16 + (turn + 7 * plr_self) % 64);
+		const auto y = static_cast<uint8_t>(16 + (turn / 3) % 64);
+
+		TPkt pkt {};
+		pkt.hdr.wCheck = LoadBE32("\0\0ip");
+		pkt.hdr.px = x;
+		pkt.hdr.py = y;
+		pkt.hdr.php = 100 << 6;
+		pkt.hdr.pmhp = 100 << 6;
+		size_t offset = 0;
+		AppendCommand(pkt, offset, TCmdLoc { CMD_WALKXY, x, y });
+		if (turn % 4 == 0)
+			AppendCommand(pkt, offset, TCmdLoc { CMD_SATTACKXY, static_cast<uint8_t>(x + 1), y });
+		if (turn % 10 == 0)
+			AppendCommand(pkt, offset, TCmdLocParam1 { CMD_RATTACKXY, x, static_cast<uint8_t>(y + 1), static_cast<uint16_t>(turn) });
+		const size_t length = sizeof(pkt.hdr) + offset;
+		pkt.hdr.wLen = static_cast<uint16_t>(length);
+
+		SNetSendMessage(SNPLAYER_OTHERS, &pkt, static_cast<unsigned>(length));
+		sentMessages.push_back(Fnv1a(&pkt, length));
+		turnSentAt.push_back(SDL_GetTicks());
+		SNetSendTurn(reinterpret_cast<char *>(&turn), sizeof(turn));
+	}
+
+	TurnLoop turnLoop { TurnDuration };
+};
+
+std::unique_ptr<LoadTestClient> MakeClient()
+{
+	auto client = std::make_unique<LoadTestClient>();
+	client->clear_password();
+	return client;
+}
+
+/**
+ * @brief Steps all clients of all games until everyone played `TurnsToPlay` turns.
+ * @return The elapsed time in milliseconds, 0 on timeout.
+ */
+uint32_t PlaySession(const std::vector<Clients *> &games)
+{
+	const uint32_t start = SDL_GetTicks();
+	const uint32_t timeout = start + 20000;
+	auto isPlaying = [](const auto &client) { return client->playedTurns.size() < TurnsToPlay; };
+	while (std::any_of(games.begin(), games.end(), [&](const Clients *clients) { return std::any_of(clients->begin(), clients->end(), isPlaying); })) {
+		if (SDL_GetTicks() >= timeout)
+			return 0;
+		for (const Clients *clients : games) {
+			for (auto &client : *clients)
+				client->Step(*clients);
+		}
+		SDL_Delay(1);
+	}
+	for (const Clients *clients : games) {
+		for (auto &client : *clients)
+			client->ReceiveMessages();
+	}
+	return std::max<uint32_t>(SDL_GetTicks() - start, 1);
+}
+
+void ExpectInSync(const Clients &clients)
+{
+	for (auto &client : clients) {
+		SCOPED_TRACE(client->Id());
+		for (size_t i = 0; i < clients.size(); i++) {
+			if (i == client->Id())
+				continue;
+			// Every message arrived unchanged and in order.
+			const std::vector<uint32_t> &received = client->receivedMessages[i];
+			const std::vector<uint32_t> &sent = clients[i]->sentMessages;
+			ASSERT_LE(received.size(), sent.size());
+			EXPECT_GE(received.size(), TurnsToPlay);
+			EXPECT_TRUE(std::equal(received.begin(), received.end(), sent.begin()));
+		}
+
+		// Everyone played the same turns, which is what keeps the game simulations in sync.
+		const auto &expected = clients[0]->playedTurns;
+		const auto &played = client->playedTurns;
+		size_t common = std::min(played.size(), expected.size());
+		EXPECT_TRUE(std::equal(played.begin(), played.begin() + common, expected.begin()));
+		for (const auto &turn : played)
+			EXPECT_TRUE(std::none_of(turn.begin(), turn.begin() + clients.size(), [](int32_t value) { return value < 0; }));
+	}
+}
+
+/** @brief Runs the relay on its own thread, like the standalone relay server does. */
+class RelayThread {
+public:
+	RelayThread(uint16_t roomCount)
+	    : relay(ioc, "127.0.0.1", RelayPort, roomCount, pktfty)
+	    , thread([this]() { ioc.run(); })
+	{
+	}
+
+	/** @brief Number of packets a room has received so far, read on the relay's thread. */
+	uint64_t PacketsReceived(uint16_t room)
+	{
+		std::promise<uint64_t> count;
+		asio::post(ioc, [&]() { count.set_value(relay.Room(room).Stats().packetsReceived); });
+		return count.get_future().get();
+	}
+
+	/** @brief Number of players in a room, read on the relay's thread. */
+	size_t PlayerCount(uint16_t room)
+	{
+		std::promise<size_t> count;
+		asio::post(ioc, [&]() { count.set_value(relay.Room(room).PlayerCount()); });
+		return count.get_future().get();
+	}
+
+	/** @brief Stops the relay, its rooms may only be inspected afterwards. */
+	void Stop()
+	{
+		if (!thread.joinable())
+			return;
+		ioc.stop();
+		thread.join();
+	}
+
+	~RelayThread()
+	{
+		Stop();
+	}
+
+	net::packet_factory pktfty;
+	asio::io_context ioc;
+	net::tcp_relay relay;
+
+private:
+	std::thread thread;
+};
+
+} // namespace
+
+TEST(NetLoad, HeadlessClientsOverLocalhost)
+{
+	sgOptions.Network.port.SetValue(Port);
+
+	Clients clients;
+	clients.push_back(MakeClient());
+	clients[0]->setup_gameinfo(net::buffer_t(sizeof(GameData)));
+	ASSERT_EQ(clients[0]->create("127.0.0.1"), 0) << SDL_GetError();
+
+	// The server lives in the host's io_context, so the host has to keep polling while the others join.
+	for (int i = 1; i < NumClients; i++) {
+		auto client = MakeClient();
+		std::atomic<bool> joined { false };
+		int id = -1;
+		std::thread joiner([&]() {
+			id = client->join("127.0.0.1");
+			joined = true;
+		});
+		while (!joined) {
+			clients[0]->poll();
+			SDL_Delay(1);
+		}
+		joiner.join();
+		ASSERT_EQ(id, i) << SDL_GetError();
+		clients.push_back(std::move(client));
+	}
+
+	const uint32_t elapsed = PlaySession({ &clients });
+	ASSERT_NE(elapsed, 0);
+	ExpectInSync(clients);
+
+	LoadStats total;
+	for (auto &client : clients) {
+		total.bytesSent += client->stats.bytesSent;
+		total.packetsSent += client->stats.packetsSent;
+		total.messagesReceived += client->stats.messagesReceived;
+		total.turnLatencySum += client->stats.turnLatencySum;
+		total.turnLatencyMax = std::max(total.turnLatencyMax, client->stats.turnLatencyMax);
+		total.turnsReceived += client->stats.turnsReceived;
+	}
+
+	// Recorded in the XML report so that CI can track the numbers over time.
+	const auto bytesPerSecond = static_cast<int>(total.bytesSent * 1000 / elapsed);
+	const auto packetsPerSecond = static_cast<int>(total.packetsSent * 1000 / elapsed);
+	const auto messagesPerSecond = static_cast<int>(total.messagesReceived * 1000 / elapsed);
+	const auto averageTurnLatency = static_cast<int>(total.turnLatencySum / std::max<uint32_t>(total.turnsReceived, 1));
+	RecordProperty("BytesPerSecond", bytesPerSecond);
+	RecordProperty("PacketsPerSecond", packetsPerSecond);
+	RecordProperty("MessagesPerSecond", messagesPerSecond);
+	RecordProperty("AverageTurnLatencyMs", averageTurnLatency);
+	RecordProperty("MaxTurnLatencyMs", static_cast<int>(total.turnLatencyMax));
+	std::cout << NumClients << " clients, " << TurnsToPlay << " turns in " << elapsed << "ms: "
+	          << bytesPerSecond << " bytes/s, " << packetsPerSecond << " packets/s, "
+	          << messagesPerSecond << " messages/s, turn latency " << averageTurnLatency
+	          << "ms average, " << total.turnLatencyMax << "ms max" << std::endl;
+
+	// The joined clients disconnect before the host takes the server down.
+	while (clients.size() > 1)
+		clients.pop_back();
+}
+
+TEST(NetLoad, RelayRooms)
+{
+	constexpr uint16_t RoomCount = 3;
+	constexpr int PlayersPerRoom = 2;
+
+	RelayThread relayThread(RoomCount);
+	std::vector<Clients> games(RoomCount);
+	for (uint16_t room = 0; room < RoomCount; room++) {
+		sgOptions.Network.port.SetValue(RelayPort + room);
+		for (int i = 0; i < PlayersPerRoom; i++) {
+			auto client = MakeClient();
+			// The first player to join an empty room creates the game.
+			if (i == 0)
+				client->setup_gameinfo(net::buffer_t(sizeof(GameData), room));
+			ASSERT_EQ(client->join("127.0.0.1"), i) << SDL_GetError();
+			games[room].push_back(std::move(client));
+		}
+	}
+
+	std::vector<Clients *> sessions;
+	for (Clients &clients : games)
+		sessions.push_back(&clients);
+	ASSERT_NE(PlaySession(sessions), 0);
+
+	// The packets of the last turns may still be on their way to the relay.
+	const uint32_t timeout = SDL_GetTicks() + 1000;
+	for (uint16_t room = 0; room < RoomCount; room++) {
+		uint64_t packetsSent = 0;
+		for (auto &client : games[room])
+			packetsSent += client->stats.packetsSent;
+		while (relayThread.PacketsReceived(room) < packetsSent && SDL_GetTicks() < timeout) {
+			for (auto &client : games[room])
+				client->ReceiveMessages();
+			SDL_Delay(1);
+		}
+	}
+	relayThread.Stop();
+
+	for (uint16_t room = 0; room < RoomCount; room++) {
+		SCOPED_TRACE(room);
+		ExpectInSync(games[room]);
+
+		// Each room only relayed the packets of its own game.
+		const net::tcp_server &server = relayThread.relay.Room(room);
+		const net::server_stats &stats = server.Stats();
+		EXPECT_EQ(server.PlayerCount(), PlayersPerRoom);
+		EXPECT_EQ(stats.playersJoined, PlayersPerRoom);
+		EXPECT_EQ(stats.playersDropped, 0);
+		uint64_t packetsSent = 0;
+		for (auto &client : games[room])
+			packetsSent += client->stats.packetsSent;
+		EXPECT_EQ(stats.packetsReceived, packetsSent);
+	}
+	EXPECT_EQ(relayThread.relay.FormatStats().size(), RoomCount);
+}
+
+TEST(NetLoad, RelayHostLeaves)
+{
+	RelayThread relayThread(1);
+	sgOptions.Network.port.SetValue(RelayPort);
+
+	Clients clients;
+	clients.push_back(MakeClient());
+	clients[0]->setup_gameinfo(net::buffer_t(sizeof(GameData), 1));
+	ASSERT_EQ(clients[0]->join("127.0.0.1"), 0) << SDL_GetError();
+	clients.push_back(MakeClient());
+	ASSERT_EQ(clients[1]->join("127.0.0.1"), 1) << SDL_GetError();
+	EXPECT_TRUE(clients[0]->IsGameHost());
+	EXPECT_FALSE(clients[1]->IsGameHost());
+
+	// The guest learns the turn sequence from the host before the host leaves.
+	while (clients[1]->playedTurns.size() < 10) {
+		for (auto &client : clients)
+			client->Step(clients);
+		SDL_Delay(1);
+	}
+	clients[0] = nullptr;
+	clients[1]->ForgetSession();
+	const uint32_t timeout = SDL_GetTicks() + 1000;
+	while (relayThread.PlayerCount(0) != 1 && SDL_GetTicks() < timeout)
+		SDL_Delay(1);
+
+	// The next player gets the slot of the host, but joins the game of the guest instead of hosting one.
+	clients[0] = MakeClient();
+	ASSERT_EQ(clients[0]->join("127.0.0.1"), 0) << SDL_GetError();
+	EXPECT_FALSE(clients[0]->IsGameHost());
+
+	ASSERT_NE(PlaySession({ &clients }), 0);
+	ExpectInSync(clients);
+}
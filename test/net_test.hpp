@@ -0,0 +1,74 @@
+/**
+ * @file net_test.hpp
+ *
+ * Helpers for tests of the multiplayer networking that run peers without the game.
+ */
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+#include <SDL.h>
+
+#include "dvlnet/abstract_net.h"
+#include "multi.h"
+
+using namespace devilution;
+
+/** @brief The turns played at once, one for each player. */
+struct PlayedTurns {
+	uint32_t time;
+	/** @brief The value of the turn of each player, -1 for the players whose turn didn't arrive. */
+	std::array<int32_t, MAX_PLRS> values;
+};
+
+/**
+ * @brief Drives the turns of a peer the way `multi_handle_delta` does for the game.
+ *
+ * The turns are sent and played as 32-bit values.
+ */
+class TurnLoop {
+public:
+	explicit TurnLoop(uint32_t turnDuration)
+	    : turnDuration_(turnDuration)
+	{
+	}
+
+	/**
+	 * @brief Runs one iteration of the turn loop.
+	 *
+	 * Sends turns until `turnsInTransit` of them are on their way, then plays the turns of everyone once the next turn is
+	 * due and all of them arrived.
+	 * @param sendTurn Sends the next turn of the peer.
+	 * @return The turns played, if any.
+	 */
+	template <typename SendTurn>
+	std::optional<PlayedTurns> Step(net::abstract_net &net, uint32_t turnsInTransit, SendTurn sendTurn)
+	{
+		uint32_t turnsSent;
+		net.SNetGetTurnsInTransit(&turnsSent);
+		while (turnsSent++ < turnsInTransit)
+			sendTurn();
+
+		const uint32_t now = SDL_GetTicks();
+		if (static_cast<int32_t>(now - nextTurnTime_) < 0)
+			return std::nullopt;
+
+		char *data[MAX_PLRS];
+		size_t size[MAX_PLRS];
+		uint32_t status[MAX_PLRS];
+		if (!net.SNetReceiveTurns(data, size, status))
+			return std::nullopt;
+
+		nextTurnTime_ = now + turnDuration_;
+		PlayedTurns played { now, {} };
+		for (int i = 0; i < MAX_PLRS; i++)
+			played.values[i] = (status[i] & PS_TURN_ARRIVED) != 0 ? *reinterpret_cast<int32_t *>(data[i]) : -1;
+		return played;
+	}
+
+private:
+	uint32_t turnDuration_;
+	uint32_t nextTurnTime_ = 0;
+};
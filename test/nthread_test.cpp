@@ -0,0 +1,295 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <SDL.h>
+
+#include "dvlnet/base.h"
+#include "multi.h"
+#include "net_test.hpp"
+#include "nthread.h"
+
+using namespace devilution;
+
+TEST(TurnScheduler, LowLatencyKeepsMinimum)
+{
+	TurnScheduler scheduler;
+	scheduler.Reset(1);
+	EXPECT_EQ(scheduler.Update(20, 2, 400), 1);
+	EXPECT_EQ(scheduler.Update(0, 0, 400), 1);
+}
+
+TEST(TurnScheduler, RaisesImmediately)
+{
+	TurnScheduler scheduler;
+	scheduler.Reset(1);
+	// Half a round trip plus four times the jitter: 300 + 4 * 60 = 540ms, so two 400ms turns.
+	EXPECT_EQ(scheduler.Update(600, 60, 400), 2);
+	EXPECT_EQ(scheduler.Update(2000, 500, 400), TurnScheduler::MaxTurnsInTransit);
+}
+
+TEST(TurnScheduler, LowersAfterStableTurns)
+{
+	TurnScheduler scheduler;
+	scheduler.Reset(1);
+	ASSERT_EQ(scheduler.Update(1200, 100, 400), 3);
+	for (uint32_t i = 1; i < TurnScheduler::StableTurnsBeforeLowering; i++)
+		EXPECT_EQ(scheduler.Update(100, 10, 400), 3);
+	EXPECT_EQ(scheduler.Update(100, 10, 400), 2);
+	for (uint32_t i = 1; i < TurnScheduler::StableTurnsBeforeLowering; i++)
+		EXPECT_EQ(scheduler.Update(100, 10, 400), 2);
+	EXPECT_EQ(scheduler.Update(100, 10, 400), 1);
+}
+
+TEST(TurnScheduler, Hysteresis)
+{
+	TurnScheduler scheduler;
+	scheduler.Reset(1);
+	ASSERT_EQ(scheduler.Update(900, 0, 400), 2);
+	// 380ms of lead time would fit into one turn, but not with the headroom required for lowering.
+	for (uint32_t i = 0; i < 2 * TurnScheduler::StableTurnsBeforeLowering; i++)
+		EXPECT_EQ(scheduler.Update(760, 0, 400), 2);
+}
+
+TEST(TurnScheduler, SpikeResetsStableTurns)
+{
+	TurnScheduler scheduler;
+	scheduler.Reset(1);
+	ASSERT_EQ(scheduler.Update(900, 0, 400), 2);
+	for (uint32_t i = 1; i < TurnScheduler::StableTurnsBeforeLowering; i++)
+		scheduler.Update(100, 0, 400);
+	scheduler.Update(900, 0, 400);
+	EXPECT_EQ(scheduler.Update(100, 0, 400), 2);
+}
+
+TEST(TurnScheduler, NeverBelowMinimum)
+{
+	TurnScheduler scheduler;
+	scheduler.Reset(2);
+	EXPECT_EQ(scheduler.TurnsInTransit(), 2);
+	for (uint32_t i = 0; i < 3 * TurnScheduler::StableTurnsBeforeLowering; i++)
+		EXPECT_EQ(scheduler.Update(0, 0, 400), 2);
+}
+
+namespace {
+
+constexpr int NumPeers = 3;
+constexpr uint32_t TurnDuration = 20;
+
+/** Delivers packets between the simulated peers after an injected delay, in order per link. */
+class SimulatedNetwork {
+public:
+	SimulatedNetwork(uint32_t latency, uint32_t jitter)
+	    : latency_(latency)
+	    , jitter_(jitter)
+	{
+	}
+
+	void Send(net::plr_t source, net::plr_t destination, const net::buffer_t &data)
+	{
+		for (net::plr_t peer = 0; peer < NumPeers; peer++) {
+			if (peer == source || (destination != net::PLR_BROADCAST && destination != peer))
+				continue;
+			uint32_t &lastDelivery = lastDelivery_[source][peer];
+			uint32_t delivery = SDL_GetTicks() + latency_ + std::uniform_int_distribution<uint32_t>(0, jitter_)(rng_);
+			lastDelivery = std::max(lastDelivery, delivery);
+			inFlight_[peer].push_back({ lastDelivery, data });
+		}
+	}
+
+	std::vector<net::buffer_t> Receive(net::plr_t peer)
+	{
+		std::vector<net::buffer_t> received;
+		std::deque<Packet> &queue = inFlight_[peer];
+		uint32_t now = SDL_GetTicks();
+		// Packets are queued in delivery order for each link, so stop at the first one that is still in flight.
+		while (!queue.empty() && static_cast<int32_t>(now - queue.front().delivery) >= 0) {
+			received.push_back(std::move(queue.front().data));
+			queue.pop_front();
+		}
+		return received;
+	}
+
+private:
+	struct Packet {
+		uint32_t delivery;
+		net::buffer_t data;
+	};
+
+	uint32_t latency_;
+	uint32_t jitter_;
+	std::mt19937 rng_ { 42 };
+	std::deque<Packet> inFlight_[NumPeers];
+	uint32_t lastDelivery_[NumPeers][NumPeers] = {};
+};
+
+class SimulatedPeer : public net::base {
+public:
+	SimulatedPeer(SimulatedNetwork &network, net::plr_t id, bool adaptiveTurns)
+	    : adaptiveTurns_(adaptiveTurns)
+	    , network_(network)
+	{
+		clear_password();
+		GameData gameData {};
+		gameData.size = sizeof(gameData);
+		gameData.bAdaptiveTurns = adaptiveTurns ? 1 : 0;
+		const auto *bytes = reinterpret_cast<const unsigned char *>(&gameData);
+		setup_gameinfo(net::buffer_t(bytes, bytes + sizeof(gameData)));
+		plr_self = id;
+		scheduler.Reset(1);
+	}
+
+	int create(std::string addrstr) override
+	{
+		return plr_self;
+	}
+
+	int join(std::string addrstr) override
+	{
+		return plr_self;
+	}
+
+	void poll() override
+	{
+		for (net::buffer_t &data : network_.Receive(plr_self)) {
+			auto pkt = pktfty->make_packet(std::move(data));
+			RecvLocal(*pkt);
+		}
+	}
+
+	void send(net::packet &pkt) override
+	{
+		network_.Send(plr_self, pkt.Destination(), pkt.Data());
+	}
+
+	std::string make_default_gamename() override
+	{
+		return "";
+	}
+
+	void ConnectAll()
+	{
+		for (net::plr_t peer = 0; peer < NumPeers; peer++)
+			Connect(peer);
+	}
+
+	/** @brief Keeps as many turns in transit as the scheduler asks for and plays the turns of everyone when they are due. */
+	void Step()
+	{
+		std::optional<PlayedTurns> played = turnLoop_.Step(*this, scheduler.TurnsInTransit(), [this]() {
+			int32_t value = turnsSent++;
+			SNetSendTurn(reinterpret_cast<char *>(&value), sizeof(value));
+		});
+		if (!played)
+			return;
+
+		for (int i = 0; i < NumPeers; i++) {
+			if (played->values[i] >= 0)
+				received[i].push_back(played->values[i]);
+		}
+		turnsPlayed++;
+
+		uint32_t roundTripLatency;
+		uint32_t jitter;
+		if (adaptiveTurns_ && SNetGetLatency(&roundTripLatency, &jitter))
+			scheduler.Update(roundTripLatency, jitter, TurnDuration);
+	}
+
+	TurnScheduler scheduler;
+	int32_t turnsSent = 0;
+	uint32_t turnsPlayed = 0;
+	std::vector<int32_t> received[NumPeers];
+
+protected:
+	bool IsGameHost() override
+	{
+		return plr_self == 0;
+	}
+
+private:
+	bool adaptiveTurns_;
+	SimulatedNetwork &network_;
+	TurnLoop turnLoop_ { TurnDuration };
+};
+
+/**
+ * @brief Plays turns on peers connected through the network, until each of them played enough.
+ */
+void PlayTurns(SimulatedNetwork &network, std::vector<std::unique_ptr<SimulatedPeer>> &peers, bool adaptiveTurns)
+{
+	constexpr uint32_t TurnsToPlay = 50;
+
+	for (net::plr_t id = 0; id < NumPeers; id++)
+		peers.push_back(std::make_unique<SimulatedPeer>(network, id, adaptiveTurns));
+	for (auto &peer : peers)
+		peer->ConnectAll();
+
+	uint32_t timeout = SDL_GetTicks() + 10000;
+	while (std::any_of(peers.begin(), peers.end(), [](const auto &peer) { return peer->turnsPlayed < TurnsToPlay; })) {
+		ASSERT_LT(SDL_GetTicks(), timeout);
+		for (auto &peer : peers)
+			peer->Step();
+		SDL_Delay(1);
+	}
+}
+
+void ExpectSameTurnsPlayed(const std::vector<std::unique_ptr<SimulatedPeer>> &peers)
+{
+	for (auto &peer : peers) {
+		for (int i = 0; i < NumPeers; i++) {
+			// Every turn sent by a peer has been played by everyone, in order and without gaps.
+			const std::vector<int32_t> &turns = peer->received[i];
+			ASSERT_FALSE(turns.empty());
+			for (size_t j = 1; j < turns.size(); j++)
+				ASSERT_EQ(turns[j], turns[j - 1] + 1);
+		}
+	}
+
+	// Everyone played the same turns of each peer.
+	for (int i = 0; i < NumPeers; i++) {
+		const std::vector<int32_t> &expected = peers[0]->received[i];
+		for (auto &peer : peers) {
+			const std::vector<int32_t> &turns = peer->received[i];
+			size_t common = std::min(turns.size(), expected.size());
+			EXPECT_TRUE(std::equal(turns.begin(), turns.begin() + common, expected.begin()));
+		}
+	}
+}
+
+} // namespace
+
+TEST(TurnScheduler, StaysInSyncWithInjectedLatency)
+{
+	SimulatedNetwork network(40, 20);
+	std::vector<std::unique_ptr<SimulatedPeer>> peers;
+	PlayTurns(network, peers, true);
+
+	// The measured latency needs more than one turn in transit.
+	for (auto &peer : peers)
+		EXPECT_GT(peer->scheduler.TurnsInTransit(), 1);
+	ExpectSameTurnsPlayed(peers);
+}
+
+TEST(TurnScheduler, StaysInSyncWithoutAdaptiveTurns)
+{
+	SimulatedNetwork network(5, 2);
+	std::vector<std::unique_ptr<SimulatedPeer>> peers;
+	PlayTurns(network, peers, false);
+
+	for (auto &peer : peers) {
+		EXPECT_EQ(peer->scheduler.TurnsInTransit(), 1);
+		// Without adaptive turns, the peers don't ask each other for echoes.
+		uint32_t roundTripLatency;
+		uint32_t jitter;
+		EXPECT_FALSE(peer->SNetGetLatency(&roundTripLatency, &jitter));
+	}
+	ExpectSameTurnsPlayed(peers);
+}
@@ -0,0 +1,34 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "utils/palette_blending.hpp"
+
+using namespace devilution;
+
+namespace {
+
+/** @brief Generates the transparency table of a palette with shades of a few hues, like the level palettes. */
+void BM_GenerateBlendedLookupTable(benchmark::State &state)
+{
+	std::vector<SDL_Color> palette(256);
+	for (int i = 0; i < 256; i++) {
+		const int shade = (i % 16) * 16;
+		const int hue = i / 16;
+		palette[i].r = static_cast<uint8_t>(shade * ((hue & 1) + 1) / 2);
+		palette[i].g = static_cast<uint8_t>(shade * (((hue >> 1) & 1) + 1) / 2);
+		palette[i].b = static_cast<uint8_t>(shade * (((hue >> 2) & 3) + 1) / 4);
+	}
+
+	static uint8_t table[256][256];
+	for (auto _ : state) {
+		GenerateBlendedLookupTable(palette.data(), 1, 31, table);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * 256 * 255 / 2);
+}
+
+BENCHMARK(BM_GenerateBlendedLookupTable);
+
+} // namespace
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+#include "utils/palette_blending.hpp"
+
+using namespace devilution;
+
+namespace {
+
+/**
+ * @brief A palette of random colors, with a few repeated and near colors to exercise the tie breaking.
+ * @param spread Range of each channel, small values cluster the colors
+ */
+std::vector<SDL_Color> MakePalette(uint32_t seed, int spread)
+{
+	std::vector<SDL_Color> palette(256);
+	for (int i = 0; i < 256; i++) {
+		seed = seed * 1103515245 + 12345;
+		SDL_Color &color = palette[i];
+		if (i >= 8 && i % 16 == 0) {
+			color = palette[(seed >> 16) % i];
+			continue;
+		}
+		color.r = static_cast<uint8_t>((seed >> 8) % spread);
+		color.g = static_cast<uint8_t>((seed >> 16) % spread);
+		color.b = static_cast<uint8_t>((seed >> 24) % spread);
+#ifndef USE_SDL1
+		color.a = SDL_ALPHA_OPAQUE;
+#endif
+	}
+	return palette;
+}
+
+uint8_t FindBestMatchLinear(const std::vector<SDL_Color> &palette, SDL_Color color, int skipFrom, int skipTo)
+{
+	uint8_t best = 0;
+	uint32_t bestDiff = UINT32_MAX;
+	for (int i = 0; i < 256; i++) {
+		if (i >= skipFrom && i <= skipTo)
+			continue;
+		const int diffr = palette[i].r - color.r;
+		const int diffg = palette[i].g - color.g;
+		const int diffb = palette[i].b - color.b;
+		const auto diff = static_cast<uint32_t>(diffr * diffr + diffg * diffg + diffb * diffb);
+		if (bestDiff > diff) {
+			best = i;
+			bestDiff = diff;
+		}
+	}
+	return best;
+}
+
+} // namespace
+
+TEST(PaletteBlending, FindBestMatchMatchesLinearSearch)
+{
+	for (int spread : { 256, 64, 5 }) {
+		const std::vector<SDL_Color> palette = MakePalette(spread, spread);
+		for (const auto &skip : { std::pair<int, int> { -1, -1 }, std::pair<int, int> { 1, 31 }, std::pair<int, int> { 0, 254 } }) {
+			const PaletteColorIndex colorIndex(palette.data(), skip.first, skip.second);
+			for (int r = 0; r < 256; r += 3) {
+				for (int g = 1; g < 256; g += 5) {
+					for (int b = 2; b < 256; b += 7) {
+						SDL_Color color {};
+						color.r = r;
+						color.g = g;
+						color.b = b;
+						ASSERT_EQ(colorIndex.FindBestMatch(color), FindBestMatchLinear(palette, color, skip.first, skip.second))
+						    << "spread " << spread << ", skipping " << skip.first << "-" << skip.second << ", color " << r << " " << g << " " << b;
+					}
+				}
+			}
+		}
+	}
+}
+
+TEST(PaletteBlending, GenerateBlendedLookupTable)
+{
+	const std::vector<SDL_Color> palette = MakePalette(7, 256);
+	static uint8_t table[256][256];
+	GenerateBlendedLookupTable(palette.data(), 1, 15, table);
+
+	for (int i = 0; i < 256; i++) {
+		for (int j = 0; j < 256; j++) {
+			if (i == j) {
+				ASSERT_EQ(table[i][j], j);
+				continue;
+			}
+			SDL_Color blendedColor {};
+			blendedColor.r = (palette[i].r + palette[j].r) / 2;
+			blendedColor.g = (palette[i].g + palette[j].g) / 2;
+			blendedColor.b = (palette[i].b + palette[j].b) / 2;
+			ASSERT_EQ(table[i][j], FindBestMatchLinear(palette, blendedColor, 1, 15)) << i << ", " << j;
+		}
+	}
+}
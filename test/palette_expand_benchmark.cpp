@@ -0,0 +1,72 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+#include "utils/palette_expand.hpp"
+
+using namespace devilution;
+
+namespace {
+
+const int Resolutions[][2] = {
+	{ 640, 480 },
+	{ 1280, 720 },
+	{ 1920, 1080 },
+	{ 2560, 1440 },
+	{ 3840, 2160 },
+};
+
+PaletteLut MakeLut()
+{
+	PaletteLut lut;
+	for (int i = 0; i < 256; i++)
+		lut.SetEntry(static_cast<uint8_t>(i), 0xFF000000U | (i << 16) | (i << 8) | i);
+	return lut;
+}
+
+/**
+ * @brief Converts the whole screen, or with `dirtyPercent` below 100 only a centered
+ * rectangle of that share of the screen height, like a frame where only the game view changed.
+ */
+void BM_ExpandPalette(benchmark::State &state)
+{
+	const auto kernel = static_cast<PaletteExpandKernel>(state.range(0));
+	const int width = static_cast<int>(state.range(1));
+	const int height = static_cast<int>(state.range(2));
+	const int dirtyPercent = static_cast<int>(state.range(3));
+	if (!IsPaletteExpandKernelSupported(kernel)) {
+		state.SkipWithError("Kernel not supported");
+		return;
+	}
+
+	const PaletteLut lut = MakeLut();
+	std::vector<uint8_t> src(static_cast<size_t>(width) * height);
+	for (size_t i = 0; i < src.size(); i++)
+		src[i] = static_cast<uint8_t>(i * 31 + i / 7);
+	std::vector<uint32_t> dst(src.size());
+
+	const int dirtyHeight = height * dirtyPercent / 100;
+	const int y = (height - dirtyHeight) / 2;
+	for (auto _ : state) {
+		ExpandPalette(&src[y * width], width, &dst[y * width], width, width, dirtyHeight, lut, kernel);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * width * dirtyHeight);
+}
+
+void ExpandPaletteArguments(benchmark::internal::Benchmark *benchmark)
+{
+	for (PaletteExpandKernel kernel : { PaletteExpandKernel::Scalar, PaletteExpandKernel::Avx2, PaletteExpandKernel::Neon }) {
+		for (const auto &resolution : Resolutions) {
+			for (int dirtyPercent : { 100, 25 })
+				benchmark->Args({ static_cast<int>(kernel), resolution[0], resolution[1], dirtyPercent });
+		}
+	}
+	benchmark->ArgNames({ "kernel", "width", "height", "dirty%" });
+}
+
+BENCHMARK(BM_ExpandPalette)->Apply(ExpandPaletteArguments);
+
+} // namespace
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+#include "utils/palette_expand.hpp"
+
+using namespace devilution;
+
+namespace {
+
+PaletteLut MakeLut()
+{
+	PaletteLut lut;
+	for (int i = 0; i < 256; i++)
+		lut.SetEntry(static_cast<uint8_t>(i), 0xFF000000U | (i << 16) | ((255 - i) << 8) | (i * 7 % 256));
+	return lut;
+}
+
+std::vector<uint8_t> MakeIndices(size_t size)
+{
+	std::vector<uint8_t> indices(size);
+	uint32_t seed = 3;
+	for (auto &index : indices) {
+		seed = seed * 1103515245 + 12345;
+		index = static_cast<uint8_t>(seed >> 16);
+	}
+	return indices;
+}
+
+} // namespace
+
+TEST(PaletteExpand, ScalarMatchesLut)
+{
+	const PaletteLut lut = MakeLut();
+	const std::vector<uint8_t> src = MakeIndices(256);
+	std::vector<uint32_t> dst(256);
+	ExpandPalette(src.data(), src.size(), dst.data(), dst.size(), 256, 1, lut, PaletteExpandKernel::Scalar);
+	for (size_t i = 0; i < src.size(); i++)
+		EXPECT_EQ(dst[i], lut[src[i]]);
+}
+
+TEST(PaletteExpand, LutPlanes)
+{
+	PaletteLut lut;
+	lut.SetEntry(42, 0x11223344);
+	EXPECT_EQ(lut[42], 0x11223344);
+	EXPECT_EQ(lut.Plane(0)[42], 0x44);
+	EXPECT_EQ(lut.Plane(1)[42], 0x33);
+	EXPECT_EQ(lut.Plane(2)[42], 0x22);
+	EXPECT_EQ(lut.Plane(3)[42], 0x11);
+}
+
+TEST(PaletteExpand, KernelsMatchScalar)
+{
+	const PaletteLut lut = MakeLut();
+	constexpr int SrcPitch = 203;
+	constexpr int DstPitch = 211;
+	constexpr int Height = 9;
+	const std::vector<uint8_t> src = MakeIndices(SrcPitch * Height);
+
+	for (PaletteExpandKernel kernel : { PaletteExpandKernel::Avx2, PaletteExpandKernel::Neon }) {
+		if (!IsPaletteExpandKernelSupported(kernel))
+			continue;
+		SCOPED_TRACE(static_cast<int>(kernel));
+		// Widths around the vector sizes, and a rectangle that does not start at the beginning of a row.
+		for (int width : { 1, 7, 8, 15, 16, 17, 31, 33, 200 }) {
+			for (int x : { 0, 3 }) {
+				SCOPED_TRACE(width);
+				std::vector<uint32_t> expected(DstPitch * Height, 0xDEADBEEF);
+				std::vector<uint32_t> actual(DstPitch * Height, 0xDEADBEEF);
+				ExpandPalette(&src[x], SrcPitch, &expected[x], DstPitch, width, Height, lut, PaletteExpandKernel::Scalar);
+				ExpandPalette(&src[x], SrcPitch, &actual[x], DstPitch, width, Height, lut, kernel);
+				ASSERT_EQ(actual, expected);
+			}
+		}
+	}
+}
+
+TEST(PaletteExpand, BestKernelIsSupported)
+{
+	EXPECT_TRUE(IsPaletteExpandKernelSupported(GetBestPaletteExpandKernel()));
+	EXPECT_TRUE(IsPaletteExpandKernelSupported(PaletteExpandKernel::Scalar));
+}
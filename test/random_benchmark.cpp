@@ -0,0 +1,121 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include "engine/random.hpp"
+
+using namespace devilution;
+
+namespace {
+
+constexpr int RollsPerIteration = 100000;
+
+/** @brief The engine state of the vanilla functions before they had contexts. */
+uint32_t GlobalSeed;
+
+/** @brief AdvanceRndSeed() as it was before contexts, on a plain global. */
+int32_t AdvanceGlobalSeed()
+{
+	GlobalSeed = (0x015A4E35 * GlobalSeed) + 1;
+	const auto seed = static_cast<int32_t>(GlobalSeed);
+	return seed == std::numeric_limits<int32_t>::min() ? std::numeric_limits<int32_t>::min() : std::abs(seed);
+}
+
+/** @brief GenerateRnd() as it was before contexts, on a plain global. */
+int32_t GenerateRndFromGlobalSeed(int32_t v)
+{
+	if (v <= 0)
+		return 0;
+	if (v <= 0x7FFF)
+		return (AdvanceGlobalSeed() >> 16) % v;
+	return AdvanceGlobalSeed() % v;
+}
+
+/**
+ * @brief Rolls through a function that is hidden from the optimizer, so that each roll is a call as it is in the game.
+ */
+void RollThrough(benchmark::State &state, int32_t (*generate)(int32_t))
+{
+	benchmark::DoNotOptimize(generate);
+	for (auto _ : state) {
+		int32_t sum = 0;
+		for (int i = 0; i < RollsPerIteration; i++)
+			sum += generate(100);
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * RollsPerIteration);
+}
+
+/**
+ * @brief Rolls through the vanilla functions, which go through the current context of the thread.
+ */
+void BM_GenerateRnd(benchmark::State &state)
+{
+	SetRndSeed(1);
+	RollThrough(state, GenerateRnd);
+}
+
+BENCHMARK(BM_GenerateRnd);
+
+/**
+ * @brief Rolls on a plain global as the vanilla functions did before they had contexts, the baseline of BM_GenerateRnd.
+ */
+void BM_GenerateRndFromGlobalSeed(benchmark::State &state)
+{
+	GlobalSeed = 1;
+	RollThrough(state, GenerateRndFromGlobalSeed);
+}
+
+BENCHMARK(BM_GenerateRndFromGlobalSeed);
+
+/**
+ * @brief Rolls through a context directly, for the cost of looking the current context up.
+ */
+void BM_RandomContextGenerate(benchmark::State &state)
+{
+	RandomContext context { 1 };
+	for (auto _ : state) {
+		int32_t sum = 0;
+		for (int i = 0; i < RollsPerIteration; i++)
+			sum += context.Generate(100);
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * RollsPerIteration);
+}
+
+BENCHMARK(BM_RandomContextGenerate);
+
+/**
+ * @brief Rolls the sequences of several seeds at once, each thread through the vanilla functions in a context of its own.
+ */
+void BM_GenerateRndOnThreads(benchmark::State &state)
+{
+	const auto threadCount = static_cast<unsigned>(state.range(0));
+	std::vector<int32_t> sums(threadCount);
+	for (auto _ : state) {
+		std::vector<std::thread> threads;
+		threads.reserve(threadCount);
+		for (unsigned t = 0; t < threadCount; t++) {
+			threads.emplace_back([t, &sums]() {
+				RandomContext context { t };
+				RandomContextScope scope { context };
+				int32_t sum = 0;
+				for (int i = 0; i < RollsPerIteration; i++)
+					sum += GenerateRnd(100);
+				sums[t] = sum;
+			});
+		}
+		for (std::thread &thread : threads)
+			thread.join();
+		benchmark::DoNotOptimize(sums.data());
+	}
+	state.SetItemsProcessed(state.iterations() * RollsPerIteration * threadCount);
+}
+
+BENCHMARK(BM_GenerateRndOnThreads)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->ArgName("threads")->UseRealTime();
+
+} // namespace
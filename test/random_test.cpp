@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 
+#include <thread>
+
 #include "engine/random.hpp"
 
 namespace devilution {
@@ -237,4 +239,56 @@ TEST(RandomTest, ModDistributionSignPreserving)
 	    << "Distribution must map negative numbers using sign preserving modulo";
 }
 
+TEST(RandomTest, ContextMatchesVanillaFunctions)
+{
+	for (uint32_t seed : { 0U, 1U, 1457187811U, 3604671459U, 2147483648U }) {
+		RandomContext context { seed };
+		SetRndSeed(seed);
+		for (int i = 0; i < 1000; i++) {
+			ASSERT_EQ(context.Generate(i % 3 == 0 ? 100 : std::numeric_limits<int32_t>::max()), GenerateRnd(i % 3 == 0 ? 100 : std::numeric_limits<int32_t>::max()));
+			ASSERT_EQ(context.Advance(), AdvanceRndSeed());
+			ASSERT_EQ(context.GetState(), GetLCGEngineState());
+		}
+	}
+}
+
+TEST(RandomTest, ContextScopesNest)
+{
+	SetRndSeed(5);
+	{
+		RandomContext outer { 100 };
+		RandomContextScope outerScope { outer };
+		ASSERT_EQ(&GetCurrentRandomContext(), &outer);
+		ASSERT_EQ(GetLCGEngineState(), 100);
+		{
+			RandomContext inner { 200 };
+			RandomContextScope innerScope { inner };
+			AdvanceRndSeed();
+			ASSERT_EQ(inner.GetState(), 200 * 22695477U + 1);
+		}
+		ASSERT_EQ(GetLCGEngineState(), 100);
+		SetRndSeed(7);
+		ASSERT_EQ(outer.GetState(), 7);
+	}
+	ASSERT_EQ(GetLCGEngineState(), 5) << "Leaving the scopes must restore the global context";
+}
+
+TEST(RandomTest, ThreadsShareTheGlobalContext)
+{
+	SetRndSeed(5);
+	RandomContext *threadContext = nullptr;
+	uint32_t scopedState = 0;
+	std::thread thread([&]() {
+		threadContext = &GetCurrentRandomContext();
+		RandomContext context { 9 };
+		RandomContextScope scope { context };
+		AdvanceRndSeed();
+		scopedState = GetLCGEngineState();
+	});
+	thread.join();
+	ASSERT_EQ(threadContext, &GetCurrentRandomContext()) << "A new thread must start with the global context";
+	ASSERT_EQ(scopedState, 9 * 22695477U + 1);
+	ASSERT_EQ(GetLCGEngineState(), 5) << "A scope on another thread must not change the global context";
+}
+
 } // namespace devilution
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "utils/sdl_bilinear_scale.hpp"
+
+using namespace devilution;
+
+namespace {
+
+/** Pixels with opaque, transparent and partially transparent areas. */
+std::vector<uint8_t> MakeImage(int width, int height, int pitch)
+{
+	std::vector<uint8_t> pixels(pitch * (height + 1));
+	uint32_t seed = 11;
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x < width; x++) {
+			uint8_t *pixel = &pixels[y * pitch + x * 4];
+			seed = seed * 1103515245 + 12345;
+			pixel[0] = static_cast<uint8_t>(seed >> 16);
+			pixel[1] = static_cast<uint8_t>(seed >> 8);
+			pixel[2] = static_cast<uint8_t>(x * 255 / width);
+			if (x < width / 2)
+				pixel[3] = 255;
+			else if (y < height / 2)
+				pixel[3] = 0;
+			else
+				pixel[3] = static_cast<uint8_t>(seed >> 24);
+		}
+	}
+	return pixels;
+}
+
+} // namespace
+
+TEST(BilinearScale, SameSizeCopiesOpaquePixels)
+{
+	const std::vector<uint8_t> src = {
+		10, 20, 30, 255, 40, 50, 60, 255,
+		70, 80, 90, 255, 100, 110, 120, 255,
+		0, 0, 0, 0, 0, 0, 0, 0
+	};
+	std::vector<uint8_t> dst(16);
+	BilinearScale32(src.data(), 2, 2, 8, dst.data(), 2, 2, 8, BilinearScaleKernel::Scalar);
+	EXPECT_EQ(dst[0], 10);
+	EXPECT_EQ(dst[3], 255);
+}
+
+TEST(BilinearScale, KernelsMatchScalar)
+{
+	if (!IsBilinearScaleKernelSupported(BilinearScaleKernel::Sse2))
+		GTEST_SKIP() << "No vector kernel";
+
+	struct Size {
+		int width;
+		int height;
+	};
+	for (Size srcSize : { Size { 32, 32 }, Size { 37, 21 }, Size { 64, 48 } }) {
+		for (Size dstSize : { Size { 48, 48 }, Size { 51, 33 }, Size { 24, 20 }, Size { 128, 96 } }) {
+			SCOPED_TRACE(testing::Message() << srcSize.width << "x" << srcSize.height << " to " << dstSize.width << "x" << dstSize.height);
+			const int srcPitch = srcSize.width * 4 + 4;
+			const int dstPitch = dstSize.width * 4;
+			const std::vector<uint8_t> src = MakeImage(srcSize.width, srcSize.height, srcPitch);
+			std::vector<uint8_t> expected(dstPitch * dstSize.height);
+			std::vector<uint8_t> actual(expected.size());
+			BilinearScale32(src.data(), srcSize.width, srcSize.height, srcPitch, expected.data(), dstSize.width, dstSize.height, dstPitch, BilinearScaleKernel::Scalar);
+			BilinearScale32(src.data(), srcSize.width, srcSize.height, srcPitch, actual.data(), dstSize.width, dstSize.height, dstPitch, BilinearScaleKernel::Sse2);
+			ASSERT_EQ(actual, expected);
+		}
+	}
+}
@@ -0,0 +1,68 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "cursor.h"
+#include "engine/render/cel_render.hpp"
+#include "engine/render/sprite_outline.hpp"
+#include "engine/surface.hpp"
+#include "init.h"
+#include "utils/endian.hpp"
+#include "utils/paths.h"
+
+using namespace devilution;
+
+namespace {
+
+bool LoadItemGraphics()
+{
+	if (diabdat_mpq)
+		return true;
+	for (const char *name : { "DIABDAT.MPQ", "diabdat.mpq" }) {
+		const std::string path = paths::BasePath() + name;
+		int32_t error = 0;
+		diabdat_mpq = MpqArchive::Open(path.c_str(), error);
+		if (diabdat_mpq) {
+			InitCursor();
+			return true;
+		}
+	}
+	return false;
+}
+
+/** @brief Outlines every inventory item graphic, as hovering items in the inventory and stash does. */
+void BM_ItemOutline(benchmark::State &state)
+{
+	if (!LoadItemGraphics()) {
+		state.SkipWithError("DIABDAT.MPQ not found");
+		return;
+	}
+	SetOutlineCacheCapacity(state.range(0) != 0 ? 256 : 0);
+
+	const CelSprite sprite { GetInvItemSprite(CURSOR_FIRSTITEM) };
+	const int numFrames = static_cast<int>(LoadLE32(sprite.Data()));
+
+	std::vector<uint8_t> pixels(640 * 352);
+	SDL_Surface surface {};
+	surface.w = 640;
+	surface.h = 352;
+	surface.pitch = 640;
+	surface.pixels = pixels.data();
+	const Surface out(&surface);
+
+	for (auto _ : state) {
+		for (int frame = 0; frame < numFrames; frame++)
+			CelBlitOutlineTo(out, 194, { 320, 200 }, sprite, frame, false);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * numFrames);
+
+	ClearOutlineCache();
+	SetOutlineCacheCapacity(256);
+}
+
+BENCHMARK(BM_ItemOutline)->Arg(0)->Arg(1)->ArgName("cached");
+
+} // namespace
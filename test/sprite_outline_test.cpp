@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "engine/render/cel_render.hpp"
+#include "engine/render/cl2_render.hpp"
+#include "engine/render/sprite_outline.hpp"
+#include "sprite_test.hpp"
+
+using namespace devilution;
+
+namespace {
+
+constexpr int SpriteWidth = 20;
+constexpr int SpriteHeight = 14;
+constexpr uint8_t OutlineColor = 194;
+
+std::vector<TestImage> MakeImages()
+{
+	std::vector<TestImage> images;
+	for (uint32_t seed : { 3, 17 })
+		images.push_back(MakeTestImage(SpriteWidth, SpriteHeight, seed));
+	return images;
+}
+
+/**
+ * @brief Paints every neighbour of the opaque pixels of an image, as the outline is specified.
+ * @param position Position of the bottom left pixel of the image
+ */
+void DrawReferenceOutline(const Surface &out, Point position, const TestImage &image, bool skipColorIndexZero, uint8_t color)
+{
+	for (int y = 0; y < SpriteHeight; y++) {
+		for (int x = 0; x < SpriteWidth; x++) {
+			const int16_t pixel = image[y * SpriteWidth + x];
+			if (pixel < 0 || (skipColorIndexZero && pixel == 0))
+				continue;
+			const Point center = position + Displacement { x, y - SpriteHeight + 1 };
+			for (Displacement offset : { Displacement { 0, -1 }, Displacement { -1, 0 }, Displacement { 1, 0 }, Displacement { 0, 1 } }) {
+				const Point neighbour = center + offset;
+				if (neighbour.x >= 0 && neighbour.x < out.w() && neighbour.y >= 0 && neighbour.y < out.h())
+					out[neighbour] = color;
+			}
+		}
+	}
+}
+
+/**
+ * @brief Checks that the cached outline matches the reference, at every position around the surface.
+ */
+template <typename Draw, typename DrawReference>
+void ExpectCachedOutlineMatches(const Draw &draw, const DrawReference &drawReference)
+{
+	SetOutlineCacheCapacity(256);
+	for (int y = -3; y < 48 + SpriteHeight + 3; y++) {
+		for (int x = -SpriteWidth - 3; x < 64 + 3; x++) {
+			TestSurface expected;
+			drawReference(expected.Region(), Point { x, y });
+
+			TestSurface actual;
+			draw(actual.Region(), Point { x, y });
+
+			ASSERT_EQ(actual.pixels, expected.pixels) << "at " << x << ", " << y;
+		}
+	}
+	ClearOutlineCache();
+}
+
+} // namespace
+
+TEST(SpriteOutline, CelMatchesReference)
+{
+	const std::vector<TestImage> images = MakeImages();
+	const std::vector<byte> sprite = EncodeCelSprite(images, SpriteWidth, SpriteHeight);
+	const CelSprite cel(sprite.data(), SpriteWidth);
+	ExpectCachedOutlineMatches(
+	    [&](const Surface &out, Point position) {
+		    CelBlitOutlineTo(out, OutlineColor, position, cel, 0);
+		    CelBlitOutlineTo(out, OutlineColor + 1, position + Displacement { 2, 1 }, cel, 1, false);
+	    },
+	    [&](const Surface &out, Point position) {
+		    DrawReferenceOutline(out, position, images[0], true, OutlineColor);
+		    DrawReferenceOutline(out, position + Displacement { 2, 1 }, images[1], false, OutlineColor + 1);
+	    });
+}
+
+TEST(SpriteOutline, Cl2MatchesReference)
+{
+	const std::vector<TestImage> images = MakeImages();
+	const std::vector<byte> sprite = EncodeCl2Sprite(images, SpriteWidth, SpriteHeight);
+	const CelSprite cel(sprite.data(), SpriteWidth);
+	ExpectCachedOutlineMatches(
+	    [&](const Surface &out, Point position) {
+		    Cl2DrawOutline(out, OutlineColor, position.x, position.y, cel, 0);
+		    Cl2DrawOutline(out, OutlineColor + 1, position.x - 1, position.y + 2, cel, 1);
+	    },
+	    [&](const Surface &out, Point position) {
+		    DrawReferenceOutline(out, position, images[0], true, OutlineColor);
+		    DrawReferenceOutline(out, position + Displacement { -1, 2 }, images[1], true, OutlineColor + 1);
+	    });
+}
+
+TEST(SpriteOutline, EvictsLeastRecentlyUsed)
+{
+	const std::vector<byte> sprite = EncodeCl2Sprite(MakeImages(), SpriteWidth, SpriteHeight);
+	const CelSprite cel(sprite.data(), SpriteWidth);
+	const std::vector<byte> celSprite = EncodeCelSprite(MakeImages(), SpriteWidth, SpriteHeight);
+	TestSurface out;
+
+	SetOutlineCacheCapacity(2);
+	Cl2DrawOutline(out.Region(), OutlineColor, 10, 20, cel, 0);
+	Cl2DrawOutline(out.Region(), OutlineColor, 10, 20, cel, 1);
+	EXPECT_NE(FindCachedOutline(sprite.data(), 0, OutlineSource::Cl2), nullptr);
+	CelBlitOutlineTo(out.Region(), OutlineColor, { 10, 20 }, CelSprite(celSprite.data(), SpriteWidth), 0);
+	EXPECT_NE(FindCachedOutline(sprite.data(), 0, OutlineSource::Cl2), nullptr);
+	EXPECT_EQ(FindCachedOutline(sprite.data(), 1, OutlineSource::Cl2), nullptr);
+	EXPECT_NE(FindCachedOutline(celSprite.data(), 0, OutlineSource::CelSkipColorIndexZero), nullptr);
+
+	EvictCachedOutlines(sprite.data());
+	EXPECT_EQ(FindCachedOutline(sprite.data(), 0, OutlineSource::Cl2), nullptr);
+	EXPECT_NE(FindCachedOutline(celSprite.data(), 0, OutlineSource::CelSkipColorIndexZero), nullptr);
+	ClearOutlineCache();
+	SetOutlineCacheCapacity(256);
+}
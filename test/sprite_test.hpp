@@ -0,0 +1,172 @@
+/**
+ * @file sprite_test.hpp
+ *
+ * Helpers for generating CEL and CL2 sprites in tests.
+ */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "engine/surface.hpp"
+#include "utils/stdcompat/cstddef.hpp"
+
+using namespace devilution;
+
+/** @brief Palette index of each pixel from the top row, or -1 where the image is transparent. */
+using TestImage = std::vector<int16_t>;
+
+/**
+ * @brief An oval with a noisy outline, filled with stripes of a single color and noise.
+ */
+inline TestImage MakeTestImage(int width, int height, uint32_t seed)
+{
+	TestImage image(width * height, -1);
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x < width; x++) {
+			seed = seed * 1103515245 + 12345;
+			const int dx = 2 * x - width;
+			const int dy = 2 * y - height;
+			const int edge = static_cast<int>((seed >> 16) % 7);
+			if (dx * dx * height * height + dy * dy * width * width > (width - edge) * (width - edge) * height * height)
+				continue;
+			if ((y / 3) % 2 == 0)
+				image[y * width + x] = static_cast<int16_t>(y * 5 % 256);
+			else
+				image[y * width + x] = static_cast<int16_t>((seed >> 24) % 8);
+		}
+	}
+	return image;
+}
+
+/** @brief Encodes an image as a CL2 frame, including the frame header. */
+inline std::vector<uint8_t> EncodeCl2Frame(const TestImage &image, int width, int height)
+{
+	std::vector<uint8_t> frame = { 10, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+	int transparent = 0;
+	const auto flushTransparent = [&]() {
+		for (; transparent > 0; transparent -= 0x7F)
+			frame.push_back(static_cast<uint8_t>(transparent > 0x7F ? 0x7F : transparent));
+		transparent = 0;
+	};
+	for (int y = height - 1; y >= 0; y--) {
+		const int16_t *line = &image[y * width];
+		int x = 0;
+		while (x < width) {
+			if (line[x] < 0) {
+				transparent++;
+				x++;
+				continue;
+			}
+			flushTransparent();
+			int same = 1;
+			while (x + same < width && same < 63 && line[x + same] == line[x])
+				same++;
+			if (same >= 3) {
+				frame.push_back(static_cast<uint8_t>(0xBF - same));
+				frame.push_back(static_cast<uint8_t>(line[x]));
+				x += same;
+				continue;
+			}
+			int count = 0;
+			while (x + count < width && count < 65 && line[x + count] >= 0 && (x + count + 2 >= width || line[x + count] != line[x + count + 1] || line[x + count] != line[x + count + 2]))
+				count++;
+			if (count == 0)
+				count = 1;
+			frame.push_back(static_cast<uint8_t>(-count));
+			for (int i = 0; i < count; i++)
+				frame.push_back(static_cast<uint8_t>(line[x + i]));
+			x += count;
+		}
+	}
+	flushTransparent();
+	return frame;
+}
+
+/** @brief Encodes an image as a CEL frame, including the frame header. */
+inline std::vector<uint8_t> EncodeCelFrame(const TestImage &image, int width, int height)
+{
+	std::vector<uint8_t> frame = { 10, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+	for (int y = height - 1; y >= 0; y--) {
+		const int16_t *line = &image[y * width];
+		int x = 0;
+		while (x < width) {
+			const bool transparent = line[x] < 0;
+			int count = 1;
+			while (x + count < width && count < 0x7F && (line[x + count] < 0) == transparent)
+				count++;
+			if (transparent) {
+				frame.push_back(static_cast<uint8_t>(-count));
+			} else {
+				frame.push_back(static_cast<uint8_t>(count));
+				for (int i = 0; i < count; i++)
+					frame.push_back(static_cast<uint8_t>(line[x + i]));
+			}
+			x += count;
+		}
+	}
+	return frame;
+}
+
+/** @brief Stores encoded frames as a single direction sprite. */
+inline std::vector<byte> PackSpriteFrames(const std::vector<std::vector<uint8_t>> &frames)
+{
+	std::vector<byte> sprite;
+	const auto pushLE32 = [&sprite](uint32_t value) {
+		for (int i = 0; i < 4; i++)
+			sprite.push_back(static_cast<byte>(value >> (8 * i)));
+	};
+	pushLE32(static_cast<uint32_t>(frames.size()));
+	auto offset = static_cast<uint32_t>(4 * (frames.size() + 2));
+	for (const std::vector<uint8_t> &frame : frames) {
+		pushLE32(offset);
+		offset += static_cast<uint32_t>(frame.size());
+	}
+	pushLE32(offset);
+	for (const std::vector<uint8_t> &frame : frames) {
+		for (uint8_t v : frame)
+			sprite.push_back(static_cast<byte>(v));
+	}
+	return sprite;
+}
+
+/** @brief Encodes images of the same size as the frames of a single direction CEL sprite. */
+inline std::vector<byte> EncodeCelSprite(const std::vector<TestImage> &images, int width, int height)
+{
+	std::vector<std::vector<uint8_t>> frames;
+	for (const TestImage &image : images)
+		frames.push_back(EncodeCelFrame(image, width, height));
+	return PackSpriteFrames(frames);
+}
+
+/** @brief Encodes images of the same size as the frames of a single direction CL2 sprite. */
+inline std::vector<byte> EncodeCl2Sprite(const std::vector<TestImage> &images, int width, int height)
+{
+	std::vector<std::vector<uint8_t>> frames;
+	for (const TestImage &image : images)
+		frames.push_back(EncodeCl2Frame(image, width, height));
+	return PackSpriteFrames(frames);
+}
+
+/** @brief A 64x48 region in a larger buffer, so that writes outside of the region are noticed. */
+struct TestSurface {
+	static constexpr int BufferWidth = 80;
+	static constexpr int BufferHeight = 60;
+
+	TestSurface()
+	    : pixels(BufferWidth * BufferHeight, 0xAA)
+	{
+		surface.w = BufferWidth;
+		surface.h = BufferHeight;
+		surface.pitch = BufferWidth;
+		surface.pixels = pixels.data();
+	}
+
+	Surface Region()
+	{
+		return Surface(&surface, MakeSdlRect(8, 6, 64, 48));
+	}
+
+	std::vector<uint8_t> pixels;
+	SDL_Surface surface {};
+};
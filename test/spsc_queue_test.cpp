@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+#include "utils/spsc_queue.hpp"
+
+using namespace devilution;
+
+TEST(SpscQueue, PushPop)
+{
+	SpscQueue<int, 4> queue;
+	EXPECT_TRUE(queue.Empty());
+	EXPECT_EQ(queue.Front(), nullptr);
+
+	EXPECT_TRUE(queue.TryPush(1));
+	EXPECT_TRUE(queue.TryPush(2));
+	EXPECT_FALSE(queue.Empty());
+	ASSERT_NE(queue.Front(), nullptr);
+	EXPECT_EQ(*queue.Front(), 1);
+
+	int value = 0;
+	EXPECT_TRUE(queue.TryPop(value));
+	EXPECT_EQ(value, 1);
+	EXPECT_TRUE(queue.TryPop(value));
+	EXPECT_EQ(value, 2);
+	EXPECT_FALSE(queue.TryPop(value));
+	EXPECT_TRUE(queue.Empty());
+}
+
+TEST(SpscQueue, Full)
+{
+	SpscQueue<std::unique_ptr<int>, 2> queue;
+	EXPECT_TRUE(queue.TryPush(std::make_unique<int>(1)));
+	EXPECT_TRUE(queue.TryPush(std::make_unique<int>(2)));
+
+	auto rejected = std::make_unique<int>(3);
+	EXPECT_FALSE(queue.TryPush(std::move(rejected)));
+	ASSERT_NE(rejected, nullptr);
+	EXPECT_EQ(*rejected, 3);
+
+	queue.Pop();
+	EXPECT_TRUE(queue.TryPush(std::move(rejected)));
+
+	std::unique_ptr<int> value;
+	EXPECT_TRUE(queue.TryPop(value));
+	EXPECT_EQ(*value, 2);
+	EXPECT_TRUE(queue.TryPop(value));
+	EXPECT_EQ(*value, 3);
+}
+
+TEST(SpscQueue, Clear)
+{
+	SpscQueue<std::unique_ptr<int>, 8> queue;
+	for (int i = 0; i < 5; i++)
+		queue.TryPush(std::make_unique<int>(i));
+	queue.Clear();
+	EXPECT_TRUE(queue.Empty());
+	EXPECT_TRUE(queue.TryPush(std::make_unique<int>(5)));
+	EXPECT_EQ(**queue.Front(), 5);
+}
+
+// Meant to be run with TSAN=ON to detect data races between the producer and the consumer.
+TEST(SpscQueue, ConcurrentStress)
+{
+	constexpr uint32_t Count = 200000;
+	SpscQueue<std::unique_ptr<uint32_t>, 64> queue;
+
+	std::thread producer([&]() {
+		for (uint32_t i = 0; i < Count; i++) {
+			auto value = std::make_unique<uint32_t>(i);
+			while (!queue.TryPush(std::move(value)))
+				std::this_thread::yield();
+		}
+	});
+
+	uint32_t expected = 0;
+	std::unique_ptr<uint32_t> value;
+	while (expected < Count) {
+		if (!queue.TryPop(value)) {
+			std::this_thread::yield();
+			continue;
+		}
+		ASSERT_NE(value, nullptr);
+		ASSERT_EQ(*value, expected);
+		expected++;
+	}
+
+	producer.join();
+	EXPECT_TRUE(queue.Empty());
+}
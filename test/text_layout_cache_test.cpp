@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "engine/render/text_render.hpp"
+
+using namespace devilution;
+
+namespace {
+
+const char *const Texts[] = {
+	"",
+	"Hello",
+	"Two\nlines",
+	"A rather long sentence that has to be wrapped over several lines",
+	"Zero​width​spaces",
+	"你好世界你好世界",
+	"Invalid \xFF tail",
+};
+
+} // namespace
+
+TEST(TextLayoutCache, MatchesUncached)
+{
+	for (const char *text : Texts) {
+		for (int spacing : { 0, 1, 2 }) {
+			SetTextLayoutCacheCapacity(0);
+			int expectedCharacters;
+			const int expectedWidth = GetLineWidth(text, GameFont12, spacing, &expectedCharacters);
+			const std::string expectedWrapped = WordWrapString(text, 40, GameFont24, spacing);
+
+			SetTextLayoutCacheCapacity(512);
+			for (int pass = 0; pass < 2; pass++) {
+				int characters;
+				EXPECT_EQ(GetLineWidth(text, GameFont12, spacing, &characters), expectedWidth) << text;
+				EXPECT_EQ(characters, expectedCharacters) << text;
+				EXPECT_EQ(WordWrapString(text, 40, GameFont24, spacing), expectedWrapped) << text;
+			}
+		}
+	}
+	UnloadFonts();
+}
+
+TEST(TextLayoutCache, CountsHitsAndMisses)
+{
+	SetTextLayoutCacheCapacity(512);
+	UnloadFonts();
+	ResetTextLayoutCacheStats();
+
+	GetLineWidth("Hello", GameFont12);
+	GetLineWidth("Hello", GameFont12, 2);
+	GetLineWidth("Hello", GameFont24);
+	EXPECT_EQ(WordWrapString("Hello world", 30), WordWrapString("Hello world", 30));
+
+	TextLayoutCacheStats stats = GetTextLayoutCacheStats();
+	EXPECT_EQ(stats.layoutHits, 1);
+	EXPECT_EQ(stats.layoutMisses, 2);
+	EXPECT_EQ(stats.wrapHits, 1);
+	EXPECT_EQ(stats.wrapMisses, 1);
+	EXPECT_EQ(stats.layouts, 2);
+	EXPECT_EQ(stats.wrappedTexts, 1);
+	EXPECT_GT(stats.memoryUsage, 0);
+
+	UnloadFonts();
+	stats = GetTextLayoutCacheStats();
+	EXPECT_EQ(stats.layouts, 0);
+	EXPECT_EQ(stats.wrappedTexts, 0);
+	EXPECT_EQ(stats.memoryUsage, 0);
+}
+
+TEST(TextLayoutCache, EvictsLeastRecentlyUsed)
+{
+	SetTextLayoutCacheCapacity(2);
+	UnloadFonts();
+	ResetTextLayoutCacheStats();
+
+	GetLineWidth("one");
+	GetLineWidth("two");
+	GetLineWidth("one");
+	GetLineWidth("three");
+	EXPECT_EQ(GetTextLayoutCacheStats().layouts, 2);
+
+	GetLineWidth("one");
+	EXPECT_EQ(GetTextLayoutCacheStats().layoutHits, 2);
+	GetLineWidth("two");
+	EXPECT_EQ(GetTextLayoutCacheStats().layoutMisses, 4);
+
+	UnloadFonts();
+	SetTextLayoutCacheCapacity(512);
+}
@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include <SDL.h>
+
+#include "diablo.h"
+#include "tmsg.h"
+
+using namespace devilution;
+
+namespace {
+
+TEST(Tmsg, KeepsTheOrderOfBurstsLargerThanTheQueue)
+{
+	gnTickDelay = 0;
+	constexpr int Count = 600;
+	for (int i = 0; i < Count; i++) {
+		const uint16_t body = static_cast<uint16_t>(i);
+		tmsg_add(reinterpret_cast<const byte *>(&body), sizeof(body));
+	}
+	// Messages are due once their time has passed.
+	SDL_Delay(2);
+
+	byte msg[MaxTmsgLen];
+	for (int i = 0; i < Count; i++) {
+		ASSERT_EQ(tmsg_get(msg), sizeof(uint16_t));
+		uint16_t body;
+		memcpy(&body, msg, sizeof(body));
+		EXPECT_EQ(body, i);
+	}
+	EXPECT_EQ(tmsg_get(msg), 0);
+	tmsg_start();
+}
+
+TEST(Tmsg, KeepsTheOrderWhenGrowingAfterWrappingAround)
+{
+	gnTickDelay = 0;
+	uint16_t next = 0;
+	uint16_t expected = 0;
+	byte msg[MaxTmsgLen];
+	for (int round = 0; round < 3; round++) {
+		for (int i = 0; i < 12 + round * 20; i++, next++)
+			tmsg_add(reinterpret_cast<const byte *>(&next), sizeof(next));
+		SDL_Delay(2);
+		for (int i = 0; i < 10; i++, expected++) {
+			ASSERT_EQ(tmsg_get(msg), sizeof(uint16_t));
+			uint16_t body;
+			memcpy(&body, msg, sizeof(body));
+			EXPECT_EQ(body, expected);
+		}
+	}
+	tmsg_cleanup();
+}
+
+TEST(Tmsg, CleanupDropsQueuedMessages)
+{
+	gnTickDelay = 0;
+	const byte body[1] {};
+	for (int i = 0; i < 300; i++)
+		tmsg_add(body, sizeof(body));
+	tmsg_cleanup();
+
+	SDL_Delay(2);
+	byte msg[MaxTmsgLen];
+	EXPECT_EQ(tmsg_get(msg), 0);
+}
+
+} // namespace
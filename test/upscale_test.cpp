@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <vector>
+
+#include "utils/upscale.hpp"
+
+using namespace devilution;
+
+namespace {
+
+constexpr UpscaleKernel VectorKernels[] = { UpscaleKernel::Sse2, UpscaleKernel::Avx2, UpscaleKernel::Neon };
+
+std::vector<uint8_t> MakePixels(size_t size)
+{
+	std::vector<uint8_t> pixels(size);
+	uint32_t seed = 7;
+	for (auto &pixel : pixels) {
+		seed = seed * 1103515245 + 12345;
+		pixel = static_cast<uint8_t>(seed >> 16);
+	}
+	return pixels;
+}
+
+} // namespace
+
+TEST(Upscale, DoublePixelsScalar)
+{
+	const uint8_t src[] = { 1, 2, 3 };
+	uint8_t dst[6];
+	DoublePixels(src, dst, 3, UpscaleKernel::Scalar);
+	const uint8_t expected[] = { 1, 1, 2, 2, 3, 3 };
+	EXPECT_EQ(memcmp(dst, expected, sizeof(dst)), 0);
+}
+
+TEST(Upscale, DoublePixelsKernelsMatchScalar)
+{
+	const std::vector<uint8_t> src = MakePixels(100);
+	for (UpscaleKernel kernel : VectorKernels) {
+		if (!IsUpscaleKernelSupported(kernel))
+			continue;
+		SCOPED_TRACE(static_cast<int>(kernel));
+		for (int count : { 0, 1, 15, 16, 17, 31, 32, 33, 64, 100 }) {
+			SCOPED_TRACE(count);
+			std::vector<uint8_t> expected(200, 0xAA);
+			std::vector<uint8_t> actual(200, 0xAA);
+			DoublePixels(src.data(), expected.data(), count, UpscaleKernel::Scalar);
+			DoublePixels(src.data(), actual.data(), count, kernel);
+			ASSERT_EQ(actual, expected);
+		}
+	}
+}
+
+TEST(Upscale, DoublePixelsInPlace)
+{
+	// Like `Zoom`, which doubles the left half of a row into the same row.
+	for (UpscaleKernel kernel : { UpscaleKernel::Scalar, UpscaleKernel::Sse2, UpscaleKernel::Avx2, UpscaleKernel::Neon }) {
+		if (!IsUpscaleKernelSupported(kernel))
+			continue;
+		SCOPED_TRACE(static_cast<int>(kernel));
+		for (int offset : { 0, 1, 5 }) {
+			SCOPED_TRACE(offset);
+			std::vector<uint8_t> row = MakePixels(2 * 77 + offset);
+			const std::vector<uint8_t> src(row.begin(), row.begin() + 77);
+			DoublePixels(row.data(), row.data() + offset, 77, kernel);
+			for (int i = 0; i < 2 * 77; i++)
+				ASSERT_EQ(row[offset + i], src[i / 2]) << i;
+		}
+	}
+}
+
+TEST(Upscale, UpscaleNearest)
+{
+	const uint8_t src[] = {
+		1, 2,
+		3, 4
+	};
+	uint8_t dst[6 * 6];
+	UpscaleNearest(src, 2, dst, 6, 2, 2, 1, 3, UpscaleKernel::Scalar);
+	for (int y = 0; y < 6; y++) {
+		for (int x = 0; x < 6; x++)
+			EXPECT_EQ(dst[y * 6 + x], src[(y / 3) * 2 + x / 3]) << x << "," << y;
+	}
+}
+
+TEST(Upscale, UpscaleNearestKernelsMatchScalar)
+{
+	constexpr int Width = 37;
+	constexpr int Height = 5;
+	constexpr int SrcPitch = Width * 4 + 12;
+	const std::vector<uint8_t> src = MakePixels(SrcPitch * Height);
+	for (UpscaleKernel kernel : VectorKernels) {
+		if (!IsUpscaleKernelSupported(kernel))
+			continue;
+		SCOPED_TRACE(static_cast<int>(kernel));
+		for (int bytesPerPixel : { 1, 4 }) {
+			for (int factor : { 1, 2, 3, 4, 8 }) {
+				SCOPED_TRACE(bytesPerPixel);
+				SCOPED_TRACE(factor);
+				const int dstPitch = Width * factor * bytesPerPixel + 8;
+				std::vector<uint8_t> expected(dstPitch * Height * factor, 0xAA);
+				std::vector<uint8_t> actual(expected.size(), 0xAA);
+				UpscaleNearest(src.data(), SrcPitch, expected.data(), dstPitch, Width, Height, bytesPerPixel, factor, UpscaleKernel::Scalar);
+				UpscaleNearest(src.data(), SrcPitch, actual.data(), dstPitch, Width, Height, bytesPerPixel, factor, kernel);
+				ASSERT_EQ(actual, expected);
+
+				for (int y = 0; y < Height * factor; y++) {
+					for (int x = 0; x < Width * factor * bytesPerPixel; x++) {
+						const int srcX = (x / bytesPerPixel / factor) * bytesPerPixel + x % bytesPerPixel;
+						ASSERT_EQ(actual[y * dstPitch + x], src[(y / factor) * SrcPitch + srcX]) << x << "," << y;
+					}
+				}
+			}
+		}
+	}
+}